@@ -88,6 +88,8 @@ namespace {
     oss << "                          (X=1000000, default)" << std::endl;
     oss << "[--seed X]                Seed of pseudo generator number" << std::endl;
     oss << "                          (X=777, default)" << std::endl;
+    oss << "[--persistent]            Persistent transport (megakernel) instead of one kernel by navigation step," << std::endl;
+    oss << "                          outputs are suffixed by '_persistent'" << std::endl;
     throw std::invalid_argument(oss.str());
   }
 
@@ -125,6 +127,7 @@ int main(int argc, char** argv)
     std::string device = "0";
     std::string device_balance = "";
     GGuint seed = 777;
+    static GGint is_persistent = 0;
 
     // Loop while there is an argument
     GGint counter(0);
@@ -137,7 +140,8 @@ int main(int argc, char** argv)
         {"n-particles", required_argument, nullptr, 'p'},
         {"device", required_argument, nullptr, 'd'},
         {"balance", required_argument, nullptr, 'b'},
-        {"seed", required_argument, nullptr, 's'}
+        {"seed", required_argument, nullptr, 's'},
+        {"persistent", no_argument, &is_persistent, 1},
       };
 
       // Getting the options
@@ -243,7 +247,7 @@ int main(int argc, char** argv)
     ct_detector.SetSourceIsocenterDistance(595.0f, "mm");
     ct_detector.SetRotation(0.0f, 0.0f, 0.0f, "deg");
     ct_detector.SetThreshold(10.0f, "keV");
-    ct_detector.StoreOutput("data/projection");
+    ct_detector.StoreOutput(is_persistent ? "data/projection_persistent" : "data/projection");
     ct_detector.StoreScatter(true);
 
     // Physics
@@ -281,6 +285,7 @@ int main(int argc, char** argv)
     ggems.SetRandomVerbose(true);
     ggems.SetProfilingVerbose(true);
     ggems.SetTrackingVerbose(false, 0);
+    if (is_persistent) ggems.SetPersistentTransport(true);
 
     // Initializing the GGEMS simulation
     ggems.Initialize(seed);
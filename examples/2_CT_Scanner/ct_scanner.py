@@ -33,6 +33,7 @@ parser.add_argument('-b', '--balance', required=False, type=str, help="X;Y;Z...
 parser.add_argument('-n', '--nparticles', required=False, type=int, default=1000000, help="Number of particles")
 parser.add_argument('-s', '--seed', required=False, type=int, default=777, help="Seed of pseudo generator number")
 parser.add_argument('-v', '--verbose', required=False, type=int, default=0, help="Set level of verbosity")
+parser.add_argument('-m', '--persistent', required=False, action='store_true', help="Persistent transport (megakernel) instead of one kernel by navigation step, outputs are suffixed by '_persistent'")
 
 args = parser.parse_args()
 
@@ -42,6 +43,8 @@ verbosity_level = args.verbose
 number_of_particles = args.nparticles
 device_balancing = args.balance
 seed = args.seed
+is_persistent = args.persistent
+output_suffix = '_persistent' if is_persistent else ''
 
 # ------------------------------------------------------------------------------
 # STEP 0: Level of verbosity during computation
@@ -111,7 +114,7 @@ ct_detector.set_source_detector_distance(1085.6, 'mm')
 ct_detector.set_source_isocenter_distance(595.0, 'mm')
 ct_detector.set_rotation(0.0, 0.0, 0.0, 'deg')
 ct_detector.set_threshold(10.0, 'keV')
-ct_detector.save('data/projection')
+ct_detector.save('data/projection' + output_suffix)
 ct_detector.store_scatter(True)
 
 # ------------------------------------------------------------------------------
@@ -153,6 +156,7 @@ ggems.range_cuts_verbose(True)
 ggems.random_verbose(True)
 ggems.profiling_verbose(True)
 ggems.tracking_verbose(False, 0)
+ggems.persistent_transport(is_persistent)
 
 # Initializing the GGEMS simulation
 ggems.initialize(seed)
@@ -0,0 +1,99 @@
+# ************************************************************************
+# * This file is part of GGEMS.                                          *
+# *                                                                      *
+# * GGEMS is free software: you can redistribute it and/or modify        *
+# * it under the terms of the GNU General Public License as published by *
+# * the Free Software Foundation, either version 3 of the License, or    *
+# * (at your option) any later version.                                  *
+# *                                                                      *
+# * GGEMS is distributed in the hope that it will be useful,             *
+# * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+# * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+# * GNU General Public License for more details.                         *
+# *                                                                      *
+# * You should have received a copy of the GNU General Public License    *
+# * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+# *                                                                      *
+# ************************************************************************
+
+import argparse
+import array
+import math
+import os
+
+# ------------------------------------------------------------------------------
+# Read arguments
+parser = argparse.ArgumentParser(
+  prog='compare_transport.py',
+  description='-->> 4 - Dosimetry Example, persistent transport against multi-kernel transport <<--',
+  epilog='Run dosimetry_photon.py twice with the same seed, without and with --persistent, then run this script. Elapsed time of each transport is printed at the end of each run.',
+  formatter_class=argparse.ArgumentDefaultsHelpFormatter
+)
+
+parser.add_argument('-r', '--reference', required=False, type=str, default='data/dosimetry', help="Basename of outputs of multi-kernel transport")
+parser.add_argument('-p', '--persistent', required=False, type=str, default='data/dosimetry_persistent', help="Basename of outputs of persistent transport")
+parser.add_argument('-u', '--uncertainty', required=False, type=float, default=0.05, help="Dosels with a relative uncertainty below this value are compared one by one")
+
+args = parser.parse_args()
+
+# ------------------------------------------------------------------------------
+# Reading a MHD image written by GGEMS
+def read_mhd(mhd_filename):
+    header = {}
+    with open(mhd_filename, 'r') as mhd_file:
+        for line in mhd_file:
+            if '=' in line:
+                key, value = line.split('=', 1)
+                header[key.strip()] = value.strip()
+
+    types = {'MET_FLOAT': 'f', 'MET_DOUBLE': 'd', 'MET_INT': 'i', 'MET_UINT': 'I', 'MET_SHORT': 'h', 'MET_USHORT': 'H', 'MET_CHAR': 'b', 'MET_UCHAR': 'B'}
+    data = array.array(types[header['ElementType']])
+
+    raw_filename = os.path.join(os.path.dirname(mhd_filename), header['ElementDataFile'])
+    with open(raw_filename, 'rb') as raw_file:
+        data.frombytes(raw_file.read())
+
+    return data
+
+# ------------------------------------------------------------------------------
+# Comparing dose and uncertainty of both transports
+dose_reference = read_mhd(args.reference + '_dose.mhd')
+dose_persistent = read_mhd(args.persistent + '_dose.mhd')
+
+is_uncertainty = os.path.isfile(args.reference + '_uncertainty.mhd') and os.path.isfile(args.persistent + '_uncertainty.mhd')
+if is_uncertainty:
+    uncertainty_reference = read_mhd(args.reference + '_uncertainty.mhd')
+    uncertainty_persistent = read_mhd(args.persistent + '_uncertainty.mhd')
+
+total_dose_reference = math.fsum(dose_reference)
+total_dose_persistent = math.fsum(dose_persistent)
+
+print('Total dose, multi-kernel transport: {:e} Gy'.format(total_dose_reference))
+print('Total dose, persistent transport: {:e} Gy'.format(total_dose_persistent))
+if total_dose_reference > 0.0:
+    print('Relative difference of total dose: {:e}'.format((total_dose_persistent - total_dose_reference) / total_dose_reference))
+
+number_of_identical_dosels = sum(1 for d_ref, d_per in zip(dose_reference, dose_persistent) if d_ref == d_per)
+print('Identical dosels: {} / {}'.format(number_of_identical_dosels, len(dose_reference)))
+
+# Dosels with low uncertainty in both runs, difference in number of standard deviations
+if is_uncertainty:
+    number_of_compared_dosels = 0
+    number_of_dosels_within_2_sigma = 0
+    maximum_relative_difference = 0.0
+    for i in range(len(dose_reference)):
+        if dose_reference[i] <= 0.0 or dose_persistent[i] <= 0.0:
+            continue
+        if uncertainty_reference[i] > args.uncertainty or uncertainty_persistent[i] > args.uncertainty:
+            continue
+
+        number_of_compared_dosels += 1
+        sigma = math.hypot(uncertainty_reference[i]*dose_reference[i], uncertainty_persistent[i]*dose_persistent[i])
+        if abs(dose_persistent[i] - dose_reference[i]) <= 2.0*sigma:
+            number_of_dosels_within_2_sigma += 1
+        maximum_relative_difference = max(maximum_relative_difference, abs(dose_persistent[i] - dose_reference[i]) / dose_reference[i])
+
+    print('Dosels with relative uncertainty below {}: {}'.format(args.uncertainty, number_of_compared_dosels))
+    if number_of_compared_dosels > 0:
+        print('Dosels agreeing within 2 standard deviations: {:.2f} %'.format(100.0 * number_of_dosels_within_2_sigma / number_of_compared_dosels))
+        print('Maximum relative difference of dose: {:e}'.format(maximum_relative_difference))
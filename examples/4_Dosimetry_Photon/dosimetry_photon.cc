@@ -90,6 +90,8 @@ namespace {
     oss << "[--seed X]                Seed of pseudo generator number" << std::endl;
     oss << "                          (X=777, default)" << std::endl;
     oss << "[--tle]                   Activating TLE method" << std::endl;
+    oss << "[--persistent]            Persistent transport (megakernel) instead of one kernel by navigation step," << std::endl;
+    oss << "                          outputs are suffixed by '_persistent'" << std::endl;
     throw std::invalid_argument(oss.str());
   }
 
@@ -128,6 +130,7 @@ int main(int argc, char** argv)
     std::string device_balance = "";
     GGuint seed = 777;
     static GGint is_tle = 0;
+    static GGint is_persistent = 0;
 
     // Loop while there is an argument
     GGint counter(0);
@@ -142,6 +145,7 @@ int main(int argc, char** argv)
         {"balance", required_argument, nullptr, 'b'},
         {"seed", required_argument, nullptr, 's'},
         {"tle", no_argument, &is_tle, 1},
+        {"persistent", no_argument, &is_persistent, 1},
       };
 
       // Getting the options
@@ -240,7 +244,7 @@ int main(int argc, char** argv)
     // Dosimetry
     GGEMSDosimetryCalculator dosimetry;
     dosimetry.AttachToNavigator("phantom");
-    dosimetry.SetOutputDosimetryBasename("data/dosimetry");
+    dosimetry.SetOutputDosimetryBasename(is_persistent ? "data/dosimetry_persistent" : "data/dosimetry");
     dosimetry.SetDoselSizes(0.5f, 0.5f, 0.5f);
     dosimetry.SetWaterReference(false);
     dosimetry.SetMinimumDensity(0.1f, "g/cm3");
@@ -287,6 +291,7 @@ int main(int argc, char** argv)
     ggems.SetRandomVerbose(true);
     ggems.SetProfilingVerbose(true);
     ggems.SetTrackingVerbose(false, 0);
+    if (is_persistent) ggems.SetPersistentTransport(true);
 
     // Initializing the GGEMS simulation
     ggems.Initialize(seed);
@@ -34,6 +34,7 @@ parser.add_argument('-n', '--nparticles', required=False, type=int, default=1000
 parser.add_argument('-s', '--seed', required=False, type=int, default=777, help="Seed of pseudo generator number")
 parser.add_argument('-v', '--verbose', required=False, type=int, default=0, help="Set level of verbosity")
 parser.add_argument('-t', '--tle', required=False, action='store_true', help="Activating TLE method")
+parser.add_argument('-m', '--persistent', required=False, action='store_true', help="Persistent transport (megakernel) instead of one kernel by navigation step, outputs are suffixed by '_persistent'")
 
 args = parser.parse_args()
 
@@ -44,6 +45,8 @@ number_of_particles = args.nparticles
 device_balancing = args.balance
 seed = args.seed
 is_tle = args.tle
+is_persistent = args.persistent
+output_suffix = '_persistent' if is_persistent else ''
 
 # ------------------------------------------------------------------------------
 # STEP 0: Level of verbosity during computation
@@ -107,7 +110,7 @@ phantom.set_position(0.0, 0.0, 0.0, 'mm')
 # STEP 5: Dosimetry
 dosimetry = GGEMSDosimetryCalculator()
 dosimetry.attach_to_navigator('phantom')
-dosimetry.set_output_basename('data/dosimetry')
+dosimetry.set_output_basename('data/dosimetry' + output_suffix)
 dosimetry.set_dosel_size(0.5, 0.5, 0.5, 'mm')
 dosimetry.water_reference(False)
 dosimetry.minimum_density(0.1, 'g/cm3')
@@ -158,6 +161,7 @@ ggems.range_cuts_verbose(True)
 ggems.random_verbose(True)
 ggems.profiling_verbose(True)
 ggems.tracking_verbose(False, 0)
+ggems.persistent_transport(is_persistent)
 
 # Initializing the GGEMS simulation
 ggems.initialize(seed)
@@ -100,9 +100,9 @@ world.set_dimensions(200, 200, 200)
 world.set_element_sizes(10.0, 10.0, 10.0, 'mm')
 world.set_output_basename('data/world')
 
-world.energy_tracking(True)
-world.energy_squared_tracking(True)
-world.momentum(True)
+world.energy_track_length(True)
+world.energy_squared_track_length(True)
+world.momentum_track_length(True)
 world.photon_tracking(True)
 
 # Loading phantom in GGEMS
@@ -325,6 +325,66 @@ inline GGfloat ComputeDistanceToOBB(GGfloat3 const* position, GGfloat3 const* di
   );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void InitializeVoxelTraversal(GGfloat3 const* position, GGfloat3 const* direction, GGfloat3 const border_min, GGfloat3 const voxel_size, GGint3 const voxel_id, GGint3* voxel_step, GGfloat3* next_crossing, GGfloat3* crossing_delta)
+  \param position - pointer on position of primary particle, inside the voxel
+  \param direction - pointer on direction of primary particle
+  \param border_min - min. border of voxelized solid
+  \param voxel_size - size of voxel
+  \param voxel_id - index of voxel containing the particle
+  \param voxel_step - step of voxel index on each axis (-1, 0 or 1)
+  \param next_crossing - distance to next voxel boundary on each axis
+  \param crossing_delta - distance between two voxel boundaries on each axis
+  \brief Initialize incremental voxel traversal (Amanatides-Woo), to be called again when direction changes
+*/
+inline void InitializeVoxelTraversal(GGfloat3 const* position, GGfloat3 const* direction, GGfloat3 const border_min, GGfloat3 const voxel_size, GGint3 const voxel_id, GGint3* voxel_step, GGfloat3* next_crossing, GGfloat3* crossing_delta)
+{
+  // Borders of current voxel
+  GGfloat3 voxel_border_min = border_min + convert_float3(voxel_id)*voxel_size;
+  GGfloat3 voxel_border_max = voxel_border_min + voxel_size;
+
+  // Next border crossed on each axis depends on sign of direction, axes parallel to direction are never crossed
+  GGint3 is_parallel = fabs(*direction) < EPSILON6;
+  GGfloat3 next_border = select(voxel_border_min, voxel_border_max, *direction > 0.0f);
+  GGfloat3 inverse_direction = 1.0f / *direction;
+
+  *voxel_step = select(convert_int3(sign(*direction)), (GGint3)(0), is_parallel);
+  *next_crossing = select(fmax((next_border - *position)*inverse_direction, (GGfloat3)(0.0f)), (GGfloat3)(OUT_OF_WORLD), is_parallel);
+  *crossing_delta = select(voxel_size*fabs(inverse_direction), (GGfloat3)(OUT_OF_WORLD), is_parallel);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void StepVoxelTraversal(GGint3* voxel_id, GGint3 const* voxel_step, GGfloat3* next_crossing, GGfloat3 const* crossing_delta)
+  \param voxel_id - index of current voxel, moved to next voxel
+  \param voxel_step - step of voxel index on each axis (-1, 0 or 1)
+  \param next_crossing - distance to next voxel boundary on each axis, nearest one is 0 when called
+  \param crossing_delta - distance between two voxel boundaries on each axis
+  \brief Move to next voxel through the nearest boundary, index of voxel is out of solid at exit face
+*/
+inline void StepVoxelTraversal(GGint3* voxel_id, GGint3 const* voxel_step, GGfloat3* next_crossing, GGfloat3 const* crossing_delta)
+{
+  if (next_crossing->x <= next_crossing->y && next_crossing->x <= next_crossing->z) {
+    voxel_id->x += voxel_step->x;
+    next_crossing->x += crossing_delta->x;
+  }
+  else if (next_crossing->y <= next_crossing->z) {
+    voxel_id->y += voxel_step->y;
+    next_crossing->y += crossing_delta->y;
+  }
+  else {
+    voxel_id->z += voxel_step->z;
+    next_crossing->z += crossing_delta->z;
+  }
+}
+
 #endif
 
 #endif // End of GUARD_GGEMS_GEOMETRIES_GGEMSRAYTRACING_HH
@@ -208,6 +208,13 @@ class GGEMS_EXPORT GGEMSSolid
     */
     inline std::string GetRegisteredDataType(void) const {return data_reg_type_;}
 
+    /*!
+      \fn std::string GetKernelOption(void) const
+      \return the preprocessor options used to compile solid kernels
+      \brief get the preprocessor options of the solid kernels
+    */
+    inline std::string GetKernelOption(void) const {return kernel_option_;}
+
     /*!
       \fn cl::Kernel* GetKernelParticleSolidDistance(GGsize const& thread_index) const
       \param thread_index - index of activated device (thread index)
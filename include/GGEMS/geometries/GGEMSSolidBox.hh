@@ -47,7 +47,7 @@ class GGEMS_EXPORT GGEMSSolidBox : public GGEMSSolid
       \param element_size_x - element size along X
       \param element_size_y - element size along Y
       \param element_size_z - element size along Z
-      \param data_reg_type - type of registration "HIT", "SINGLE", "DOSE"
+      \param data_reg_type - type of registration "HISTOGRAM" or "MODULE" (histogram owned by system)
       \brief GGEMSSolidBox constructor
     */
     GGEMSSolidBox(GGsize const& virtual_element_number_x, GGsize const& virtual_element_number_y, GGsize const& virtual_element_number_z, GGfloat const& element_size_x, GGfloat const& element_size_y, GGfloat const& element_size_z, std::string const& data_reg_type);
@@ -42,6 +42,8 @@ typedef struct GGEMSSolidBoxData_t
   GGEMSOBB obb_geometry_; /*!< OBB storing border of voxelized solid and matrix of transformation */
   GGsize virtual_element_number_xyz_[3]; /*!< Number of virtual element in box */
   GGfloat box_size_xyz_[3]; /*!< Length of box in X, Y and Z */
+  GGsize histogram_offset_; /*!< Index of the first element of box in histogram */
+  GGsize histogram_stride_; /*!< Number of elements in a row of histogram */
   GGint solid_id_; /*!< Navigator index */
 } GGEMSSolidBoxData; /*!< Using C convention name of struct to C++ (_t deletion) */
 
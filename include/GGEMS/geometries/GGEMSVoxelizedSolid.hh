@@ -31,6 +31,9 @@
   \date Wednesday June 10, 2020
 */
 
+#include <thread>
+#include <algorithm>
+
 #include "GGEMS/geometries/GGEMSVoxelizedSolidData.hh"
 #include "GGEMS/geometries/GGEMSSolid.hh"
 
@@ -143,6 +146,35 @@ class GGEMS_EXPORT GGEMSVoxelizedSolid : public GGEMSSolid
     template <typename T>
     void ConvertImageToLabel(std::string const& raw_data_filename, std::string const& range_data_filename, GGEMSMaterials* materials);
 
+    /*!
+      \fn void ReadRangeToLabel(std::string const& range_data_filename, GGEMSMaterials* materials)
+      \param range_data_filename - name of the file containing the range to material data
+      \param materials - pointer on material for a phantom
+      \brief read the range file once and build sorted bounds of ranges with their labels, the last matching range gives the label
+    */
+    void ReadRangeToLabel(std::string const& range_data_filename, GGEMSMaterials* materials);
+
+    /*!
+      \fn GGLabelType GetLabelOfValue(GGfloat const& value) const
+      \param value - value of voxel in image
+      \return label of value, max of GGLabelType if value is in no range
+      \brief find the label of a value by binary search in sorted bounds of ranges
+    */
+    GGLabelType GetLabelOfValue(GGfloat const& value) const;
+
+    /*!
+      \fn template <typename T> void ConvertVoxelsToLabel(T const* raw_data, GGLabelType* label_data, GGLabelType const* label_lut, GGsize const first_voxel, GGsize const last_voxel) const
+      \tparam T - type of data
+      \param raw_data - image data
+      \param label_data - label data
+      \param label_lut - lookup table of labels for 8 and 16 bits data, nullptr otherwise
+      \param first_voxel - first voxel to convert
+      \param last_voxel - last voxel to convert (excluded)
+      \brief convert a part of image data to label data, called by each host thread
+    */
+    template <typename T>
+    void ConvertVoxelsToLabel(T const* raw_data, GGLabelType* label_data, GGLabelType const* label_lut, GGsize const first_voxel, GGsize const last_voxel) const;
+
     /*!
       \fn void InitializeKernel(void)
       \brief Initialize kernel for particle solid distance
@@ -152,6 +184,9 @@ class GGEMS_EXPORT GGEMSVoxelizedSolid : public GGEMSSolid
   private:
     std::string volume_header_filename_; /*!< Filename of MHD file for phantom */
     std::string range_filename_; /*!< Filename of file for range data */
+    std::vector<GGfloat> range_bounds_; /*!< Sorted bounds of ranges, used during conversion to label */
+    std::vector<GGLabelType> bound_labels_; /*!< Label of value equal to a bound */
+    std::vector<GGLabelType> interval_labels_; /*!< Label of values between a bound and the next one */
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -166,93 +201,86 @@ void GGEMSVoxelizedSolid::ConvertImageToLabel(std::string const& raw_data_filena
   // Get the OpenCL manager
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
+  // Get pointer on OpenCL device, image is the same on all devices
+  GGEMSVoxelizedSolidData* solid_data_device = opencl_manager.GetDeviceBuffer<GGEMSVoxelizedSolidData>(solid_data_[0], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSVoxelizedSolidData), 0);
+
+  // Get information about mhd file
+  number_of_voxels_ = static_cast<GGsize>(solid_data_device->number_of_voxels_);
+
+  // Release the pointer
+  opencl_manager.ReleaseDeviceBuffer(solid_data_[0], solid_data_device, 0);
+
+  // Checking if file exists
+  std::ifstream in_raw_stream(raw_data_filename, std::ios::in | std::ios::binary);
+  GGEMSFileStream::CheckInputStream(in_raw_stream, raw_data_filename);
+
+  // Reading data to a tmp buffer, only once for all devices
+  std::vector<T> tmp_raw_data;
+  tmp_raw_data.resize(number_of_voxels_);
+  in_raw_stream.read(reinterpret_cast<char*>(&tmp_raw_data[0]), static_cast<std::streamsize>(number_of_voxels_ * sizeof(T)));
+
+  // Closing file
+  in_raw_stream.close();
+
+  // Reading ranges and adding materials
+  ReadRangeToLabel(range_data_filename, materials);
+
+  // For 8 and 16 bits data, label of each possible value is stored in a lookup table
+  std::vector<GGLabelType> label_lut;
+  if constexpr (sizeof(T) <= 2) {
+    GGint lowest_value = static_cast<GGint>(std::numeric_limits<T>::lowest());
+    GGint max_value = static_cast<GGint>(std::numeric_limits<T>::max());
+    label_lut.resize(static_cast<GGsize>(max_value - lowest_value + 1));
+    for (GGint v = lowest_value; v <= max_value; ++v) label_lut[static_cast<GGsize>(v - lowest_value)] = GetLabelOfValue(static_cast<GGfloat>(v));
+  }
+
+  // Converting voxels in parallel on host, each thread converts a contiguous part of image
+  std::vector<GGLabelType> label_data(number_of_voxels_);
+  GGsize number_of_threads = std::max(static_cast<GGsize>(std::thread::hardware_concurrency()), static_cast<GGsize>(1));
+  number_of_threads = std::min(number_of_threads, number_of_voxels_);
+  GGsize voxels_by_thread = (number_of_voxels_ + number_of_threads - 1) / number_of_threads;
+
+  std::vector<std::thread> thread_conversion;
+  for (GGsize t = 0; t < number_of_threads; ++t) {
+    GGsize first_voxel = t * voxels_by_thread;
+    GGsize last_voxel = std::min(first_voxel + voxels_by_thread, number_of_voxels_);
+    if (first_voxel >= last_voxel) break;
+    thread_conversion.push_back(std::thread(&GGEMSVoxelizedSolid::ConvertVoxelsToLabel<T>, this, tmp_raw_data.data(), label_data.data(), label_lut.empty() ? nullptr : label_lut.data(), first_voxel, last_voxel));
+  }
+  for (GGsize t = 0; t < thread_conversion.size(); ++t) thread_conversion[t].join();
+
+  tmp_raw_data.clear();
+  range_bounds_.clear();
+  bound_labels_.clear();
+  interval_labels_.clear();
+
+  // Checking if all voxels converted
+  if (std::find(label_data.begin(), label_data.end(), std::numeric_limits<GGLabelType>::max()) == label_data.end()) {
+    GGcout("GGEMSVoxelizedSolid", "ConvertImageToLabel", 2) << "All your voxels are converted to label..." << GGendl;
+  }
+  else {
+    GGEMSMisc::ThrowException("GGEMSVoxelizedSolid", "ConvertImageToLabel", "Errors(s) in the range data file!!!");
+  }
+
+  // Copying label data to all devices
   for (GGsize d = 0; d < number_activated_devices_; ++d) {
-    // Get pointer on OpenCL device
-    GGEMSVoxelizedSolidData* solid_data_device = opencl_manager.GetDeviceBuffer<GGEMSVoxelizedSolidData>(solid_data_[d], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSVoxelizedSolidData), d);
-
-    // Get information about mhd file
-    number_of_voxels_ = static_cast<GGsize>(solid_data_device->number_of_voxels_);
-
-    // Release the pointer
-    opencl_manager.ReleaseDeviceBuffer(solid_data_[d], solid_data_device, d);
-
-    // Checking if file exists
-    std::ifstream in_raw_stream(raw_data_filename, std::ios::in | std::ios::binary);
-    GGEMSFileStream::CheckInputStream(in_raw_stream, raw_data_filename);
-
-    // Reading data to a tmp buffer
-    std::vector<T> tmp_raw_data;
-    tmp_raw_data.resize(number_of_voxels_);
-    in_raw_stream.read(reinterpret_cast<char*>(&tmp_raw_data[0]), static_cast<std::streamsize>(number_of_voxels_ * sizeof(T)));
-
-    // Closing file
-    in_raw_stream.close();
-
-    // Allocating memory on OpenCL device
-    label_data_[d] = opencl_manager.Allocate(nullptr, number_of_voxels_ * sizeof(GGuchar), d, CL_MEM_READ_WRITE, "GGEMSVoxelizedSolid");
-
-    // Get pointer on OpenCL device
-    GGuchar* label_data_device = opencl_manager.GetDeviceBuffer<GGuchar>(label_data_[d], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, number_of_voxels_ * sizeof(GGuchar), d);
-
-    // Set value to max of GGuchar
-    std::fill(label_data_device, label_data_device + number_of_voxels_, std::numeric_limits<GGuchar>::max());
-
-    // Opening range data file
-    std::ifstream in_range_stream(range_data_filename, std::ios::in);
-    GGEMSFileStream::CheckInputStream(in_range_stream, range_data_filename);
-
-    // Values in the range file
-    GGfloat first_label_value = 0.0f;
-    GGfloat last_label_value = 0.0f;
-    GGuchar label_index = 0;
-    std::string material_name("");
-
-    // Reading range file
-    std::string line("");
-    while (std::getline(in_range_stream, line)) {
-      // Check if blank line
-      if (GGEMSTextReader::IsBlankLine(line)) continue;
-
-      // Getting the value in string stream
-      std::istringstream iss = GGEMSRangeReader::ReadRangeMaterial(line);
-      iss >> first_label_value >> last_label_value >> material_name;
-
-      // Adding the material only once
-      if (d == 0) materials->AddMaterial(material_name);
-
-      // Setting the label
-      for (GGsize i = 0; i < number_of_voxels_; ++i) {
-        // Getting the value of phantom
-        GGfloat value = static_cast<GGfloat>(tmp_raw_data[i]);
-        if (((value == first_label_value) && (value == last_label_value)) || ((value >= first_label_value) && (value < last_label_value))) {
-          label_data_device[i] = label_index;
-        }
-      }
-
-      // Increment the label index
-      ++label_index;
-    }
-
-    // Final loop checking if a value is still max of GGuchar
-    bool all_converted = true;
-    for (GGsize i = 0; i < number_of_voxels_; ++i) {
-      if (label_data_device[i] == std::numeric_limits<GGuchar>::max()) all_converted = false;
-    }
-
-    // Closing file
-    in_range_stream.close();
-    tmp_raw_data.clear();
-
-    // Release the pointer
-    opencl_manager.ReleaseDeviceBuffer(label_data_[d], label_data_device, d);
-
-    // Checking if all voxels converted
-    if (all_converted) {
-      GGcout("GGEMSVoxelizedSolid", "ConvertImageToLabel", 2) << "All your voxels are converted to label..." << GGendl;
-    }
-    else {
-      GGEMSMisc::ThrowException("GGEMSVoxelizedSolid", "ConvertImageToLabel", "Errors(s) in the range data file!!!");
-    }
+    label_data_[d] = opencl_manager.Allocate(label_data.data(), number_of_voxels_ * sizeof(GGLabelType), d, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, "GGEMSVoxelizedSolid");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+void GGEMSVoxelizedSolid::ConvertVoxelsToLabel(T const* raw_data, GGLabelType* label_data, GGLabelType const* label_lut, GGsize const first_voxel, GGsize const last_voxel) const
+{
+  if (label_lut) {
+    GGint lowest_value = static_cast<GGint>(std::numeric_limits<T>::lowest());
+    for (GGsize i = first_voxel; i < last_voxel; ++i) label_data[i] = label_lut[static_cast<GGsize>(static_cast<GGint>(raw_data[i]) - lowest_value)];
+  }
+  else {
+    for (GGsize i = first_voxel; i < last_voxel; ++i) label_data[i] = GetLabelOfValue(static_cast<GGfloat>(raw_data[i]));
   }
 }
 
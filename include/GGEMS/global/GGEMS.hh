@@ -193,6 +193,49 @@ class GGEMS_EXPORT GGEMS
     */
     inline GGint GetParticleTrackingID(void) const {return particle_tracking_id_;}
 
+    /*!
+      \fn void SetPipelinedRun(bool const& is_pipelined_run)
+      \param is_pipelined_run - flag for pipelined run
+      \brief activate the pipelined run, primaries of the next batch are generated in a second particle stack while the current batch is transported
+    */
+    void SetPipelinedRun(bool const& is_pipelined_run);
+
+    /*!
+      \fn bool IsPipelinedRun(void) const
+      \return state of pipelined run flag
+      \brief get the pipelined run flag
+    */
+    inline bool IsPipelinedRun(void) const {return is_pipelined_run_;}
+
+    /*!
+      \fn void SetLivenessCheck(GGint const& liveness_check_period, bool const& is_speculative_liveness_check)
+      \param liveness_check_period - alive particles are checked every liveness_check_period transport iterations
+      \param is_speculative_liveness_check - if true, the next transport iteration is launched before reading the result of the check
+      \brief set the policy checking alive particles during transport
+    */
+    void SetLivenessCheck(GGint const& liveness_check_period, bool const& is_speculative_liveness_check);
+
+    /*!
+      \fn void SetDynamicBatchScheduling(bool const& is_dynamic_batch_scheduling)
+      \param is_dynamic_batch_scheduling - flag for dynamic scheduling of batchs
+      \brief activate the dynamic scheduling of batchs, each device pulls the next batch from a shared pool as soon as it is free
+    */
+    void SetDynamicBatchScheduling(bool const& is_dynamic_batch_scheduling);
+
+    /*!
+      \fn void SetPersistentTransport(bool const& is_persistent_transport)
+      \param is_persistent_transport - flag for persistent transport kernel
+      \brief activate the transport of each batch by a single persistent kernel, instead of one kernel launch by navigation step and solid
+    */
+    void SetPersistentTransport(bool const& is_persistent_transport);
+
+    /*!
+      \fn void SetAliveCompaction(bool const& is_alive_compaction)
+      \param is_alive_compaction - flag for compaction of alive particles
+      \brief activate the compaction of alive particles at each check, transport kernels are then launched only over alive particles
+    */
+    void SetAliveCompaction(bool const& is_alive_compaction);
+
   private:
     /*!
       \fn void PrintBanner(void) const
@@ -219,6 +262,16 @@ class GGEMS_EXPORT GGEMS
     bool is_tracking_verbose_; /*!< Flag for tracking verbosity */
     bool is_profiling_verbose_; /*!< Flag for kernel time verbosity */
     GGint particle_tracking_id_; /*!< Particle if for tracking */
+    bool is_pipelined_run_; /*!< Flag for pipelined run using two particle stacks by device */
+    GGint liveness_check_period_; /*!< Number of transport iterations between two checks of alive particles */
+    bool is_speculative_liveness_check_; /*!< Flag for speculative check of alive particles */
+    bool is_dynamic_batch_scheduling_; /*!< Flag for dynamic scheduling of batchs between devices */
+    bool is_persistent_transport_; /*!< Flag for transport using a persistent kernel */
+    bool is_alive_compaction_; /*!< Flag for compaction of alive particles */
+    std::vector<GGsize> number_of_simulated_particles_; /*!< Number of simulated particles by device */
+    std::vector<GGdouble> elapsed_time_by_device_; /*!< Elapsed time by device in s */
+    std::vector<GGsize> number_of_pipelined_batchs_; /*!< Number of batchs generated during the transport of a previous batch by device, pipelined run */
+    std::vector<GGsize> number_of_overlapped_batchs_; /*!< Number of batchs whose primaries are ready at the end of the transport of the previous batch by device, pipelined run */
 };
 
 /*!
@@ -324,6 +377,47 @@ extern "C" GGEMS_EXPORT void set_profiling_ggems(GGEMS* ggems, bool const is_pro
 */
 extern "C" GGEMS_EXPORT void set_tracking_ggems(GGEMS* ggems, bool const is_tracking_verbose, GGint const particle_id_tracking);
 
+/*!
+  \fn void set_pipelined_run_ggems(GGEMS* ggems, bool const is_pipelined_run)
+  \param ggems - pointer to GGEMS
+  \param is_pipelined_run - flag on pipelined run
+  \brief Activate the pipelined run
+*/
+extern "C" GGEMS_EXPORT void set_pipelined_run_ggems(GGEMS* ggems, bool const is_pipelined_run);
+
+/*!
+  \fn void set_liveness_check_ggems(GGEMS* ggems, GGint const liveness_check_period, bool const is_speculative_liveness_check)
+  \param ggems - pointer to GGEMS
+  \param liveness_check_period - number of transport iterations between two checks of alive particles
+  \param is_speculative_liveness_check - flag on speculative check
+  \brief Set the policy checking alive particles
+*/
+extern "C" GGEMS_EXPORT void set_liveness_check_ggems(GGEMS* ggems, GGint const liveness_check_period, bool const is_speculative_liveness_check);
+
+/*!
+  \fn void set_dynamic_batch_scheduling_ggems(GGEMS* ggems, bool const is_dynamic_batch_scheduling)
+  \param ggems - pointer on ggems
+  \param is_dynamic_batch_scheduling - flag on dynamic scheduling of batchs
+  \brief Activate the dynamic scheduling of batchs between devices
+*/
+extern "C" GGEMS_EXPORT void set_dynamic_batch_scheduling_ggems(GGEMS* ggems, bool const is_dynamic_batch_scheduling);
+
+/*!
+  \fn void set_persistent_transport_ggems(GGEMS* ggems, bool const is_persistent_transport)
+  \param ggems - pointer on ggems
+  \param is_persistent_transport - flag on persistent transport kernel
+  \brief Activate the transport of particles by a persistent kernel
+*/
+extern "C" GGEMS_EXPORT void set_persistent_transport_ggems(GGEMS* ggems, bool const is_persistent_transport);
+
+/*!
+  \fn void set_alive_compaction_ggems(GGEMS* ggems, bool const is_alive_compaction)
+  \param ggems - pointer on ggems
+  \param is_alive_compaction - flag on compaction of alive particles
+  \brief Activate the compaction of alive particles
+*/
+extern "C" GGEMS_EXPORT void set_alive_compaction_ggems(GGEMS* ggems, bool const is_alive_compaction);
+
 /*!
   \fn void run_ggems(GGEMS* ggems)
   \param ggems - pointer to GGEMS
@@ -32,6 +32,10 @@
 */
 
 #include <unordered_map>
+#include <unordered_set>
+#include <filesystem>
+#include <sstream>
+
 #include "GGEMS/tools/GGEMSPrint.hh"
 
 #ifdef _MSC_VER
@@ -45,6 +49,8 @@
 typedef std::unordered_map<std::string, std::string> VendorUMap; /*!< Alias to OpenCL vendors */
 
 #define KERNEL_NOT_COMPILED 0x100000000 /*!< value if OpenCL kernel is not compiled */
+#define KERNEL_CACHE_MAXIMUM_SIZE 536870912 /*!< Maximum size in bytes of the cache of OpenCL program binaries, 512 MB */
+#define KERNEL_CACHE_MAGIC "GGEMS_KERNEL_CACHE_1" /*!< Header of a program binary in cache, changed if file format changes */
 
 /*!
   \struct ComputingDevice_t
@@ -55,6 +61,7 @@ typedef struct ComputingDevice_t
   GGsize index_; /*!< Index of computing device */
   cl::Context* context_; /*!< Context associated to computing device */
   cl::CommandQueue* queue_; /*!< Queue associated to computing device */
+  cl::CommandQueue* source_queue_; /*!< Second queue associated to computing device, generating primaries while queue_ is transporting particles */
 
   /*!
     \fn void Clean(void)
@@ -71,6 +78,11 @@ typedef struct ComputingDevice_t
       delete queue_;
       queue_ = nullptr;
     }
+
+    if (source_queue_) {
+      delete source_queue_;
+      source_queue_ = nullptr;
+    }
   }
 } ComputingDevice; /*!< Using C convention name of struct to C++ (_t deletion) */
 
@@ -171,6 +183,13 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     void AddBuildOption(std::string const& option);
 
+    /*!
+      \fn void SetKernelCachePath(std::string const& kernel_cache_path)
+      \param kernel_cache_path - directory storing OpenCL program binaries, empty string to disable the cache
+      \brief set the directory of the on-disk cache of OpenCL program binaries
+    */
+    void SetKernelCachePath(std::string const& kernel_cache_path);
+
     /*!
       \fn std::string GetDeviceName(GGsize const& device_index) const
       \param device_index - index of device
@@ -217,6 +236,14 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     inline GGsize GetRAMMemory(GGsize const& device_index) const {return static_cast<GGsize>(device_global_mem_size_[device_index]);}
 
+    /*!
+      \fn inline GGsize GetMaxParameterSize(GGsize const& device_index) const
+      \param device_index - index of activated devices
+      \return Max size of kernel arguments
+      \brief Get the max size in bytes of all arguments of a kernel on OpenCL device
+    */
+    inline GGsize GetMaxParameterSize(GGsize const& device_index) const {return device_max_parameter_size_[device_index];}
+
     /*!
       \fn inline GGsize GetWorkGroupSize(void) const
       \return Work group size
@@ -256,6 +283,14 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     inline cl::CommandQueue* GetCommandQueue(GGsize const& thread_index) const {return computing_devices_[thread_index].queue_;}
 
+    /*!
+      \fn cl::CommandQueue* GetSourceCommandQueue(GGsize const& thread_index) const
+      \param thread_index - index of the thread (= activated device index)
+      \return the pointer on the source command queue
+      \brief Return the command queue used to generate primaries in pipelined mode
+    */
+    inline cl::CommandQueue* GetSourceCommandQueue(GGsize const& thread_index) const {return computing_devices_[thread_index].source_queue_;}
+
     /*!
       \fn void DeviceToActivate(GGsize const& device_id)
       \param device_id - device index
@@ -293,6 +328,29 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     inline GGsize GetNumberDeviceBalancing(void) const {return device_balancing_.size();}
 
+    /*!
+      \fn void SetParticleStackSize(std::string const& particle_stack_size)
+      \param particle_stack_size - number of particles in particle stack: 'auto', a value for all activated devices, or a value by activated device separated by ';'
+      \brief set the number of particles in particle stacks, by default stacks are sized from memory of each device
+    */
+    void SetParticleStackSize(std::string const& particle_stack_size);
+
+    /*!
+      \fn void SetParticleStackSize(GGsize const& thread_index, GGsize const& particle_stack_size)
+      \param thread_index - index of the thread (= activated device index)
+      \param particle_stack_size - number of particles in particle stack
+      \brief set the number of particles in particle stacks of an activated device, rounded up to a multiple of work group size
+    */
+    void SetParticleStackSize(GGsize const& thread_index, GGsize const& particle_stack_size);
+
+    /*!
+      \fn inline GGsize GetParticleStackSize(GGsize const& thread_index) const
+      \param thread_index - index of the thread (= activated device index)
+      \return number of particles in particle stacks of device, 0 if not set yet
+      \brief get the number of particles in particle stacks of an activated device
+    */
+    inline GGsize GetParticleStackSize(GGsize const& thread_index) const {return particle_stack_size_[thread_index];}
+
     /*!
       \fn inline bool IsReady(void) const
       \return true is OpenCL manager is ready to use, it means a device is activated
@@ -317,6 +375,17 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     void CompileKernel(std::string const& kernel_filename, std::string const& kernel_name, cl::Kernel** kernel_list, char* const custom_options = nullptr, char* const additional_options = nullptr);
 
+    /*!
+      \fn void CompileKernelFromSource(std::string const& source_code, std::string const& kernel_name, cl::Kernel** kernel_list, char* const custom_options = nullptr, char* const additional_options = nullptr)
+      \param source_code - source code of the kernel, generated by GGEMS
+      \param kernel_name - name of the kernel
+      \param kernel_list - list of kernel by device
+      \param custom_options - new compilation option for the kernel
+      \param additional_options - additionnal compilation option
+      \brief Compile an OpenCL kernel from source code on the activated device
+    */
+    void CompileKernelFromSource(std::string const& source_code, std::string const& kernel_name, cl::Kernel** kernel_list, char* const custom_options = nullptr, char* const additional_options = nullptr);
+
     /*!
       \return the pointer on host memory on write/read mode
       \brief Get the device pointer on host to write on it. ReleaseDeviceBuffer must be used after this method!!!
@@ -325,10 +394,11 @@ class GGEMS_EXPORT GGEMSOpenCLManager
       \param map_flags - Is a bit-field and can be set to CL_MAP_READ and/or CL_MAP_WRITE
       \param size - size of region to map
       \param thread_index - index of the thread (= activated device index)
+      \param offset - offset in bytes of region to map
       \tparam T - type of the returned pointer on host memory
     */
     template <typename T>
-    T* GetDeviceBuffer(cl::Buffer* device_ptr, GGbool const& blocking, cl_map_flags const& map_flags, GGsize const& size, GGsize const& thread_index);
+    T* GetDeviceBuffer(cl::Buffer* device_ptr, GGbool const& blocking, cl_map_flags const& map_flags, GGsize const& size, GGsize const& thread_index, GGsize const& offset = 0);
 
     /*!
       \brief Get the device pointer on host to write on it. Mandatory after a GetDeviceBufferWrite ou GetDeviceBufferRead!!!
@@ -404,6 +474,67 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     void DisableCudaKernelCache(void) const;
 
+    /*!
+      \fn void InitKernelCache(void)
+      \brief Set the default directory of the cache of OpenCL program binaries, GGEMS_KERNEL_CACHE_PATH environment variable or user cache directory
+    */
+    void InitKernelCache(void);
+
+    /*!
+      \fn static void ExpandKernelIncludes(std::string const& source_code, std::filesystem::path const& current_directory, std::vector<std::filesystem::path> const& include_paths, std::unordered_set<std::string>& visited_files, std::ostringstream& expanded_source)
+      \param source_code - source code to expand
+      \param current_directory - directory of the file storing source code, empty for kernel source
+      \param include_paths - include paths from compilation options
+      \param visited_files - files already expanded
+      \param expanded_source - source code with content of included files
+      \brief expand recursively include directives, each file is expanded once
+    */
+    static void ExpandKernelIncludes(std::string const& source_code, std::filesystem::path const& current_directory, std::vector<std::filesystem::path> const& include_paths, std::unordered_set<std::string>& visited_files, std::ostringstream& expanded_source);
+
+    /*!
+      \fn std::string PreprocessKernelSource(std::string const& source_code, std::string const& compilation_options) const
+      \param source_code - source code of the kernel
+      \param compilation_options - arguments of compilation, storing include paths
+      \return source code with the content of all included files
+      \brief expand the include directives of kernel source code, header modifications invalidate the cache
+    */
+    std::string PreprocessKernelSource(std::string const& source_code, std::string const& compilation_options) const;
+
+    /*!
+      \fn std::string GetKernelCacheKey(std::string const& preprocessed_source, std::string const& compilation_options, GGsize const& device_index) const
+      \param preprocessed_source - source code with the content of included files
+      \param compilation_options - arguments of compilation
+      \param device_index - index of the device
+      \return key identifying a program binary in the cache
+      \brief get the key of a program binary, built from source, options, device name and driver version
+    */
+    std::string GetKernelCacheKey(std::string const& preprocessed_source, std::string const& compilation_options, GGsize const& device_index) const;
+
+    /*!
+      \fn bool LoadKernelBinary(std::string const& cache_key, GGsize const& thread_index, char const* compilation_options, cl::Program& program) const
+      \param cache_key - key of the program binary
+      \param thread_index - index of activated device (thread index)
+      \param compilation_options - arguments of compilation
+      \param program - OpenCL program built from the binary
+      \return true if the program is built from the cache, otherwize false
+      \brief load and build a program binary from the cache, invalid entries are removed from the cache
+    */
+    bool LoadKernelBinary(std::string const& cache_key, GGsize const& thread_index, char const* compilation_options, cl::Program& program) const;
+
+    /*!
+      \fn void SaveKernelBinary(std::string const& cache_key, cl::Program const& program)
+      \param cache_key - key of the program binary
+      \param program - built OpenCL program
+      \brief store the binary of a built program in the cache
+    */
+    void SaveKernelBinary(std::string const& cache_key, cl::Program const& program);
+
+    /*!
+      \fn void EvictKernelCache(void) const
+      \brief remove the least recently used program binaries if the cache is bigger than KERNEL_CACHE_MAXIMUM_SIZE
+    */
+    void EvictKernelCache(void) const;
+
     /*!
       \fn void SetOpenCLCompilationOptions(void)
       \brief Setting compilation options for OpenCL kernel
@@ -421,12 +552,21 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     /*!
       \fn std::GGsize CheckKernel(std::string const& kernel_name, std::string const& compilation_options) const
       \param kernel_name - name of the kernel
-      \param compilation_options - arguments of compilation
+      \param compilation_options - arguments of compilation for the first activated device
       \brief check if a kernel has been already compiled
       \return index of kernel if already compiled
     */
     GGsize CheckKernel(std::string const& kernel_name, std::string const& compilation_options) const;
 
+    /*!
+      \fn std::string GetDeviceCompilationOptions(char const* compilation_options, GGsize const& thread_index) const
+      \param compilation_options - arguments of compilation
+      \param thread_index - index of the thread (= activated device index)
+      \return arguments of compilation for the device
+      \brief add the size of particle stack of device to arguments of compilation
+    */
+    std::string GetDeviceCompilationOptions(char const* compilation_options, GGsize const& thread_index) const;
+
     /*!
       \fn bool IsDoublePrecision(GGsize const& device_index) const
       \param device_index - index of the device
@@ -526,6 +666,7 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     std::vector<GGuint> device_partition_max_sub_devices_; /*!< Partition affinity domain */
     std::vector<GGsize> device_profiling_timer_resolution_; /*!< Timer resolution */
     std::vector<GGfloat> device_balancing_; /*!< Device balancing */
+    std::vector<GGsize> particle_stack_size_; /*!< Number of particles in particle stacks of each activated device, 0 for automatic size */
 
     // Custom OpenCL members
     GGsize work_group_size_; /*!< Work group size by GGEMS, here 64 */
@@ -533,6 +674,7 @@ class GGEMS_EXPORT GGEMSOpenCLManager
 
     // OpenCL compilation options
     std::string build_options_; /*!< list of default option to OpenCL compiler */
+    std::string kernel_cache_path_; /*!< Directory of the cache of OpenCL program binaries, empty if cache is disabled */
 
     // ComputingDevice storing context, queue, and index
     std::vector<ComputingDevice> computing_devices_; /*!< vector storing index, context and queue of an OpenCL computing device */
@@ -547,7 +689,7 @@ class GGEMS_EXPORT GGEMSOpenCLManager
 ////////////////////////////////////////////////////////////////////////////////
 
 template <typename T>
-T* GGEMSOpenCLManager::GetDeviceBuffer(cl::Buffer* const device_ptr, GGbool const& blocking, cl_map_flags const& map_flags, GGsize const& size, GGsize const& thread_index)
+T* GGEMSOpenCLManager::GetDeviceBuffer(cl::Buffer* const device_ptr, GGbool const& blocking, cl_map_flags const& map_flags, GGsize const& size, GGsize const& thread_index, GGsize const& offset)
 {
   GGcout("GGEMSOpenCLManager", "GetDeviceBuffer", 4) << "Getting mapped memory buffer on OpenCL device..." << GGendl;
 
@@ -555,7 +697,7 @@ T* GGEMSOpenCLManager::GetDeviceBuffer(cl::Buffer* const device_ptr, GGbool cons
   GGint err = 0;
   cl::Event event;
 
-  T* ptr = static_cast<T*>(computing_devices_[thread_index].queue_->enqueueMapBuffer(*device_ptr, blocking, map_flags, 0, size, nullptr, &event, &err));
+  T* ptr = static_cast<T*>(computing_devices_[thread_index].queue_->enqueueMapBuffer(*device_ptr, blocking, map_flags, offset, size, nullptr, &event, &err));
   CheckOpenCLError(err, "GGEMSOpenCLManager", "GetDeviceBuffer");
 
   // Checking event status
@@ -631,4 +773,20 @@ extern "C" GGEMS_EXPORT void clean_opencl_manager(GGEMSOpenCLManager* opencl_man
 */
 extern "C" GGEMS_EXPORT void set_device_balancing_opencl_manager(GGEMSOpenCLManager* opencl_manager, char const* device_balancing);
 
+/*!
+  \fn void set_kernel_cache_path_opencl_manager(GGEMSOpenCLManager* opencl_manager, char const* kernel_cache_path)
+  \param opencl_manager - pointer on the singleton
+  \param kernel_cache_path - directory storing OpenCL program binaries, empty string to disable the cache
+  \brief set the directory of the cache of OpenCL program binaries
+*/
+extern "C" GGEMS_EXPORT void set_kernel_cache_path_opencl_manager(GGEMSOpenCLManager* opencl_manager, char const* kernel_cache_path);
+
+/*!
+  \fn void set_particle_stack_size_opencl_manager(GGEMSOpenCLManager* opencl_manager, char const* particle_stack_size)
+  \param opencl_manager - pointer on the singleton
+  \param particle_stack_size - number of particles in particle stack: 'auto', a value for all devices, or a value by device separated by ';'
+  \brief set the number of particles in particle stacks
+*/
+extern "C" GGEMS_EXPORT void set_particle_stack_size_opencl_manager(GGEMSOpenCLManager* opencl_manager, char const* particle_stack_size);
+
 #endif // GUARD_GGEMS_GLOBAL_GGEMSOPENCLMANAGER_HH
@@ -216,7 +216,7 @@ class GGEMS_EXPORT GGEMSOpenGLVolume
     GLfloat update_angle_z_; /*!< Angle after translation, volume rotate around isocenter */
 
     MaterialRGBColorUMap material_rgb_; /*!< Color of material */
-    GGuchar* label_; /*!< Label for material */
+    GGLabelType* label_; /*!< Label for material */
     std::vector<std::string> material_names_; /*!< Name of material */
     MaterialVisibleUMap material_visible_; /*!< Visibily of material */
 
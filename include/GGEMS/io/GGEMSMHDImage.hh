@@ -118,6 +118,15 @@ class GGEMS_EXPORT GGEMSMHDImage
     template<typename T>
     void Write(T* image);
 
+    /*!
+      \fn void WriteDosimetry(GGDosiType* image, GGdouble const& fixed_point_scale, bool const& is_positive)
+      \param image - dosimetry tally to write on output file
+      \param fixed_point_scale - fixed-point units by unit of tally
+      \param is_positive - true if tally can not be negative (energy, squared energy), a negative value is an overflow
+      \brief write a dosimetry tally, fixed-point values are converted in double in reproducible mode, a warning is printed if tally is saturated
+    */
+    void WriteDosimetry(GGDosiType* image, GGdouble const& fixed_point_scale, bool const& is_positive);
+
     /*!
       \fn void SetElementSizes(GGfloat3 const& element_sizes)
       \param element_sizes - size of elements in X, Y, Z
@@ -36,7 +36,7 @@
 
 /*!
   \struct GGEMSMaterialTables_t
-  \brief Structure storing the material tables on OpenCL device
+  \brief Header of the material tables on OpenCL device, the tables are stored after the header in the same buffer and sized to the number of materials. Each table member stores the offset in bytes of the table, read with GGEMS_TABLE
 */
 typedef struct GGEMSMaterialTables_t
 {
@@ -44,36 +44,36 @@ typedef struct GGEMSMaterialTables_t
   GGsize number_of_materials_; /*!< Number of the materials */
   GGsize total_number_of_chemical_elements_; /*!< Total number of chemical elements */
 
-  // Infos by materials
-  GGsize number_of_chemical_elements_[255]; /*!< Number of chemical elements in a single material */
-  GGfloat density_of_material_[255]; /*!< Density of material in g/cm3 */
-  GGfloat number_of_atoms_by_volume_[255]; /*!< Number of atoms by volume */
-  GGfloat number_of_electrons_by_volume_[255]; /*!< Number of electrons by volume */
-  GGfloat mean_excitation_energy_[255]; /*!< Mean of excitation energy */
-  GGfloat log_mean_excitation_energy_[255]; /*!< Log of mean of excitation energy */
-  GGfloat radiation_length_[255]; /*!< Radiation length */
-  GGfloat x0_density_[255]; /*!< x0 density correction */
-  GGfloat x1_density_[255]; /*!< x1 density correction */
-  GGfloat d0_density_[255]; /*!< d0 density correction */
-  GGfloat c_density_[255]; /*!< c density correction */
-  GGfloat a_density_[255]; /*!< a density correction */
-  GGfloat m_density_[255]; /*!< m density correction */
-  GGfloat f1_fluct_[255]; /*!< f1 energy loss fluctuation model */
-  GGfloat f2_fluct_[255]; /*!< f2 energy loss fluctuation model */
-  GGfloat energy0_fluct_[255]; /*!< energy 0 energy loss fluctuation model */
-  GGfloat energy1_fluct_[255]; /*!< energy 1 energy loss fluctuation model */
-  GGfloat energy2_fluct_[255]; /*!< energy 2 energy loss fluctuation model */
-  GGfloat log_energy1_fluct_[255]; /*!< log of energy 0 energy loss fluctuation model */
-  GGfloat log_energy2_fluct_[255]; /*!< log of energy 1 energy loss fluctuation model */
-  GGfloat photon_energy_cut_[255]; /*!< Photon energy cut */
-  GGfloat electron_energy_cut_[255]; /*!< Electron energy cut */
-  GGfloat positron_energy_cut_[255]; /*!< Positron energy cut */
+  // Infos by materials, tables of number_of_materials_ values
+  GGsize number_of_chemical_elements_; /*!< Offset of table (GGsize) - Number of chemical elements in a single material */
+  GGsize density_of_material_; /*!< Offset of table (GGfloat) - Density of material in g/cm3 */
+  GGsize number_of_atoms_by_volume_; /*!< Offset of table (GGfloat) - Number of atoms by volume */
+  GGsize number_of_electrons_by_volume_; /*!< Offset of table (GGfloat) - Number of electrons by volume */
+  GGsize mean_excitation_energy_; /*!< Offset of table (GGfloat) - Mean of excitation energy */
+  GGsize log_mean_excitation_energy_; /*!< Offset of table (GGfloat) - Log of mean of excitation energy */
+  GGsize radiation_length_; /*!< Offset of table (GGfloat) - Radiation length */
+  GGsize x0_density_; /*!< Offset of table (GGfloat) - x0 density correction */
+  GGsize x1_density_; /*!< Offset of table (GGfloat) - x1 density correction */
+  GGsize d0_density_; /*!< Offset of table (GGfloat) - d0 density correction */
+  GGsize c_density_; /*!< Offset of table (GGfloat) - c density correction */
+  GGsize a_density_; /*!< Offset of table (GGfloat) - a density correction */
+  GGsize m_density_; /*!< Offset of table (GGfloat) - m density correction */
+  GGsize f1_fluct_; /*!< Offset of table (GGfloat) - f1 energy loss fluctuation model */
+  GGsize f2_fluct_; /*!< Offset of table (GGfloat) - f2 energy loss fluctuation model */
+  GGsize energy0_fluct_; /*!< Offset of table (GGfloat) - energy 0 energy loss fluctuation model */
+  GGsize energy1_fluct_; /*!< Offset of table (GGfloat) - energy 1 energy loss fluctuation model */
+  GGsize energy2_fluct_; /*!< Offset of table (GGfloat) - energy 2 energy loss fluctuation model */
+  GGsize log_energy1_fluct_; /*!< Offset of table (GGfloat) - log of energy 0 energy loss fluctuation model */
+  GGsize log_energy2_fluct_; /*!< Offset of table (GGfloat) - log of energy 1 energy loss fluctuation model */
+  GGsize photon_energy_cut_; /*!< Offset of table (GGfloat) - Photon energy cut */
+  GGsize electron_energy_cut_; /*!< Offset of table (GGfloat) - Electron energy cut */
+  GGsize positron_energy_cut_; /*!< Offset of table (GGfloat) - Positron energy cut */
+  GGsize index_of_chemical_elements_; /*!< Offset of table (GGsize) - Index to chemical element by material */
 
-  // Infos by chemical elements by materials
-  GGsize index_of_chemical_elements_[255]; /*!< Index to chemical element by material */
-  GGuchar atomic_number_Z_[255*32]; /*!< Atomic number Z by chemical elements */
-  GGfloat atomic_number_density_[255*32]; /*!< Atomic number density : fraction of element in material * density * Avogadro / Atomic mass */
-  GGfloat mass_fraction_[255*32]; /*!< Mass fraction of element in material */
+  // Infos by chemical elements by materials, tables of total_number_of_chemical_elements_ values
+  GGsize atomic_number_Z_; /*!< Offset of table (GGuchar) - Atomic number Z by chemical elements */
+  GGsize atomic_number_density_; /*!< Offset of table (GGfloat) - Atomic number density : fraction of element in material * density * Avogadro / Atomic mass */
+  GGsize mass_fraction_; /*!< Offset of table (GGfloat) - Mass fraction of element in material */
 } GGEMSMaterialTables; /*!< Using C convention name of struct to C++ (_t deletion) */
 
 #endif // GUARD_GGEMS_MATERIALS_GGEMSMATERIALSTABLE_HH
@@ -155,6 +155,20 @@ class GGEMS_EXPORT GGEMSMaterials
     */
     inline GGsize GetNumberOfMaterials(void) const {return materials_.size();}
 
+    /*!
+      \fn GGsize GetTotalNumberOfChemicalElements(void) const
+      \return the total number of chemical elements in the materials
+      \brief Get the sum of the number of chemical elements of each material
+    */
+    GGsize GetTotalNumberOfChemicalElements(void) const;
+
+    /*!
+      \fn std::string GetPhysicTablesCacheKey(void) const
+      \return description of the composition of all materials
+      \brief get the composition of materials, part of the key of physic tables in cache
+    */
+    std::string GetPhysicTablesCacheKey(void) const;
+
     /*!
       \fn inline cl::Buffer* GetMaterialTables(GGsize const& thread_index) const
       \param thread_index - index of activated device (thread index)
@@ -163,6 +177,27 @@ class GGEMS_EXPORT GGEMSMaterials
     */
     inline cl::Buffer* GetMaterialTables(GGsize const& thread_index) const {return material_tables_[thread_index];}
 
+    /*!
+      \fn inline GGsize GetMaterialTablesSize(void) const
+      \return the size in bytes of material tables
+      \brief get the size in bytes of material tables, header included
+    */
+    inline GGsize GetMaterialTablesSize(void) const {return material_tables_size_;}
+
+    /*!
+      \fn inline GGEMSMaterialTables* GetMaterialTablesHost(void)
+      \return pointer to material tables on host
+      \brief return the pointer to material tables on host, built once and copied to each OpenCL device
+    */
+    inline GGEMSMaterialTables* GetMaterialTablesHost(void) {return reinterpret_cast<GGEMSMaterialTables*>(material_tables_host_.data());}
+
+    /*!
+      \fn inline GGEMSMaterialTables const* GetMaterialTablesHost(void) const
+      \return pointer to material tables on host
+      \brief return the pointer to material tables on host, built once and copied to each OpenCL device
+    */
+    inline GGEMSMaterialTables const* GetMaterialTablesHost(void) const {return reinterpret_cast<GGEMSMaterialTables const*>(material_tables_host_.data());}
+
     /*!
       \fn inline GGEMSRangeCuts* GetRangeCuts(void) const
       \brief get the pointer on range cuts
@@ -204,9 +239,17 @@ class GGEMS_EXPORT GGEMSMaterials
     */
     void BuildMaterialTables(void);
 
+    /*!
+      \fn void CopyMaterialTablesToDevices(void)
+      \brief Copy material tables from host to each OpenCL device
+    */
+    void CopyMaterialTablesToDevices(void);
+
   private:
     std::vector<std::string> materials_; /*!< Defined material for a phantom */
     cl::Buffer** material_tables_; /*!< Material tables on OpenCL device */
+    GGsize material_tables_size_; /*!< Size in bytes of material tables, sized to the number of materials */
+    std::vector<GGuchar> material_tables_host_; /*!< Material tables on host (RAM memory) */
     GGsize number_activated_devices_; /*!< Number of activated device */
     GGEMSRangeCuts* range_cuts_; /*!< Cut for particles */
 };
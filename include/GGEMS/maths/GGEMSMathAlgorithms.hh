@@ -73,6 +73,30 @@ inline GGint BinarySearchLeft(GGfloat const key, GGfloat const* array, GGint con
   return min;
 }
 
+/*!
+  \fn inline GGint LogEnergyIndex(GGfloat const energy, GGfloat const log_min_energy, GGfloat const inverse_log_energy_step, GGint const number_of_bins)
+  \param energy - energy to find in table
+  \param log_min_energy - log of first energy bin
+  \param inverse_log_energy_step - inverse of log step between two energy bins
+  \param number_of_bins - number of energy bins
+  \return index of energy bin on the left of energy, same as BinarySearchLeft on log-spaced bins
+  \brief Compute directly the index of energy in a log-spaced energy table
+*/
+inline GGint LogEnergyIndex(GGfloat const energy, GGfloat const log_min_energy, GGfloat const inverse_log_energy_step, GGint const number_of_bins)
+{
+  #ifdef __OPENCL_C_VERSION__
+  GGint index = (GGint)floor((log(energy) - log_min_energy) * inverse_log_energy_step);
+  #else
+  GGint index = static_cast<GGint>(std::floor((std::log(energy) - log_min_energy) * inverse_log_energy_step));
+  #endif
+
+  // Last bin is never returned, energy is always between 2 bins
+  if (index < 0) return 0;
+  if (index > number_of_bins - 2) return number_of_bins - 2;
+
+  return index;
+}
+
 /*!
   \fn inline GGfloat LinearInterpolation(GGfloat xa, GGfloat ya, GGfloat xb, GGfloat yb, GGfloat x)
   \param xa - Coordinate x of point A
@@ -107,6 +107,66 @@ class GGEMS_EXPORT GGEMSCTSystem : public GGEMSSystem
     */
     void SetSourceDetectorDistance(GGfloat const& source_detector_distance, std::string const& unit = "mm");
 
+    /*!
+      \fn void ParticleSolidDistance(GGsize const& thread_index) override
+      \param thread_index - index of activated device (thread index)
+      \brief Compute distance between particles and modules of CT system in a single kernel
+    */
+    void ParticleSolidDistance(GGsize const& thread_index) override;
+
+    /*!
+      \fn void ProjectToSolid(GGsize const& thread_index) override
+      \param thread_index - index of activated device (thread index)
+      \brief Project particles to selected module of CT system in a single kernel
+    */
+    void ProjectToSolid(GGsize const& thread_index) override;
+
+    /*!
+      \fn void TrackThroughSolid(GGsize const& thread_index) override
+      \param thread_index - index of activated device (thread index)
+      \brief Track particles through selected module of CT system in a single kernel
+    */
+    void TrackThroughSolid(GGsize const& thread_index) override;
+
+    /*!
+      \fn std::string GetTransportKernelParameters(GGsize& parameter_size) const override
+      \param parameter_size - size in bytes of parameters, incremented by size of CT system parameters
+      \return declaration of CT system parameters for persistent transport kernel
+      \brief get parameters of CT system for persistent transport kernel
+    */
+    std::string GetTransportKernelParameters(GGsize& parameter_size) const override;
+
+    /*!
+      \fn std::string GetTransportKernelParticleSolidDistance(void) const override
+      \return call computing distance between particles and modules
+      \brief get particle solid distance step of CT system for persistent transport kernel
+    */
+    std::string GetTransportKernelParticleSolidDistance(void) const override;
+
+    /*!
+      \fn std::string GetTransportKernelProjectToSolid(void) const override
+      \return call projecting particles to modules
+      \brief get project to solid step of CT system for persistent transport kernel
+    */
+    std::string GetTransportKernelProjectToSolid(void) const override;
+
+    /*!
+      \fn std::string GetTransportKernelTrackThroughSolid(void) const override
+      \return call tracking particles through modules
+      \brief get track through solid step of CT system for persistent transport kernel
+    */
+    std::string GetTransportKernelTrackThroughSolid(void) const override;
+
+    /*!
+      \fn GGuint SetTransportKernelArguments(cl::Kernel* kernel, GGuint const& argument_index, GGsize const& thread_index) const override
+      \param kernel - pointer to persistent transport kernel
+      \param argument_index - index of first argument of CT system
+      \param thread_index - index of activated device (thread index)
+      \return index of next argument
+      \brief set arguments of CT system in persistent transport kernel
+    */
+    GGuint SetTransportKernelArguments(cl::Kernel* kernel, GGuint const& argument_index, GGsize const& thread_index) const override;
+
   private:
     /*!
       \fn void CheckParameters(void) const override
@@ -126,10 +186,29 @@ class GGEMS_EXPORT GGEMSCTSystem : public GGEMSSystem
     */
     void InitializeFlatGeometry(void);
 
+    /*!
+      \fn void InitializeCTSystemData(void)
+      \brief Initialize CT system data and copy data of all modules in a single buffer
+    */
+    void InitializeCTSystemData(void);
+
+    /*!
+      \fn void InitializeKernel(void)
+      \brief Initialize kernels handling all the modules of CT system
+    */
+    void InitializeKernel(void);
+
   private:
     std::string ct_system_type_; /*!< Type of CT scanner, here: flat or curved */
     GGfloat source_isocenter_distance_; /*!< Distance from source to isocenter (SID) */
     GGfloat source_detector_distance_; /*!< Distance from source to detector (SDD) */
+
+    cl::Buffer** ct_system_data_; /*!< Data about CT system on each OpenCL device */
+    cl::Buffer** modules_data_; /*!< Data of all the modules on each OpenCL device */
+
+    cl::Kernel** kernel_particle_solid_distance_; /*!< OpenCL kernel computing distance between particles and modules */
+    cl::Kernel** kernel_project_to_solid_; /*!< OpenCL kernel moving particles to module */
+    cl::Kernel** kernel_track_through_solid_; /*!< OpenCL kernel tracking particles within modules */
 };
 
 /*!
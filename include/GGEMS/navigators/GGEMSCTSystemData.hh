@@ -0,0 +1,52 @@
+#ifndef GUARD_GGEMS_NAVIGATORS_GGEMSCTSYSTEMDATA_HH
+#define GUARD_GGEMS_NAVIGATORS_GGEMSCTSYSTEMDATA_HH
+
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSCTSystemData.hh
+
+  \brief Structure storing CT system infos, used to find modules crossed by a particle
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.2
+  \date Saturday October 17, 2026
+*/
+
+#include "GGEMS/maths/GGEMSMatrixTypes.hh"
+
+/*!
+  \struct GGEMSCTSystemData_t
+  \brief Structure storing CT system infos. In CT system frame, the source is at (-SID, 0, 0), modules are placed along Z axis (module X) and around the source in XY plane (module Y)
+*/
+typedef struct GGEMSCTSystemData_t
+{
+  GGfloat44 matrix_transformation_; /*!< Transformation matrix from CT system frame to global frame */
+  GGint number_of_modules_xy_[2]; /*!< Number of modules in X and Y */
+  GGfloat module_size_xyz_[3]; /*!< Size of a module in X, Y and Z (local axis of module) */
+  GGfloat source_isocenter_distance_; /*!< Source isocenter distance (SID) */
+  GGfloat source_detector_distance_; /*!< Source detector distance (SDD) */
+  GGfloat module_angle_; /*!< Angle between two modules around the source, only for curved CT system */
+  GGint is_curved_; /*!< 1 for curved CT system, 0 for flat CT system */
+  GGint first_solid_id_; /*!< Index of the first module, index of modules are contiguous */
+} GGEMSCTSystemData; /*!< Using C convention name of struct to C++ (_t deletion) */
+
+#endif // End of GUARD_GGEMS_NAVIGATORS_GGEMSCTSYSTEMDATA_HH
@@ -60,21 +60,45 @@ typedef struct GGEMSDoseRecording_t
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-inline void dose_photon_tracking(global GGEMSDoseParams* dose_params, global GGint* photon_tracking, GGfloat3 const* position)
+/*!
+  \fn inline GGint GetDoselID(global GGEMSDoseParams* dose_params, GGfloat3 const* position)
+  \param dose_params - params associated to dosemap
+  \param position - position of the particle in local solid
+  \return index of the dosel in dosemap, -1 if the particle is outside the dosemap
+  \brief Get index of dosel containing the particle
+*/
+inline GGint GetDoselID(global GGEMSDoseParams* dose_params, GGfloat3 const* position)
 {
   // Check position of photon inside dosemap limits
-  if (position->x < dose_params->border_min_xyz_.x + EPSILON6 || position->x > dose_params->border_max_xyz_.x - EPSILON6) return;
-  if (position->y < dose_params->border_min_xyz_.y + EPSILON6 || position->y > dose_params->border_max_xyz_.y - EPSILON6) return;
-  if (position->z < dose_params->border_min_xyz_.z + EPSILON6 || position->z > dose_params->border_max_xyz_.z - EPSILON6) return;
+  if (position->x < dose_params->border_min_xyz_.x + EPSILON6 || position->x > dose_params->border_max_xyz_.x - EPSILON6) return -1;
+  if (position->y < dose_params->border_min_xyz_.y + EPSILON6 || position->y > dose_params->border_max_xyz_.y - EPSILON6) return -1;
+  if (position->z < dose_params->border_min_xyz_.z + EPSILON6 || position->z > dose_params->border_max_xyz_.z - EPSILON6) return -1;
 
   // Get index in dose map
   GGint3 dosel_id = convert_int3((*position - dose_params->border_min_xyz_) * dose_params->inv_size_of_dosels_);
 
-  GGint global_dosel_id = dosel_id.x + dosel_id.y * dose_params->number_of_dosels_.x + dosel_id.z * dose_params->number_of_dosels_.x * dose_params->number_of_dosels_.y;
+  if (dosel_id.x < 0 || dosel_id.x >= dose_params->number_of_dosels_.x) return -1;
+  if (dosel_id.y < 0 || dosel_id.y >= dose_params->number_of_dosels_.y) return -1;
+  if (dosel_id.z < 0 || dosel_id.z >= dose_params->number_of_dosels_.z) return -1;
+
+  return dosel_id.x + dosel_id.y * dose_params->number_of_dosels_.x + dosel_id.z * dose_params->number_of_dosels_.x * dose_params->number_of_dosels_.y;
+}
 
-  if (dosel_id.x < 0 || dosel_id.x >= dose_params->number_of_dosels_.x) return;
-  if (dosel_id.y < 0 || dosel_id.y >= dose_params->number_of_dosels_.y) return;
-  if (dosel_id.z < 0 || dosel_id.z >= dose_params->number_of_dosels_.z) return;
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void dose_photon_tracking(global GGEMSDoseParams* dose_params, global GGint* photon_tracking, GGfloat3 const* position)
+  \param dose_params - params associated to dosemap
+  \param photon_tracking - photon tracking counter in dosemap
+  \param position - position of the particle in local solid
+  \brief Recording photon crossing a dosel
+*/
+inline void dose_photon_tracking(global GGEMSDoseParams* dose_params, global GGint* photon_tracking, GGfloat3 const* position)
+{
+  GGint global_dosel_id = GetDoselID(dose_params, position);
+  if (global_dosel_id < 0) return;
 
   atomic_add(&photon_tracking[global_dosel_id], 1);
 }
@@ -83,38 +107,193 @@ inline void dose_photon_tracking(global GGEMSDoseParams* dose_params, global GGi
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+/*!
+  \fn inline void DoseRecordGlobal(global GGDosiType* edep_tracking, global GGDosiType* edep_squared_tracking, global GGint* hit_tracking, GGint const global_dosel_id, GGDosiType const edep, GGDosiType const edep_squared, GGint const hit)
+  \param edep_tracking - energy deposit in dosemap
+  \param edep_squared_tracking - energy deposit squared in dosemap
+  \param hit_tracking - hit counter in dosemap
+  \param global_dosel_id - index of dosel
+  \param edep - energy deposit to add, converted with RealToDosi
+  \param edep_squared - energy deposit squared to add, converted with RealToDosi
+  \param hit - number of hits to add
+  \brief Adding values to dosel in global memory using atomic operations
+*/
+inline void DoseRecordGlobal(global GGDosiType* edep_tracking, global GGDosiType* edep_squared_tracking, global GGint* hit_tracking, GGint const global_dosel_id, GGDosiType const edep, GGDosiType const edep_squared, GGint const hit)
+{
+  if (hit_tracking) atomic_add(&hit_tracking[global_dosel_id], hit);
+  AtomicAddDosi(&edep_tracking[global_dosel_id], edep);
+  if (edep_squared_tracking) AtomicAddDosi(&edep_squared_tracking[global_dosel_id], edep_squared);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 /*!
   \fn void dose_record_standard(global GGEMSDoseParams* dose_params, global GGDosiType* edep_tracking, global GGDosiType* edep_squared_tracking, global GGint* hit_tracking, GGfloat edep, GGfloat3 const* position)
   \param dose_params - params associated to dosemap
-  \param
+  \param edep_tracking - energy deposit in dosemap
+  \param edep_squared_tracking - energy deposit squared in dosemap
+  \param hit_tracking - hit counter in dosemap
+  \param edep - energy deposit
+  \param position - position of the particle in local solid
   \brief Recording data for dosimetry
 */
 inline void dose_record_standard(global GGEMSDoseParams* dose_params, global GGDosiType* edep_tracking, global GGDosiType* edep_squared_tracking, global GGint* hit_tracking, GGfloat edep, GGfloat3 const* position)
 {
-  // Check position of photon inside dosemap limits
-  if (position->x < dose_params->border_min_xyz_.x + EPSILON6 || position->x > dose_params->border_max_xyz_.x - EPSILON6) return;
-  if (position->y < dose_params->border_min_xyz_.y + EPSILON6 || position->y > dose_params->border_max_xyz_.y - EPSILON6) return;
-  if (position->z < dose_params->border_min_xyz_.z + EPSILON6 || position->z > dose_params->border_max_xyz_.z - EPSILON6) return;
+  GGint global_dosel_id = GetDoselID(dose_params, position);
+  if (global_dosel_id < 0) return;
 
-  // Get index in dose map
-  GGint3 dosel_id = convert_int3((*position - dose_params->border_min_xyz_) * dose_params->inv_size_of_dosels_);
+  DoseRecordGlobal(edep_tracking, edep_squared_tracking, hit_tracking, global_dosel_id, RealToDosi((GGDosiRealType)edep, (GGDosiRealType)DOSIMETRY_EDEP_FIXED_POINT_SCALE), RealToDosi((GGDosiRealType)edep*(GGDosiRealType)edep, (GGDosiRealType)DOSIMETRY_EDEP_SQUARED_FIXED_POINT_SCALE), 1);
+}
+
+#ifdef DOSE_LOCAL_TALLY
+
+#define DOSE_TALLY_SIZE 512 /*!< Number of dosels stored in local memory by work-group */
+#define DOSE_TALLY_PROBES 8 /*!< Maximum number of probes in local tally before using global memory */
+
+/*!
+  \struct GGEMSDoseTally_t
+  \brief Hashed tile of dosels in work-group local memory, accumulating deposits before a single flush in global memory
+*/
+typedef struct GGEMSDoseTally_t
+{
+  GGint dosel_id_[DOSE_TALLY_SIZE]; /*!< Index of dosel stored in slot, -1 if slot is free */
+  GGDosiType edep_[DOSE_TALLY_SIZE]; /*!< Energy deposit in slot */
+  GGDosiType edep_squared_[DOSE_TALLY_SIZE]; /*!< Energy deposit squared in slot */
+  GGint hit_[DOSE_TALLY_SIZE]; /*!< Hit counter in slot */
+  GGint photon_[DOSE_TALLY_SIZE]; /*!< Photon tracking counter in slot */
+} GGEMSDoseTally; /*!< Using C convention name of struct to C++ (_t deletion) */
 
-  GGint global_dosel_id = dosel_id.x + dosel_id.y * dose_params->number_of_dosels_.x + dosel_id.z * dose_params->number_of_dosels_.x * dose_params->number_of_dosels_.y;
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-  if (dosel_id.x < 0 || dosel_id.x >= dose_params->number_of_dosels_.x) return;
-  if (dosel_id.y < 0 || dosel_id.y >= dose_params->number_of_dosels_.y) return;
-  if (dosel_id.z < 0 || dosel_id.z >= dose_params->number_of_dosels_.z) return;
+/*!
+  \fn inline void InitializeDoseTally(local GGEMSDoseTally* dose_tally)
+  \param dose_tally - tally in local memory
+  \brief Clear local tally, must be called by all work-items of the work-group
+*/
+inline void InitializeDoseTally(local GGEMSDoseTally* dose_tally)
+{
+  for (GGint i = get_local_id(0); i < DOSE_TALLY_SIZE; i += get_local_size(0)) {
+    dose_tally->dosel_id_[i] = -1;
+    dose_tally->edep_[i] = (GGDosiType)0;
+    dose_tally->edep_squared_[i] = (GGDosiType)0;
+    dose_tally->hit_[i] = 0;
+    dose_tally->photon_[i] = 0;
+  }
 
-  if (hit_tracking) atomic_add(&hit_tracking[global_dosel_id], 1);
-  #ifdef DOSIMETRY_DOUBLE_PRECISION
-  AtomicAddDouble(&edep_tracking[global_dosel_id], (GGDosiType)edep);
-  if (edep_squared_tracking) AtomicAddDouble(&edep_squared_tracking[global_dosel_id], (GGDosiType)edep*(GGDosiType)edep);
-  #else
-  AtomicAddFloat(&edep_tracking[global_dosel_id], (GGDosiType)edep);
-  if (edep_squared_tracking) AtomicAddFloat(&edep_squared_tracking[global_dosel_id], (GGDosiType)edep*(GGDosiType)edep);
-  #endif
+  barrier(CLK_LOCAL_MEM_FENCE);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGint GetDoseTallySlot(local GGEMSDoseTally* dose_tally, GGint const global_dosel_id)
+  \param dose_tally - tally in local memory
+  \param global_dosel_id - index of dosel
+  \return index of slot in local tally, -1 if no slot is available
+  \brief Find or claim the slot of a dosel in local tally using linear probing
+*/
+inline GGint GetDoseTallySlot(local GGEMSDoseTally* dose_tally, GGint const global_dosel_id)
+{
+  GGint slot = (GGint)(((GGuint)global_dosel_id * 2654435761u) % DOSE_TALLY_SIZE);
+
+  for (GGint i = 0; i < DOSE_TALLY_PROBES; ++i) {
+    GGint stored_id = atomic_cmpxchg((volatile local GGint*)&dose_tally->dosel_id_[slot], -1, global_dosel_id);
+    if (stored_id == -1 || stored_id == global_dosel_id) return slot;
+    slot = (slot + 1) % DOSE_TALLY_SIZE;
+  }
+
+  return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void dose_photon_tracking_tally(global GGEMSDoseParams* dose_params, local GGEMSDoseTally* dose_tally, global GGint* photon_tracking, GGfloat3 const* position)
+  \param dose_params - params associated to dosemap
+  \param dose_tally - tally in local memory
+  \param photon_tracking - photon tracking counter in dosemap
+  \param position - position of the particle in local solid
+  \brief Recording photon crossing a dosel in local tally, global memory is used if tally is full
+*/
+inline void dose_photon_tracking_tally(global GGEMSDoseParams* dose_params, local GGEMSDoseTally* dose_tally, global GGint* photon_tracking, GGfloat3 const* position)
+{
+  GGint global_dosel_id = GetDoselID(dose_params, position);
+  if (global_dosel_id < 0) return;
+
+  GGint slot = GetDoseTallySlot(dose_tally, global_dosel_id);
+  if (slot < 0) atomic_add(&photon_tracking[global_dosel_id], 1);
+  else atomic_add(&dose_tally->photon_[slot], 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void dose_record_tally(global GGEMSDoseParams* dose_params, local GGEMSDoseTally* dose_tally, global GGDosiType* edep_tracking, global GGDosiType* edep_squared_tracking, global GGint* hit_tracking, GGfloat edep, GGfloat3 const* position)
+  \param dose_params - params associated to dosemap
+  \param dose_tally - tally in local memory
+  \param edep_tracking - energy deposit in dosemap
+  \param edep_squared_tracking - energy deposit squared in dosemap
+  \param hit_tracking - hit counter in dosemap
+  \param edep - energy deposit
+  \param position - position of the particle in local solid
+  \brief Recording data for dosimetry in local tally, global memory is used if tally is full
+*/
+inline void dose_record_tally(global GGEMSDoseParams* dose_params, local GGEMSDoseTally* dose_tally, global GGDosiType* edep_tracking, global GGDosiType* edep_squared_tracking, global GGint* hit_tracking, GGfloat edep, GGfloat3 const* position)
+{
+  GGint global_dosel_id = GetDoselID(dose_params, position);
+  if (global_dosel_id < 0) return;
+
+  GGint slot = GetDoseTallySlot(dose_tally, global_dosel_id);
+  if (slot < 0) {
+    DoseRecordGlobal(edep_tracking, edep_squared_tracking, hit_tracking, global_dosel_id, RealToDosi((GGDosiRealType)edep, (GGDosiRealType)DOSIMETRY_EDEP_FIXED_POINT_SCALE), RealToDosi((GGDosiRealType)edep*(GGDosiRealType)edep, (GGDosiRealType)DOSIMETRY_EDEP_SQUARED_FIXED_POINT_SCALE), 1);
+    return;
+  }
+
+  atomic_add(&dose_tally->hit_[slot], 1);
+  AtomicAddLocalDosi(&dose_tally->edep_[slot], RealToDosi((GGDosiRealType)edep, (GGDosiRealType)DOSIMETRY_EDEP_FIXED_POINT_SCALE));
+  AtomicAddLocalDosi(&dose_tally->edep_squared_[slot], RealToDosi((GGDosiRealType)edep*(GGDosiRealType)edep, (GGDosiRealType)DOSIMETRY_EDEP_SQUARED_FIXED_POINT_SCALE));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void FlushDoseTally(local GGEMSDoseTally* dose_tally, global GGDosiType* edep_tracking, global GGDosiType* edep_squared_tracking, global GGint* hit_tracking, global GGint* photon_tracking)
+  \param dose_tally - tally in local memory
+  \param edep_tracking - energy deposit in dosemap
+  \param edep_squared_tracking - energy deposit squared in dosemap
+  \param hit_tracking - hit counter in dosemap
+  \param photon_tracking - photon tracking counter in dosemap
+  \brief Adding local tally to dosemap in global memory, must be called by all work-items of the work-group
+*/
+inline void FlushDoseTally(local GGEMSDoseTally* dose_tally, global GGDosiType* edep_tracking, global GGDosiType* edep_squared_tracking, global GGint* hit_tracking, global GGint* photon_tracking)
+{
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  for (GGint i = get_local_id(0); i < DOSE_TALLY_SIZE; i += get_local_size(0)) {
+    GGint global_dosel_id = dose_tally->dosel_id_[i];
+    if (global_dosel_id < 0) continue;
+
+    if (dose_tally->hit_[i] > 0) {
+      DoseRecordGlobal(edep_tracking, edep_squared_tracking, hit_tracking, global_dosel_id, dose_tally->edep_[i], dose_tally->edep_squared_[i], dose_tally->hit_[i]);
+    }
+    if (photon_tracking && dose_tally->photon_[i] > 0) atomic_add(&photon_tracking[global_dosel_id], dose_tally->photon_[i]);
+  }
+}
+
+#endif
+
 #endif
 
 #endif // End of GUARD_GGEMS_NAVIGATORS_GGEMSDOSERECORDING_HH
@@ -129,6 +129,13 @@ class GGEMS_EXPORT GGEMSDosimetryCalculator
     */
     void SetPhotonTracking(bool const& is_activated);
 
+    /*!
+      \fn inline bool IsPhotonTracking(void) const
+      \return true if photon tracking is activated
+      \brief check if photon tracking is activated during dosimetry mode
+    */
+    inline bool IsPhotonTracking(void) const {return is_photon_tracking_;}
+
     /*!
       \fn void SetEdep(bool const& is_activated)
       \param is_activated - boolean activating energy deposit registration
@@ -179,6 +186,13 @@ class GGEMS_EXPORT GGEMSDosimetryCalculator
     */
     void SetTLE(bool const& is_activated);
 
+    /*!
+      \fn void SetLocalTally(bool const& is_activated)
+      \param is_activated - boolean activating local tallies
+      \brief activating scoring of dose in work-group local memory, flushed once by work-group in global memory
+    */
+    void SetLocalTally(bool const& is_activated);
+
     /*!
       \fn inline cl::Buffer* GetPhotonTrackingBuffer(GGsize const& thread_index) const
       \param thread_index - index of activated device (thread index)
@@ -226,6 +240,12 @@ class GGEMS_EXPORT GGEMSDosimetryCalculator
     */
     void ComputeDose(GGsize const& thread_index);
 
+    /*!
+      \fn void ReduceDose(void)
+      \brief adding tallies of all devices in first device then computing dose, used in reproducible mode
+    */
+    void ReduceDose(void);
+
     /*!
       \fn void SaveResults(void) const
       \brief save results (dose images)
@@ -409,6 +429,14 @@ extern "C" GGEMS_EXPORT void dose_uncertainty_dosimetry_calculator(GGEMSDosimetr
 */
 extern "C" GGEMS_EXPORT void dose_tle_navigator(GGEMSDosimetryCalculator* dose_calculator, bool const is_activated);
 
+/*!
+  \fn void dose_local_tally_navigator(GGEMSDosimetryCalculator* dose_calculator, bool const is_activated)
+  \param dose_calculator - pointer on dose calculator
+  \param is_activated - boolean the use of local tallies
+  \brief activates scoring of dose in work-group local memory on the navigator
+*/
+extern "C" GGEMS_EXPORT void dose_local_tally_navigator(GGEMSDosimetryCalculator* dose_calculator, bool const is_activated);
+
 /*!
   \fn void attach_to_navigator_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, char const* navigator)
   \param dose_calculator - pointer on dose calculator
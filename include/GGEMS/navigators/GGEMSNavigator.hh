@@ -169,21 +169,60 @@ class GGEMS_EXPORT GGEMSNavigator
       \param thread_index - index of activated device (thread index)
       \brief Compute distance between particle and solid
     */
-    void ParticleSolidDistance(GGsize const& thread_index);
+    virtual void ParticleSolidDistance(GGsize const& thread_index);
 
     /*!
       \fn void ProjectToSolid(GGsize const& thread_index)
       \param thread_index - index of activated device (thread index)
       \brief Project particle to entry of closest solid
     */
-    void ProjectToSolid(GGsize const& thread_index);
+    virtual void ProjectToSolid(GGsize const& thread_index);
 
     /*!
       \fn void TrackThroughSolid(GGsize const& thread_index)
       \param thread_index - index of activated device (thread index)
       \brief Move particle through solid
     */
-    void TrackThroughSolid(GGsize const& thread_index);
+    virtual void TrackThroughSolid(GGsize const& thread_index);
+
+    /*!
+      \fn std::string GetTransportKernelParameters(GGsize& parameter_size) const
+      \param parameter_size - size in bytes of kernel parameters, incremented by the navigator parameters
+      \return declaration of the navigator parameters in persistent transport kernel
+      \brief get the declaration of the navigator parameters in persistent transport kernel
+    */
+    virtual std::string GetTransportKernelParameters(GGsize& parameter_size) const;
+
+    /*!
+      \fn std::string GetTransportKernelParticleSolidDistance(void) const
+      \return calls computing distance between particle and solids in persistent transport kernel
+      \brief get the calls computing distance between particle and solids in persistent transport kernel
+    */
+    virtual std::string GetTransportKernelParticleSolidDistance(void) const;
+
+    /*!
+      \fn std::string GetTransportKernelProjectToSolid(void) const
+      \return calls projecting particle to solids in persistent transport kernel
+      \brief get the calls projecting particle to solids in persistent transport kernel
+    */
+    virtual std::string GetTransportKernelProjectToSolid(void) const;
+
+    /*!
+      \fn std::string GetTransportKernelTrackThroughSolid(void) const
+      \return calls moving particle through solids in persistent transport kernel
+      \brief get the calls moving particle through solids in persistent transport kernel
+    */
+    virtual std::string GetTransportKernelTrackThroughSolid(void) const;
+
+    /*!
+      \fn GGuint SetTransportKernelArguments(cl::Kernel* kernel, GGuint const& argument_index, GGsize const& thread_index) const
+      \param kernel - pointer to persistent transport kernel
+      \param argument_index - index of the first navigator argument
+      \param thread_index - index of activated device (thread index)
+      \return index of the next argument
+      \brief set the navigator arguments of persistent transport kernel
+    */
+    virtual GGuint SetTransportKernelArguments(cl::Kernel* kernel, GGuint const& argument_index, GGsize const& thread_index) const;
 
     /*!
       \fn void PrintInfos(void) const
@@ -210,6 +249,12 @@ class GGEMS_EXPORT GGEMSNavigator
     */
     void ComputeDose(GGsize const& thread_index);
 
+    /*!
+      \fn void ReduceDose(void)
+      \brief Reduce dosimetry tallies of all devices and compute dose, used in reproducible mode
+    */
+    void ReduceDose(void);
+
     /*!
       \fn void StoreOutput(std::string basename)
       \param basename - basename of the output file
@@ -237,6 +282,20 @@ class GGEMS_EXPORT GGEMSNavigator
     */
     void EnableTLE(bool const& is_activated);
 
+    /*!
+      \fn void EnableWoodcockTracking(bool const& is_activated)
+      \param is_activated - bool activating or not Woodcock tracking
+      \brief Enable Woodcock (delta) tracking of photons, free flights are sampled with the majorant cross section without stopping at voxel boundaries. Not compatible with photon tracking in dosimetry
+    */
+    void EnableWoodcockTracking(bool const& is_activated);
+
+    /*!
+      \fn void EnableDoseLocalTally(bool const& is_activated)
+      \param is_activated - bool activating or not local tallies
+      \brief Enable scoring of dose in work-group local memory, depositions are flushed in global memory once by work-group
+    */
+    void EnableDoseLocalTally(bool const& is_activated);
+
     /*!
       \fn void SetVisible(bool const& is_visible)
       \param is_visible - true if navigator is drawn using OpenGL
@@ -303,6 +362,8 @@ class GGEMS_EXPORT GGEMSNavigator
     GGEMSDosimetryCalculator* dose_calculator_; /*!< Dose calculator pointer */
     bool is_dosimetry_mode_; /*!< Boolean checking if dosimetry mode is activated */
     bool is_tle_;  /*!< Boolean checking if tle mode is activated */
+    bool is_woodcock_tracking_; /*!< Boolean checking if Woodcock tracking is activated */
+    bool is_dose_local_tally_; /*!< Boolean checking if dose is scored in local memory */
     GGsize number_activated_devices_; /*!< Number of activated device */
 
     // OpenGL
@@ -207,6 +207,32 @@ class GGEMS_EXPORT GGEMSNavigatorManager
     */
     void ComputeDose(GGsize const& thread_index);
 
+    /*!
+      \fn void ReduceDose(void)
+      \brief Reduce dosimetry tallies of all devices and compute dose, used in reproducible mode
+    */
+    void ReduceDose(void);
+
+    /*!
+      \fn void InitializeTransportKernel(void)
+      \brief Generate and compile the persistent kernel transporting particles through all the navigators
+    */
+    void InitializeTransportKernel(void);
+
+    /*!
+      \fn inline bool IsTransportKernel(void) const
+      \return true if persistent transport kernel is available
+      \brief check if persistent transport kernel is available for the scene
+    */
+    inline bool IsTransportKernel(void) const {return kernel_transport_ != nullptr;}
+
+    /*!
+      \fn void Transport(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \brief Transport particles until they die or leave the world, using the persistent kernel
+    */
+    void Transport(GGsize const& thread_index) const;
+
     /*!
       \fn void Clean(void)
       \brief clean OpenCL data if necessary
@@ -217,6 +243,7 @@ class GGEMS_EXPORT GGEMSNavigatorManager
     GGEMSNavigator** navigators_; /*!< Pointer on the navigators */
     GGsize number_of_navigators_; /*!< Number of navigators */
     GGEMSWorld* world_; /*!< Pointer on world volume */
+    cl::Kernel** kernel_transport_; /*!< OpenCL persistent kernel transporting particles */
 };
 
 #endif // End of GUARD_GGEMS_NAVIGATORS_GGEMSNAVIGATORMANAGER_HH
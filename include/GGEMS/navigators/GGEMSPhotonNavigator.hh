@@ -46,50 +46,99 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn inline void GetPhotonNextInteraction(global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSParticleCrossSections const* particle_cross_sections, GGshort const index_material, GGint const index_particle)
+  \fn inline void GetPhotonNextInteraction(global GGEMSPrimaryParticles* primary_particle, GGEMSRandomState* random, global GGEMSParticleCrossSections const* particle_cross_sections, GGLabelType const index_material, GGint const particle_id)
   \param primary_particle - buffer of particles
-  \param random - pointer on random numbers
+  \param random - pointer on random state of the particle in private memory
   \param particle_cross_sections - buffer of cross sections
   \param index_material - index of the material
-  \param index_particle - index of the particle
-  \brief Determine the next photon interaction
+  \param particle_id - index of the particle
+  \brief Determine the distance to next photon interaction from the remaining number of mean free paths, a new number is sampled only after an interaction
 */
 inline void GetPhotonNextInteraction(
   global GGEMSPrimaryParticles* primary_particle,
-  global GGEMSRandom* random,
+  GGEMSRandomState* random,
   global GGEMSParticleCrossSections const* particle_cross_sections,
-  GGuchar const index_material,
+  GGLabelType const index_material,
   GGint const particle_id)
 {
-  // Getting energy of the particle and the index of energy in cross section table
-  GGint energy_id = BinarySearchLeft(primary_particle->E_[particle_id], particle_cross_sections->energy_bins_, particle_cross_sections->number_of_bins_, 0, 0);
+  // Getting energy of the particle and the index of energy in cross section table, bins are log-spaced
+  GGint number_of_bins = (GGint)particle_cross_sections->number_of_bins_;
+  GGint energy_id = LogEnergyIndex(GetParticleEnergy(primary_particle, particle_id), particle_cross_sections->log_min_energy_, particle_cross_sections->inverse_log_energy_step_, number_of_bins);
 
   // Initialization of next interaction distance
   GGfloat next_interaction_distance = OUT_OF_WORLD;
-  GGchar next_discrete_process = NO_PROCESS;
-  GGchar photon_process_id = 0;
-  GGfloat interaction_distance = 0.0f;
-
-  // Loop over activated processes
-  for (GGchar i = 0; i < particle_cross_sections->number_of_activated_photon_processes_; ++i) {
-    // Getting index of process
-    photon_process_id = particle_cross_sections->photon_cs_id_[i];
-
-    // Getting the interaction distance
-    interaction_distance =
-      -log(KissUniform(random, particle_id))/
-      particle_cross_sections->photon_cross_sections_[photon_process_id][energy_id + particle_cross_sections->number_of_bins_*index_material];
 
-    if (interaction_distance < next_interaction_distance) {
-      next_interaction_distance = interaction_distance;
-      next_discrete_process = photon_process_id;
+  // Distance is given by the remaining number of mean free paths and the total cross section
+  GGfloat total_cross_section = GGEMS_TABLE(GGfloat, particle_cross_sections, photon_total_cross_sections_)[energy_id + number_of_bins*index_material];
+  if (total_cross_section > 0.0f) {
+    GGfloat number_of_mean_free_paths = primary_particle->number_of_mean_free_paths_[particle_id];
+    if (number_of_mean_free_paths < 0.0f) {
+      number_of_mean_free_paths = -log(KissUniform(random));
+      primary_particle->number_of_mean_free_paths_[particle_id] = number_of_mean_free_paths;
     }
+    next_interaction_distance = number_of_mean_free_paths/total_cross_section;
   }
 
-  // Storing results in particle buffer
+  // Storing results in particle buffer, process is selected only if interaction occurs
   primary_particle->E_index_[particle_id] = energy_id;
   primary_particle->next_interaction_distance_[particle_id] = next_interaction_distance;
-  primary_particle->next_discrete_process_[particle_id] = next_discrete_process;
+  SetParticleNextDiscreteProcess(primary_particle, particle_id, NO_PROCESS);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void ReducePhotonMeanFreePaths(global GGEMSPrimaryParticles* primary_particle, GGfloat const distance, GGint const particle_id)
+  \param primary_particle - buffer of particles
+  \param distance - distance crossed without interaction, inferior to next interaction distance
+  \param particle_id - index of the particle
+  \brief Remove the mean free paths crossed on a distance without interaction (voxel or solid boundary), the remaining number is used in next voxel or next navigator
+*/
+inline void ReducePhotonMeanFreePaths(
+  global GGEMSPrimaryParticles* primary_particle,
+  GGfloat const distance,
+  GGint const particle_id)
+{
+  // Number of mean free paths is proportional to distance in a material: remaining = number - distance*total cross section
+  GGfloat next_interaction_distance = primary_particle->next_interaction_distance_[particle_id];
+  primary_particle->number_of_mean_free_paths_[particle_id] *= fmax(0.0f, 1.0f - distance/next_interaction_distance);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGchar SelectPhotonProcess(global GGEMSPrimaryParticles* primary_particle, GGEMSRandomState* random, global GGEMSParticleCrossSections const* particle_cross_sections, GGLabelType const index_material, GGint const particle_id)
+  \param primary_particle - buffer of particles
+  \param random - pointer on random state of the particle in private memory
+  \param particle_cross_sections - buffer of cross sections
+  \param index_material - index of the material
+  \param particle_id - index of the particle
+  \return selected photon process
+  \brief Select the process of the photon interaction with probability cross section of process / total cross section
+*/
+inline GGchar SelectPhotonProcess(
+  global GGEMSPrimaryParticles* primary_particle,
+  GGEMSRandomState* random,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  GGLabelType const index_material,
+  GGint const particle_id)
+{
+  GGint table_id = primary_particle->E_index_[particle_id] + (GGint)particle_cross_sections->number_of_bins_*index_material;
+
+  GGfloat random_cross_section = KissUniform(random)*GGEMS_TABLE(GGfloat, particle_cross_sections, photon_total_cross_sections_)[table_id];
+  GGchar next_discrete_process = NO_PROCESS;
+  for (GGchar i = 0; i < particle_cross_sections->number_of_activated_photon_processes_; ++i) {
+    next_discrete_process = particle_cross_sections->photon_cs_id_[i];
+    random_cross_section -= GGEMS_TABLE(GGfloat, particle_cross_sections, photon_cross_sections_[next_discrete_process])[table_id];
+    if (random_cross_section < 0.0f) break;
+  }
+
+  SetParticleNextDiscreteProcess(primary_particle, particle_id, next_discrete_process);
+  return next_discrete_process;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -97,9 +146,9 @@ inline void GetPhotonNextInteraction(
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn inline void PhotonDiscreteProcess(global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSMaterialTables const* materials, global GGEMSParticleCrossSections const* particle_cross_sections, GGshort const material_id, GGint const particle_id)
+  \fn inline void PhotonDiscreteProcess(global GGEMSPrimaryParticles* primary_particle, GGEMSRandomState* random, global GGEMSMaterialTables const* materials, global GGEMSParticleCrossSections const* particle_cross_sections, GGshort const material_id, GGint const particle_id)
   \param primary_particle - buffer of particles
-  \param random - pointer on random numbers
+  \param random - pointer on random state of the particle in private memory
   \param materials - buffer of materials
   \param particle_cross_sections - pointer to cross sections activated in navigator
   \param material_id - index of the material
@@ -108,15 +157,18 @@ inline void GetPhotonNextInteraction(
 */
 inline void PhotonDiscreteProcess(
   global GGEMSPrimaryParticles* primary_particle,
-  global GGEMSRandom* random,
+  GGEMSRandomState* random,
   global GGEMSMaterialTables const* materials,
   global GGEMSParticleCrossSections const* particle_cross_sections,
-  GGuchar const material_id,
+  GGLabelType const material_id,
   GGint const particle_id
 )
 {
   // Get photon process
-  GGchar next_iteraction_process = primary_particle->next_discrete_process_[particle_id];
+  GGchar next_iteraction_process = GetParticleNextDiscreteProcess(primary_particle, particle_id);
+
+  // A new number of mean free paths is sampled after an interaction
+  primary_particle->number_of_mean_free_paths_[particle_id] = -1.0f;
 
   // Select process
   if (next_iteraction_process == COMPTON_SCATTERING) {
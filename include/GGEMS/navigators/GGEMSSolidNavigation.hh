@@ -0,0 +1,1188 @@
+#ifndef GUARD_GGEMS_NAVIGATORS_GGEMSSOLIDNAVIGATION_HH
+#define GUARD_GGEMS_NAVIGATORS_GGEMSSOLIDNAVIGATION_HH
+
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSSolidNavigation.hh
+
+  \brief Functions navigating particles through solids, shared by navigator kernels and persistent transport kernel, only for OpenCL kernel usage
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.2
+  \date Saturday October 17, 2026
+*/
+
+#ifdef __OPENCL_C_VERSION__
+
+#include "GGEMS/physics/GGEMSPrimaryParticles.hh"
+#include "GGEMS/geometries/GGEMSVoxelizedSolidData.hh"
+#include "GGEMS/geometries/GGEMSSolidBoxData.hh"
+#include "GGEMS/navigators/GGEMSCTSystemData.hh"
+#include "GGEMS/geometries/GGEMSRayTracing.hh"
+#include "GGEMS/global/GGEMSConstants.hh"
+#include "GGEMS/materials/GGEMSMaterialTables.hh"
+#include "GGEMS/physics/GGEMSParticleCrossSections.hh"
+#include "GGEMS/randoms/GGEMSRandom.hh"
+#include "GGEMS/maths/GGEMSMatrixOperations.hh"
+#include "GGEMS/navigators/GGEMSPhotonNavigator.hh"
+#include "GGEMS/physics/GGEMSMuData.hh"
+
+#if defined(DOSIMETRY)
+#include "GGEMS/navigators/GGEMSDoseRecording.hh"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void ParticleSolidDistance(global GGEMSPrimaryParticles* primary_particle, global GGEMSOBB const* obb_geometry, GGint const solid_id, GGint const particle_id)
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param obb_geometry - OBB of the solid
+  \param solid_id - index of the solid
+  \param particle_id - index of the particle
+  \brief Compute distance between a solid and a particle, the closest solid is stored
+*/
+inline void ParticleSolidDistance(
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSOBB const* obb_geometry,
+  GGint const solid_id,
+  GGint const particle_id)
+{
+  // Checking particle status. If DEAD, the particle is not track
+  if (GetParticleStatus(primary_particle, particle_id) == DEAD) return;
+
+  // Checking if the particle - solid is 0. If yes the particle is already in another navigator
+  if (primary_particle->particle_solid_distance_[particle_id] == 0.0f) return;
+
+  // Position of particle
+  GGfloat3 position = GetParticlePosition(primary_particle, particle_id);
+
+  // Direction of particle
+  GGfloat3 direction = GetParticleDirection(primary_particle, particle_id);
+
+  // Check if particle inside voxelized navigator, if yes distance is 0.0 and not need to compute particle - solid distance
+  if (IsParticleInOBB(&position, obb_geometry)) {
+    #ifdef GGEMS_TRACKING
+    if (particle_id == primary_particle->particle_tracking_id) {
+      printf("[GGEMS OpenCL function ParticleSolidDistance] --------------------------------------------------------------------------------\n");
+      printf("[GGEMS OpenCL function ParticleSolidDistance] Find a closest solid\n");
+      printf("[GGEMS OpenCL function ParticleSolidDistance] Particle id: %d\n", particle_id);
+      printf("[GGEMS OpenCL function ParticleSolidDistance] Particle in solid, id: %d\n", solid_id);
+      printf("[GGEMS OpenCL function ParticleSolidDistance] Particle solid distance: 0.0\n");
+    }
+    #endif
+    primary_particle->particle_solid_distance_[particle_id] = 0.0f;
+    primary_particle->solid_id_[particle_id] = solid_id;
+    return;
+  }
+
+  // Compute distance between particles and voxelized navigator
+  GGfloat distance = ComputeDistanceToOBB(&position, &direction, obb_geometry);
+
+  // Check distance value with previous value. Store the minimum value
+  if (distance < primary_particle->particle_solid_distance_[particle_id]) {
+    #ifdef GGEMS_TRACKING
+    if (particle_id == primary_particle->particle_tracking_id) {
+      printf("[GGEMS OpenCL function ParticleSolidDistance] --------------------------------------------------------------------------------\n");
+      printf("[GGEMS OpenCL function ParticleSolidDistance] Find a closest solid\n");
+      printf("[GGEMS OpenCL function ParticleSolidDistance] Particle id: %d\n", particle_id);
+      printf("[GGEMS OpenCL function ParticleSolidDistance] Particle in solid, id: %d\n", solid_id);
+      printf("[GGEMS OpenCL function ParticleSolidDistance] Particle solid distance: %e mm\n", distance/mm);
+    }
+    #endif
+    primary_particle->particle_solid_distance_[particle_id] = distance;
+    primary_particle->solid_id_[particle_id] = solid_id;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void ProjectToSolid(global GGEMSPrimaryParticles* primary_particle, global GGEMSOBB const* obb_geometry, GGint const solid_id, GGint const particle_id)
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param obb_geometry - OBB of the solid
+  \param solid_id - index of the solid
+  \param particle_id - index of the particle
+  \brief Move a particle to the solid if the solid is the closest one, particle without solid is killed
+*/
+inline void ProjectToSolid(
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSOBB const* obb_geometry,
+  GGint const solid_id,
+  GGint const particle_id)
+{
+  // No solid detected, consider particle as dead
+  if(primary_particle->solid_id_[particle_id] == -1) SetParticleStatus(primary_particle, particle_id, DEAD);
+
+  // Checking if distance to navigator is OUT_OF_WORLD after computation distance
+  // If yes, the particle is OUT_OF_WORLD and DEAD, so no tracking
+  if (primary_particle->particle_solid_distance_[particle_id] == OUT_OF_WORLD) {
+    primary_particle->solid_id_[particle_id] = -1; // -1 is out_of_world, using for debugging
+    SetParticleStatus(primary_particle, particle_id, DEAD);
+
+    #ifdef OPENGL
+    if (particle_id < MAXIMUM_DISPLAYED_PARTICLES) {
+      // Storing OpenGL index on OpenCL private memory
+      GGint stored_particles_gl = primary_particle->stored_particles_gl_[particle_id];
+
+      // Checking if buffer is full
+      if (stored_particles_gl != MAXIMUM_INTERACTIONS) {
+        GGfloat3 exit_position = GetParticlePosition(primary_particle, particle_id) + GetParticleDirection(primary_particle, particle_id)*100.0f*m;
+        primary_particle->px_gl_[particle_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = exit_position.x;
+        primary_particle->py_gl_[particle_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = exit_position.y;
+        primary_particle->pz_gl_[particle_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = exit_position.z;
+
+        // Storing final index
+        primary_particle->stored_particles_gl_[particle_id] += 1;
+      }
+    }
+    #endif
+
+    return;
+  }
+
+  // Checking if the current navigator is the selected navigator
+  if (primary_particle->solid_id_[particle_id] != solid_id) return;
+
+  // Checking status of particle
+  if (GetParticleStatus(primary_particle, particle_id) == DEAD) return;
+
+  // Position of particle
+  GGfloat3 position = GetParticlePosition(primary_particle, particle_id);
+
+  // Direction of particle
+  GGfloat3 direction = GetParticleDirection(primary_particle, particle_id);
+
+  // Distance to current navigator and geometry tolerance
+  GGfloat distance = primary_particle->particle_solid_distance_[particle_id];
+
+  // Moving the particle slightly inside the volume
+  position += direction*(distance+GEOMETRY_TOLERANCE);
+
+  // Correcting the particle position if not totally inside due to float tolerance
+  TransportGetSafetyInsideOBB(&position, obb_geometry);
+
+  // Set new value for particles
+  SetParticlePosition(primary_particle, particle_id, position);
+
+  primary_particle->particle_solid_distance_[particle_id] = 0.0f;
+
+  #ifdef GGEMS_TRACKING
+  if (particle_id == primary_particle->particle_tracking_id) {
+    printf("[GGEMS OpenCL function ProjectToSolid] ********************************************************************************\n");
+    printf("[GGEMS OpenCL function ProjectToSolid] Project to closest solid\n");
+    printf("[GGEMS OpenCL function ProjectToSolid] Particle id: %d\n", particle_id);
+    printf("[GGEMS OpenCL function ProjectToSolid] Position (x, y, z): %e %e %e mm\n", position.x/mm, position.y/mm, position.z/mm);
+  }
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGchar GetWoodcockNextInteraction(global GGEMSPrimaryParticles* primary_particle, GGEMSRandomState* random, global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGLabelType const* label_data, global GGEMSParticleCrossSections const* particle_cross_sections, GGfloat3* local_position, GGfloat3 const* local_direction, GGLabelType* material_id, GGint const particle_id)
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param random - pointer on random state of the particle in private memory
+  \param voxelized_solid_data - pointer to voxelized solid data
+  \param label_data - pointer storing label of material
+  \param particle_cross_sections - pointer to cross sections activated in navigator
+  \param local_position - position of particle in local OBB coordinate, moved to next real interaction
+  \param local_direction - direction of particle in local OBB coordinate
+  \param material_id - material at the position of the real interaction
+  \param particle_id - index of the particle
+  \return photon process of the real interaction, TRANSPORTATION if particle leaves the solid
+  \brief Woodcock tracking, free flights are sampled with the majorant cross section and a collision is real with probability total cross section / majorant cross section
+*/
+inline GGchar GetWoodcockNextInteraction(
+  global GGEMSPrimaryParticles* primary_particle,
+  GGEMSRandomState* random,
+  global GGEMSVoxelizedSolidData const* voxelized_solid_data,
+  global GGLabelType const* label_data,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  GGfloat3* local_position,
+  GGfloat3 const* local_direction,
+  GGLabelType* material_id,
+  GGint const particle_id)
+{
+  // Get borders of OBB
+  GGfloat3 border_min = voxelized_solid_data->obb_geometry_.border_min_xyz_;
+  GGfloat3 border_max = voxelized_solid_data->obb_geometry_.border_max_xyz_;
+
+  GGfloat3 voxel_size = voxelized_solid_data->voxel_sizes_xyz_;
+  GGint3 number_of_voxels = voxelized_solid_data->number_of_voxels_xyz_;
+  GGsize number_of_bins = particle_cross_sections->number_of_bins_;
+
+  // Energy is constant during free flights, so the majorant is constant too
+  GGint energy_id = LogEnergyIndex(GetParticleEnergy(primary_particle, particle_id), particle_cross_sections->log_min_energy_, particle_cross_sections->inverse_log_energy_step_, number_of_bins);
+  GGfloat majorant_cross_section = GGEMS_TABLE(GGfloat, particle_cross_sections, photon_majorant_cross_sections_)[energy_id];
+  primary_particle->E_index_[particle_id] = energy_id;
+
+  // Distance to leave the solid
+  GGfloat distance_to_exit = ComputeDistanceToAABB(
+    local_position, local_direction,
+    border_min.x, border_max.x,
+    border_min.y, border_max.y,
+    border_min.z, border_max.z,
+    GEOMETRY_TOLERANCE
+  );
+  GGfloat flight_distance = 0.0f;
+
+  while (TRUE) {
+    GGfloat free_flight = -log(KissUniform(random))/majorant_cross_section;
+
+    // No collision before leaving the solid
+    if (free_flight >= distance_to_exit) {
+      *local_position = *local_position + *local_direction*(distance_to_exit+GEOMETRY_TOLERANCE);
+      primary_particle->next_interaction_distance_[particle_id] = flight_distance + distance_to_exit + GEOMETRY_TOLERANCE;
+      SetParticleNextDiscreteProcess(primary_particle, particle_id, TRANSPORTATION);
+      return TRANSPORTATION;
+    }
+
+    // Moving particle to collision
+    *local_position = *local_position + *local_direction*free_flight;
+    distance_to_exit -= free_flight;
+    flight_distance += free_flight;
+
+    // Get the material at the collision, index is clamped because of float tolerance at solid borders
+    GGint3 voxel_id = clamp(convert_int3((*local_position - border_min) / voxel_size), (GGint3)(0), number_of_voxels - 1);
+    *material_id = label_data[voxel_id.x + voxel_id.y * number_of_voxels.x + voxel_id.z * number_of_voxels.x * number_of_voxels.y];
+
+    // Same random number accepts the collision and selects the process, a virtual collision goes on with the free flight
+    GGfloat random_cross_section = KissUniform(random)*majorant_cross_section;
+    if (random_cross_section >= GGEMS_TABLE(GGfloat, particle_cross_sections, photon_total_cross_sections_)[energy_id + number_of_bins*(*material_id)]) continue;
+
+    for (GGchar i = 0; i < particle_cross_sections->number_of_activated_photon_processes_; ++i) {
+      GGchar photon_process_id = particle_cross_sections->photon_cs_id_[i];
+      random_cross_section -= GGEMS_TABLE(GGfloat, particle_cross_sections, photon_cross_sections_[photon_process_id])[energy_id + number_of_bins*(*material_id)];
+      if (random_cross_section < 0.0f) {
+        primary_particle->next_interaction_distance_[particle_id] = flight_distance;
+        SetParticleNextDiscreteProcess(primary_particle, particle_id, photon_process_id);
+        return photon_process_id;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(WOODCOCK) && defined(TLE)
+#error "Woodcock tracking is not compatible with TLE"
+#endif
+
+/*!
+  \fn inline void TrackThroughVoxelizedSolid(global GGEMSPrimaryParticles* primary_particle, GGEMSRandomState* random, global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGLabelType const* label_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGEMSMaterialTables const* materials, global GGEMSMuMuEnData const* attenuations, GGfloat const threshold, GGint const particle_id)
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param random - pointer on random state of the particle in private memory
+  \param voxelized_solid_data - pointer to voxelized solid data
+  \param label_data - pointer storing label of material
+  \param particle_cross_sections - pointer to cross sections activated in navigator
+  \param materials - pointer on material in navigator
+  \param attenuations - pointer on attenuation values
+  \param threshold - energy threshold
+  \param particle_id - index of the particle
+  \brief Track a particle within voxelized solid until it leaves the solid or dies, dose buffers are given if DOSIMETRY is defined and local dose tally if DOSE_LOCAL_TALLY is defined
+*/
+inline void TrackThroughVoxelizedSolid(
+  global GGEMSPrimaryParticles* primary_particle,
+  GGEMSRandomState* random,
+  global GGEMSVoxelizedSolidData const* voxelized_solid_data,
+  global GGLabelType const* label_data,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGEMSMaterialTables const* materials,
+  global GGEMSMuMuEnData const* attenuations,
+  GGfloat const threshold,
+  #ifdef DOSIMETRY
+  global GGEMSDoseParams* dose_params,
+  global GGDosiType* edep_tracking,
+  global GGDosiType* edep_squared_tracking,
+  global GGint* hit_tracking,
+  global GGint* photon_tracking,
+  #endif
+  #if defined(DOSIMETRY) && defined(DOSE_LOCAL_TALLY)
+  local GGEMSDoseTally* dose_tally,
+  #endif
+  GGint const particle_id)
+{
+  // Checking if the current navigator is the selected navigator
+  if (primary_particle->solid_id_[particle_id] != voxelized_solid_data->solid_id_) return;
+
+  // Checking status of particle
+  if (GetParticleStatus(primary_particle, particle_id) == DEAD) {
+    #if defined(GGEMS_TRACKING)
+    if (particle_id == primary_particle->particle_tracking_id) {
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] ################################################################################\n");
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] The particle id %d is dead!!!\n", particle_id);
+    }
+    #endif
+    return;
+  }
+
+  // Get the position and direction in local OBB coordinate
+  GGfloat3 global_position = GetParticlePosition(primary_particle, particle_id);
+  GGfloat3 global_direction = GetParticleDirection(primary_particle, particle_id);
+  GGfloat3 local_position = GlobalToLocalPosition(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &global_position);
+  GGfloat3 local_direction = GlobalToLocalDirection(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &global_direction);
+
+  // Storing local direction in particles 
+  SetParticleDirection(primary_particle, particle_id, local_direction);
+
+  // Get borders of OBB
+  GGfloat3 border_min = voxelized_solid_data->obb_geometry_.border_min_xyz_;
+  GGfloat3 border_max = voxelized_solid_data->obb_geometry_.border_max_xyz_;
+
+  GGfloat3 voxel_size = voxelized_solid_data->voxel_sizes_xyz_;
+  GGint3 number_of_voxels = voxelized_solid_data->number_of_voxels_xyz_;
+
+  #if !defined(WOODCOCK)
+  // Incremental voxel traversal, index is clamped because particle is projected inside solid with a tolerance
+  GGint3 voxel_id = clamp(convert_int3((local_position - border_min) / voxel_size), (GGint3)(0), number_of_voxels - 1);
+  GGint3 voxel_step;
+  GGfloat3 next_crossing, crossing_delta;
+  InitializeVoxelTraversal(&local_position, &local_direction, border_min, voxel_size, voxel_id, &voxel_step, &next_crossing, &crossing_delta);
+  #endif
+
+  // Track particle until out of solid
+  do {
+    #if defined(WOODCOCK)
+    // Find next real photon interaction, voxel boundaries are not crossed one by one
+    GGLabelType material_id = 0;
+    GGchar next_discrete_process = GetWoodcockNextInteraction(primary_particle, random, voxelized_solid_data, label_data, particle_cross_sections, &local_position, &local_direction, &material_id, particle_id);
+
+    #if defined(GGEMS_TRACKING)
+    if (particle_id == primary_particle->particle_tracking_id) {
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] ################################################################################\n");
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Woodcock tracking, particle id: %d\n", particle_id);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Local position (x, y, z): %e %e %e mm\n", local_position.x/mm, local_position.y/mm, local_position.z/mm);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Energy: %e keV\n", GetParticleEnergy(primary_particle, particle_id)/keV);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Material: %d\n", material_id);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Next process: ");
+      if (next_discrete_process == COMPTON_SCATTERING) printf("COMPTON_SCATTERING\n");
+      if (next_discrete_process == PHOTOELECTRIC_EFFECT) printf("PHOTOELECTRIC_EFFECT\n");
+      if (next_discrete_process == RAYLEIGH_SCATTERING) printf("RAYLEIGH_SCATTERING\n");
+      if (next_discrete_process == TRANSPORTATION) printf("TRANSPORTATION\n");
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Flight distance: %e mm\n", primary_particle->next_interaction_distance_[particle_id]/mm);
+    }
+    #endif
+
+    // Particle leaves the solid without real interaction
+    if (next_discrete_process == TRANSPORTATION) {
+      primary_particle->particle_solid_distance_[particle_id] = OUT_OF_WORLD; // Reset to initiale value
+      primary_particle->solid_id_[particle_id] = -1; // Out of world
+      break;
+    }
+    #else
+    // Get the material that compose this voxel
+    GGLabelType material_id = label_data[voxel_id.x + voxel_id.y * number_of_voxels.x + voxel_id.z * number_of_voxels.x * number_of_voxels.y];
+
+    // Find next discrete photon interaction
+    GetPhotonNextInteraction(primary_particle, random, particle_cross_sections, material_id, particle_id);
+    GGfloat next_interaction_distance = primary_particle->next_interaction_distance_[particle_id];
+    GGchar next_discrete_process = TRANSPORTATION;
+
+    // Distance to next voxel boundary is the nearest crossing of the traversal
+    GGfloat distance_to_next_boundary = fmin(next_crossing.x, fmin(next_crossing.y, next_crossing.z));
+
+    // Mean free paths crossed in voxel are removed, otherwise process of interaction is selected
+    if (distance_to_next_boundary <= next_interaction_distance) {
+      ReducePhotonMeanFreePaths(primary_particle, distance_to_next_boundary, particle_id);
+      next_interaction_distance = distance_to_next_boundary;
+      #if defined(DOSIMETRY) && defined(DOSE_LOCAL_TALLY)
+      if (photon_tracking) dose_photon_tracking_tally(dose_params, dose_tally, photon_tracking, &local_position);
+      #elif defined(DOSIMETRY)
+      if (photon_tracking) dose_photon_tracking(dose_params, photon_tracking, &local_position);
+      #endif
+    }
+    else {
+      next_discrete_process = SelectPhotonProcess(primary_particle, random, particle_cross_sections, material_id, particle_id);
+    }
+
+    #if defined(GGEMS_TRACKING)
+    if (particle_id == primary_particle->particle_tracking_id) {
+      GGfloat3 voxel_border_min = border_min + convert_float3(voxel_id)*voxel_size;
+      GGfloat3 voxel_border_max = voxel_border_min + voxel_size;
+
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] ################################################################################\n");
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Particle id: %d\n", particle_id);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Particle type: ");
+      if (GetParticleName(primary_particle, particle_id) == PHOTON) printf("gamma\n");
+      else if (GetParticleName(primary_particle, particle_id) == ELECTRON) printf("e-\n");
+      else if (GetParticleName(primary_particle, particle_id) == POSITRON) printf("e+\n");
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Local position (x, y, z): %e %e %e mm\n", local_position.x/mm, local_position.y/mm, local_position.z/mm);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Local direction (x, y, z): %e %e %e\n", local_direction.x, local_direction.y, local_direction.z);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Energy: %e keV\n", GetParticleEnergy(primary_particle, particle_id)/keV);
+      printf("\n");
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Solid id: %u\n", voxelized_solid_data->solid_id_);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Nb voxels: %u %u %u\n", number_of_voxels.x, number_of_voxels.y, number_of_voxels.z);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Voxel size: %e %e %e mm\n", voxel_size.x/mm, voxel_size.y/mm, voxel_size.z/mm);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Solid X Borders: %e %e mm\n", border_min.x/mm, border_max.x/mm);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Solid Y Borders: %e %e mm\n", border_min.y/mm, border_max.y/mm);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Solid Z Borders: %e %e mm\n", border_min.z/mm, border_max.z/mm);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Voxel X Borders: %e %e mm\n", voxel_border_min.x/mm, voxel_border_max.x/mm);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Voxel Y Borders: %e %e mm\n", voxel_border_min.y/mm, voxel_border_max.y/mm);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Voxel Z Borders: %e %e mm\n", voxel_border_min.z/mm, voxel_border_max.z/mm);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Index of current voxel (x, y, z): %d %d %d\n", voxel_id.x, voxel_id.y, voxel_id.z);
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Material in voxel: %d\n", material_id);
+      printf("\n");
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Next process: ");
+      if (next_discrete_process == COMPTON_SCATTERING) printf("COMPTON_SCATTERING\n");
+      if (next_discrete_process == PHOTOELECTRIC_EFFECT) printf("PHOTOELECTRIC_EFFECT\n");
+      if (next_discrete_process == RAYLEIGH_SCATTERING) printf("RAYLEIGH_SCATTERING\n");
+      if (next_discrete_process == TRANSPORTATION) printf("TRANSPORTATION\n");
+      printf("[GGEMS OpenCL function TrackThroughVoxelizedSolid] Next interaction distance: %e mm\n", next_interaction_distance/mm);
+    }
+    #endif
+
+    // Moving particle to next position
+    local_position = local_position + local_direction*next_interaction_distance;
+    next_crossing -= next_interaction_distance;
+
+    // Crossing a voxel boundary, exit face of solid is given by index of voxel
+    if (next_discrete_process == TRANSPORTATION) {
+      StepVoxelTraversal(&voxel_id, &voxel_step, &next_crossing, &crossing_delta);
+
+      if (any(voxel_id < 0) || any(voxel_id >= number_of_voxels)) {
+        local_position = local_position + local_direction*GEOMETRY_TOLERANCE;
+        primary_particle->particle_solid_distance_[particle_id] = OUT_OF_WORLD; // Reset to initiale value
+        primary_particle->solid_id_[particle_id] = -1; // Out of world
+        break;
+      }
+    }
+    #endif
+
+    // Storing new position in local
+    SetParticlePosition(primary_particle, particle_id, local_position);
+
+    #if defined(DOSIMETRY)
+    GGfloat initial_energy = GetParticleEnergy(primary_particle, particle_id);
+    #endif
+
+    // Resolve process if different of TRANSPORTATION
+    if (next_discrete_process != TRANSPORTATION) {
+
+      PhotonDiscreteProcess(primary_particle, random, materials, particle_cross_sections, material_id, particle_id);
+
+      // If process is COMPTON_SCATTERING or RAYLEIGH_SCATTERING scatter order is incremented
+      if (next_discrete_process == COMPTON_SCATTERING || next_discrete_process == RAYLEIGH_SCATTERING)
+      {
+        SetParticleScatter(primary_particle, particle_id, TRUE);
+      }
+
+      #if defined(DOSIMETRY) && !defined(TLE)
+      GGfloat edep = initial_energy - GetParticleEnergy(primary_particle, particle_id);
+      #if defined(DOSE_LOCAL_TALLY)
+      dose_record_tally(dose_params, dose_tally, edep_tracking, edep_squared_tracking, hit_tracking, edep, &local_position);
+      #else
+      dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, edep, &local_position);
+      #endif
+      #endif
+
+      local_direction = GetParticleDirection(primary_particle, particle_id);
+
+      #if !defined(WOODCOCK)
+      // New direction, traversal restarts from current voxel
+      InitializeVoxelTraversal(&local_position, &local_direction, border_min, voxel_size, voxel_id, &voxel_step, &next_crossing, &crossing_delta);
+      #endif
+
+      #if defined(OPENGL)
+      if (particle_id < MAXIMUM_DISPLAYED_PARTICLES) {
+        // Storing OpenGL index on OpenCL private memory
+        GGint stored_particles_gl = primary_particle->stored_particles_gl_[particle_id];
+
+        // Checking if buffer is full
+        if (stored_particles_gl != MAXIMUM_INTERACTIONS) {
+          // Getting global position
+          global_position = LocalToGlobalPosition(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &local_position);
+
+          primary_particle->px_gl_[particle_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.x;
+          primary_particle->py_gl_[particle_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.y;
+          primary_particle->pz_gl_[particle_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.z;
+
+          // Storing final index
+          primary_particle->stored_particles_gl_[particle_id] += 1;
+        }
+      }
+      #endif
+    }
+
+    #if defined(DOSIMETRY) && defined(TLE)
+    GGint E_index = BinarySearchLeft(initial_energy, attenuations->energy_bins_, attenuations->number_of_bins_, 0, 0);
+    GGfloat mu_en = 0.0f;
+    if (E_index == 0) {
+      mu_en = GGEMS_TABLE(GGfloat, attenuations, mu_en_)[material_id*attenuations->number_of_bins_];
+    }
+    else {
+      mu_en = LinearInterpolation(
+        attenuations->energy_bins_[E_index-1], GGEMS_TABLE(GGfloat, attenuations, mu_en_)[material_id*attenuations->number_of_bins_ + E_index-1],
+        attenuations->energy_bins_[E_index], GGEMS_TABLE(GGfloat, attenuations, mu_en_)[material_id*attenuations->number_of_bins_ + E_index],
+        initial_energy
+      );
+    }
+    GGfloat edep = initial_energy * mu_en * next_interaction_distance * 0.1f;
+    #if defined(DOSE_LOCAL_TALLY)
+    dose_record_tally(dose_params, dose_tally, edep_tracking, edep_squared_tracking, hit_tracking, edep, &local_position);
+    #else
+    dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, edep, &local_position);
+    #endif
+    #endif
+
+    // Apply threshold
+    if (GetParticleEnergy(primary_particle, particle_id) <= GGEMS_TABLE(GGfloat, materials, photon_energy_cut_)[material_id]) {
+      #if defined(DOSIMETRY) && defined(DOSE_LOCAL_TALLY)
+      dose_record_tally(dose_params, dose_tally, edep_tracking, edep_squared_tracking, hit_tracking, GetParticleEnergy(primary_particle, particle_id), &local_position);
+      #elif defined(DOSIMETRY)
+      dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, GetParticleEnergy(primary_particle, particle_id), &local_position);
+      #endif
+      SetParticleStatus(primary_particle, particle_id, DEAD);
+    }
+  } while (GetParticleStatus(primary_particle, particle_id) == ALIVE);
+
+  // Convert to global position
+  global_position = LocalToGlobalPosition(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &local_position);
+  SetParticlePosition(primary_particle, particle_id, global_position);
+
+  // Convert to global direction
+  global_direction = LocalToGlobalDirection(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &local_direction);
+  SetParticleDirection(primary_particle, particle_id, global_direction);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void TrackThroughSolidBox(global GGEMSPrimaryParticles* primary_particle, GGEMSRandomState* random, global GGEMSSolidBoxData const* solid_box_data, global GGLabelType const* label_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGEMSMaterialTables const* materials, global GGEMSMuMuEnData const* attenuations, GGfloat const threshold, GGint const particle_id)
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param random - pointer on random state of the particle in private memory
+  \param solid_box_data - pointer to solid box data
+  \param label_data - pointer storing label of material (empty buffer here, 1 material only)
+  \param particle_cross_sections - pointer to cross sections activated in navigator
+  \param materials - pointer on material in navigator
+  \param attenuations - pointer on attenuation values
+  \param threshold - energy threshold
+  \param particle_id - index of the particle
+  \brief Track a particle within solid box until it leaves the solid or dies, histogram buffers are given if HISTOGRAM is defined
+*/
+inline void TrackThroughSolidBox(
+  global GGEMSPrimaryParticles* primary_particle,
+  GGEMSRandomState* random,
+  global GGEMSSolidBoxData const* solid_box_data,
+  global GGLabelType const* label_data,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGEMSMaterialTables const* materials,
+  global GGEMSMuMuEnData const* attenuations,
+  GGfloat const threshold,
+  #ifdef HISTOGRAM
+  global GGint* histogram,
+  global GGint* scatter_histogram,
+  #endif
+  GGint const particle_id)
+{
+  // Checking if the current navigator is the selected navigator
+  if (primary_particle->solid_id_[particle_id] != solid_box_data->solid_id_) return;
+
+  // Checking status of particle
+  if (GetParticleStatus(primary_particle, particle_id) == DEAD) {
+    #ifdef GGEMS_TRACKING
+    if (particle_id == primary_particle->particle_tracking_id) {
+      printf("[GGEMS OpenCL function TrackThroughSolidBox] ################################################################################\n");
+      printf("[GGEMS OpenCL function TrackThroughSolidBox] The particle id %d is dead!!!\n", particle_id);
+    }
+    #endif
+    return;
+  }
+
+  // Get the position and direction in local OBB coordinate
+  GGfloat3 global_position = GetParticlePosition(primary_particle, particle_id);
+  GGfloat3 global_direction = GetParticleDirection(primary_particle, particle_id);
+  GGfloat3 local_position = GlobalToLocalPosition(&solid_box_data->obb_geometry_.matrix_transformation_, &global_position);
+  GGfloat3 local_direction = GlobalToLocalDirection(&solid_box_data->obb_geometry_.matrix_transformation_, &global_direction);
+
+  // Storing local direction in particles 
+  SetParticleDirection(primary_particle, particle_id, local_direction);
+
+  // Get borders of OBB
+  GGfloat3 border_min = solid_box_data->obb_geometry_.border_min_xyz_;
+  GGfloat3 border_max = solid_box_data->obb_geometry_.border_max_xyz_;
+
+  // Get box size of solid box
+  GGfloat3 box_size = {
+    solid_box_data->box_size_xyz_[0],
+    solid_box_data->box_size_xyz_[1],
+    solid_box_data->box_size_xyz_[2]
+  };
+
+  // Get virtual element size
+  GGint3 virtual_element_number = {
+    solid_box_data->virtual_element_number_xyz_[0],
+    solid_box_data->virtual_element_number_xyz_[1],
+    solid_box_data->virtual_element_number_xyz_[2]
+  };
+
+  // Track particle until out of solid
+  do {
+    // Find next discrete photon interaction
+    GetPhotonNextInteraction(primary_particle, random, particle_cross_sections, 0, particle_id);
+    GGfloat next_interaction_distance = primary_particle->next_interaction_distance_[particle_id];
+    GGchar next_discrete_process = TRANSPORTATION;
+
+    // Get safety position of particle to be sure particle is inside voxel
+    TransportGetSafetyInsideAABB(
+      &local_position,
+      border_min.x, border_max.x,
+      border_min.y, border_max.y,
+      border_min.z, border_max.z,
+      GEOMETRY_TOLERANCE
+    );
+
+    // Get the distance to next boundary
+    GGfloat distance_to_next_boundary = ComputeDistanceToAABB(
+      &local_position, &local_direction,
+      border_min.x, border_max.x,
+      border_min.y, border_max.y,
+      border_min.z, border_max.z,
+      GEOMETRY_TOLERANCE
+    );
+
+    // If distance to next boundary is inferior to distance to next interaction we move particle to boundary
+    // Remaining mean free paths are carried to next navigator, otherwise process of interaction is selected
+    if (distance_to_next_boundary <= next_interaction_distance) {
+      ReducePhotonMeanFreePaths(primary_particle, distance_to_next_boundary, particle_id);
+      next_interaction_distance = distance_to_next_boundary + GEOMETRY_TOLERANCE;
+    }
+    else {
+      next_discrete_process = SelectPhotonProcess(primary_particle, random, particle_cross_sections, 0, particle_id);
+    }
+
+    #ifdef GGEMS_TRACKING
+    if (particle_id == primary_particle->particle_tracking_id) {
+      printf("[GGEMS OpenCL function TrackThroughSolidBox] ################################################################################\n");
+      printf("[GGEMS OpenCL function TrackThroughSolidBox] Particle id: %d\n", particle_id);
+      printf("[GGEMS OpenCL function TrackThroughSolidBox] Particle type: ");
+      if (GetParticleName(primary_particle, particle_id) == PHOTON) printf("gamma\n");
+      else if (GetParticleName(primary_particle, particle_id) == ELECTRON) printf("e-\n");
+      else if (GetParticleName(primary_particle, particle_id) == POSITRON) printf("e+\n");
+      printf("[GGEMS OpenCL function TrackThroughSolidBox] Local position (x, y, z): %e %e %e mm\n", local_position.x/mm, local_position.y/mm, local_position.z/mm);
+      printf("[GGEMS OpenCL function TrackThroughSolidBox] Local direction (x, y, z): %e %e %e\n", local_direction.x, local_direction.y, local_direction.z);
+      printf("[GGEMS OpenCL function TrackThroughSolidBox] Energy: %e keV\n", GetParticleEnergy(primary_particle, particle_id)/keV);
+      printf("\n");
+      printf("[GGEMS OpenCL function TrackThroughSolidBox] Solid id: %u\n", solid_box_data->solid_id_);
+      printf("[GGEMS OpenCL function TrackThroughSolidBox] Solid X Borders: %e %e mm\n", border_min.x/mm, border_max.x/mm);
+      printf("[GGEMS OpenCL function TrackThroughSolidBox] Solid Y Borders: %e %e mm\n", border_min.y/mm, border_max.y/mm);
+      printf("[GGEMS OpenCL function TrackThroughSolidBox] Solid Z Borders: %e %e mm\n", border_min.z/mm, border_max.z/mm);
+      printf("[GGEMS OpenCL function TrackThroughSolidBox] Material in voxel: %d\n", 0);
+      printf("\n");
+      printf("[GGEMS OpenCL function TrackThroughSolidBox] Next process: ");
+      if (next_discrete_process == COMPTON_SCATTERING) printf("COMPTON_SCATTERING\n");
+      if (next_discrete_process == PHOTOELECTRIC_EFFECT) printf("PHOTOELECTRIC_EFFECT\n");
+      if (next_discrete_process == RAYLEIGH_SCATTERING) printf("RAYLEIGH_SCATTERING\n");
+      if (next_discrete_process == TRANSPORTATION) printf("TRANSPORTATION\n");
+      printf("[GGEMS OpenCL function TrackThroughSolidBox] Next interaction distance: %e mm\n", next_interaction_distance/mm);
+    }
+    #endif
+
+    // Moving particle to next postion
+    local_position = local_position + local_direction*next_interaction_distance;
+
+    // Get safety position of particle to be sure particle is outside voxel
+    TransportGetSafetyOutsideAABB(
+      &local_position,
+      border_min.x, border_max.x,
+      border_min.y, border_max.y,
+      border_min.z, border_max.z,
+      GEOMETRY_TOLERANCE
+    );
+
+    //  Checking if particle outside solid, still in local
+    if (!IsParticleInAABB(&local_position, border_min.x, border_max.x, border_min.y, border_max.y, border_min.z, border_max.z, GEOMETRY_TOLERANCE)) {
+      primary_particle->particle_solid_distance_[particle_id] = OUT_OF_WORLD; // Reset to initiale value
+      primary_particle->solid_id_[particle_id] = -1; // Out of world
+      break;
+    }
+
+    // Storing new position in local
+    SetParticlePosition(primary_particle, particle_id, local_position);
+
+    // Check thresold
+    if (GetParticleEnergy(primary_particle, particle_id) < threshold) SetParticleStatus(primary_particle, particle_id, DEAD);
+
+    // Resolve process if different of TRANSPORTATION
+    if (next_discrete_process != TRANSPORTATION) {
+      PhotonDiscreteProcess(primary_particle, random, materials, particle_cross_sections, 0, particle_id);
+
+      local_direction = GetParticleDirection(primary_particle, particle_id);
+
+      #ifdef HISTOGRAM
+      if (next_discrete_process == PHOTOELECTRIC_EFFECT || next_discrete_process == COMPTON_SCATTERING) {
+        GGfloat3 element_size = box_size / convert_float3(virtual_element_number);
+        GGint3 voxel_id = convert_int3((local_position - border_min) / element_size);
+
+        GGsize histogram_id = solid_box_data->histogram_offset_ + voxel_id.x + voxel_id.y * solid_box_data->histogram_stride_;
+
+        atomic_add(&histogram[histogram_id], 1);
+
+        // Storing scatter
+        if (scatter_histogram) {
+          if (GetParticleScatter(primary_particle, particle_id) == TRUE) atomic_add(&scatter_histogram[histogram_id], 1);
+        }
+      }
+      #endif
+
+      #ifdef OPENGL
+      if (particle_id < MAXIMUM_DISPLAYED_PARTICLES) {
+        // Storing OpenGL index on OpenCL private memory
+        GGint stored_particles_gl = primary_particle->stored_particles_gl_[particle_id];
+
+        // Checking if buffer is full
+        if (stored_particles_gl != MAXIMUM_INTERACTIONS) {
+          // Getting global position
+          global_position = LocalToGlobalPosition(&solid_box_data->obb_geometry_.matrix_transformation_, &local_position);
+
+          primary_particle->px_gl_[particle_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.x;
+          primary_particle->py_gl_[particle_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.y;
+          primary_particle->pz_gl_[particle_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = global_position.z;
+
+          // Storing final index
+          primary_particle->stored_particles_gl_[particle_id] += 1;
+        }
+      }
+      #endif
+    }
+  } while (GetParticleStatus(primary_particle, particle_id) == ALIVE);
+
+  // Convert to global position
+  global_position = LocalToGlobalPosition(&solid_box_data->obb_geometry_.matrix_transformation_, &local_position);
+  SetParticlePosition(primary_particle, particle_id, global_position);
+
+  // Convert to global direction
+  global_direction = LocalToGlobalDirection(&solid_box_data->obb_geometry_.matrix_transformation_, &local_direction);
+  SetParticleDirection(primary_particle, particle_id, global_direction);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat2 GetSlabInterval(GGfloat const position, GGfloat const direction, GGfloat const border_min, GGfloat const border_max)
+  \param position - coordinate of particle position
+  \param direction - coordinate of particle direction
+  \param border_min - minimum border of slab
+  \param border_max - maximum border of slab
+  \return interval of distances along the ray inside the slab, min. > max. if the ray does not cross the slab
+  \brief Get the part of a ray inside a slab
+*/
+inline GGfloat2 GetSlabInterval(GGfloat const position, GGfloat const direction, GGfloat const border_min, GGfloat const border_max)
+{
+  // Ray parallel to slab
+  if (fabs(direction) < EPSILON6) {
+    if (position < border_min || position > border_max) return (GGfloat2)(OUT_OF_WORLD, -OUT_OF_WORLD);
+    return (GGfloat2)(-OUT_OF_WORLD, OUT_OF_WORLD);
+  }
+
+  GGfloat distance_min = (border_min - position) / direction;
+  GGfloat distance_max = (border_max - position) / direction;
+
+  return (GGfloat2)(fmin(distance_min, distance_max), fmax(distance_min, distance_max));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat2 GetDiskInterval(GGfloat2 const position, GGfloat2 const direction, GGfloat const radius)
+  \param position - particle position in plane, relative to disk center
+  \param direction - particle direction in plane, not normalized
+  \param radius - radius of disk
+  \return interval of distances along the ray inside the disk, min. > max. if the ray does not cross the disk
+  \brief Get the part of a ray inside a disk
+*/
+inline GGfloat2 GetDiskInterval(GGfloat2 const position, GGfloat2 const direction, GGfloat const radius)
+{
+  GGfloat a = dot(direction, direction);
+  GGfloat b = dot(position, direction);
+  GGfloat c = dot(position, position) - radius*radius;
+
+  // Ray orthogonal to disk plane
+  if (a < EPSILON6) {
+    if (c > 0.0f) return (GGfloat2)(OUT_OF_WORLD, -OUT_OF_WORLD);
+    return (GGfloat2)(-OUT_OF_WORLD, OUT_OF_WORLD);
+  }
+
+  GGfloat discriminant = b*b - a*c;
+  if (discriminant < 0.0f) return (GGfloat2)(OUT_OF_WORLD, -OUT_OF_WORLD);
+
+  GGfloat sqrt_discriminant = sqrt(discriminant);
+  return (GGfloat2)((-b - sqrt_discriminant) / a, (-b + sqrt_discriminant) / a);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGint2 GetCTSystemModuleRange(GGfloat const coordinate_a, GGfloat const coordinate_b, GGfloat const module_size, GGint const number_of_modules, GGint const margin)
+  \param coordinate_a - coordinate (position or angle) of the first end of the ray part
+  \param coordinate_b - coordinate (position or angle) of the second end of the ray part
+  \param module_size - size (or angle) of a module
+  \param number_of_modules - number of modules in this direction
+  \param margin - number of neighbour modules added on each side
+  \return first and last index of modules covering the coordinates
+  \brief Get the range of modules crossed by a ray part, modules are centered around 0
+*/
+inline GGint2 GetCTSystemModuleRange(GGfloat const coordinate_a, GGfloat const coordinate_b, GGfloat const module_size, GGint const number_of_modules, GGint const margin)
+{
+  GGfloat half_number_of_modules = 0.5f*(GGfloat)number_of_modules;
+
+  GGint2 range = {
+    (GGint)floor(fmin(coordinate_a, coordinate_b) / module_size + half_number_of_modules) - margin,
+    (GGint)floor(fmax(coordinate_a, coordinate_b) / module_size + half_number_of_modules) + margin
+  };
+
+  return clamp(range, 0, number_of_modules - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void ParticleCTSystemDistance(global GGEMSPrimaryParticles* primary_particle, global GGEMSCTSystemData const* ct_system_data, global GGEMSSolidBoxData const* modules_data, GGint const particle_id)
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param ct_system_data - pointer to CT system data
+  \param modules_data - pointer to data of all modules of CT system
+  \param particle_id - index of the particle
+  \brief Compute distance between a particle and the modules of a CT system. Modules crossed by the ray are found analytically from the part of the ray inside the shell of modules, only these modules are checked
+*/
+inline void ParticleCTSystemDistance(
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSCTSystemData const* ct_system_data,
+  global GGEMSSolidBoxData const* modules_data,
+  GGint const particle_id)
+{
+  // Checking particle status. If DEAD, the particle is not track
+  if (GetParticleStatus(primary_particle, particle_id) == DEAD) return;
+
+  // Checking if the particle - solid is 0. If yes the particle is already in another navigator
+  if (primary_particle->particle_solid_distance_[particle_id] == 0.0f) return;
+
+  // Position and direction of particle in CT system frame
+  GGfloat3 global_position = GetParticlePosition(primary_particle, particle_id);
+  GGfloat3 global_direction = GetParticleDirection(primary_particle, particle_id);
+  GGfloat3 position = GlobalToLocalPosition(&ct_system_data->matrix_transformation_, &global_position);
+  GGfloat3 direction = GlobalToLocalDirection(&ct_system_data->matrix_transformation_, &global_direction);
+
+  GGint number_of_modules_x = ct_system_data->number_of_modules_xy_[0];
+  GGint number_of_modules_y = ct_system_data->number_of_modules_xy_[1];
+  GGfloat half_depth = 0.5f*ct_system_data->module_size_xyz_[2];
+
+  // Part of the ray crossing modules along Z axis, particle is only moving forward
+  GGfloat half_length_z = 0.5f*ct_system_data->module_size_xyz_[0]*(GGfloat)number_of_modules_x + GEOMETRY_TOLERANCE;
+  GGfloat2 interval_z = GetSlabInterval(position.z, direction.z, -half_length_z, half_length_z);
+  interval_z.x = fmax(interval_z.x, 0.0f);
+
+  // Parts of the ray crossing the shell of modules, two parts if the ray crosses the hole of a curved CT system
+  GGfloat2 intervals[2];
+  GGint margin_y = 0;
+  if (ct_system_data->is_curved_) {
+    // Modules are between the front face of modules and the farthest corner of modules, around the source
+    GGfloat2 position_xy = {position.x + ct_system_data->source_isocenter_distance_, position.y};
+    GGfloat2 direction_xy = {direction.x, direction.y};
+    GGfloat half_length_y = 0.5f*ct_system_data->module_size_xyz_[1];
+    GGfloat outer_radius = sqrt((ct_system_data->source_detector_distance_ + half_depth)*(ct_system_data->source_detector_distance_ + half_depth) + half_length_y*half_length_y) + GEOMETRY_TOLERANCE;
+    GGfloat inner_radius = ct_system_data->source_detector_distance_ - half_depth - GEOMETRY_TOLERANCE;
+
+    GGfloat2 outer_interval = GetDiskInterval(position_xy, direction_xy, outer_radius);
+    GGfloat2 inner_interval = GetDiskInterval(position_xy, direction_xy, inner_radius);
+
+    if (inner_interval.x > inner_interval.y) {
+      intervals[0] = outer_interval;
+      intervals[1] = (GGfloat2)(OUT_OF_WORLD, -OUT_OF_WORLD);
+    }
+    else {
+      intervals[0] = (GGfloat2)(outer_interval.x, fmin(outer_interval.y, inner_interval.x));
+      intervals[1] = (GGfloat2)(fmax(outer_interval.x, inner_interval.y), outer_interval.y);
+    }
+
+    // Corners of a module overlap the angle of neighbour modules
+    margin_y = 1;
+  }
+  else {
+    GGfloat module_position_x = ct_system_data->source_detector_distance_ - ct_system_data->source_isocenter_distance_;
+    GGfloat half_length_y = 0.5f*ct_system_data->module_size_xyz_[1]*(GGfloat)number_of_modules_y + GEOMETRY_TOLERANCE;
+
+    GGfloat2 interval_x = GetSlabInterval(position.x, direction.x, module_position_x - half_depth - GEOMETRY_TOLERANCE, module_position_x + half_depth + GEOMETRY_TOLERANCE);
+    GGfloat2 interval_y = GetSlabInterval(position.y, direction.y, -half_length_y, half_length_y);
+
+    intervals[0] = (GGfloat2)(fmax(interval_x.x, interval_y.x), fmin(interval_x.y, interval_y.y));
+    intervals[1] = (GGfloat2)(OUT_OF_WORLD, -OUT_OF_WORLD);
+  }
+
+  for (GGint k = 0; k < 2; ++k) {
+    GGfloat distance_min = fmax(intervals[k].x, interval_z.x);
+    GGfloat distance_max = fmin(intervals[k].y, interval_z.y);
+    if (distance_min > distance_max) continue;
+
+    // Ends of the ray part
+    GGfloat3 position_a = position + direction*distance_min;
+    GGfloat3 position_b = position + direction*distance_max;
+
+    // Range of modules, angle around the source is monotonic along the ray part for curved CT system
+    GGint2 range_x = GetCTSystemModuleRange(position_a.z, position_b.z, ct_system_data->module_size_xyz_[0], number_of_modules_x, 0);
+    GGint2 range_y;
+    if (ct_system_data->is_curved_) {
+      GGfloat angle_a = atan2(position_a.y, position_a.x + ct_system_data->source_isocenter_distance_);
+      GGfloat angle_b = atan2(position_b.y, position_b.x + ct_system_data->source_isocenter_distance_);
+      range_y = GetCTSystemModuleRange(angle_a, angle_b, ct_system_data->module_angle_, number_of_modules_y, margin_y);
+    }
+    else {
+      range_y = GetCTSystemModuleRange(position_a.y, position_b.y, ct_system_data->module_size_xyz_[1], number_of_modules_y, margin_y);
+    }
+
+    for (GGint j = range_y.x; j <= range_y.y; ++j) {
+      for (GGint i = range_x.x; i <= range_x.y; ++i) {
+        global GGEMSSolidBoxData const* module_data = &modules_data[i + j*number_of_modules_x];
+        ParticleSolidDistance(primary_particle, &module_data->obb_geometry_, module_data->solid_id_, particle_id);
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGint GetCTSystemModuleID(global GGEMSPrimaryParticles* primary_particle, global GGEMSCTSystemData const* ct_system_data, GGint const particle_id)
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param ct_system_data - pointer to CT system data
+  \param particle_id - index of the particle
+  \return index of the module selected by the particle, -1 if the selected solid is not a module of CT system
+  \brief Get index of module from index of selected solid, modules have contiguous indices
+*/
+inline GGint GetCTSystemModuleID(
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSCTSystemData const* ct_system_data,
+  GGint const particle_id)
+{
+  GGint module_id = primary_particle->solid_id_[particle_id] - ct_system_data->first_solid_id_;
+
+  if (module_id < 0 || module_id >= ct_system_data->number_of_modules_xy_[0]*ct_system_data->number_of_modules_xy_[1]) return -1;
+
+  return module_id;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void ProjectToCTSystem(global GGEMSPrimaryParticles* primary_particle, global GGEMSCTSystemData const* ct_system_data, global GGEMSSolidBoxData const* modules_data, GGint const particle_id)
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param ct_system_data - pointer to CT system data
+  \param modules_data - pointer to data of all modules of CT system
+  \param particle_id - index of the particle
+  \brief Move a particle to the selected module of CT system, particle without solid is killed
+*/
+inline void ProjectToCTSystem(
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSCTSystemData const* ct_system_data,
+  global GGEMSSolidBoxData const* modules_data,
+  GGint const particle_id)
+{
+  // If the selected solid is not a module, first module is used only to kill particles without solid
+  GGint module_id = max(GetCTSystemModuleID(primary_particle, ct_system_data, particle_id), 0);
+
+  ProjectToSolid(primary_particle, &modules_data[module_id].obb_geometry_, modules_data[module_id].solid_id_, particle_id);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void TrackThroughCTSystem(global GGEMSPrimaryParticles* primary_particle, GGEMSRandomState* random, global GGEMSCTSystemData const* ct_system_data, global GGEMSSolidBoxData const* modules_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGEMSMaterialTables const* materials, global GGEMSMuMuEnData const* attenuations, GGfloat const threshold, GGint const particle_id)
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param random - pointer on random state of the particle in private memory
+  \param ct_system_data - pointer to CT system data
+  \param modules_data - pointer to data of all modules of CT system
+  \param particle_cross_sections - pointer to cross sections activated in navigator
+  \param materials - pointer on material in navigator
+  \param attenuations - pointer on attenuation values
+  \param threshold - energy threshold
+  \param particle_id - index of the particle
+  \brief Track a particle within the selected module of CT system, histogram buffers of CT system are given if HISTOGRAM is defined
+*/
+inline void TrackThroughCTSystem(
+  global GGEMSPrimaryParticles* primary_particle,
+  GGEMSRandomState* random,
+  global GGEMSCTSystemData const* ct_system_data,
+  global GGEMSSolidBoxData const* modules_data,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGEMSMaterialTables const* materials,
+  global GGEMSMuMuEnData const* attenuations,
+  GGfloat const threshold,
+  #ifdef HISTOGRAM
+  global GGint* histogram,
+  global GGint* scatter_histogram,
+  #endif
+  GGint const particle_id)
+{
+  GGint module_id = GetCTSystemModuleID(primary_particle, ct_system_data, particle_id);
+  if (module_id < 0) return;
+
+  TrackThroughSolidBox(
+    primary_particle, random, &modules_data[module_id], NULL, particle_cross_sections, materials, attenuations, threshold,
+    #ifdef HISTOGRAM
+    histogram, scatter_histogram,
+    #endif
+    particle_id
+  );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void WorldTracking(global GGEMSPrimaryParticles* primary_particle, global GGint* photon_tracking, global GGDosiType* edep_tracking, global GGDosiType* edep_squared_tracking, global GGDosiType* momentum_x, global GGDosiType* momentum_y, global GGDosiType* momentum_z, GGsize width, GGsize height, GGsize depth, GGfloat size_x, GGfloat size_y, GGfloat size_z, GGint const particle_id)
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param photon_tracking - photon tracking counter in world
+  \param edep_tracking - sum of energy times track length in world (MeV.mm)
+  \param edep_squared_tracking - sum of squared energy times track length in world (MeV2.mm), divided by edep_tracking it gives the mean energy weighted by energy fluence, not a variance of the estimate
+  \param momentum_x - sum of energy times track length times direction along X (MeV.mm)
+  \param momentum_y - sum of energy times track length times direction along Y (MeV.mm)
+  \param momentum_z - sum of energy times track length times direction along Z (MeV.mm)
+  \param width - number of elements in world along X
+  \param height - number of elements in world along Y
+  \param depth - number of elements in world along Z
+  \param size_x - size of world voxel along X
+  \param size_y - size of world voxel along Y
+  \param size_z - size of world voxel along Z
+  \param particle_id - index of the particle
+  \brief tracking a particle through world volume until the next solid or the world border, each voxel records the length of track inside it (track-length estimator): energy, squared energy and momentum (energy times direction) are weighted by this length
+*/
+inline void WorldTracking(
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGint* photon_tracking,
+  global GGDosiType* edep_tracking,
+  global GGDosiType* edep_squared_tracking,
+  global GGDosiType* momentum_x,
+  global GGDosiType* momentum_y,
+  global GGDosiType* momentum_z,
+  GGsize width,
+  GGsize height,
+  GGsize depth,
+  GGfloat size_x,
+  GGfloat size_y,
+  GGfloat size_z,
+  GGint const particle_id)
+{
+  if (GetParticleStatus(primary_particle, particle_id) == DEAD) return;
+
+  // In world, the particle is tracked voxel by voxel (DDA) and each voxel records the length of track inside it
+  GGfloat3 direction = GetParticleDirection(primary_particle, particle_id);
+  GGfloat3 position = GetParticlePosition(primary_particle, particle_id);
+  GGfloat energy = GetParticleEnergy(primary_particle, particle_id);
+
+  // World is centered on isocenter
+  GGint3 dim = {width, height, depth};
+  GGfloat3 size = {size_x, size_y, size_z};
+  GGfloat3 border_min = size*convert_float3(dim)*-0.5f;
+  GGfloat3 border_max = -border_min;
+
+  // Part of the ray inside the world, stopped at next solid
+  GGfloat distance = primary_particle->particle_solid_distance_[particle_id];
+
+  if (distance <= GEOMETRY_TOLERANCE) return;
+
+  GGfloat2 interval_x = GetSlabInterval(position.x, direction.x, border_min.x, border_max.x);
+  GGfloat2 interval_y = GetSlabInterval(position.y, direction.y, border_min.y, border_max.y);
+  GGfloat2 interval_z = GetSlabInterval(position.z, direction.z, border_min.z, border_max.z);
+  GGfloat distance_min = fmax(0.0f, fmax(interval_x.x, fmax(interval_y.x, interval_z.x)));
+  GGfloat distance_max = fmin(distance, fmin(interval_x.y, fmin(interval_y.y, interval_z.y)));
+
+  if (distance_min >= distance_max) return;
+
+  // Starting voxel, index is clamped because entry point is on world border
+  position = position + direction*distance_min;
+  GGint3 index = clamp(convert_int3(floor((position - border_min)/size)), (GGint3)(0), dim - 1);
+
+  GGint3 voxel_step;
+  GGfloat3 next_crossing, crossing_delta;
+  InitializeVoxelTraversal(&position, &direction, border_min, size, index, &voxel_step, &next_crossing, &crossing_delta);
+
+  GGfloat track_length = distance_max - distance_min;
+  while (track_length > 0.0f) {
+    // Length of track inside current voxel
+    GGfloat distance_to_next_boundary = fmin(next_crossing.x, fmin(next_crossing.y, next_crossing.z));
+    GGfloat chord = fmin(distance_to_next_boundary, track_length);
+
+    // Voxel corners give zero length chords, nothing is recorded
+    if (chord > 0.0f) {
+      GGint global_index_world = index.x + index.y * dim.x + index.z * dim.x * dim.y;
+
+      if (photon_tracking) atomic_add(&photon_tracking[global_index_world], 1);
+
+      GGDosiRealType edep_chord = (GGDosiRealType)energy*(GGDosiRealType)chord;
+      if (edep_tracking) AtomicAddDosi(&edep_tracking[global_index_world], RealToDosi(edep_chord, (GGDosiRealType)WORLD_ENERGY_FIXED_POINT_SCALE));
+      if (edep_squared_tracking) AtomicAddDosi(&edep_squared_tracking[global_index_world], RealToDosi(edep_chord*(GGDosiRealType)energy, (GGDosiRealType)WORLD_ENERGY_SQUARED_FIXED_POINT_SCALE));
+      if (momentum_x) AtomicAddDosi(&momentum_x[global_index_world], RealToDosi(edep_chord*(GGDosiRealType)direction.x, (GGDosiRealType)WORLD_ENERGY_FIXED_POINT_SCALE));
+      if (momentum_y) AtomicAddDosi(&momentum_y[global_index_world], RealToDosi(edep_chord*(GGDosiRealType)direction.y, (GGDosiRealType)WORLD_ENERGY_FIXED_POINT_SCALE));
+      if (momentum_z) AtomicAddDosi(&momentum_z[global_index_world], RealToDosi(edep_chord*(GGDosiRealType)direction.z, (GGDosiRealType)WORLD_ENERGY_FIXED_POINT_SCALE));
+    }
+
+    // End of track inside this voxel, world border or next solid
+    track_length -= chord;
+    if (track_length <= 0.0f) break;
+
+    // Next voxel
+    next_crossing -= distance_to_next_boundary;
+    StepVoxelTraversal(&index, &voxel_step, &next_crossing, &crossing_delta);
+
+    if (any(index < 0) || any(index >= dim)) break;
+  }
+
+  #ifdef GGEMS_TRACKING
+  if (particle_id == primary_particle->particle_tracking_id) {
+    printf("[GGEMS OpenCL function WorldTracking] ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
+    printf("[GGEMS OpenCL function WorldTracking] World tracking particle\n");
+    printf("[GGEMS OpenCL function WorldTracking] Particle status: %d, DEAD: %d, ALIVE: %d\n", GetParticleStatus(primary_particle, particle_id), DEAD, ALIVE);
+    GGfloat3 particle_position = GetParticlePosition(primary_particle, particle_id);
+    printf("[GGEMS OpenCL function WorldTracking] Particle position: %e %e %e mm\n", particle_position.x/mm, particle_position.y/mm, particle_position.z/mm);
+    printf("[GGEMS OpenCL function WorldTracking] Particle direction: %e %e %e\n", direction.x, direction.y, direction.z);
+    printf("[GGEMS OpenCL function WorldTracking] Particle energy: %e keV\n", GetParticleEnergy(primary_particle, particle_id)/keV);
+    printf("[GGEMS OpenCL function WorldTracking] Distance to next solid: %e mm\n", distance/mm);
+  }
+  #endif
+}
+
+#endif
+
+#endif // End of GUARD_GGEMS_NAVIGATORS_GGEMSSOLIDNAVIGATION_HH
@@ -146,12 +146,27 @@ class GGEMS_EXPORT GGEMSSystem : public GGEMSNavigator
     */
     virtual void CheckParameters(void) const override;
 
+    /*!
+      \fn void InitializeHistogram(void)
+      \brief allocate histogram of system, all the modules are stored in this histogram
+    */
+    void InitializeHistogram(void);
+
+    /*!
+      \fn GGsize GetNumberOfHistogramElements(void) const
+      \return number of elements in histogram of system
+      \brief get the number of elements in histogram of system
+    */
+    GGsize GetNumberOfHistogramElements(void) const;
+
   protected:
     GGsize2 number_of_modules_xy_; /*!< Number of the detection modules */
     GGsize3 number_of_detection_elements_inside_module_xyz_; /*!< Number of virtual elements (X,Y,Z) in a module */
     GGfloat3 size_of_detection_elements_xyz_; /*!< Size of pixel in each direction */
     bool is_scatter_; /*!< Boolean storing scatter infos */
     GGfloat3 global_system_position_xyz_; /*!< Global position of the system in X, Y and Z */
+    cl::Buffer** histogram_; /*!< Histogram of all the modules on each OpenCL device */
+    cl::Buffer** scatter_histogram_; /*!< Scatter histogram of all the modules on each OpenCL device */
 };
 
 #endif // End of GUARD_GGEMS_SYSTEMS_GGEMSSYSTEM_HH
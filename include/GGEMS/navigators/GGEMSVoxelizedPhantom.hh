@@ -186,4 +186,12 @@ extern "C" GGEMS_EXPORT void set_material_color_ggems_voxelized_phantom(GGEMSVox
 */
 extern "C" GGEMS_EXPORT void set_material_color_name_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, char const* material_name, char const* color_name);
 
+/*!
+  \fn void set_woodcock_tracking_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, bool const flag)
+  \param voxelized_phantom - pointer on voxelized phantom
+  \param flag - flag activating Woodcock tracking
+  \brief Set Woodcock (delta) tracking of photons in voxelized phantom
+*/
+extern "C" GGEMS_EXPORT void set_woodcock_tracking_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, bool const flag);
+
 #endif // End of GUARD_GGEMS_NAVIGATORS_GGEMSVOXELIZEDPHANTOM_HH
@@ -122,28 +122,28 @@ class GGEMS_EXPORT GGEMSWorld
     /*!
       \fn void SetPhotonTracking(bool const& is_activated)
       \param is_activated - boolean activating photon tracking
-      \brief activating photon tracking in world
+      \brief activating photon tracking in world, number of photons crossing each element
     */
     void SetPhotonTracking(bool const& is_activated);
 
     /*!
       \fn void SetEnergyTracking(bool const& is_activated)
       \param is_activated - boolean activating energy tracking
-      \brief activating energy tracking in world
+      \brief activating energy tracking in world, sum of energy times track length in each element in MeV.mm (energy fluence times element volume), saved in <basename>_world_energy_track_length.mhd
     */
     void SetEnergyTracking(bool const& is_activated);
 
     /*!
       \fn void SetEnergySquaredTracking(bool const& is_activated)
       \param is_activated - boolean activating energy squared tracking
-      \brief activating energy squared tracking in world
+      \brief activating energy squared tracking in world, sum of squared energy times track length in each element in MeV2.mm (mean energy weighted by energy fluence once divided by energy tracking), saved in <basename>_world_energy_squared_track_length.mhd
     */
     void SetEnergySquaredTracking(bool const& is_activated);
 
     /*!
       \fn void SetMomentum(bool const& is_activated)
       \param is_activated - boolean activating sum of momentum in world
-      \brief activating sum of momentum in world
+      \brief activating sum of momentum in world, momentum (energy times direction) is weighted by track length in each element in MeV.mm, saved in <basename>_world_momentum_track_length_[xyz].mhd
     */
     void SetMomentum(bool const& is_activated);
 
@@ -172,6 +172,38 @@ class GGEMS_EXPORT GGEMSWorld
     */
     void EnableTracking(void);
 
+    /*!
+      \fn std::string GetKernelOption(void) const
+      \return the preprocessor options used to compile world kernel
+      \brief get the preprocessor options of world kernel
+    */
+    inline std::string GetKernelOption(void) const {return tracking_kernel_option_;}
+
+    /*!
+      \fn std::string GetTransportKernelParameters(GGsize& parameter_size) const
+      \param parameter_size - size in bytes of kernel parameters, incremented by the world parameters
+      \return declaration of the world parameters in persistent transport kernel
+      \brief get the declaration of the world parameters in persistent transport kernel
+    */
+    std::string GetTransportKernelParameters(GGsize& parameter_size) const;
+
+    /*!
+      \fn std::string GetTransportKernelTracking(void) const
+      \return call tracking particle through world in persistent transport kernel
+      \brief get the call tracking particle through world in persistent transport kernel
+    */
+    std::string GetTransportKernelTracking(void) const;
+
+    /*!
+      \fn GGuint SetTransportKernelArguments(cl::Kernel* kernel, GGuint const& argument_index, GGsize const& thread_index) const
+      \param kernel - pointer to persistent transport kernel
+      \param argument_index - index of the first world argument
+      \param thread_index - index of activated device (thread index)
+      \return index of the next argument
+      \brief set the world arguments of persistent transport kernel
+    */
+    GGuint SetTransportKernelArguments(cl::Kernel* kernel, GGuint const& argument_index, GGsize const& thread_index) const;
+
   private:
     /*!
       \fn void CheckParameters(void) const
@@ -193,19 +225,19 @@ class GGEMS_EXPORT GGEMSWorld
 
     /*!
       \fn void SaveEnergyTracking(void) const
-      \brief save energy tracking
+      \brief save sum of energy times track length
     */
     void SaveEnergyTracking(void) const;
 
     /*!
       \fn void SaveEnergySquaredTracking(void) const
-      \brief save energy squared tracking
+      \brief save sum of squared energy times track length
     */
     void SaveEnergySquaredTracking(void) const;
 
     /*!
       \fn void SaveMomentum(void) const
-      \brief save sum of momentum
+      \brief save sum of momentum times track length
     */
     void SaveMomentum(void) const;
 
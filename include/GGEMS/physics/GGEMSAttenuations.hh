@@ -34,6 +34,7 @@
 #include "GGEMS/global/GGEMSExport.hh"
 #include "GGEMS/tools/GGEMSTypes.hh"
 #include "GGEMS/physics/GGEMSMuData.hh"
+#include "GGEMS/materials/GGEMSMaterialTables.hh"
 
 class GGEMSMaterials;
 class GGEMSCrossSections;
@@ -87,7 +88,7 @@ class GGEMS_EXPORT GGEMSAttenuations
 
     /*!
       \fn void Initialize(void)
-      \brief Initialize all the activated processes computing tables on OpenCL device
+      \brief Initialize attenuation tables computed on host and copying them on each OpenCL device
     */
     void Initialize(void);
 
@@ -105,6 +106,13 @@ class GGEMS_EXPORT GGEMSAttenuations
     */
     inline cl::Buffer* GetAttenuations(GGsize const& thread_index) const {return mu_tables_[thread_index];}
 
+    /*!
+      \fn inline GGsize GetAttenuationsSize(void) const
+      \return the size in bytes of attenuation tables
+      \brief get the size in bytes of attenuation tables, header included
+    */
+    inline GGsize GetAttenuationsSize(void) const {return mu_tables_size_;}
+
     /*!
       \fn GGfloat GetAttenuation(std::string const& material_name, GGfloat const& energy, std::string const& unit) const
       \param material_name - name of the material
@@ -127,10 +135,14 @@ class GGEMS_EXPORT GGEMSAttenuations
 
   private:
     /*!
-      \fn void LoadAttenuationsOnHost(void)
-      \brief Load attenuations coefficients from OpenCL device to RAM. Optimization for python user
+      \fn void ComputeAttenuationsOfBins(GGEMSMuMuEnData* attenuations, GGEMSMaterialTables const* material_tables, GGsize const first_bin, GGsize const last_bin) const
+      \param attenuations - attenuation tables on host
+      \param material_tables - material tables on host
+      \param first_bin - first bin to compute, bins of all materials are numbered one after the other
+      \param last_bin - last bin to compute (excluded)
+      \brief compute mu and mu_en of a part of material and energy bins, called by each host thread
     */
-    void LoadAttenuationsOnHost(void);
+    void ComputeAttenuationsOfBins(GGEMSMuMuEnData* attenuations, GGEMSMaterialTables const* material_tables, GGsize const first_bin, GGsize const last_bin) const;
 
   private:
     GGsize number_activated_devices_; /*!< Number of activated device */
@@ -139,12 +151,13 @@ class GGEMS_EXPORT GGEMSAttenuations
     GGfloat* mu_; /*!< attenuation coefficients */
     GGfloat* mu_en_; /*!< energy-absorption coefficient */
     GGint* mu_index_; /*!< index of attenuation */
-    GGEMSMuMuEnData* attenuations_host_; /*!< Pointer storing attenuations coef. on host (RAM memory) */
+    std::vector<GGuchar> attenuations_host_; /*!< Buffer storing attenuations coef. on host (RAM memory), built once and copied to each OpenCL device */
     GGEMSMaterials* materials_; /*!< Pointer to materials */
     GGEMSCrossSections* cross_sections_; /*!< Pointer to physical cross sections */
 
     // OpenCL Buffer
     cl::Buffer** mu_tables_; /*!< attenuations coefficients on OpenCL device */
+    GGsize mu_tables_size_; /*!< Size in bytes of attenuation tables, sized to the number of materials */
 };
 
 /*!
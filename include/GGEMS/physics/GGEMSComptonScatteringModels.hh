@@ -38,28 +38,24 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn inline void KleinNishinaComptonSampleSecondaries(global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, GGint const particle_id)
+  \fn inline void KleinNishinaComptonSampleSecondaries(global GGEMSPrimaryParticles* primary_particle, GGEMSRandomState* random, GGint const particle_id)
   \param primary_particle - buffer of particles
-  \param random - pointer on random numbers
+  \param random - pointer on random state of the particle in private memory
   \param particle_id - index of the particle
   \brief Klein Nishina Compton model, Effects due to binding of atomic electrons are negliged.
 */
 inline void KleinNishinaComptonSampleSecondaries(
   global GGEMSPrimaryParticles* primary_particle,
-  global GGEMSRandom* random,
+  GGEMSRandomState* random,
   GGint const particle_id
 )
 {
   // Energy
-  GGfloat kE0 = primary_particle->E_[particle_id];
+  GGfloat kE0 = GetParticleEnergy(primary_particle, particle_id);
   GGfloat kE0_MeC2 = kE0 / ELECTRON_MASS_C2;
 
   // Direction
-  GGfloat3 kGammaDirection = {
-    primary_particle->dx_[particle_id],
-    primary_particle->dy_[particle_id],
-    primary_particle->dz_[particle_id]
-  };
+  GGfloat3 kGammaDirection = GetParticleDirection(primary_particle, particle_id);
 
   // sample the energy rate the scattered gamma
   GGfloat kEps0 = 1.0f / (1.0f + 2.0f*kE0_MeC2);
@@ -87,9 +83,9 @@ inline void KleinNishinaComptonSampleSecondaries(
     if (nloop > 1000) return;
 
     // Get 3 random numbers
-    rndm.x = KissUniform(random, particle_id);
-    rndm.y = KissUniform(random, particle_id);
-    rndm.z = KissUniform(random, particle_id);
+    rndm.x = KissUniform(random);
+    rndm.y = KissUniform(random);
+    rndm.z = KissUniform(random);
 
     if (kAlpha1 > kAlpha2*rndm.x) {
       epsilon = exp(-kAlpha1*rndm.y);
@@ -109,7 +105,7 @@ inline void KleinNishinaComptonSampleSecondaries(
   if (sint2 < 0.0f) sint2 = 0.0f;
   costheta = 1.0f - onecost;
   sintheta = sqrt(sint2);
-  phi = KissUniform(random, particle_id) * TWO_PI;
+  phi = KissUniform(random) * TWO_PI;
 
   // Update scattered gamma
   GGfloat3 gamma_direction = {sintheta*cos(phi), sintheta*sin(phi), costheta};
@@ -124,11 +120,9 @@ inline void KleinNishinaComptonSampleSecondaries(
   }
   #endif
 
-  primary_particle->E_[particle_id] = kE1;
+  SetParticleEnergy(primary_particle, particle_id, kE1);
 
-  primary_particle->dx_[particle_id] = gamma_direction.x;
-  primary_particle->dy_[particle_id] = gamma_direction.y;
-  primary_particle->dz_[particle_id] = gamma_direction.z;
+  SetParticleDirection(primary_particle, particle_id, gamma_direction);
 }
 
 #endif
@@ -102,7 +102,7 @@ class GGEMS_EXPORT GGEMSCrossSections
 
     /*!
       \fn void Initialize(void)
-      \brief Initialize all the activated processes computing tables on OpenCL device
+      \brief Initialize all the activated processes computing tables on host and copying them on each OpenCL device
     */
     void Initialize(void);
 
@@ -128,6 +128,13 @@ class GGEMS_EXPORT GGEMSCrossSections
     */
     inline cl::Buffer* GetCrossSections(GGsize const& thread_index) const {return particle_cross_sections_[thread_index];}
 
+    /*!
+      \fn inline GGsize GetCrossSectionsSize(void) const
+      \return the size in bytes of cross sections
+      \brief get the size in bytes of cross sections, header included
+    */
+    inline GGsize GetCrossSectionsSize(void) const {return particle_cross_sections_size_;}
+
     /*!
       \fn GGfloat GetPhotonCrossSection(std::string const& process_name, std::string const& material_name, GGfloat const& energy, std::string const& unit) const
       \param process_name - name of the process
@@ -147,17 +154,18 @@ class GGEMS_EXPORT GGEMSCrossSections
 
   private:
     /*!
-      \fn void LoadPhysicTablesOnHost(void)
-      \brief Load physic tables from OpenCL device to RAM. Optimization for python user
+      \fn void BuildTotalCrossSections(void)
+      \brief Compute the total photon cross section of each material, and for each energy bin the maximum over materials used by Woodcock tracking
     */
-    void LoadPhysicTablesOnHost(void);
+    void BuildTotalCrossSections(void);
 
   private:
     GGEMSEMProcess** em_processes_list_; /*!< vector of electromagnetic processes */
     GGsize number_of_activated_processes_; /*!< Number of activated processes */
     std::vector<bool> is_process_activated_; /*!< Boolean checking if the process is already activated */
     cl::Buffer** particle_cross_sections_; /*!< Pointer storing cross sections for each particles on OpenCL device */
-    GGEMSParticleCrossSections* particle_cross_sections_host_; /*!< Pointer storing cross sections for each particles on host (RAM memory) */
+    GGsize particle_cross_sections_size_; /*!< Size in bytes of cross sections, sized to the number of materials and bins */
+    std::vector<GGuchar> particle_cross_sections_host_; /*!< Buffer storing cross sections for each particles on host (RAM memory), built once and copied to each OpenCL device */
     GGsize number_activated_devices_; /*!< Number of activated device */
     GGEMSMaterials* materials_; /*!< Pointer to material defined in a navigator */
 };
@@ -35,10 +35,14 @@
 #pragma warning(disable: 4251) // Deleting warning exporting STL members!!!
 #endif
 
+#include <thread>
+
 #include "GGEMS/materials/GGEMSMaterialTables.hh"
 #include "GGEMS/global/GGEMSOpenCLManager.hh"
 #include "GGEMS/physics/GGEMSParticleCrossSections.hh"
 
+class GGEMSMaterials;
+
 /*!
   \class GGEMSEMProcess
   \brief GGEMS mother class for electromagnectic process
@@ -92,15 +96,24 @@ class GGEMS_EXPORT GGEMSEMProcess
     inline std::string GetProcessName(void) const {return process_name_;}
 
     /*!
-      \fn void BuildCrossSectionTables(cl::Buffer* particle_cross_sections, cl::Buffer* material_tables, GGsize const& thread_index)
-      \param particle_cross_sections - OpenCL buffer storing all the cross section tables for each particles
-      \param material_tables - material tables on OpenCL device
-      \param thread_index - index of activated device (thread index)
-      \brief build cross section tables and storing them in particle_cross_sections
+      \fn void BuildCrossSectionTables(GGEMSParticleCrossSections* particle_cross_sections, GGEMSMaterials const* materials)
+      \param particle_cross_sections - cross section tables on host for each particles
+      \param materials - materials of the navigator, storing material tables on host
+      \brief build cross section tables on host with all host threads and storing them in particle_cross_sections
     */
-    virtual void BuildCrossSectionTables(cl::Buffer* particle_cross_sections, cl::Buffer* material_tables, GGsize const& thread_index);
+    virtual void BuildCrossSectionTables(GGEMSParticleCrossSections* particle_cross_sections, GGEMSMaterials const* materials);
 
   protected:
+    /*!
+      \fn void ComputeCrossSectionsOfBins(GGEMSParticleCrossSections* particle_cross_sections, GGEMSMaterialTables const* material_tables, GGsize const first_bin, GGsize const last_bin)
+      \param particle_cross_sections - cross section tables on host
+      \param material_tables - material tables on host
+      \param first_bin - first bin to compute, bins of all materials are numbered one after the other
+      \param last_bin - last bin to compute (excluded)
+      \brief compute cross sections of a part of material and energy bins, called by each host thread
+    */
+    void ComputeCrossSectionsOfBins(GGEMSParticleCrossSections* particle_cross_sections, GGEMSMaterialTables const* material_tables, GGsize const first_bin, GGsize const last_bin);
+
     /*!
       \fn GGfloat ComputeCrossSectionPerMaterial(GGEMSParticleCrossSections* cross_section, GGEMSMaterialTables const* material_tables, GGsize const& material_index, GGsize const& energy_index)
       \param cross_section - cross section
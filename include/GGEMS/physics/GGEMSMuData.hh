@@ -37,13 +37,13 @@
 
 /*!
   \struct GGEMSMuMuEnData_t
-  \brief Mu and Mu_en table used by TLE
+  \brief Header of Mu and Mu_en tables used by TLE, the tables are stored after the header in the same buffer and sized to the number of materials, read with GGEMS_TABLE
 */
 typedef struct GGEMSMuMuEnData_t
 {
   GGfloat energy_bins_[ATTENUATION_TABLE_NUMBER_BINS]; /*!< Number of energy bins */
-  GGfloat mu_[256*ATTENUATION_TABLE_NUMBER_BINS]; /*!< attenuation coefficient values for each material (n*k) */
-  GGfloat mu_en_[256*ATTENUATION_TABLE_NUMBER_BINS]; /*!< energy-absorption coefficient for each material (n*k) */
+  GGsize mu_; /*!< Offset of table (GGfloat) - attenuation coefficient values for each material (n*k) */
+  GGsize mu_en_; /*!< Offset of table (GGfloat) - energy-absorption coefficient for each material (n*k) */
 
   GGint number_of_materials_; /*!< Number of materials : k */
   GGint number_of_bins_; /*!< Number of bins : n */
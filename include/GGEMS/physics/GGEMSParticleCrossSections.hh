@@ -35,26 +35,28 @@
 
 /*!
   \struct GGEMSParticleCrossSections_t
-  \brief Structure storing the photon cross sections for OpenCL device
+  \brief Header of the photon cross sections for OpenCL device, the tables are stored after the header in the same buffer and sized to the number of materials, chemical elements, activated processes and bins. Table members store the offset in bytes of the table, read with GGEMS_TABLE
 */
 typedef struct GGEMSParticleCrossSections_t
 {
   // Variables for all particles
   GGsize number_of_bins_; /*!< Number of bins in the cross section tables */
   GGsize number_of_materials_; /*!< Number of materials */
+  GGsize total_number_of_chemical_elements_; /*!< Total number of chemical elements in materials */
   GGfloat min_energy_; /*!< Min energy in the cross section table */
   GGfloat max_energy_; /*!< Max energy in the cross section table */
-  GGfloat energy_bins_[MAX_CROSS_SECTION_TABLE_NUMBER_BINS]; /*!< Energy in bin (220 by default) */
+  GGsize energy_bins_; /*!< Offset of table (GGfloat) - Energy in bin, number_of_bins_ values (220 by default) */
+  GGfloat log_min_energy_; /*!< Log of first energy bin, energy bins are log-spaced so index of energy is computed directly */
+  GGfloat inverse_log_energy_step_; /*!< Inverse of log step between two energy bins */
 
   // Photon
-  // 256: Max number of materials [0...255]
-  // MAX_CROSS_SECTION_TABLE_NUMBER_BINS: Max number of bins [0...2047]
-  GGfloat photon_cross_sections_[NUMBER_PHOTON_PROCESSES][256*MAX_CROSS_SECTION_TABLE_NUMBER_BINS]; /*!< Photon cross sections per material in mm-1 */
-  GGfloat photon_cross_sections_per_atom_[NUMBER_PHOTON_PROCESSES][101*MAX_CROSS_SECTION_TABLE_NUMBER_BINS]; /*!< Photon cross sections per atom in mm-1, 100 chemical elements + 1 first empty element */
+  // Offset is 0 for a process not activated, no table is stored for it
+  GGsize photon_cross_sections_[NUMBER_PHOTON_PROCESSES]; /*!< Offset of tables (GGfloat) - Photon cross sections per material in mm-1, number_of_materials_*number_of_bins_ values by activated process */
+  GGsize photon_cross_sections_per_atom_[NUMBER_PHOTON_PROCESSES]; /*!< Offset of tables (GGfloat) - Photon cross sections per atom in mm-1, total_number_of_chemical_elements_*number_of_bins_ values by activated process, indexed as the chemical elements in material tables */
   GGsize number_of_activated_photon_processes_; /*!< Number of activated photon processes, 3 processes -> 0: Compton, 1: Photoelectric, 2: Rayleigh */
   GGchar photon_cs_id_[NUMBER_PHOTON_PROCESSES]; /*!< Index of activated photon process, ex: if only Rayleigh activate index_photon_cs[0] = 2 */
-
-  GGchar material_names_[256][64]; /*!< Name of the materials */
+  GGsize photon_total_cross_sections_; /*!< Offset of table (GGfloat) - Sum of activated photon cross sections per material in mm-1, number_of_materials_*number_of_bins_ values */
+  GGsize photon_majorant_cross_sections_; /*!< Offset of table (GGfloat) - Maximum over materials of the sum of activated photon cross sections in mm-1, number_of_bins_ values, for Woodcock tracking */
 } GGEMSParticleCrossSections; /*!< Using C convention name of struct to C++ (_t deletion) */
 
 #endif // GUARD_GGEMS_PHYSICS_GGEMSPARTICLECROSSSECTIONS_HH
@@ -91,37 +91,142 @@ class GGEMS_EXPORT GGEMSParticles
     */
     void Initialize(void);
 
+    /*!
+      \fn void SetNumberOfStacks(GGsize const& number_of_stacks)
+      \param number_of_stacks - number of particle stacks by device, 1 by default, 2 for pipelined run
+      \brief Set the number of particle stacks allocated on each device, must be called before Initialize
+    */
+    void SetNumberOfStacks(GGsize const& number_of_stacks);
+
+    /*!
+      \fn inline GGsize GetNumberOfStacks(void) const
+      \return number of particle stacks by device
+      \brief Get the number of particle stacks by device
+    */
+    inline GGsize GetNumberOfStacks(void) const {return number_of_stacks_;}
+
+    /*!
+      \fn inline GGsize GetActiveStack(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return index of the stack currently transported
+      \brief Get the index of the stack currently transported
+    */
+    inline GGsize GetActiveStack(GGsize const& thread_index) const {return active_stack_[thread_index];}
+
+    /*!
+      \fn inline GGsize GetNextStack(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return index of the stack transported after the active one
+      \brief Get the index of the stack transported after the active one
+    */
+    inline GGsize GetNextStack(GGsize const& thread_index) const {return (active_stack_[thread_index] + 1) % number_of_stacks_;}
+
+    /*!
+      \fn void SwapStacks(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \brief Activate the next stack of particles
+    */
+    void SwapStacks(GGsize const& thread_index);
+
     /*!
       \fn inline cl::Buffer* GetPrimaryParticles(GGsize const& thread_index) const
       \param thread_index - index of activated device (thread index)
       \return pointer to OpenCL buffer storing particles
-      \brief return the pointer to OpenCL buffer storing particles
+      \brief return the pointer to OpenCL buffer storing particles of the active stack
+    */
+    inline cl::Buffer* GetPrimaryParticles(GGsize const& thread_index) const {return primary_particles_[thread_index*number_of_stacks_ + active_stack_[thread_index]];}
+
+    /*!
+      \fn inline cl::Buffer* GetPrimaryParticles(GGsize const& thread_index, GGsize const& stack_index) const
+      \param thread_index - index of activated device (thread index)
+      \param stack_index - index of the particle stack
+      \return pointer to OpenCL buffer storing particles
+      \brief return the pointer to OpenCL buffer storing particles of a specific stack
     */
-    inline cl::Buffer* GetPrimaryParticles(GGsize const& thread_index) const {return primary_particles_[thread_index];}
+    inline cl::Buffer* GetPrimaryParticles(GGsize const& thread_index, GGsize const& stack_index) const {return primary_particles_[thread_index*number_of_stacks_ + stack_index];}
 
     /*!
-      \fn void SetNumberOfParticles(GGsize const& thread_index, GGsize const& number_of_particles)
+      \fn void SetNumberOfParticles(GGsize const& thread_index, GGsize const& number_of_particles, GGsize const& stack_index)
       \param thread_index - index of activated device (thread index)
       \param number_of_particles - number of activated particles in buffer
+      \param stack_index - index of the particle stack
       \brief Set the number of particles in buffer
     */
-    void SetNumberOfParticles(GGsize const& thread_index, GGsize const& number_of_particles);
+    void SetNumberOfParticles(GGsize const& thread_index, GGsize const& number_of_particles, GGsize const& stack_index);
 
     /*!
       \fn inline GGsize GetNumberOfParticles(GGsize const& thread_index) const
       \param thread_index - index of activated device (thread index)
       \return number of particles currently activated in OpenCL buffer
-      \brief Get the number of particles on activated device
+      \brief Get the number of particles of the active stack on activated device
+    */
+    inline GGsize GetNumberOfParticles(GGsize const& thread_index) const {return number_of_particles_[thread_index*number_of_stacks_ + active_stack_[thread_index]];}
+
+    /*!
+      \fn void SetAliveCompaction(bool const& is_alive_compaction)
+      \param is_alive_compaction - flag for compaction of alive particles
+      \brief Build a list of alive particles at each check, kernels are then launched only over alive particles, must be called before Initialize
+    */
+    void SetAliveCompaction(bool const& is_alive_compaction);
+
+    /*!
+      \fn inline bool IsAliveCompaction(void) const
+      \return true if alive particles are compacted
+      \brief check if lists of alive particles are used
+    */
+    inline bool IsAliveCompaction(void) const {return is_alive_compaction_;}
+
+    /*!
+      \fn void SetOpenGLTrajectories(bool const& is_opengl_trajectories)
+      \param is_opengl_trajectories - flag for storage of trajectories for OpenGL
+      \brief Allocate trajectories for OpenGL at the end of primary particles, must be called before Initialize
+    */
+    void SetOpenGLTrajectories(bool const& is_opengl_trajectories);
+
+    /*!
+      \fn inline bool IsOpenGLTrajectories(void) const
+      \return true if trajectories for OpenGL are stored
+      \brief check if trajectories for OpenGL are allocated in primary particles
+    */
+    inline bool IsOpenGLTrajectories(void) const {return is_opengl_trajectories_;}
+
+    /*!
+      \fn void ResetAliveParticles(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \brief Forget the list of alive particles, all the particles of the active stack are transported
+    */
+    void ResetAliveParticles(GGsize const& thread_index);
+
+    /*!
+      \fn inline cl::Buffer* GetAliveParticles(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return pointer to OpenCL buffer storing number of alive particles followed by their indices, nullptr if particles are not compacted
+      \brief return the pointer to OpenCL buffer storing the list of alive particles
+    */
+    inline cl::Buffer* GetAliveParticles(GGsize const& thread_index) const {return active_alive_particles_[thread_index] < 0 ? nullptr : alive_particles_[thread_index*2 + active_alive_particles_[thread_index]];}
+
+    /*!
+      \fn inline GGsize GetNumberOfAliveParticles(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return upper bound of number of alive particles, used as number of work-items by transport kernels
+      \brief Get the number of alive particles known by host, exact number is read in list of alive particles by kernels
+    */
+    inline GGsize GetNumberOfAliveParticles(GGsize const& thread_index) const {return active_alive_particles_[thread_index] < 0 ? GetNumberOfParticles(thread_index) : number_of_alive_particles_[thread_index];}
+
+    /*!
+      \fn void CheckAlive(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \brief count asynchronously alive particles in OpenCL particle buffer, the result is read back in pinned host memory without blocking the host. In compaction mode the list of alive particles is built in same time
     */
-    inline GGsize GetNumberOfParticles(GGsize const& thread_index) const {return number_of_particles_[thread_index];}
+    void CheckAlive(GGsize const& thread_index);
 
     /*!
-      \fn bool IsAlive(GGsize const& thread_index) const
+      \fn bool IsAlive(GGsize const& thread_index)
       \param thread_index - index of activated device (thread index)
       \return true if source is still alive, otherwize false
-      \brief check if some particles are alive in OpenCL particle buffer
+      \brief wait for the last check of alive particles (CheckAlive) and return its result
     */
-    bool IsAlive(GGsize const& thread_index) const;
+    bool IsAlive(GGsize const& thread_index);
 
     /*!
       \fn void Dump(std::string const& message) const
@@ -143,12 +248,39 @@ class GGEMS_EXPORT GGEMSParticles
     */
     void InitializeKernel(void);
 
+    /*!
+      \fn void CompactAlive(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \brief build asynchronously the list of alive particles, the number of alive particles is read back in pinned host memory
+    */
+    void CompactAlive(GGsize const& thread_index);
+
+  private:
+    /*!
+      \fn GGsize GetPrimaryParticlesBufferSize(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return size in bytes of a primary particles buffer on device
+      \brief get the size of primary particles buffer, with trajectories for OpenGL if activated
+    */
+    GGsize GetPrimaryParticlesBufferSize(GGsize const& thread_index) const;
+
   private:
-    GGsize* number_of_particles_; /*!< Number of activated particles in buffer */
-    cl::Buffer** primary_particles_; /*!< Pointer storing info about primary particles in batch on OpenCL device */
-    cl::Buffer** status_; /*!< Buffer storing status of particle */
+    GGsize* number_of_particles_; /*!< Number of activated particles in buffer, for each stack of each device */
+    cl::Buffer** primary_particles_; /*!< Pointer storing info about primary particles in batch on OpenCL device, for each stack of each device */
+    GGsize number_of_stacks_; /*!< Number of particle stacks by device */
+    GGsize* active_stack_; /*!< Index of the stack currently transported on each device */
+    cl::Buffer** status_; /*!< Buffer storing number of alive particles */
+    cl::Buffer** status_pinned_; /*!< Buffer in pinned host memory receiving number of alive particles */
+    GGint** status_pinned_ptr_; /*!< Host pointer mapped on pinned buffer */
+    cl::Event* status_event_; /*!< Event of the last read back of the number of alive particles */
     GGsize number_activated_devices_; /*!< Number of activated device */
     cl::Kernel** kernel_alive_; /*!< Kernel checking if particles are alive */
+    bool is_alive_compaction_; /*!< Flag for compaction of alive particles */
+    cl::Buffer** alive_particles_; /*!< Two lists of alive particles by device, number of alive particles followed by their indices */
+    GGint* active_alive_particles_; /*!< Index of list of alive particles used by kernels, -1 if particles are not compacted */
+    GGsize* number_of_alive_particles_; /*!< Number of alive particles read back for each device */
+    cl::Kernel** kernel_compact_alive_; /*!< Kernel building list of alive particles */
+    bool is_opengl_trajectories_; /*!< Flag for storage of trajectories for OpenGL */
 };
 
 #endif // End of GUARD_GGEMS_PHYSICS_GGEMSPARTICLES_HH
@@ -48,8 +48,8 @@ inline void StandardPhotoElectricSampleSecondaries(
   GGint const particle_id
 )
 {
-  primary_particle->status_[particle_id] = DEAD;
-  primary_particle->E_[particle_id] = 0.0f;
+  SetParticleStatus(primary_particle, particle_id, DEAD);
+  SetParticleEnergy(primary_particle, particle_id, 0.0f);
 }
 
 #endif
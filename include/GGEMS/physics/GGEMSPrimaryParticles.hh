@@ -35,14 +35,21 @@
 #include "GGEMS/tools/GGEMSTypes.hh"
 #include "GGEMS/physics/GGEMSParticleConstants.hh"
 
+#ifdef __OPENCL_C_VERSION__
+
 /*!
   \struct GGEMSPrimaryParticles_t
-  \brief Structure storing informations about primary particles
+  \brief Structure storing informations about primary particles. MAXIMUM_PARTICLES is the size of particle stack on device, given at kernel compilation by GGEMSOpenCLManager. Position, direction, energy and state of particles must be read and written using accessors below, the layout depends on COMPACT_PARTICLES option
 */
 typedef struct GGEMSPrimaryParticles_t
 {
   GGint particle_tracking_id; /*!< Particle id for tracking */
 
+  #ifdef COMPACT_PARTICLES
+  GGfloat4 position_energy_[MAXIMUM_PARTICLES]; /*!< Position of the particle in x, y and z, energy in w */
+  GGfloat2 direction_[MAXIMUM_PARTICLES]; /*!< Direction of the particle, octahedral encoding */
+  GGuint state_[MAXIMUM_PARTICLES]; /*!< Next process, status, level, particle name and scatter flag packed in a word */
+  #else
   GGfloat E_[MAXIMUM_PARTICLES]; /*!< Energies of particles */
   GGfloat dx_[MAXIMUM_PARTICLES]; /*!< Direction of the particle in x */
   GGfloat dy_[MAXIMUM_PARTICLES]; /*!< Direction of the particle in y */
@@ -51,22 +58,495 @@ typedef struct GGEMSPrimaryParticles_t
   GGfloat py_[MAXIMUM_PARTICLES]; /*!< Position of the particle in y */
   GGfloat pz_[MAXIMUM_PARTICLES]; /*!< Position of the particle in z */
   GGchar scatter_[MAXIMUM_PARTICLES]; /*!< Index of scattered photon */
+  #endif
 
   GGint E_index_[MAXIMUM_PARTICLES]; /*!< Energy index within CS and Mat tables */
   GGint solid_id_[MAXIMUM_PARTICLES]; /*!< current solid crossed by the particle */
 
   GGfloat particle_solid_distance_[MAXIMUM_PARTICLES]; /*!< Distance from previous position to next position, OUT_OF_WORLD if no next position */
   GGfloat next_interaction_distance_[MAXIMUM_PARTICLES]; /*!< Distance to the next interaction */
+  GGfloat number_of_mean_free_paths_[MAXIMUM_PARTICLES]; /*!< Remaining number of mean free paths before next interaction, negative if a new number has to be sampled */
+
+  #ifndef COMPACT_PARTICLES
   GGchar next_discrete_process_[MAXIMUM_PARTICLES]; /*!< Next process */
 
   GGchar status_[MAXIMUM_PARTICLES]; /*!< Status of the particle */
   GGchar level_[MAXIMUM_PARTICLES]; /*!< Level of the particle */
   GGchar pname_[MAXIMUM_PARTICLES]; /*!< particle name (photon, electron, etc) */
+  #endif
 
+  #ifdef OPENGL
+  // Trajectories for OpenGL, allocated only if OpenGL visualization is activated
   GGfloat px_gl_[MAXIMUM_DISPLAYED_PARTICLES*MAXIMUM_INTERACTIONS]; /*!< Position in X of primary particles interactions */
   GGfloat py_gl_[MAXIMUM_DISPLAYED_PARTICLES*MAXIMUM_INTERACTIONS]; /*!< Position in Y of primary particles interactions */
   GGfloat pz_gl_[MAXIMUM_DISPLAYED_PARTICLES*MAXIMUM_INTERACTIONS]; /*!< Position in Z of primary particles interactions */
   GGint stored_particles_gl_[MAXIMUM_DISPLAYED_PARTICLES]; /*!< index to current interaction particle to store */
+  #endif
 } GGEMSPrimaryParticles; /*!< Using C convention name of struct to C++ (_t deletion) */
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef COMPACT_PARTICLES
+
+#define NEXT_DISCRETE_PROCESS_SHIFT 0 /*!< Bit offset of next discrete process in state word */
+#define STATUS_SHIFT 8 /*!< Bit offset of status in state word */
+#define LEVEL_SHIFT 16 /*!< Bit offset of level in state word */
+#define PNAME_SHIFT 24 /*!< Bit offset of particle name in state word, 4 bits */
+#define SCATTER_SHIFT 28 /*!< Bit offset of scatter flag in state word, 1 bit */
+
+/*!
+  \fn inline GGchar GetStateField(GGuint const state, GGuint const shift, GGuint const mask)
+  \param state - packed state word
+  \param shift - bit offset of the field
+  \param mask - mask of the field
+  \return value of the field
+  \brief extract a field from the packed state word of a particle
+*/
+inline GGchar GetStateField(GGuint const state, GGuint const shift, GGuint const mask)
+{
+  return (GGchar)((state >> shift) & mask);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGuint SetStateField(GGuint const state, GGuint const shift, GGuint const mask, GGchar const value)
+  \param state - packed state word
+  \param shift - bit offset of the field
+  \param mask - mask of the field
+  \param value - new value of the field
+  \return updated state word
+  \brief replace a field in the packed state word of a particle
+*/
+inline GGuint SetStateField(GGuint const state, GGuint const shift, GGuint const mask, GGchar const value)
+{
+  return (state & ~(mask << shift)) | (((GGuint)(GGuchar)value & mask) << shift);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat2 EncodeOctahedralDirection(GGfloat3 const direction)
+  \param direction - unit direction
+  \return direction projected on octahedron and unfolded on [-1, 1]^2
+  \brief encode a unit direction in 2 floats
+*/
+inline GGfloat2 EncodeOctahedralDirection(GGfloat3 const direction)
+{
+  GGfloat2 encoded = direction.xy / (fabs(direction.x) + fabs(direction.y) + fabs(direction.z));
+
+  // Folding lower hemisphere
+  if (direction.z < 0.0f) {
+    GGfloat2 sign_not_zero = (GGfloat2)(encoded.x >= 0.0f ? 1.0f : -1.0f, encoded.y >= 0.0f ? 1.0f : -1.0f);
+    encoded = (1.0f - fabs(encoded.yx)) * sign_not_zero;
+  }
+
+  return encoded;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat3 DecodeOctahedralDirection(GGfloat2 const encoded)
+  \param encoded - direction encoded by EncodeOctahedralDirection
+  \return unit direction
+  \brief decode a direction stored in 2 floats
+*/
+inline GGfloat3 DecodeOctahedralDirection(GGfloat2 const encoded)
+{
+  GGfloat3 direction = (GGfloat3)(encoded.x, encoded.y, 1.0f - fabs(encoded.x) - fabs(encoded.y));
+
+  // Unfolding lower hemisphere
+  if (direction.z < 0.0f) {
+    GGfloat2 sign_not_zero = (GGfloat2)(direction.x >= 0.0f ? 1.0f : -1.0f, direction.y >= 0.0f ? 1.0f : -1.0f);
+    direction.xy = (1.0f - fabs(direction.yx)) * sign_not_zero;
+  }
+
+  return normalize(direction);
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat3 GetParticlePosition(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \return position of the particle
+  \brief get the position of a particle
+*/
+inline GGfloat3 GetParticlePosition(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+{
+  #ifdef COMPACT_PARTICLES
+  return primary_particle->position_energy_[particle_id].xyz;
+  #else
+  return (GGfloat3)(primary_particle->px_[particle_id], primary_particle->py_[particle_id], primary_particle->pz_[particle_id]);
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void SetParticlePosition(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGfloat3 const position)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \param position - new position of the particle
+  \brief set the position of a particle
+*/
+inline void SetParticlePosition(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGfloat3 const position)
+{
+  #ifdef COMPACT_PARTICLES
+  primary_particle->position_energy_[particle_id].xyz = position;
+  #else
+  primary_particle->px_[particle_id] = position.x;
+  primary_particle->py_[particle_id] = position.y;
+  primary_particle->pz_[particle_id] = position.z;
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat3 GetParticleDirection(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \return direction of the particle
+  \brief get the direction of a particle
+*/
+inline GGfloat3 GetParticleDirection(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+{
+  #ifdef COMPACT_PARTICLES
+  return DecodeOctahedralDirection(primary_particle->direction_[particle_id]);
+  #else
+  return (GGfloat3)(primary_particle->dx_[particle_id], primary_particle->dy_[particle_id], primary_particle->dz_[particle_id]);
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void SetParticleDirection(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGfloat3 const direction)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \param direction - new unit direction of the particle
+  \brief set the direction of a particle
+*/
+inline void SetParticleDirection(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGfloat3 const direction)
+{
+  #ifdef COMPACT_PARTICLES
+  primary_particle->direction_[particle_id] = EncodeOctahedralDirection(direction);
+  #else
+  primary_particle->dx_[particle_id] = direction.x;
+  primary_particle->dy_[particle_id] = direction.y;
+  primary_particle->dz_[particle_id] = direction.z;
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat GetParticleEnergy(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \return energy of the particle
+  \brief get the energy of a particle
+*/
+inline GGfloat GetParticleEnergy(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+{
+  #ifdef COMPACT_PARTICLES
+  return primary_particle->position_energy_[particle_id].w;
+  #else
+  return primary_particle->E_[particle_id];
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void SetParticleEnergy(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGfloat const energy)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \param energy - new energy of the particle
+  \brief set the energy of a particle
+*/
+inline void SetParticleEnergy(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGfloat const energy)
+{
+  #ifdef COMPACT_PARTICLES
+  primary_particle->position_energy_[particle_id].w = energy;
+  #else
+  primary_particle->E_[particle_id] = energy;
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGchar GetParticleStatus(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \return status of the particle
+  \brief get the status of a particle
+*/
+inline GGchar GetParticleStatus(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+{
+  #ifdef COMPACT_PARTICLES
+  return GetStateField(primary_particle->state_[particle_id], STATUS_SHIFT, 0xff);
+  #else
+  return primary_particle->status_[particle_id];
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void SetParticleStatus(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGchar const status)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \param status - new status of the particle
+  \brief set the status of a particle
+*/
+inline void SetParticleStatus(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGchar const status)
+{
+  #ifdef COMPACT_PARTICLES
+  primary_particle->state_[particle_id] = SetStateField(primary_particle->state_[particle_id], STATUS_SHIFT, 0xff, status);
+  #else
+  primary_particle->status_[particle_id] = status;
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGchar GetParticleLevel(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \return level of the particle
+  \brief get the level of a particle
+*/
+inline GGchar GetParticleLevel(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+{
+  #ifdef COMPACT_PARTICLES
+  return GetStateField(primary_particle->state_[particle_id], LEVEL_SHIFT, 0xff);
+  #else
+  return primary_particle->level_[particle_id];
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void SetParticleLevel(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGchar const level)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \param level - new level of the particle
+  \brief set the level of a particle
+*/
+inline void SetParticleLevel(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGchar const level)
+{
+  #ifdef COMPACT_PARTICLES
+  primary_particle->state_[particle_id] = SetStateField(primary_particle->state_[particle_id], LEVEL_SHIFT, 0xff, level);
+  #else
+  primary_particle->level_[particle_id] = level;
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGchar GetParticleName(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \return name of the particle
+  \brief get the name of a particle
+*/
+inline GGchar GetParticleName(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+{
+  #ifdef COMPACT_PARTICLES
+  return GetStateField(primary_particle->state_[particle_id], PNAME_SHIFT, 0x0f);
+  #else
+  return primary_particle->pname_[particle_id];
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void SetParticleName(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGchar const particle_name)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \param particle_name - new name of the particle
+  \brief set the name of a particle
+*/
+inline void SetParticleName(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGchar const particle_name)
+{
+  #ifdef COMPACT_PARTICLES
+  primary_particle->state_[particle_id] = SetStateField(primary_particle->state_[particle_id], PNAME_SHIFT, 0x0f, particle_name);
+  #else
+  primary_particle->pname_[particle_id] = particle_name;
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGchar GetParticleScatter(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \return scatter flag of the particle
+  \brief get the scatter flag of a particle
+*/
+inline GGchar GetParticleScatter(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+{
+  #ifdef COMPACT_PARTICLES
+  return GetStateField(primary_particle->state_[particle_id], SCATTER_SHIFT, 0x01);
+  #else
+  return primary_particle->scatter_[particle_id];
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void SetParticleScatter(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGchar const scatter)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \param scatter - new scatter flag of the particle
+  \brief set the scatter flag of a particle
+*/
+inline void SetParticleScatter(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGchar const scatter)
+{
+  #ifdef COMPACT_PARTICLES
+  primary_particle->state_[particle_id] = SetStateField(primary_particle->state_[particle_id], SCATTER_SHIFT, 0x01, scatter);
+  #else
+  primary_particle->scatter_[particle_id] = scatter;
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGchar GetParticleNextDiscreteProcess(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \return next discrete process of the particle
+  \brief get the next discrete process of a particle
+*/
+inline GGchar GetParticleNextDiscreteProcess(global GGEMSPrimaryParticles const* primary_particle, GGint const particle_id)
+{
+  #ifdef COMPACT_PARTICLES
+  return GetStateField(primary_particle->state_[particle_id], NEXT_DISCRETE_PROCESS_SHIFT, 0xff);
+  #else
+  return primary_particle->next_discrete_process_[particle_id];
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void SetParticleNextDiscreteProcess(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGchar const next_discrete_process)
+  \param primary_particle - pointer on primary particles on device
+  \param particle_id - index of the particle
+  \param next_discrete_process - new next discrete process of the particle
+  \brief set the next discrete process of a particle
+*/
+inline void SetParticleNextDiscreteProcess(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id, GGchar const next_discrete_process)
+{
+  #ifdef COMPACT_PARTICLES
+  primary_particle->state_[particle_id] = SetStateField(primary_particle->state_[particle_id], NEXT_DISCRETE_PROCESS_SHIFT, 0xff, next_discrete_process);
+  #else
+  primary_particle->next_discrete_process_[particle_id] = next_discrete_process;
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGint GetParticleID(GGsize const global_id, GGsize const particle_id_limit, global GGint const* alive_particles)
+  \param global_id - index of work-item
+  \param particle_id_limit - particle id limit
+  \param alive_particles - number of alive particles followed by their indices, null if particles are not compacted
+  \return index of particle in primary particles, -1 if no particle for the work-item
+  \brief get index of particle handled by a work-item
+*/
+inline GGint GetParticleID(GGsize const global_id, GGsize const particle_id_limit, global GGint const* alive_particles)
+{
+  if (alive_particles) return global_id < (GGsize)alive_particles[0] ? alive_particles[global_id+1] : -1;
+
+  return global_id < particle_id_limit ? (GGint)global_id : -1;
+}
+
+#else
+
+/*!
+  \fn inline GGsize GetPrimaryParticlesSize(GGsize const& number_of_particles)
+  \param number_of_particles - size of particle stack, multiple of 8
+  \return size in bytes of GGEMSPrimaryParticles on OpenCL device without OpenGL members, offset of px_gl_ if OpenGL is activated
+  \brief get the size of primary particles on OpenCL device, must be updated with members of GGEMSPrimaryParticles
+*/
+inline GGsize GetPrimaryParticlesSize(GGsize const& number_of_particles)
+{
+  #ifdef COMPACT_PARTICLES
+  // particle_tracking_id padded to the 16 bytes alignment of float4, then 1 float4, 1 float2, 1 uint, 3 floats and 2 integers by particle
+  return 4*sizeof(GGint) + number_of_particles*(4*sizeof(GGfloat) + 2*sizeof(GGfloat) + sizeof(GGuint) + 3*sizeof(GGfloat) + 2*sizeof(GGint));
+  #else
+  // particle_tracking_id, then 10 floats, 2 integers and 5 chars by particle, no padding if size of stack is a multiple of 8
+  return sizeof(GGint) + number_of_particles*(10*sizeof(GGfloat) + 2*sizeof(GGint) + 5*sizeof(GGchar));
+  #endif
+}
+
+/*!
+  \fn inline GGsize GetPrimaryParticlesOpenGLSize(void)
+  \return size in bytes of OpenGL members of GGEMSPrimaryParticles
+  \brief get the size of trajectories stored at the end of primary particles if OpenGL is activated
+*/
+inline GGsize GetPrimaryParticlesOpenGLSize(void)
+{
+  return MAXIMUM_DISPLAYED_PARTICLES*MAXIMUM_INTERACTIONS*3*sizeof(GGfloat) + MAXIMUM_DISPLAYED_PARTICLES*sizeof(GGint);
+}
+
+#endif
+
 #endif // GUARD_GGEMS_PHYSICS_GGEMSPRIMARYPARTICLESSTACK_HH
@@ -31,9 +31,19 @@
   \date Monday March 9, 2020
 */
 
+#ifdef _MSC_VER
+#pragma warning(disable: 4251) // Deleting warning exporting STL members!!!
+#endif
+
+#include <string>
+#include <vector>
+
 #include "GGEMS/global/GGEMSExport.hh"
 #include "GGEMS/physics/GGEMSProcessConstants.hh"
 
+#define PHYSIC_TABLES_CACHE_MAGIC "GGEMS_PHYSIC_TABLES_1" /*!< Header of physic tables in cache, changed if file format changes */
+#define PHYSIC_TABLES_VERSION 1 /*!< Version of the computation of physic tables (models, table layout), incremented at each change to invalidate cache */
+
 /*!
   \class GGEMSProcessesManager
   \brief GGEMS class managing the processes in GGEMS simulation
@@ -170,6 +180,46 @@ class GGEMS_EXPORT GGEMSProcessesManager
     */
     inline bool IsPrintPhysicTables(void) const {return is_processes_print_tables_;}
 
+    /*!
+      \fn void SetPhysicTablesCachePath(std::string const& physic_tables_cache_path)
+      \param physic_tables_cache_path - directory storing physic tables, empty string to disable the cache
+      \brief set the directory of the on-disk cache of physic tables, disabled by default
+    */
+    void SetPhysicTablesCachePath(std::string const& physic_tables_cache_path);
+
+    /*!
+      \fn inline bool IsPhysicTablesCache(void) const
+      \return true if the cache of physic tables is activated
+      \brief check if the cache of physic tables is activated
+    */
+    inline bool IsPhysicTablesCache(void) const {return !physic_tables_cache_path_.empty();}
+
+    /*!
+      \fn bool LoadPhysicTables(std::string const& cache_key, GGsize const& tables_size, std::vector<GGuchar>& tables) const
+      \param cache_key - key of the physic tables, describing all parameters used to compute them
+      \param tables_size - expected size in bytes of the tables
+      \param tables - buffer storing the tables
+      \return true if the tables are loaded from the cache, otherwize false
+      \brief load physic tables from the cache, invalid entries are removed from the cache. Tables computed by another version of GGEMS or of the physic tables are never loaded
+    */
+    bool LoadPhysicTables(std::string const& cache_key, GGsize const& tables_size, std::vector<GGuchar>& tables) const;
+
+    /*!
+      \fn std::string GetPhysicTablesCacheKey(std::string const& cache_key) const
+      \param cache_key - key of the physic tables, describing all parameters used to compute them
+      \return key of the physic tables with the versions of GGEMS and of the physic tables
+      \brief get the full key of physic tables in cache
+    */
+    std::string GetPhysicTablesCacheKey(std::string const& cache_key) const;
+
+    /*!
+      \fn void SavePhysicTables(std::string const& cache_key, std::vector<GGuchar> const& tables)
+      \param cache_key - key of the physic tables, describing all parameters used to compute them
+      \param tables - buffer storing the tables
+      \brief store computed physic tables in the cache
+    */
+    void SavePhysicTables(std::string const& cache_key, std::vector<GGuchar> const& tables);
+
     /*!
       \fn void Clean(void)
       \brief clean OpenCL data if necessary
@@ -181,6 +231,7 @@ class GGEMS_EXPORT GGEMSProcessesManager
     GGfloat cross_section_table_min_energy_; /*!< Minimum energy in the cross section table */
     GGfloat cross_section_table_max_energy_; /*!< Maximum energy in the cross section table */
     bool is_processes_print_tables_; /*!< Flag for physic tables printing */
+    std::string physic_tables_cache_path_; /*!< Directory of the cache of physic tables, empty if cache is disabled */
 };
 
 /*!
@@ -248,4 +299,12 @@ extern "C" GGEMS_EXPORT void print_available_processes_manager(GGEMSProcessesMan
 */
 extern "C" GGEMS_EXPORT void print_tables_processes_manager(GGEMSProcessesManager* processes_manager, bool const is_processes_print_tables);
 
+/*!
+  \fn void set_physic_tables_cache_path_processes_manager(GGEMSProcessesManager* processes_manager, char const* physic_tables_cache_path)
+  \param processes_manager - pointer on the processes manager
+  \param physic_tables_cache_path - directory storing physic tables, empty string to disable the cache
+  \brief set the directory of the cache of physic tables
+*/
+extern "C" GGEMS_EXPORT void set_physic_tables_cache_path_processes_manager(GGEMSProcessesManager* processes_manager, char const* physic_tables_cache_path);
+
 #endif // GUARD_GGEMS_PHYSICS_GGEMSRANGECUTSMANAGER_HH
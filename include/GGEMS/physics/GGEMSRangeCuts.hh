@@ -35,6 +35,8 @@
 #pragma warning(disable: 4251) // Deleting warning exporting STL members!!!
 #endif
 
+#include <thread>
+
 #include "GGEMS/materials/GGEMSMaterials.hh"
 
 class GGEMSMaterials;
@@ -157,10 +159,26 @@ class GGEMS_EXPORT GGEMSRangeCuts
     */
     void ConvertCutsFromDistanceToEnergy(GGEMSMaterials* materials);
 
+    /*!
+      \fn void StoreEnergyCuts(GGEMSMaterials const* materials)
+      \param materials - pointer on the list of activated materials
+      \brief Store the energy cuts of material tables by material name
+    */
+    void StoreEnergyCuts(GGEMSMaterials const* materials);
+
   private:
+    /*!
+      \fn void ConvertCutsOfMaterials(GGEMSMaterialTables* material_table, GGsize const first_material, GGsize const last_material)
+      \param material_table - material tables on host
+      \param first_material - first material to convert
+      \param last_material - last material to convert (excluded)
+      \brief convert cuts of a part of materials, called by each host thread with its own range cuts
+    */
+    void ConvertCutsOfMaterials(GGEMSMaterialTables* material_table, GGsize const first_material, GGsize const last_material);
+
     /*!
       \fn GGfloat ConvertToEnergy(GGEMSMaterialTables* material_table, GGushort const& index_mat, std::string const& particle_name)
-      \param material_table - material table on OpenCL device
+      \param material_table - material tables on host
       \param index_mat - index of the material
       \param particle_name - name of the particle
       \return energy cut of photon
@@ -170,7 +188,7 @@ class GGEMS_EXPORT GGEMSRangeCuts
 
     /*!
       \fn void BuildElementsLossTable(GGEMSMaterialTables* material_table, GGushort const& index_mat, std::string const& particle_name)
-      \param material_table - material table on OpenCL device
+      \param material_table - material tables on host
       \param index_mat - index of the material
       \param particle_name - name of the particle
       \brief Build loss table for elements in material
@@ -179,7 +197,7 @@ class GGEMS_EXPORT GGEMSRangeCuts
 
     /*!
       \fn void BuildAbsorptionLengthTable(GGEMSMaterialTables* material_table, GGushort const& index_mat)
-      \param material_table - material table on OpenCL device
+      \param material_table - material tables on host
       \param index_mat - index of the material
       \brief Build absorption length table for photon
     */
@@ -187,7 +205,7 @@ class GGEMS_EXPORT GGEMSRangeCuts
 
     /*!
       \fn void BuildMaterialLossTable(GGEMSMaterialTables* material_table, GGushort const& index_mat)
-      \param material_table - material table on OpenCL device
+      \param material_table - material tables on host
       \param index_mat - index of the material
       \brief Build loss table for material in case of electron and positron
     */
@@ -157,9 +157,9 @@ constant GGfloat PP8[101] = { 0.0f,
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn inline void KleinNishinaComptonSampleSecondaries(global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSMaterialTables const* materials, global GGEMSParticleCrossSections const* particle_cross_sections, GGshort const material_id, GGint const particle_id)
+  \fn inline void KleinNishinaComptonSampleSecondaries(global GGEMSPrimaryParticles* primary_particle, GGEMSRandomState* random, global GGEMSMaterialTables const* materials, global GGEMSParticleCrossSections const* particle_cross_sections, GGshort const material_id, GGint const particle_id)
   \param primary_particle - buffer of particles
-  \param random - pointer on random numbers
+  \param random - pointer on random state of the particle in private memory
   \param materials - buffer of materials
   \param particle_cross_sections - pointer to cross sections activated in navigator
   \param material_id - index of the material
@@ -168,58 +168,54 @@ constant GGfloat PP8[101] = { 0.0f,
 */
 inline void LivermoreRayleighSampleSecondaries(
   global GGEMSPrimaryParticles* primary_particle,
-  global GGEMSRandom* random,
+  GGEMSRandomState* random,
   global GGEMSMaterialTables const* materials,
   global GGEMSParticleCrossSections const* particle_cross_sections,
-  GGuchar const material_id,
+  GGLabelType const material_id,
   GGint const particle_id
 )
 {
-  GGfloat kE0 = primary_particle->E_[particle_id];
+  GGfloat kE0 = GetParticleEnergy(primary_particle, particle_id);
 
   if (kE0 <= 250.0e-6f) { // 250 eV
-    primary_particle->status_[particle_id] = DEAD;
+    SetParticleStatus(primary_particle, particle_id, DEAD);
     return;
   }
 
   // Current Direction
-  GGfloat3 kGammaDirection = {
-    primary_particle->dx_[particle_id],
-    primary_particle->dy_[particle_id],
-    primary_particle->dz_[particle_id]
-  };
+  GGfloat3 kGammaDirection = GetParticleDirection(primary_particle, particle_id);
 
   GGshort kNumberOfBins = particle_cross_sections->number_of_bins_;
-  GGchar kNEltsMinusOne = materials->number_of_chemical_elements_[material_id]-1;
-  GGshort kMixtureID = materials->index_of_chemical_elements_[material_id];
+  GGchar kNEltsMinusOne = GGEMS_TABLE(GGsize, materials, number_of_chemical_elements_)[material_id]-1;
+  GGint kMixtureID = GGEMS_TABLE(GGsize, materials, index_of_chemical_elements_)[material_id];
   GGint kEnergyID = primary_particle->E_index_[particle_id];
 
   // Get last atom
-  GGchar selected_atomic_number_z = materials->atomic_number_Z_[kMixtureID+kNEltsMinusOne];
+  GGchar selected_atomic_number_z = GGEMS_TABLE(GGuchar, materials, atomic_number_Z_)[kMixtureID+kNEltsMinusOne];
 
   // Select randomly one element that composed the material
   GGuchar i = 0;
   if (kNEltsMinusOne > 0) {
     // Get Cross Section of Livermore Rayleigh
     GGfloat kCS = LinearInterpolation(
-      particle_cross_sections->energy_bins_[kEnergyID],
-      particle_cross_sections->photon_cross_sections_[RAYLEIGH_SCATTERING][kEnergyID + kNumberOfBins*material_id],
-      particle_cross_sections->energy_bins_[kEnergyID+1],
-      particle_cross_sections->photon_cross_sections_[RAYLEIGH_SCATTERING][kEnergyID+1 + kNumberOfBins*material_id],
+      GGEMS_TABLE(GGfloat, particle_cross_sections, energy_bins_)[kEnergyID],
+      GGEMS_TABLE(GGfloat, particle_cross_sections, photon_cross_sections_[RAYLEIGH_SCATTERING])[kEnergyID + kNumberOfBins*material_id],
+      GGEMS_TABLE(GGfloat, particle_cross_sections, energy_bins_)[kEnergyID+1],
+      GGEMS_TABLE(GGfloat, particle_cross_sections, photon_cross_sections_[RAYLEIGH_SCATTERING])[kEnergyID+1 + kNumberOfBins*material_id],
       kE0
     );
 
     // Get a random
-    GGfloat x = KissUniform(random, particle_id) * kCS;
+    GGfloat x = KissUniform(random) * kCS;
 
     GGfloat cross_section = 0.0f;
     while (i < kNEltsMinusOne) {
-      GGuchar atomic_number_z = materials->atomic_number_Z_[kMixtureID+i];
-      cross_section += materials->atomic_number_density_[kMixtureID+i] * LinearInterpolation(
-        particle_cross_sections->energy_bins_[kEnergyID],
-        particle_cross_sections->photon_cross_sections_per_atom_[RAYLEIGH_SCATTERING][kEnergyID + kNumberOfBins*atomic_number_z],
-        particle_cross_sections->energy_bins_[kEnergyID+1],
-        particle_cross_sections->photon_cross_sections_per_atom_[RAYLEIGH_SCATTERING][kEnergyID+1 + kNumberOfBins*atomic_number_z],
+      GGuchar atomic_number_z = GGEMS_TABLE(GGuchar, materials, atomic_number_Z_)[kMixtureID+i];
+      cross_section += GGEMS_TABLE(GGfloat, materials, atomic_number_density_)[kMixtureID+i] * LinearInterpolation(
+        GGEMS_TABLE(GGfloat, particle_cross_sections, energy_bins_)[kEnergyID],
+        GGEMS_TABLE(GGfloat, particle_cross_sections, photon_cross_sections_per_atom_[RAYLEIGH_SCATTERING])[kEnergyID + kNumberOfBins*(kMixtureID+i)],
+        GGEMS_TABLE(GGfloat, particle_cross_sections, energy_bins_)[kEnergyID+1],
+        GGEMS_TABLE(GGfloat, particle_cross_sections, photon_cross_sections_per_atom_[RAYLEIGH_SCATTERING])[kEnergyID+1 + kNumberOfBins*(kMixtureID+i)],
         kE0
       );
 
@@ -263,7 +259,7 @@ inline void LivermoreRayleighSampleSecondaries(
     GGfloat n = kN0;
     GGfloat b = kB0;
 
-    x = KissUniform(random, particle_id)*(kX0+kX1+kX2);
+    x = KissUniform(random)*(kX0+kX1+kX2);
     if (x > kX0) {
       x -= kX0;
       if (x <= kX1) {
@@ -280,7 +276,7 @@ inline void LivermoreRayleighSampleSecondaries(
     n = 1.0f/n;
 
     // sampling of angle
-    GGfloat y = KissUniform(random, particle_id)*w;
+    GGfloat y = KissUniform(random)*w;
     if (y < 0.02f) {
       x = y*n*(1.0f + 0.5f*(n + 1.0f)*y*(1.0f - (n + 2.0f)*y/3.0f));
     }
@@ -289,9 +285,9 @@ inline void LivermoreRayleighSampleSecondaries(
     }
 
     costheta = 1.0f - x/(b*kXX);
-  } while (2.0f*KissUniform(random, particle_id) > 1.0f + costheta*costheta || costheta < -1.0f);
+  } while (2.0f*KissUniform(random) > 1.0f + costheta*costheta || costheta < -1.0f);
 
-  GGfloat phi  = TWO_PI * KissUniform(random, particle_id);
+  GGfloat phi  = TWO_PI * KissUniform(random);
   GGfloat sintheta = sqrt((1.0f - costheta)*(1.0f + costheta));
 
   GGfloat3 gamma_direction = {sintheta*cos(phi), sintheta*sin(phi), costheta};
@@ -299,18 +295,16 @@ inline void LivermoreRayleighSampleSecondaries(
   gamma_direction = normalize(gamma_direction);
 
   // Update direction
-  primary_particle->dx_[particle_id] = gamma_direction.x;
-  primary_particle->dy_[particle_id] = gamma_direction.y;
-  primary_particle->dz_[particle_id] = gamma_direction.z;
+  SetParticleDirection(primary_particle, particle_id, gamma_direction);
 
   #ifdef GGEMS_TRACKING
   if (particle_id == primary_particle->particle_tracking_id) {
     printf("\n");
     printf("[GGEMS OpenCL function LivermoreRayleighSampleSecondaries]     Photon energy: %e keV\n", kE0/keV);
     printf("[GGEMS OpenCL function LivermoreRayleighSampleSecondaries]     Photon direction: %e %e %e\n", kGammaDirection.x, kGammaDirection.y, kGammaDirection.z);
-    printf("[GGEMS OpenCL function LivermoreRayleighSampleSecondaries]     Number of element in material %s: %d\n", particle_cross_sections->material_names_[material_id], materials->number_of_chemical_elements_[material_id]);
+    printf("[GGEMS OpenCL function LivermoreRayleighSampleSecondaries]     Number of element in material %d: %d\n", material_id, GGEMS_TABLE(GGsize, materials, number_of_chemical_elements_)[material_id]);
     printf("[GGEMS OpenCL function LivermoreRayleighSampleSecondaries]     Selected element: %u\n", selected_atomic_number_z);
-    printf("[GGEMS OpenCL function LivermoreRayleighSampleSecondaries]     Scattered photon direction: %e %e %e\n", primary_particle->dx_[particle_id], primary_particle->dy_[particle_id], primary_particle->dz_[particle_id]);
+    printf("[GGEMS OpenCL function LivermoreRayleighSampleSecondaries]     Scattered photon direction: %e %e %e\n", gamma_direction.x, gamma_direction.y, gamma_direction.z);
   }
   #endif
 }
@@ -36,19 +36,25 @@
 #include "GGEMS/randoms/GGEMSRandom.hh"
 #include "GGEMS/global/GGEMSConstants.hh"
 
+#ifdef PHILOX_RANDOM
+#include "GGEMS/randoms/GGEMSPhiloxEngine.hh"
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn inline GGfloat KissUniform(global GGEMSRandom* random, GGint const index)
-  \param random - pointer on random buffer on OpenCL device
-  \param index - index of thread
+  \fn inline GGfloat KissUniform(GGEMSRandomState* random)
+  \param random - pointer on random state of the particle in private memory
   \return Uniform random float number
-  \brief JKISS 32-bit (period ~2^121=2.6x10^36), passes all of the Dieharder and the BigCrunch tests in TestU01
+  \brief JKISS 32-bit (period ~2^121=2.6x10^36), passes all of the Dieharder and the BigCrunch tests in TestU01. Philox4x32-10 counter-based engine if PHILOX_RANDOM is defined
 */
-inline GGfloat KissUniform(global GGEMSRandom* random, GGint const index)
+inline GGfloat KissUniform(GGEMSRandomState* random)
 {
+  #ifdef PHILOX_RANDOM
+  return PhiloxUniform(random);
+  #else
   // y ^= (y<<5);
   // y ^= (y>>7);
   // y ^= (y<<22);
@@ -58,20 +64,21 @@ inline GGfloat KissUniform(global GGEMSRandom* random, GGint const index)
   // w = t & 2147483647;
   // x += 1411392427;
 
-  random->prng_state_2_[index] ^= (random->prng_state_2_[index] << 5);
-  random->prng_state_2_[index] ^= (random->prng_state_2_[index] >> 7);
-  random->prng_state_2_[index] ^= (random->prng_state_2_[index] << 22);
+  random->prng_state_2_ ^= (random->prng_state_2_ << 5);
+  random->prng_state_2_ ^= (random->prng_state_2_ >> 7);
+  random->prng_state_2_ ^= (random->prng_state_2_ << 22);
 
-  GGint t = random->prng_state_3_[index] + random->prng_state_4_[index] + random->prng_state_5_[index];
+  GGint t = random->prng_state_3_ + random->prng_state_4_ + random->prng_state_5_;
 
-  random->prng_state_3_[index] = random->prng_state_4_[index];
-  random->prng_state_5_[index] = t < 0;
-  random->prng_state_4_[index] = t & 2147483647;
-  random->prng_state_1_[index] += 1411392427;
+  random->prng_state_3_ = random->prng_state_4_;
+  random->prng_state_5_ = t < 0;
+  random->prng_state_4_ = t & 2147483647;
+  random->prng_state_1_ += 1411392427;
 
-  return ((GGfloat)(random->prng_state_1_[index] + random->prng_state_2_[index] + random->prng_state_4_[index])
+  return ((GGfloat)(random->prng_state_1_ + random->prng_state_2_ + random->prng_state_4_)
     //  UINT_MAX       1.0  - float32_precision
     / 4294967295.0) * (1.0f - 1.0f/(1<<23));
+  #endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -79,14 +86,13 @@ inline GGfloat KissUniform(global GGEMSRandom* random, GGint const index)
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn GGuint KissPoisson(global GGEMSRandom* random, GGint const index, GGfloat const mean)
-  \param random - pointer on random buffer on OpenCL device
-  \param index - index of thread
+  \fn GGuint KissPoisson(GGEMSRandomState* random, GGfloat const mean)
+  \param random - pointer on random state of the particle in private memory
   \param mean - mean of the Poisson distribution
   \return Poisson random uint number
   \brief Poisson random from G4Poisson in Geant4
 */
-inline GGint KissPoisson(global GGEMSRandom* random, GGint const index, GGfloat const mean)
+inline GGint KissPoisson(GGEMSRandomState* random, GGfloat const mean)
 {
   // Initialization of parameters
   GGint number = 0;
@@ -96,7 +102,7 @@ inline GGint KissPoisson(global GGEMSRandom* random, GGint const index, GGfloat
   if (mean <= 16.) {// border == 16, gaussian after 16
     // to avoid 1 due to f32 approximation
     do {
-      position = KissUniform(random, index);
+      position = KissUniform(random);
     }
     while ((1.f-position) < 2.e-7f);
 
@@ -113,8 +119,8 @@ inline GGint KissPoisson(global GGEMSRandom* random, GGint const index, GGfloat
     return number;
   }
 
-  t = sqrt(-2.f*log(KissUniform(random, index)));
-  y = 2.f * PI * KissUniform(random, index);
+  t = sqrt(-2.f*log(KissUniform(random)));
+  y = 2.f * PI * KissUniform(random);
   t *= cos(y);
   value = mean + t*sqrt(mean) + 0.5f;
 
@@ -128,18 +134,17 @@ inline GGint KissPoisson(global GGEMSRandom* random, GGint const index, GGfloat
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn inline GGfloat KissGauss(global GGEMSRandom* random, GGint const index, GGfloat const sigma)
-  \param random - pointer on random buffer on OpenCL device
-  \param index - index of thread
+  \fn inline GGfloat KissGauss(GGEMSRandomState* random, GGfloat const sigma)
+  \param random - pointer on random state of the particle in private memory
   \param sigma - standard deviation
   \return Gaussian random float number
   \brief Gaussian random
 */
-inline GGfloat KissGauss(global GGEMSRandom* random, GGint const index, GGfloat const sigma)
+inline GGfloat KissGauss(GGEMSRandomState* random, GGfloat const sigma)
 {
   // Box-Muller transformation
-  GGfloat u1 = KissUniform(random, index);
-  GGfloat u2 = KissUniform(random, index);
+  GGfloat u1 = KissUniform(random);
+  GGfloat u2 = KissUniform(random);
   GGfloat r1 = sqrt(-2.0f * log(u1));
   GGfloat r2 = 2.0f * PI * u2;
 
@@ -0,0 +1,117 @@
+#ifndef GUARD_GGEMS_RANDOMS_GGEMSPHILOXENGINE_HH
+#define GUARD_GGEMS_RANDOMS_GGEMSPHILOXENGINE_HH
+
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSPhiloxEngine.hh
+
+  \brief Functions for counter-based pseudo random number generator using Philox4x32-10 engine (Salmon et al., SC11). This functions can be used only by an OpenCL kernel
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.2
+  \date Saturday October 17, 2026
+*/
+
+#ifdef __OPENCL_C_VERSION__
+
+#include "GGEMS/randoms/GGEMSRandom.hh"
+
+__constant GGuint PHILOX_M0 = 0xD2511F53; /*!< Multiplier of first Philox round */
+__constant GGuint PHILOX_M1 = 0xCD9E8D57; /*!< Multiplier of second Philox round */
+__constant GGuint PHILOX_W0 = 0x9E3779B9; /*!< Weyl key increment, golden ratio */
+__constant GGuint PHILOX_W1 = 0xBB67AE85; /*!< Weyl key increment, sqrt(3)-1 */
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGuint4 Philox4x32(GGuint4 counter, GGuint2 key)
+  \param counter - 128 bits counter
+  \param key - 64 bits key
+  \return 128 random bits
+  \brief Philox4x32 with 10 rounds, the output is a bijection of the counter for a given key
+*/
+inline GGuint4 Philox4x32(GGuint4 counter, GGuint2 key)
+{
+  for (GGint i = 0; i < 10; ++i) {
+    GGuint hi0 = mul_hi(PHILOX_M0, counter.x);
+    GGuint lo0 = PHILOX_M0 * counter.x;
+    GGuint hi1 = mul_hi(PHILOX_M1, counter.z);
+    GGuint lo1 = PHILOX_M1 * counter.z;
+
+    counter = (GGuint4)(hi1 ^ counter.y ^ key.x, lo1, hi0 ^ counter.w ^ key.y, lo0);
+
+    key.x += PHILOX_W0;
+    key.y += PHILOX_W1;
+  }
+
+  return counter;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void PhiloxNewHistory(GGEMSRandomState* random, GGulong const history)
+  \param random - pointer on random state of the particle in private memory
+  \param history - index of history in simulation
+  \brief Start the random stream of a new particle history
+*/
+inline void PhiloxNewHistory(GGEMSRandomState* random, GGulong const history)
+{
+  random->history_ = history;
+  random->draw_counter_ = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat PhiloxUniform(GGEMSRandomState* random)
+  \param random - pointer on random state of the particle in private memory
+  \return Uniform random float number in ]0, 1[
+  \brief Random number depending only on (seed, history, draw counter), a Philox block gives 4 random numbers, a new block is computed every 4 draws
+*/
+inline GGfloat PhiloxUniform(GGEMSRandomState* random)
+{
+  GGuint draw_counter = random->draw_counter_++;
+  GGuint word_index = draw_counter & 3;
+
+  // Computing a new block, counter of block is the draw counter divided by 4
+  if (word_index == 0) {
+    GGulong history = random->history_;
+    GGuint4 counter = (GGuint4)(draw_counter >> 2, (GGuint)history, (GGuint)(history >> 32), 0);
+    GGuint2 key = (GGuint2)(random->seed_, 0);
+
+    vstore4(Philox4x32(counter, key), 0, random->philox_words_);
+  }
+
+  // 23 bits of mantissa, centered in bin, 0 and 1 are never returned
+  return ((GGfloat)(random->philox_words_[word_index] >> 9) + 0.5f) * (1.0f/8388608.0f);
+}
+
+#endif
+
+#endif // End of GUARD_GGEMS_RANDOMS_GGEMSPHILOXENGINE_HH
@@ -101,12 +101,20 @@ class GGEMS_EXPORT GGEMSPseudoRandomGenerator
     void PrintInfos(void) const;
 
     /*!
-      \fn inline cl::Buffer* GetPseudoRandomNumbers(GGsize const& thread_index) const
+      \fn void SetNumberOfStacks(GGsize const& number_of_stacks)
+      \param number_of_stacks - number of random stacks by device, one for each particle stack
+      \brief set the number of random stacks by device, must be called before Initialize
+    */
+    void SetNumberOfStacks(GGsize const& number_of_stacks);
+
+    /*!
+      \fn inline cl::Buffer* GetPseudoRandomNumbers(GGsize const& thread_index, GGsize const& stack_index = 0) const
       \param thread_index - index of activated device (thread index)
+      \param stack_index - index of the particle stack using the random numbers
       \return pointer to OpenCL buffer storing random numbers
       \brief return the pointer to OpenCL buffer storing random numbers
     */
-    inline cl::Buffer* GetPseudoRandomNumbers(GGsize const& thread_index) const {return pseudo_random_numbers_[thread_index];}
+    inline cl::Buffer* GetPseudoRandomNumbers(GGsize const& thread_index, GGsize const& stack_index = 0) const {return pseudo_random_numbers_[thread_index*number_of_stacks_ + stack_index];}
 
   private:
     /*!
@@ -117,7 +125,7 @@ class GGEMS_EXPORT GGEMSPseudoRandomGenerator
 
     /*!
       \fn void InitializeSeeds(void)
-      \brief Initialize seeds for random
+      \brief Initialize seeds for random, states of JKISS engine are computed on each device by kernel initialize_random_states
     */
     void InitializeSeeds(void);
 
@@ -129,7 +137,9 @@ class GGEMS_EXPORT GGEMSPseudoRandomGenerator
     GGuint GenerateSeed(void) const;
 
   private:
-    cl::Buffer** pseudo_random_numbers_; /*!< Pointer storing the buffer about random numbers in activated device */
+    cl::Buffer** pseudo_random_numbers_; /*!< Pointer storing the buffer about random numbers in activated device, for each stack */
+    cl::Kernel** kernel_initialize_random_states_; /*!< Kernel initializing states of JKISS engine on each device */
+    GGsize number_of_stacks_; /*!< Number of random stacks by device */
     GGsize number_activated_devices_; /*!< Number of activated device */
     GGuint seed_; /*!< Initial seed generating state of GGEMS random */
 };
@@ -34,17 +34,121 @@
 #include "GGEMS/global/GGEMSConfiguration.hh"
 #include "GGEMS/tools/GGEMSTypes.hh"
 
+#ifdef __OPENCL_C_VERSION__
+
 /*!
   \struct GGEMSRandom_t
-  \brief Structure storing informations about random
+  \brief Structure storing informations about random. MAXIMUM_PARTICLES is the size of particle stack on device, given at kernel compilation by GGEMSOpenCLManager
 */
 typedef struct GGEMSRandom_t
 {
+  #ifdef PHILOX_RANDOM
+  GGuint seed_; /*!< Global seed, key of the Philox engine */
+  GGuint draw_counter_[MAXIMUM_PARTICLES]; /*!< Number of random numbers drawn in history of particle */
+  GGulong history_[MAXIMUM_PARTICLES]; /*!< Index of history of particle in simulation, independent of batchs and devices */
+  #else
   GGuint prng_state_1_[MAXIMUM_PARTICLES]; /*!< State 1 of the prng */
   GGuint prng_state_2_[MAXIMUM_PARTICLES]; /*!< State 2 of the prng */
   GGuint prng_state_3_[MAXIMUM_PARTICLES]; /*!< State 3 of the prng */
   GGuint prng_state_4_[MAXIMUM_PARTICLES]; /*!< State 4 of the prng */
   GGuint prng_state_5_[MAXIMUM_PARTICLES]; /*!< State 5 of the prng */
+  #endif
 } GGEMSRandom; /*!< Using C convention name of struct to C++ (_t deletion) */
 
+/*!
+  \struct GGEMSRandomState_t
+  \brief Random state of a particle copied in private memory, loaded once at the beginning of a kernel and stored once at the end
+*/
+typedef struct GGEMSRandomState_t
+{
+  #ifdef PHILOX_RANDOM
+  GGuint seed_; /*!< Global seed, key of the Philox engine */
+  GGuint draw_counter_; /*!< Number of random numbers drawn in history of particle */
+  GGulong history_; /*!< Index of history of particle in simulation */
+  GGuint philox_words_[4]; /*!< Output of the last Philox block, consumed word by word */
+  #else
+  GGuint prng_state_1_; /*!< State 1 of the prng */
+  GGuint prng_state_2_; /*!< State 2 of the prng */
+  GGuint prng_state_3_; /*!< State 3 of the prng */
+  GGuint prng_state_4_; /*!< State 4 of the prng */
+  GGuint prng_state_5_; /*!< State 5 of the prng */
+  #endif
+} GGEMSRandomState; /*!< Using C convention name of struct to C++ (_t deletion) */
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGEMSRandomState LoadRandomState(global GGEMSRandom const* random, GGint const index)
+  \param random - pointer on random buffer on OpenCL device
+  \param index - index of thread
+  \return random state of the particle in private memory
+  \brief copy the random state of a particle from global memory
+*/
+inline GGEMSRandomState LoadRandomState(global GGEMSRandom const* random, GGint const index)
+{
+  GGEMSRandomState state;
+
+  #ifdef PHILOX_RANDOM
+  state.seed_ = random->seed_;
+  state.draw_counter_ = random->draw_counter_[index];
+  state.history_ = random->history_[index];
+  #else
+  state.prng_state_1_ = random->prng_state_1_[index];
+  state.prng_state_2_ = random->prng_state_2_[index];
+  state.prng_state_3_ = random->prng_state_3_[index];
+  state.prng_state_4_ = random->prng_state_4_[index];
+  state.prng_state_5_ = random->prng_state_5_[index];
+  #endif
+
+  return state;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void StoreRandomState(global GGEMSRandom* random, GGint const index, GGEMSRandomState const* state)
+  \param random - pointer on random buffer on OpenCL device
+  \param index - index of thread
+  \param state - random state of the particle in private memory
+  \brief copy the random state of a particle back to global memory
+*/
+inline void StoreRandomState(global GGEMSRandom* random, GGint const index, GGEMSRandomState const* state)
+{
+  #ifdef PHILOX_RANDOM
+  // Words of the current Philox block not consumed are skipped, next kernel starts a new block
+  random->draw_counter_[index] = (state->draw_counter_ + 3) & ~3u;
+  random->history_[index] = state->history_;
+  #else
+  random->prng_state_1_[index] = state->prng_state_1_;
+  random->prng_state_2_[index] = state->prng_state_2_;
+  random->prng_state_3_[index] = state->prng_state_3_;
+  random->prng_state_4_[index] = state->prng_state_4_;
+  random->prng_state_5_[index] = state->prng_state_5_;
+  #endif
+}
+
+#else
+
+/*!
+  \fn inline GGsize GetRandomSize(GGsize const& number_of_particles)
+  \param number_of_particles - size of particle stack, multiple of 8
+  \return size in bytes of GGEMSRandom on OpenCL device
+  \brief get the size of random structure on OpenCL device, must be updated with members of GGEMSRandom
+*/
+inline GGsize GetRandomSize(GGsize const& number_of_particles)
+{
+  #ifdef PHILOX_RANDOM
+  // seed_ is padded to align history_ on 8 bytes
+  return 2*sizeof(GGuint) + number_of_particles*(sizeof(GGuint) + sizeof(GGulong));
+  #else
+  return 5*number_of_particles*sizeof(GGuint);
+  #endif
+}
+
+#endif
+
 #endif // End of GUARD_GGEMS_RANDOMS_GGEMSRANDOM_HH
@@ -168,12 +168,15 @@ class GGEMS_EXPORT GGEMSSource
     virtual void Initialize(bool const& is_tracking = false);
 
     /*!
-      \fn void GetPrimaries(GGsize const& thread_index, GGsize const& number_of particles) = 0
+      \fn void GetPrimaries(GGsize const& thread_index, GGsize const& number_of particles, GGsize const& first_history, GGsize const& stack_index, cl::Event* event) = 0
       \param thread_index - index of activated device (thread index)
       \param number_of_particles - number of particles to generate
+      \param first_history - index of the first particle in simulation, used by counter-based random engine
+      \param stack_index - index of the particle stack to fill
+      \param event - if not null, primaries are generated asynchronously on the source queue and the event is returned
       \brief Generate primary particles
     */
-    virtual void GetPrimaries(GGsize const& thread_index, GGsize const& number_of_particles) = 0;
+    virtual void GetPrimaries(GGsize const& thread_index, GGsize const& number_of_particles, GGsize const& first_history, GGsize const& stack_index, cl::Event* event) = 0;
 
     /*!
       \fn void PrintInfos(void) const = 0
@@ -41,6 +41,19 @@
 
 class GGEMSPseudoRandomGenerator;
 
+#define MINIMUM_BATCHS_BY_DEVICE 4 /*!< Minimum number of batchs by device in dynamic scheduling, so batchs of slow device can be pulled by fast device */
+
+/*!
+  \struct GGEMSBatch_t
+  \brief Batch of particles to simulate for a source
+*/
+typedef struct GGEMSBatch_t
+{
+  GGsize source_index_; /*!< Index of the source */
+  GGsize number_of_particles_; /*!< Number of particles in batch */
+  GGsize first_history_; /*!< Index of the first particle of batch in simulation, independent of devices */
+} GGEMSBatch; /*!< Using C convention name of struct to C++ (_t deletion) */
+
 /*!
   \class GGEMSSourceManager
   \brief GGEMS class handling the source(s)
@@ -119,13 +132,37 @@ class GGEMS_EXPORT GGEMSSourceManager
     inline GGsize GetNumberOfSources(void) const {return number_of_sources_;}
 
     /*!
-      \fn void Initialize(GGuint const& seed, bool const& is_tracking = false, GGint const& particle_tracking_id = 0) const
+      \fn void Initialize(GGuint const& seed, bool const& is_tracking = false, GGint const& particle_tracking_id = 0)
       \param seed - seed of the random
       \param is_tracking - boolean value for tracking
       \param particle_tracking_id - id of particle to track
       \brief Initialize a GGEMS source
     */
-    void Initialize(GGuint const& seed, bool const& is_tracking = false, GGint const& particle_tracking_id = 0) const;
+    void Initialize(GGuint const& seed, bool const& is_tracking = false, GGint const& particle_tracking_id = 0);
+
+    /*!
+      \fn void SetDynamicBatchScheduling(bool const& is_dynamic_batch_scheduling)
+      \param is_dynamic_batch_scheduling - true to share batchs between devices
+      \brief set the dynamic scheduling of batchs, each device pulls a new batch from a shared pool once its batch is simulated
+    */
+    void SetDynamicBatchScheduling(bool const& is_dynamic_batch_scheduling);
+
+    /*!
+      \fn inline bool IsDynamicBatchScheduling(void) const
+      \return true if batchs are dynamically scheduled
+      \brief check if batchs are dynamically scheduled
+    */
+    inline bool IsDynamicBatchScheduling(void) const {return is_dynamic_batch_scheduling_;}
+
+    /*!
+      \fn bool GetNextBatch(GGsize const& thread_index, GGsize& batch_counter, GGEMSBatch& batch)
+      \param thread_index - index of activated device (thread index)
+      \param batch_counter - number of batchs already pulled by the device, incremented by the method
+      \param batch - next batch to simulate
+      \return false if there is no more batch to simulate
+      \brief get the next batch to simulate on a device, from the shared pool in dynamic scheduling or from the batchs of the device otherwise
+    */
+    bool GetNextBatch(GGsize const& thread_index, GGsize& batch_counter, GGEMSBatch& batch);
 
     /*!
       \fn inline std::string GetNameOfSource(GGsize const& source_index) const
@@ -187,23 +224,51 @@ class GGEMS_EXPORT GGEMSSourceManager
     inline GGEMSPseudoRandomGenerator* GetPseudoRandomGenerator(void) const {return pseudo_random_generator_;}
 
     /*!
-      \fn void GetPrimaries(GGsize const& source_index, GGsize const& thread_index, GGsize const& number_of_particles) const
-      \param source_index - index of the source
+      \fn void SetNumberOfStacks(GGsize const& number_of_stacks) const
+      \param number_of_stacks - number of particle and random stacks by device
+      \brief set the number of particle stacks by device, 2 stacks are used by pipelined run
+    */
+    void SetNumberOfStacks(GGsize const& number_of_stacks) const;
+
+    /*!
+      \fn void GetPrimaries(GGEMSBatch const& batch, GGsize const& thread_index) const
+      \param batch - batch of particles to simulate
       \param thread_index - index of activated device (thread index)
-      \param number_of_particles - number of particles to simulate
-      \brief Generate primary particles for a specific source
+      \brief Generate primary particles of a batch in the active stack
     */
-    inline void GetPrimaries(GGsize const& source_index, GGsize const& thread_index, GGsize const& number_of_particles) const
+    inline void GetPrimaries(GGEMSBatch const& batch, GGsize const& thread_index) const
     {
-      particles_->SetNumberOfParticles(thread_index, number_of_particles);
-      sources_[source_index]->GetPrimaries(thread_index, number_of_particles);
+      GGsize stack_index = particles_->GetActiveStack(thread_index);
+      particles_->SetNumberOfParticles(thread_index, batch.number_of_particles_, stack_index);
+      sources_[batch.source_index_]->GetPrimaries(thread_index, batch.number_of_particles_, batch.first_history_, stack_index, nullptr);
     }
 
+    /*!
+      \fn void EnqueuePrimaries(GGEMSBatch const& batch, GGsize const& thread_index, GGsize const& stack_index, cl::Event* event) const
+      \param batch - batch of particles to simulate
+      \param thread_index - index of activated device (thread index)
+      \param stack_index - index of the particle stack to fill
+      \param event - event signaled when primaries are generated
+      \brief Generate asynchronously primary particles of a batch in a specific stack
+    */
+    inline void EnqueuePrimaries(GGEMSBatch const& batch, GGsize const& thread_index, GGsize const& stack_index, cl::Event* event) const
+    {
+      particles_->SetNumberOfParticles(thread_index, batch.number_of_particles_, stack_index);
+      sources_[batch.source_index_]->GetPrimaries(thread_index, batch.number_of_particles_, batch.first_history_, stack_index, event);
+    }
+
+    /*!
+      \fn void CheckAlive(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \brief launch asynchronously the count of alive particles in OpenCL particle buffer
+    */
+    void CheckAlive(GGsize const& thread_index) const;
+
     /*!
       \fn bool IsAlive(GGsize const& thread_index) const
       \param thread_index - index of activated device (thread index)
       \return true if source is still alive, otherwize false
-      \brief check if some particles are alive in OpenCL particle buffer
+      \brief get the result of the last check of alive particles in OpenCL particle buffer
     */
     bool IsAlive(GGsize const& thread_index) const;
 
@@ -213,11 +278,29 @@ class GGEMS_EXPORT GGEMSSourceManager
     */
     void Clean(void);
 
+  private:
+    /*!
+      \fn void InitializeParticleStackSize(void)
+      \brief compute the number of particles in particle stacks from memory of each device, if not set by user
+    */
+    void InitializeParticleStackSize(void);
+
+    /*!
+      \fn void OrganizeBatchPool(void)
+      \brief cut particles of each source in batchs shared between devices
+    */
+    void OrganizeBatchPool(void);
+
   private: // Source infos
     GGEMSSource** sources_; /*!< Pointer on GGEMS sources */
     GGsize number_of_sources_; /*!< Number of sources */
     GGEMSParticles* particles_; /*!< Pointer on particle management */
     GGEMSPseudoRandomGenerator* pseudo_random_generator_; /*!< Pointer on pseudo random generator */
+
+  private: // Batch scheduling
+    bool is_dynamic_batch_scheduling_; /*!< Flag for dynamic scheduling of batchs */
+    std::vector<GGEMSBatch> batch_pool_; /*!< Batchs shared between devices */
+    GGsize next_batch_in_pool_; /*!< Index of the next batch in pool */
 };
 
 /*!
@@ -33,6 +33,7 @@
 
 #include <fstream>
 #include <cmath>
+#include <vector>
 
 #include "GGEMS/global/GGEMSConfiguration.hh"
 #include "GGEMS/tools/GGEMSTypes.hh"
@@ -68,4 +69,42 @@ namespace GGEMSMisc
   [[noreturn]] void ThrowException(std::string const& class_name, std::string const& method_name, std::string const& message);
 }
 
+/*!
+  \namespace GGEMSCache
+  \brief namespace storing functions reading and writing files in on-disk caches (OpenCL program binaries, physic tables)
+*/
+namespace GGEMSCache
+{
+  /*!
+    \fn std::string Hash(std::string const& data)
+    \param data - data to hash
+    \return FNV-1a 64 bits hash of data in hexadecimal
+    \brief hash naming files in cache, stable between runs and platforms, std::hash is not
+  */
+  std::string Hash(std::string const& data);
+
+  /*!
+    \fn bool ReadCacheFile(std::string const& cache_filename, std::string const& magic, std::string const& cache_key, std::vector<GGuchar>& data)
+    \param cache_filename - name of file in cache
+    \param magic - header of file, changed if file format changes
+    \param cache_key - full key of data, checked against key stored in file to reject hash collisions
+    \param data - data read from file
+    \return true if the file exists and is valid
+    \brief read data in cache, format: magic, key size, key, data size, data
+  */
+  bool ReadCacheFile(std::string const& cache_filename, std::string const& magic, std::string const& cache_key, std::vector<GGuchar>& data);
+
+  /*!
+    \fn bool WriteCacheFile(std::string const& cache_filename, std::string const& magic, std::string const& cache_key, GGuchar const* data, GGsize const& data_size)
+    \param cache_filename - name of file in cache
+    \param magic - header of file, changed if file format changes
+    \param cache_key - full key of data
+    \param data - data to write
+    \param data_size - size of data in bytes
+    \return true if the file is written
+    \brief write data in a temporary file then rename it, concurrent jobs never see a partial file
+  */
+  bool WriteCacheFile(std::string const& cache_filename, std::string const& magic, std::string const& cache_key, GGuchar const* data, GGsize const& data_size);
+}
+
 #endif // End of GUARD_GGEMS_TOOLS_GGEMSTOOLS_HH
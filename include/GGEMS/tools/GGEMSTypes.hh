@@ -34,6 +34,13 @@
 #define FALSE 0 /*!< False for OpenCL */
 #define TRUE 1 /*!< True for OpenCL */
 
+// Fixed-point scales of tallies in reproducible mode, a tally saturates at 2^63 units
+#define DOSIMETRY_EDEP_FIXED_POINT_SCALE 4294967296.0 /*!< Fixed-point units by MeV (2^32) of energy deposit in dosel, range 2.1e9 MeV, resolution 2.3e-10 MeV */
+#define DOSIMETRY_EDEP_SQUARED_FIXED_POINT_SCALE 268435456.0 /*!< Fixed-point units by MeV2 (2^28) of squared energy deposit in dosel, range 3.4e10 MeV2, resolution 3.7e-9 MeV2 */
+#define WORLD_ENERGY_FIXED_POINT_SCALE 16777216.0 /*!< Fixed-point units by MeV.mm (2^24) of energy and momentum times track length in world element, range 5.5e11 MeV.mm, resolution 6.0e-8 MeV.mm */
+#define WORLD_ENERGY_SQUARED_FIXED_POINT_SCALE 16777216.0 /*!< Fixed-point units by MeV2.mm (2^24) of squared energy times track length in world element, range 5.5e11 MeV2.mm, resolution 6.0e-8 MeV2.mm */
+#define FIXED_POINT_SATURATION 4611686018427387904 /*!< Tally above 2^62 units (half of range) is reported as close to saturation on readback */
+
 #ifdef _MSC_VER
 #ifndef NOMINMAX
 #define NOMINMAX
@@ -126,8 +133,24 @@
 #define GGdouble8 double8 /*!< define a new type for double8 */
 #define GGdouble16 double16 /*!< define a new type for double16 */
 
+#ifdef REPRODUCIBLE_RESULTS
+#define GGDosiType GGlong /*!< define GGDositype as a fixed-point long, integer additions do not depend on the order */
+
+#if defined(cl_khr_int64_base_atomics)
+#pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable
+#else
+#error "Int64 atomic operation not available on your OpenCL device!!! Please recompile GGEMS setting REPRODUCIBLE_RESULTS to OFF."
+#endif
+
 #ifdef DOSIMETRY_DOUBLE_PRECISION
+#define GGDosiRealType GGdouble /*!< define type of dosimetry values before fixed-point conversion */
+#else
+#define GGDosiRealType GGfloat /*!< define type of dosimetry values before fixed-point conversion */
+#endif
+
+#elif defined(DOSIMETRY_DOUBLE_PRECISION)
 #define GGDosiType GGdouble /*!< define GGDositype as a double, useful for dosimetry computation */
+#define GGDosiRealType GGdouble /*!< define type of dosimetry values, same as GGDosiType */
 
 #if defined(cl_khr_int64_base_atomics)
 #pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable
@@ -137,8 +160,21 @@
 
 #else
 #define GGDosiType GGfloat /*!< define GGDositype as a float, useful for dosimetry computation */
+#define GGDosiRealType GGfloat /*!< define type of dosimetry values, same as GGDosiType */
 #endif
 
+#ifdef LABEL_16BITS
+#define GGLabelType GGushort /*!< define type of material labels in voxelized solids, up to 65535 materials */
+#else
+#define GGLabelType GGuchar /*!< define type of material labels in voxelized solids, up to 255 materials */
+#endif
+
+/*!
+  \def GGEMS_TABLE(type, tables, table)
+  \brief Pointer to a table stored in the same buffer after the header 'tables', the member 'table' of the header storing its offset in bytes
+*/
+#define GGEMS_TABLE(type, tables, table) ((global type const*)((global GGuchar const*)(tables) + (tables)->table))
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -175,7 +211,7 @@ inline void AtomicAddFloat(volatile global GGDosiType* address, GGfloat val)
   \param val - double value to add
   \brief atomic addition for double precision
 */
-#ifdef DOSIMETRY_DOUBLE_PRECISION
+#if defined(DOSIMETRY_DOUBLE_PRECISION) && !defined(REPRODUCIBLE_RESULTS)
 inline void AtomicAddDouble(volatile global GGDosiType* address, GGdouble val)
 {
   union {
@@ -193,6 +229,142 @@ inline void AtomicAddDouble(volatile global GGDosiType* address, GGdouble val)
 }
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void AtomicAddLocalFloat(volatile local GGDosiType* address, GGfloat val)
+  \param address - address of pointer in local memory where the value is added
+  \param val - float value to add
+  \brief atomic addition for float precision in local memory
+*/
+inline void AtomicAddLocalFloat(volatile local GGDosiType* address, GGfloat val)
+{
+  union {
+    GGuint  u32;
+    GGfloat f32;
+  } next, expected, current;
+
+  current.f32 = *address;
+
+  do {
+    expected.f32 = current.f32;
+    next.f32     = expected.f32 + val;
+    current.u32  = atomic_cmpxchg((volatile local GGuint*)address, expected.u32, next.u32);
+  } while(current.u32 != expected.u32);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void AtomicAddLocalDouble(volatile local GGDosiType* address, GGdouble val)
+  \param address - address of pointer in local memory where the value is added
+  \param val - double value to add
+  \brief atomic addition for double precision in local memory
+*/
+#if defined(DOSIMETRY_DOUBLE_PRECISION) && !defined(REPRODUCIBLE_RESULTS)
+inline void AtomicAddLocalDouble(volatile local GGDosiType* address, GGdouble val)
+{
+  union {
+    GGulong  u64;
+    GGdouble f64;
+  } next, expected, current;
+
+  current.f64 = *address;
+
+  do {
+    expected.f64 = current.f64;
+    next.f64     = expected.f64 + val;
+    current.u64  = atom_cmpxchg((volatile local GGulong*)address, expected.u64, next.u64);
+  } while(current.u64 != expected.u64);
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGDosiType RealToDosi(GGDosiRealType const value, GGDosiRealType const fixed_point_scale)
+  \param value - dosimetry value (energy, energy squared, momentum)
+  \param fixed_point_scale - fixed-point units by unit of value, scale of the tally
+  \return value stored in dosimetry tally
+  \brief convert a dosimetry value to the type of tally, rounded to fixed-point in reproducible mode
+*/
+inline GGDosiType RealToDosi(GGDosiRealType const value, GGDosiRealType const fixed_point_scale)
+{
+  #ifdef REPRODUCIBLE_RESULTS
+  return convert_long_rte(value * fixed_point_scale);
+  #else
+  return value;
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGDosiRealType DosiToReal(GGDosiType const value, GGDosiRealType const fixed_point_scale)
+  \param value - value stored in dosimetry tally
+  \param fixed_point_scale - fixed-point units by unit of value, scale of the tally
+  \return dosimetry value
+  \brief convert a value of tally to a dosimetry value
+*/
+inline GGDosiRealType DosiToReal(GGDosiType const value, GGDosiRealType const fixed_point_scale)
+{
+  #ifdef REPRODUCIBLE_RESULTS
+  return (GGDosiRealType)value / fixed_point_scale;
+  #else
+  return value;
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void AtomicAddDosi(volatile global GGDosiType* address, GGDosiType const val)
+  \param address - address of tally in global memory
+  \param val - value to add, converted with RealToDosi
+  \brief atomic addition in dosimetry tally, integer addition in reproducible mode
+*/
+inline void AtomicAddDosi(volatile global GGDosiType* address, GGDosiType const val)
+{
+  #if defined(REPRODUCIBLE_RESULTS)
+  atom_add(address, val);
+  #elif defined(DOSIMETRY_DOUBLE_PRECISION)
+  AtomicAddDouble(address, val);
+  #else
+  AtomicAddFloat(address, val);
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void AtomicAddLocalDosi(volatile local GGDosiType* address, GGDosiType const val)
+  \param address - address of tally in local memory
+  \param val - value to add, converted with RealToDosi
+  \brief atomic addition in dosimetry tally in local memory, integer addition in reproducible mode
+*/
+inline void AtomicAddLocalDosi(volatile local GGDosiType* address, GGDosiType const val)
+{
+  #if defined(REPRODUCIBLE_RESULTS)
+  atom_add(address, val);
+  #elif defined(DOSIMETRY_DOUBLE_PRECISION)
+  AtomicAddLocalDouble(address, val);
+  #else
+  AtomicAddLocalFloat(address, val);
+  #endif
+}
+
 #else
 
 #ifdef OPENGL_VISUALIZATION
@@ -304,12 +476,68 @@ typedef struct GGsize3_t {
 #define GGdouble8 cl_double8 /*!< define a new type for cl_double8 */
 #define GGdouble16 cl_double16 /*!< define a new type for cl_double16 */
 
-#ifdef DOSIMETRY_DOUBLE_PRECISION
+#ifdef REPRODUCIBLE_RESULTS
+#define GGDosiType GGlong /*!< define GGDositype as a fixed-point long, integer additions do not depend on the order */
+#elif defined(DOSIMETRY_DOUBLE_PRECISION)
 #define GGDosiType GGdouble /*!< define GGDositype as a double, useful for dosimetry computation */
 #else
 #define GGDosiType GGfloat /*!< define GGDositype as a float, useful for dosimetry computation */
 #endif
 
+#ifdef LABEL_16BITS
+#define GGLabelType GGushort /*!< define type of material labels in voxelized solids, up to 65535 materials */
+#else
+#define GGLabelType GGuchar /*!< define type of material labels in voxelized solids, up to 255 materials */
+#endif
+
+#define TABLE_ALIGNMENT 64 /*!< Alignment in bytes of tables stored after a header in a buffer */
+
+/*!
+  \fn template <typename T, typename H> inline T* GetTable(H* tables, GGsize const offset)
+  \tparam T - type of table elements
+  \tparam H - type of header
+  \param tables - pointer to the header at the beginning of the buffer
+  \param offset - offset of the table in bytes
+  \return pointer to the table
+  \brief Get a table stored in the same buffer after a header
+*/
+template <typename T, typename H>
+inline T* GetTable(H* tables, GGsize const offset)
+{
+  return reinterpret_cast<T*>(reinterpret_cast<GGuchar*>(tables) + offset);
+}
+
+/*!
+  \fn template <typename T, typename H> inline T const* GetTable(H const* tables, GGsize const offset)
+  \tparam T - type of table elements
+  \tparam H - type of header
+  \param tables - pointer to the header at the beginning of the buffer
+  \param offset - offset of the table in bytes
+  \return pointer to the constant table
+  \brief Get a constant table stored in the same buffer after a header
+*/
+template <typename T, typename H>
+inline T const* GetTable(H const* tables, GGsize const offset)
+{
+  return reinterpret_cast<T const*>(reinterpret_cast<GGuchar const*>(tables) + offset);
+}
+
+/*!
+  \fn inline GGsize AppendTable(GGsize& buffer_size, GGsize const table_size)
+  \param buffer_size - size of the buffer in bytes, incremented by the aligned table
+  \param table_size - size of the appended table in bytes
+  \return offset of the appended table in bytes
+  \brief Append a table at the end of a buffer beginning by a header, the offset is aligned on TABLE_ALIGNMENT bytes
+*/
+inline GGsize AppendTable(GGsize& buffer_size, GGsize const table_size)
+{
+  GGsize offset = ((buffer_size + TABLE_ALIGNMENT - 1) / TABLE_ALIGNMENT) * TABLE_ALIGNMENT;
+  buffer_size = offset + table_size;
+  return offset;
+}
+
+#define GGEMS_TABLE(type, tables, table) GetTable<type>(tables, (tables)->table) /*!< Pointer to a table stored in the same buffer after the header 'tables' */
+
 #endif
 
 #endif // End of GUARD_GGEMS_TOOLS_GGEMSTYPES_HH
@@ -73,6 +73,21 @@ class GGEMS(object):
         ggems_lib.set_tracking_ggems.argtypes = [ctypes.c_void_p, ctypes.c_bool, ctypes.c_int]
         ggems_lib.set_tracking_ggems.restype = ctypes.c_void_p
 
+        ggems_lib.set_pipelined_run_ggems.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_pipelined_run_ggems.restype = ctypes.c_void_p
+
+        ggems_lib.set_liveness_check_ggems.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_bool]
+        ggems_lib.set_liveness_check_ggems.restype = ctypes.c_void_p
+
+        ggems_lib.set_dynamic_batch_scheduling_ggems.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_dynamic_batch_scheduling_ggems.restype = ctypes.c_void_p
+
+        ggems_lib.set_persistent_transport_ggems.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_persistent_transport_ggems.restype = ctypes.c_void_p
+
+        ggems_lib.set_alive_compaction_ggems.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_alive_compaction_ggems.restype = ctypes.c_void_p
+
         ggems_lib.run_ggems.argtypes = [ctypes.c_void_p]
         ggems_lib.run_ggems.restype = ctypes.c_void_p
 
@@ -117,6 +132,21 @@ class GGEMS(object):
     def tracking_verbose(self, flag, particle_id):
         ggems_lib.set_tracking_ggems(self.obj, flag, particle_id)
 
+    def pipelined_run(self, flag):
+        ggems_lib.set_pipelined_run_ggems(self.obj, flag)
+
+    def liveness_check(self, period, speculative = False):
+        ggems_lib.set_liveness_check_ggems(self.obj, period, speculative)
+
+    def dynamic_batch_scheduling(self, flag):
+        ggems_lib.set_dynamic_batch_scheduling_ggems(self.obj, flag)
+
+    def persistent_transport(self, flag):
+        ggems_lib.set_persistent_transport_ggems(self.obj, flag)
+
+    def alive_compaction(self, flag):
+        ggems_lib.set_alive_compaction_ggems(self.obj, flag)
+
 
 def clean_safely():
     GGEMSOpenCLManager().clean()
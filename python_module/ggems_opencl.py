@@ -39,6 +39,12 @@ class GGEMSOpenCLManager(object):
         ggems_lib.set_device_balancing_opencl_manager.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
         ggems_lib.set_device_balancing_opencl_manager.restype = ctypes.c_void_p
 
+        ggems_lib.set_kernel_cache_path_opencl_manager.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+        ggems_lib.set_kernel_cache_path_opencl_manager.restype = ctypes.c_void_p
+
+        ggems_lib.set_particle_stack_size_opencl_manager.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+        ggems_lib.set_particle_stack_size_opencl_manager.restype = ctypes.c_void_p
+
         self.obj = ggems_lib.get_instance_ggems_opencl_manager()
 
     def print_infos(self):
@@ -53,5 +59,11 @@ class GGEMSOpenCLManager(object):
     def set_device_balancing(self, device_balancing):
         ggems_lib.set_device_balancing_opencl_manager(self.obj, device_balancing.encode('ASCII'))
 
+    def set_kernel_cache_path(self, kernel_cache_path):
+        ggems_lib.set_kernel_cache_path_opencl_manager(self.obj, kernel_cache_path.encode('ASCII'))
+
+    def set_particle_stack_size(self, particle_stack_size):
+        ggems_lib.set_particle_stack_size_opencl_manager(self.obj, str(particle_stack_size).encode('ASCII'))
+
     def clean(self):
         ggems_lib.clean_opencl_manager(self.obj)
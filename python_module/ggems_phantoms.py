@@ -45,6 +45,9 @@ class GGEMSVoxelizedPhantom(object):
         ggems_lib.set_rotation_ggems_voxelized_phantom.argtypes = [ctypes.c_void_p, ctypes.c_float, ctypes.c_float, ctypes.c_float, ctypes.c_char_p]
         ggems_lib.set_rotation_ggems_voxelized_phantom.restype = ctypes.c_void_p
 
+        ggems_lib.set_woodcock_tracking_ggems_voxelized_phantom.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_woodcock_tracking_ggems_voxelized_phantom.restype = ctypes.c_void_p
+
         self.obj = ggems_lib.create_ggems_voxelized_phantom(voxelized_phantom_name.encode('ASCII'))
 
     def set_phantom(self, phantom_filename, range_data_filename):
@@ -68,6 +71,9 @@ class GGEMSVoxelizedPhantom(object):
     def set_rotation(self, rx, ry, rz, unit):
         ggems_lib.set_rotation_ggems_voxelized_phantom(self.obj, rx, ry, rz, unit.encode('ASCII'))
 
+    def set_woodcock_tracking(self, flag):
+        ggems_lib.set_woodcock_tracking_ggems_voxelized_phantom(self.obj, flag)
+
 
 class GGEMSWorld(object):
     """Class for world volume for GGEMS simulation
@@ -110,11 +116,11 @@ class GGEMSWorld(object):
     def set_output_basename(self, output):
         ggems_lib.set_output_ggems_world(self.obj, output.encode('ASCII'))
 
-    def energy_tracking(self, activate):
+    def energy_track_length(self, activate):
         ggems_lib.energy_tracking_ggems_world(self.obj, activate)
 
-    def energy_squared_tracking(self, activate):
+    def energy_squared_track_length(self, activate):
         ggems_lib.energy_squared_tracking_ggems_world(self.obj, activate)
 
-    def momentum(self, activate):
+    def momentum_track_length(self, activate):
         ggems_lib.momentum_ggems_world(self.obj, activate)
@@ -103,7 +103,7 @@ GGEMSSolid::~GGEMSSolid(void)
 
   if (label_data_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(label_data_[i], number_of_voxels_*sizeof(GGuchar), i);
+      opencl_manager.Deallocate(label_data_[i], number_of_voxels_*sizeof(GGLabelType), i);
     }
     delete[] label_data_;
     label_data_ = nullptr;
@@ -135,7 +135,7 @@ void GGEMSSolid::EnableTracking(void)
 
 void GGEMSSolid::AddKernelOption(std::string const& option)
 {
-  kernel_option_ += " -DTLE";
+  kernel_option_ += option;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
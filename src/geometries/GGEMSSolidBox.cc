@@ -61,6 +61,10 @@ GGEMSSolidBox::GGEMSSolidBox(GGsize const& virtual_element_number_x, GGsize cons
     solid_data_device->box_size_xyz_[1] = box_size_y;
     solid_data_device->box_size_xyz_[2] = box_size_z;
 
+    // Histogram of box only, modules of a system are placed in the histogram of system
+    solid_data_device->histogram_offset_ = 0;
+    solid_data_device->histogram_stride_ = virtual_element_number_x;
+
     solid_data_device->obb_geometry_.border_min_xyz_.s[0] = -box_size_x*0.5f;
     solid_data_device->obb_geometry_.border_min_xyz_.s[1] = -box_size_y*0.5f;
     solid_data_device->obb_geometry_.border_min_xyz_.s[2] = -box_size_z*0.5f;
@@ -102,11 +106,19 @@ GGEMSSolidBox::GGEMSSolidBox(GGsize const& virtual_element_number_x, GGsize cons
       opencl_manager.CleanBuffer(histogram_.histogram_[d], histogram_.number_of_elements_*sizeof(GGint), d);
     }
   }
+  else if (data_reg_type == "MODULE") {
+    // Module of a system, histogram is owned by the system
+    histogram_.number_of_elements_ = virtual_element_number_x*virtual_element_number_y*virtual_element_number_z;
+    histogram_.histogram_ = nullptr;
+    histogram_.scatter_ = nullptr;
+    kernel_option_ += " -DHISTOGRAM";
+  }
   else {
     std::ostringstream oss(std::ostringstream::out);
     oss << "False registration type name!!!" << std::endl;
     oss << "Registration type is :" << std::endl;
     oss << "    - HISTOGRAM" << std::endl;
+    oss << "    - MODULE" << std::endl;
     //oss << "    - LISTMODE" << std::endl;
     //oss << "    - DOSIMETRY" << std::endl;
     GGEMSMisc::ThrowException("GGEMSSolidBox", "GGEMSSolidBox", oss.str());
@@ -211,6 +223,9 @@ void GGEMSSolidBox::EnableScatter(void)
 
   is_scatter_ = true;
 
+  // Scatter histogram of a module is owned by the system
+  if (data_reg_type_ != "HISTOGRAM") return;
+
   // Loop over number of device
   for (GGsize d = 0; d < number_activated_devices_; ++d) {
     histogram_.scatter_[d] = opencl_manager.Allocate(nullptr, histogram_.number_of_elements_*sizeof(GGint), d, CL_MEM_READ_WRITE, "GGEMSSolidBox");
@@ -264,6 +264,81 @@ void GGEMSVoxelizedSolid::PrintInfos(void) const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSVoxelizedSolid::ReadRangeToLabel(std::string const& range_data_filename, GGEMSMaterials* materials)
+{
+  // Opening range data file
+  std::ifstream in_range_stream(range_data_filename, std::ios::in);
+  GGEMSFileStream::CheckInputStream(in_range_stream, range_data_filename);
+
+  // Values in the range file
+  std::vector<GGfloat> first_label_values;
+  std::vector<GGfloat> last_label_values;
+  GGfloat first_label_value = 0.0f;
+  GGfloat last_label_value = 0.0f;
+  std::string material_name("");
+
+  // Reading range file, label index is the index of line
+  std::string line("");
+  while (std::getline(in_range_stream, line)) {
+    // Check if blank line
+    if (GGEMSTextReader::IsBlankLine(line)) continue;
+
+    // Getting the value in string stream
+    std::istringstream iss = GGEMSRangeReader::ReadRangeMaterial(line);
+    iss >> first_label_value >> last_label_value >> material_name;
+
+    // Adding the material only once
+    materials->AddMaterial(material_name);
+
+    first_label_values.push_back(first_label_value);
+    last_label_values.push_back(last_label_value);
+  }
+
+  // Closing file
+  in_range_stream.close();
+
+  // Sorted bounds of all ranges, label is constant on a bound and between 2 bounds
+  range_bounds_ = first_label_values;
+  range_bounds_.insert(range_bounds_.end(), last_label_values.begin(), last_label_values.end());
+  std::sort(range_bounds_.begin(), range_bounds_.end());
+  range_bounds_.erase(std::unique(range_bounds_.begin(), range_bounds_.end()), range_bounds_.end());
+
+  bound_labels_.assign(range_bounds_.size(), std::numeric_limits<GGLabelType>::max());
+  interval_labels_.assign(range_bounds_.size(), std::numeric_limits<GGLabelType>::max());
+
+  // A value is in range [first, last[, or equal to first if first == last. As in range file, last range wins
+  for (GGsize i = 0; i < first_label_values.size(); ++i) {
+    GGLabelType label_index = static_cast<GGLabelType>(i);
+    for (GGsize j = 0; j < range_bounds_.size(); ++j) {
+      GGfloat bound = range_bounds_[j];
+      if ((bound == first_label_values[i] && bound == last_label_values[i]) || (bound >= first_label_values[i] && bound < last_label_values[i])) {
+        bound_labels_[j] = label_index;
+      }
+      if (j + 1 < range_bounds_.size() && bound >= first_label_values[i] && range_bounds_[j+1] <= last_label_values[i]) {
+        interval_labels_[j] = label_index;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGLabelType GGEMSVoxelizedSolid::GetLabelOfValue(GGfloat const& value) const
+{
+  // Index of the last bound lower or equal to value
+  std::vector<GGfloat>::const_iterator bound_iterator = std::upper_bound(range_bounds_.begin(), range_bounds_.end(), value);
+  if (bound_iterator == range_bounds_.begin()) return std::numeric_limits<GGLabelType>::max();
+
+  GGsize bound_index = static_cast<GGsize>(bound_iterator - range_bounds_.begin()) - 1;
+  return value == range_bounds_[bound_index] ? bound_labels_[bound_index] : interval_labels_[bound_index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSVoxelizedSolid::LoadVolumeImage(GGEMSMaterials* materials)
 {
   GGcout("GGEMSVoxelizedSolid", "LoadVolumeImage", 3) << "Loading volume image from mhd file..." << GGendl;
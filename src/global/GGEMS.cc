@@ -75,7 +75,13 @@ GGEMS::GGEMS(void)
   is_random_verbose_(false),
   is_tracking_verbose_(false),
   is_profiling_verbose_(false),
-  particle_tracking_id_(0)
+  particle_tracking_id_(0),
+  is_pipelined_run_(false),
+  liveness_check_period_(1),
+  is_speculative_liveness_check_(false),
+  is_dynamic_batch_scheduling_(false),
+  is_persistent_transport_(false),
+  is_alive_compaction_(false)
 {
   GGcout("GGEMS", "GGEMS", 3) << "GGEMS creating..." << GGendl;
 
@@ -188,6 +194,58 @@ void GGEMS::SetTrackingVerbose(bool const& is_tracking_verbose, GGint const& par
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMS::SetPipelinedRun(bool const& is_pipelined_run)
+{
+  is_pipelined_run_ = is_pipelined_run;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::SetLivenessCheck(GGint const& liveness_check_period, bool const& is_speculative_liveness_check)
+{
+  if (liveness_check_period < 1) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Period checking alive particles must be at least 1!!!";
+    GGEMSMisc::ThrowException("GGEMS", "SetLivenessCheck", oss.str());
+  }
+
+  liveness_check_period_ = liveness_check_period;
+  is_speculative_liveness_check_ = is_speculative_liveness_check;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::SetDynamicBatchScheduling(bool const& is_dynamic_batch_scheduling)
+{
+  is_dynamic_batch_scheduling_ = is_dynamic_batch_scheduling;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::SetPersistentTransport(bool const& is_persistent_transport)
+{
+  is_persistent_transport_ = is_persistent_transport;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::SetAliveCompaction(bool const& is_alive_compaction)
+{
+  is_alive_compaction_ = is_alive_compaction;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMS::Initialize(GGuint const& seed)
 {
   GGcout("GGEMS", "Initialize", 1) << "Initialization of GGEMS Manager singleton..." << GGendl;
@@ -214,12 +272,21 @@ void GGEMS::Initialize(GGuint const& seed)
   // Checking if material manager is ready
   if (!material_database_manager.IsReady()) GGEMSMisc::ThrowException("GGEMS", "Initialize", "Materials are not loaded in GGEMS!!!");
 
-  // Initialization of the source
+  // Initialization of the source, a second particle stack is allocated for pipelined run
+  source_manager.SetNumberOfStacks(is_pipelined_run_ ? 2 : 1);
+  source_manager.SetDynamicBatchScheduling(is_dynamic_batch_scheduling_);
+  source_manager.GetParticles()->SetAliveCompaction(is_alive_compaction_);
+  #ifdef OPENGL_VISUALIZATION
+  source_manager.GetParticles()->SetOpenGLTrajectories(opengl_manager.IsOpenGLActivated());
+  #endif
   source_manager.Initialize(seed, is_tracking_verbose_, particle_tracking_id_);
 
   // Initialization of the navigators (phantom + system)
   navigator_manager.Initialize(is_tracking_verbose_);
 
+  // Generating the persistent transport kernel, multi-kernel transport is kept if scene is not supported
+  if (is_persistent_transport_) navigator_manager.InitializeTransportKernel();
+
   // Printing infos about OpenCL
   if (is_opencl_verbose_) {
     opencl_manager.PrintPlatformInfos();
@@ -294,8 +361,10 @@ void GGEMS::Initialize(GGuint const& seed)
 
 void GGEMS::RunOnDevice(GGsize const& thread_index)
 {
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
   GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
   GGEMSNavigatorManager& navigator_manager = GGEMSNavigatorManager::GetInstance();
+  GGEMSParticles* particles = source_manager.GetParticles();
 
   #ifdef OPENGL_VISUALIZATION
   GGEMSOpenGLManager& opengl_manager = GGEMSOpenGLManager::GetInstance();
@@ -306,21 +375,53 @@ void GGEMS::RunOnDevice(GGsize const& thread_index)
   static GGEMSProgressBar progress_bar(source_manager.GetTotalNumberOfBatchs());
   mutex.unlock();
 
-  // Loop over sources
-  for (GGsize i = 0; i < source_manager.GetNumberOfSources(); ++i) {
-    // Number of batch for a source
-    GGsize number_of_batchs = source_manager.GetNumberOfBatchs(i, thread_index);
+  // Get the start time of device
+  ChronoTime start_time = GGEMSChrono::Now();
+
+  // Batchs are pulled one by one, from the shared pool in dynamic scheduling
+  GGsize batch_counter = 0;
+  GGEMSBatch batch, next_batch;
+  bool is_batch = source_manager.GetNextBatch(thread_index, batch_counter, batch);
 
-    // Loop over batch
-    for (GGsize j = 0; j < number_of_batchs; ++j) {
-      GGsize number_of_particles = source_manager.GetNumberOfParticlesInBatch(i, thread_index, j);
+  // In pipelined run, primaries of first batch are generated asynchronously in the active stack
+  cl::Event primaries_event;
+  if (is_pipelined_run_ && is_batch) {
+    source_manager.EnqueuePrimaries(batch, thread_index, particles->GetActiveStack(thread_index), &primaries_event);
+  }
 
+  // Loop over batchs
+  while (is_batch) {
+    number_of_simulated_particles_[thread_index] += batch.number_of_particles_;
+
+    if (is_pipelined_run_) {
+      // Transport of the active stack waits for its primaries on device, host is not blocked
+      std::vector<cl::Event> wait_list(1, primaries_event);
+      GGint barrier_status = opencl_manager.GetCommandQueue(thread_index)->enqueueBarrierWithWaitList(&wait_list);
+      opencl_manager.CheckOpenCLError(barrier_status, "GGEMS", "RunOnDevice");
+
+      // Generating primaries of next batch in the other stack, overlapping transport of the active stack
+      is_batch = source_manager.GetNextBatch(thread_index, batch_counter, next_batch);
+      if (is_batch) {
+        source_manager.EnqueuePrimaries(next_batch, thread_index, particles->GetNextStack(thread_index), &primaries_event);
+      }
+    }
+    else {
       // Generating particles
-      source_manager.GetPrimaries(i, thread_index, number_of_particles);
+      source_manager.GetPrimaries(batch, thread_index);
+    }
+
+    // All the particles of the batch are alive
+    particles->ResetAliveParticles(thread_index);
 
+    if (navigator_manager.IsTransportKernel()) {
+      // Persistent transport, each work-item loops over navigation steps until its particle is dead
+      navigator_manager.Transport(thread_index);
+    }
+    else {
       // Loop until ALL particles are dead
-      GGint loop_counter = 0, max_loop = 100; // Prevent infinite loop
-      do {
+      GGint loop_counter = 0, max_loop = MAXIMUM_NAVIGATION_STEPS; // Prevent infinite loop
+      bool is_check_pending = false;
+      while (loop_counter < max_loop) {
         // Step 2: Find closest navigator (phantom, detector) before projection and track operation
         navigator_manager.FindSolid(thread_index);
 
@@ -334,24 +435,63 @@ void GGEMS::RunOnDevice(GGsize const& thread_index)
         navigator_manager.TrackThroughSolid(thread_index);
 
         loop_counter++;
-      } while (source_manager.IsAlive(thread_index) && loop_counter < max_loop); // Step 5: Checking if all particles are dead, otherwize go back to step 2
 
-      // Incrementing progress bar
-      mutex.lock();
-      ++progress_bar;
-      mutex.unlock();
+        // Step 5: Checking if all particles are dead, otherwize go back to step 2
+        // In speculative mode, the result of the previous check is read once this iteration is enqueued, dead particles are ignored by kernels
+        if (is_check_pending) {
+          is_check_pending = false;
+          if (!source_manager.IsAlive(thread_index)) break;
+        }
+
+        if (loop_counter % liveness_check_period_ == 0) {
+          source_manager.CheckAlive(thread_index);
+          if (is_speculative_liveness_check_) is_check_pending = true;
+          else if (!source_manager.IsAlive(thread_index)) break;
+        }
+      }
+    }
 
-      // If OpenGL, send particle OpenGL infos from OpenCL buffer to OpenGL for the current source
-      #ifdef OPENGL_VISUALIZATION
-      if (opengl_manager.IsOpenGLActivated()) {
-        opengl_manager.CopyParticlePositionToOpenGL(i);
+    // Incrementing progress bar
+    mutex.lock();
+    ++progress_bar;
+    mutex.unlock();
+
+    // If OpenGL, send particle OpenGL infos from OpenCL buffer to OpenGL for the current source
+    #ifdef OPENGL_VISUALIZATION
+    if (opengl_manager.IsOpenGLActivated()) {
+      opengl_manager.CopyParticlePositionToOpenGL(batch.source_index_);
+    }
+    #endif
+
+    // Next batch is transported using the other stack, the other stack is reused only when its transport is over
+    if (is_pipelined_run_) {
+      opencl_manager.GetCommandQueue(thread_index)->finish();
+
+      // Primaries already generated at the end of transport, generation of next batch is hidden by transport
+      if (is_batch) {
+        GGint primaries_status = CL_QUEUED;
+        opencl_manager.CheckOpenCLError(primaries_event.getInfo(CL_EVENT_COMMAND_EXECUTION_STATUS, &primaries_status), "GGEMS", "RunOnDevice");
+        ++number_of_pipelined_batchs_[thread_index];
+        if (primaries_status == CL_COMPLETE) ++number_of_overlapped_batchs_[thread_index];
       }
-      #endif
+
+      particles->SwapStacks(thread_index);
+      batch = next_batch;
+    }
+    else {
+      is_batch = source_manager.GetNextBatch(thread_index, batch_counter, batch);
     }
   }
 
-  // Computing dose
+  // Computing dose, in reproducible mode dose is computed once tallies of all devices are reduced
+  #ifndef REPRODUCIBLE_RESULTS
   navigator_manager.ComputeDose(thread_index);
+  #endif
+
+  // Storing elapsed time of device
+  opencl_manager.GetCommandQueue(thread_index)->finish();
+  DurationNano elapsed_time = GGEMSChrono::Now() - start_time;
+  elapsed_time_by_device_[thread_index] = static_cast<GGdouble>(elapsed_time.count()) * 1.0e-9;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -369,6 +509,12 @@ void GGEMS::Run()
   GGsize number_of_activated_devices = opencl_manager.GetNumberOfActivatedDevice();
   std::thread* thread_device = new std::thread[number_of_activated_devices];
 
+  // Throughput by device
+  number_of_simulated_particles_.assign(number_of_activated_devices, 0);
+  elapsed_time_by_device_.assign(number_of_activated_devices, 0.0);
+  number_of_pipelined_batchs_.assign(number_of_activated_devices, 0);
+  number_of_overlapped_batchs_.assign(number_of_activated_devices, 0);
+
   for (GGsize i = 0; i < number_of_activated_devices; ++i) {
     thread_device[i] = std::thread(&GGEMS::RunOnDevice, this, i);
   }
@@ -378,9 +524,27 @@ void GGEMS::Run()
   // Deleting threads
   delete[] thread_device;
 
+  // Printing throughput of each device
+  for (GGsize i = 0; i < number_of_activated_devices; ++i) {
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(i);
+    GGdouble throughput = elapsed_time_by_device_[i] > 0.0 ? static_cast<GGdouble>(number_of_simulated_particles_[i]) / elapsed_time_by_device_[i] : 0.0;
+    GGcout("GGEMS", "Run", 1) << "Device " << opencl_manager.GetDeviceName(device_index) << ": " << number_of_simulated_particles_[i] << " particles in " << elapsed_time_by_device_[i] << " s, " << throughput << " particles/s" << GGendl;
+
+    // Overlap of primary generation and transport in pipelined run
+    if (is_pipelined_run_) {
+      GGcout("GGEMS", "Run", 1) << "Device " << opencl_manager.GetDeviceName(device_index) << ": primaries of " << number_of_overlapped_batchs_[i] << "/" << number_of_pipelined_batchs_[i] << " batchs ready at the end of transport of previous batch" << GGendl;
+    }
+  }
+
+  GGEMSNavigatorManager& navigator_manager = GGEMSNavigatorManager::GetInstance();
+
+  // Reducing dosimetry tallies of all devices, results do not depend on number of devices
+  #ifdef REPRODUCIBLE_RESULTS
+  navigator_manager.ReduceDose();
+  #endif
+
   // End of simulation, storing output
   GGcout("GGEMS", "Run", 1) << "Saving results..." << GGendl;
-  GGEMSNavigatorManager& navigator_manager = GGEMSNavigatorManager::GetInstance();
   navigator_manager.SaveResults();
 
   // Printing elapsed time in kernels
@@ -548,6 +712,51 @@ void set_tracking_ggems(GGEMS* ggems, bool const is_tracking_verbose, GGint cons
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void set_pipelined_run_ggems(GGEMS* ggems, bool const is_pipelined_run)
+{
+  ggems->SetPipelinedRun(is_pipelined_run);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_liveness_check_ggems(GGEMS* ggems, GGint const liveness_check_period, bool const is_speculative_liveness_check)
+{
+  ggems->SetLivenessCheck(liveness_check_period, is_speculative_liveness_check);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_dynamic_batch_scheduling_ggems(GGEMS* ggems, bool const is_dynamic_batch_scheduling)
+{
+  ggems->SetDynamicBatchScheduling(is_dynamic_batch_scheduling);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_persistent_transport_ggems(GGEMS* ggems, bool const is_persistent_transport)
+{
+  ggems->SetPersistentTransport(is_persistent_transport);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_alive_compaction_ggems(GGEMS* ggems, bool const is_alive_compaction)
+{
+  ggems->SetAliveCompaction(is_alive_compaction);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void run_ggems(GGEMS* ggems)
 {
   ggems->Run();
@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <sstream>
+#include <filesystem>
 
 #include "GGEMS/tools/GGEMSTools.hh"
 #include "GGEMS/global/GGEMSOpenCLManager.hh"
@@ -76,6 +77,7 @@ void GGEMSOpenCLManager::Clean(void)
   // Freeing activated devices
   for (ComputingDevice& i : computing_devices_) i.Clean();
   computing_devices_.clear();
+  particle_stack_size_.clear();
 
   // Deleting kernel
   for (cl::Kernel* k : kernels_) {
@@ -100,6 +102,7 @@ void GGEMSOpenCLManager::InitOpenCL(void)
   GetOpenCLPlatorms();
   GetOpenCLDevices();
   SetOpenCLCompilationOptions();
+  InitKernelCache();
 
   // Filling alias vendor
   vendors_.insert(std::make_pair("nvidia", "NVIDIA Corporation"));
@@ -125,6 +128,35 @@ void GGEMSOpenCLManager::DisableCudaKernelCache(void) const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSOpenCLManager::InitKernelCache(void)
+{
+  kernel_cache_path_.clear();
+
+  #ifdef OPENCL_CACHE_KERNEL_COMPILATION
+  // Directory given by user, empty value disables the cache
+  char const* kernel_cache_env = std::getenv("GGEMS_KERNEL_CACHE_PATH");
+  if (kernel_cache_env) {
+    kernel_cache_path_ = kernel_cache_env;
+    return;
+  }
+
+  // Default cache directory of user
+  #ifdef _MSC_VER
+  char const* local_app_data = std::getenv("LOCALAPPDATA");
+  if (local_app_data) kernel_cache_path_ = (std::filesystem::path(local_app_data) / "GGEMS" / "kernel_cache").string();
+  #else
+  char const* xdg_cache_home = std::getenv("XDG_CACHE_HOME");
+  char const* home = std::getenv("HOME");
+  if (xdg_cache_home && xdg_cache_home[0] != '\0') kernel_cache_path_ = (std::filesystem::path(xdg_cache_home) / "ggems" / "kernels").string();
+  else if (home) kernel_cache_path_ = (std::filesystem::path(home) / ".cache" / "ggems" / "kernels").string();
+  #endif
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSOpenCLManager::GetOpenCLPlatorms(void)
 {
   // Getting all platforms
@@ -571,6 +603,26 @@ void GGEMSOpenCLManager::SetOpenCLCompilationOptions(void)
   build_options_ += " -DDOSIMETRY_DOUBLE_PRECISION";
   #endif
 
+  // Counter-based random engine
+  #ifdef PHILOX_RANDOM
+  build_options_ += " -DPHILOX_RANDOM";
+  #endif
+
+  // Fixed-point dosimetry tallies, independent of devices
+  #ifdef REPRODUCIBLE_RESULTS
+  build_options_ += " -DREPRODUCIBLE_RESULTS";
+  #endif
+
+  // Compact layout of particles
+  #ifdef COMPACT_PARTICLES
+  build_options_ += " -DCOMPACT_PARTICLES";
+  #endif
+
+  // Type of material labels
+  #ifdef LABEL_16BITS
+  build_options_ += " -DLABEL_16BITS";
+  #endif
+
   // Add auxiliary function path to OpenCL options
   #ifdef GGEMS_PATH
   build_options_ += " -I";
@@ -593,6 +645,10 @@ void GGEMSOpenCLManager::PrintBuildOptions(void) const
   GGcout("GGEMSOpenCLManager", "PrintBuildOptions", 0) << "OpenCL NVIDIA kernel cache compilation: ON" << GGendl;
   #endif
   GGcout("GGEMSOpenCLManager", "PrintBuildOptions", 0) << "OpenCL building options: " << build_options_ << GGendl;
+  if (kernel_cache_path_.empty())
+    GGcout("GGEMSOpenCLManager", "PrintBuildOptions", 0) << "OpenCL program binary cache: OFF" << GGendl;
+  else
+    GGcout("GGEMSOpenCLManager", "PrintBuildOptions", 0) << "OpenCL program binary cache: " << kernel_cache_path_ << GGendl;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -635,6 +691,20 @@ void GGEMSOpenCLManager::AddBuildOption(std::string const& option)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSOpenCLManager::SetKernelCachePath(std::string const& kernel_cache_path)
+{
+  kernel_cache_path_ = kernel_cache_path;
+
+  if (kernel_cache_path_.empty())
+    GGcout("GGEMSOpenCLManager", "SetKernelCachePath", 1) << "OpenCL program binary cache disabled" << GGendl;
+  else
+    GGcout("GGEMSOpenCLManager", "SetKernelCachePath", 1) << "OpenCL program binary cache in: " << kernel_cache_path_ << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSOpenCLManager::DeviceToActivate(std::string const& device_type, std::string const& device_vendor)
 {
   // Transform all parameters in lower caracters
@@ -740,9 +810,11 @@ void GGEMSOpenCLManager::DeviceToActivate(GGsize const& device_id)
   computing_device.index_ = device_id;
   computing_device.context_ = new cl::Context(*devices_.at(device_id));
   computing_device.queue_ = new cl::CommandQueue(*computing_device.context_, *devices_.at(device_id), CL_QUEUE_PROFILING_ENABLE);
+  computing_device.source_queue_ = new cl::CommandQueue(*computing_device.context_, *devices_.at(device_id), CL_QUEUE_PROFILING_ENABLE);
 
-  // Storing computing device
+  // Storing computing device, size of particle stack is set later
   computing_devices_.push_back(computing_device);
+  particle_stack_size_.push_back(0);
 
   // Printing name of activated device
   GGcout("GGEMSOpenCLManager", "DeviceToActivate", 2) << "Activated device: " << GetDeviceName(device_id) << GGendl;
@@ -795,6 +867,62 @@ void GGEMSOpenCLManager::DeviceBalancing(std::string const& device_balancing)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSOpenCLManager::SetParticleStackSize(std::string const& particle_stack_size)
+{
+  std::string tmp_stack_size = particle_stack_size;
+  std::transform(tmp_stack_size.begin(), tmp_stack_size.end(), tmp_stack_size.begin(), ::tolower);
+
+  // Automatic size, computed from memory of device at initialization
+  if (tmp_stack_size == "auto") {
+    for (GGsize i = 0; i < particle_stack_size_.size(); ++i) particle_stack_size_[i] = 0;
+    GGcout("GGEMSOpenCLManager", "SetParticleStackSize", 0) << "Particle stack size computed from memory of each device" << GGendl;
+    return;
+  }
+
+  std::vector<GGsize> stack_sizes;
+  GGsize pos = 0;
+  std::string delimiter = ";";
+  while ((pos = tmp_stack_size.find(delimiter)) != std::string::npos) {
+    stack_sizes.push_back(static_cast<GGsize>(std::stoull(tmp_stack_size.substr(0, pos))));
+    tmp_stack_size.erase(0, pos + delimiter.length());
+  }
+  stack_sizes.push_back(static_cast<GGsize>(std::stoull(tmp_stack_size)));
+
+  // A single value is used for all activated devices
+  if (stack_sizes.size() == 1) stack_sizes.resize(computing_devices_.size(), stack_sizes[0]);
+
+  // Checking number of stack size values
+  if (stack_sizes.size() != computing_devices_.size()) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Mismatch between number of particle stack size values and number of activated devices!!!";
+    GGEMSMisc::ThrowException("GGEMSOpenCLManager", "SetParticleStackSize", oss.str());
+  }
+
+  for (GGsize i = 0; i < stack_sizes.size(); ++i) SetParticleStackSize(i, stack_sizes[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::SetParticleStackSize(GGsize const& thread_index, GGsize const& particle_stack_size)
+{
+  if (particle_stack_size == 0) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Particle stack size has to be positive!!!";
+    GGEMSMisc::ThrowException("GGEMSOpenCLManager", "SetParticleStackSize", oss.str());
+  }
+
+  // Stack is a multiple of work group size, members of particle structures are not padded
+  particle_stack_size_[thread_index] = ((particle_stack_size + work_group_size_ - 1) / work_group_size_) * work_group_size_;
+
+  GGcout("GGEMSOpenCLManager", "SetParticleStackSize", 0) << "Particle stack size on device " << GetDeviceName(computing_devices_[thread_index].index_) << ": " << particle_stack_size_[thread_index] << " particles" << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 GGsize GGEMSOpenCLManager::CheckKernel(std::string const& kernel_name, std::string const& compilation_options) const
 {
   GGcout("GGEMSOpenCLManager","CheckKernel", 3) << "Checking if kernel has already been compiled..." << GGendl;
@@ -802,8 +930,8 @@ GGsize GGEMSOpenCLManager::CheckKernel(std::string const& kernel_name, std::stri
   // Parameters for kernel infos
   std::string registered_kernel_name("");
 
-  // Loop over registered kernels
-  for (GGsize i = 0; i < kernels_.size(); ++i) {
+  // Loop over registered kernels, kernels are stored by block of activated devices
+  for (GGsize i = 0; i < kernels_.size(); i += computing_devices_.size()) {
     CheckOpenCLError(kernels_.at(i)->getInfo(CL_KERNEL_FUNCTION_NAME, &registered_kernel_name), "GGEMSOpenCLManager", "CheckKernel");
     registered_kernel_name.erase(std::remove(registered_kernel_name.begin(), registered_kernel_name.end(), '\0'), registered_kernel_name.end());
     if (kernel_name == registered_kernel_name && compilation_options == kernel_compilation_options_.at(i)) return i;
@@ -816,15 +944,47 @@ GGsize GGEMSOpenCLManager::CheckKernel(std::string const& kernel_name, std::stri
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+std::string GGEMSOpenCLManager::GetDeviceCompilationOptions(char const* compilation_options, GGsize const& thread_index) const
+{
+  std::string device_compilation_options(compilation_options);
+
+  // Size of particle stack depends on device, given to kernel once particle stacks are sized
+  if (particle_stack_size_[thread_index] != 0) device_compilation_options += " -DMAXIMUM_PARTICLES=" + std::to_string(particle_stack_size_[thread_index]);
+
+  return device_compilation_options;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSOpenCLManager::CompileKernel(std::string const& kernel_filename, std::string const& kernel_name, cl::Kernel** kernel_list, char* const p_custom_options, char* const p_additional_options)
 {
-  GGcout("GGEMSOpenCLManager","CompileKernel", 3) << "Compiling a kernel on OpenCL activated context..." << GGendl;
+  GGcout("GGEMSOpenCLManager","CompileKernel", 3) << "Compiling a kernel from file: " << kernel_filename << GGendl;
+
+  // Check if the source kernel file exists
+  std::ifstream source_file_stream(kernel_filename.c_str(), std::ios::in);
+  GGEMSFileStream::CheckInputStream(source_file_stream, kernel_filename);
+
+  // Store kernel in a std::string buffer
+  std::string source_code(std::istreambuf_iterator<char>(source_file_stream), (std::istreambuf_iterator<char>()));
+
+  CompileKernelFromSource(source_code, kernel_name, kernel_list, p_custom_options, p_additional_options);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::CompileKernelFromSource(std::string const& source_code, std::string const& kernel_name, cl::Kernel** kernel_list, char* const p_custom_options, char* const p_additional_options)
+{
+  GGcout("GGEMSOpenCLManager","CompileKernelFromSource", 3) << "Compiling a kernel on OpenCL activated context..." << GGendl;
 
   // Checking the compilation options
   if (p_custom_options && p_additional_options) {
     std::ostringstream oss(std::ostringstream::out);
     oss << "Custom and additional options can not by set in same time!!!";
-    GGEMSMisc::ThrowException("GGEMSOpenCLManager", "CompileKernel", oss.str());
+    GGEMSMisc::ThrowException("GGEMSOpenCLManager", "CompileKernelFromSource", oss.str());
   }
 
   // Handling options to OpenCL compilation kernel
@@ -856,7 +1016,7 @@ void GGEMSOpenCLManager::CompileKernel(std::string const& kernel_filename, std::
   }
 
   // Checking if kernel already compiled
-  GGsize kernel_index = CheckKernel(kernel_name, kernel_compilation_option);
+  GGsize kernel_index = computing_devices_.empty() ? KERNEL_NOT_COMPILED : CheckKernel(kernel_name, GetDeviceCompilationOptions(kernel_compilation_option, 0));
 
   // if kernel already compiled return it
   if (kernel_index != KERNEL_NOT_COMPILED) {
@@ -865,45 +1025,63 @@ void GGEMSOpenCLManager::CompileKernel(std::string const& kernel_filename, std::
     }
   }
   else {
-    // Check if the source kernel file exists
-    std::ifstream source_file_stream(kernel_filename.c_str(), std::ios::in);
-    GGEMSFileStream::CheckInputStream(source_file_stream, kernel_filename);
-
-    // Store kernel in a std::string buffer
-    std::string source_code(std::istreambuf_iterator<char>(source_file_stream), (std::istreambuf_iterator<char>()));
-
     // Creating an OpenCL program
     cl::Program::Sources program_source(1, std::make_pair(source_code.c_str(), source_code.length() + 1));
 
+    // Source code with included files, used to identify program binaries in cache
+    std::string preprocessed_source;
+    if (!kernel_cache_path_.empty()) preprocessed_source = PreprocessKernelSource(source_code, kernel_compilation_option);
+
     // Loop over activated device
     for (GGsize i = 0; i < computing_devices_.size(); ++i) {
-      // Make program from source code in context
-      cl::Program program = cl::Program(*computing_devices_[i].context_, program_source);
-
       // Get device associated to context, in our case 1 context = 1 device
       std::vector<cl::Device> device;
-      CheckOpenCLError(computing_devices_[i].context_->getInfo(CL_CONTEXT_DEVICES, &device), "GGEMSOpenCLManager", "CompileKernel");
-
-      GGcout("GGEMSOpenCLManager", "CompileKernel", 2) << "Compile a new kernel '" << kernel_name << "' from file: " << kernel_filename << " on device: " << GetDeviceName(computing_devices_[i].index_) << " with options: " << kernel_compilation_option << GGendl;
-
-      // Compile source code on device
-      GGint build_status = program.build(device, kernel_compilation_option);
-      if (build_status != CL_SUCCESS) {
-        std::ostringstream oss(std::ostringstream::out);
-        std::string log;
-        program.getBuildInfo(device[0], CL_PROGRAM_BUILD_LOG, &log);
-        oss << ErrorType(build_status) << std::endl;
-        oss << log;
-        GGEMSMisc::ThrowException("GGEMSOpenCLManager", "CompileKernel", oss.str());
+      CheckOpenCLError(computing_devices_[i].context_->getInfo(CL_CONTEXT_DEVICES, &device), "GGEMSOpenCLManager", "CompileKernelFromSource");
+
+      // Compilation options depend on size of particle stack of device
+      std::string device_compilation_option = GetDeviceCompilationOptions(kernel_compilation_option, i);
+
+      // Loading program from cache if possible
+      cl::Program program;
+      std::string cache_key;
+      bool is_cached = false;
+      if (!kernel_cache_path_.empty()) {
+        cache_key = GetKernelCacheKey(preprocessed_source, device_compilation_option, computing_devices_[i].index_);
+        is_cached = LoadKernelBinary(cache_key, i, device_compilation_option.c_str(), program);
+      }
+
+      GGint build_status = CL_SUCCESS;
+      if (is_cached) {
+        GGcout("GGEMSOpenCLManager", "CompileKernelFromSource", 2) << "Load kernel '" << kernel_name << "' from cache on device: " << GetDeviceName(computing_devices_[i].index_) << " with options: " << device_compilation_option << GGendl;
+      }
+      else {
+        // Make program from source code in context
+        program = cl::Program(*computing_devices_[i].context_, program_source);
+
+        GGcout("GGEMSOpenCLManager", "CompileKernelFromSource", 2) << "Compile a new kernel '" << kernel_name << "' on device: " << GetDeviceName(computing_devices_[i].index_) << " with options: " << device_compilation_option << GGendl;
+
+        // Compile source code on device
+        build_status = program.build(device, device_compilation_option.c_str());
+        if (build_status != CL_SUCCESS) {
+          std::ostringstream oss(std::ostringstream::out);
+          std::string log;
+          program.getBuildInfo(device[0], CL_PROGRAM_BUILD_LOG, &log);
+          oss << ErrorType(build_status) << std::endl;
+          oss << log;
+          GGEMSMisc::ThrowException("GGEMSOpenCLManager", "CompileKernelFromSource", oss.str());
+        }
+
+        // Storing program binary for next runs
+        if (!kernel_cache_path_.empty()) SaveKernelBinary(cache_key, program);
       }
 
       // Storing the kernel in the singleton
       kernels_.push_back(new cl::Kernel(program, kernel_name.c_str(), &build_status));
       kernel_list[i] = kernels_.back();
-      CheckOpenCLError(build_status, "GGEMSOpenCLManager", "CompileKernel");
+      CheckOpenCLError(build_status, "GGEMSOpenCLManager", "CompileKernelFromSource");
 
       // Storing the compilation options
-      kernel_compilation_options_.push_back(kernel_compilation_option);
+      kernel_compilation_options_.push_back(device_compilation_option);
     }
   }
 }
@@ -912,6 +1090,204 @@ void GGEMSOpenCLManager::CompileKernel(std::string const& kernel_filename, std::
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSOpenCLManager::ExpandKernelIncludes(std::string const& source_code, std::filesystem::path const& current_directory, std::vector<std::filesystem::path> const& include_paths, std::unordered_set<std::string>& visited_files, std::ostringstream& expanded_source)
+{
+  std::istringstream source_stream(source_code);
+  std::string line;
+  while (std::getline(source_stream, line)) {
+    expanded_source << line << '\n';
+
+    // Finding include directive
+    GGsize first = line.find_first_not_of(" \t");
+    if (first == std::string::npos || line[first] != '#') continue;
+    first = line.find_first_not_of(" \t", first + 1);
+    if (first == std::string::npos || line.compare(first, 7, "include") != 0) continue;
+
+    GGsize name_begin = line.find_first_of("\"<", first + 7);
+    if (name_begin == std::string::npos) continue;
+    GGsize name_end = line.find_first_of("\">", name_begin + 1);
+    if (name_end == std::string::npos) continue;
+    std::filesystem::path include_name(line.substr(name_begin + 1, name_end - name_begin - 1));
+
+    // Searching included file in current directory then in include paths
+    std::vector<std::filesystem::path> search_paths;
+    if (!current_directory.empty()) search_paths.push_back(current_directory);
+    search_paths.insert(search_paths.end(), include_paths.begin(), include_paths.end());
+
+    std::error_code error_code;
+    for (std::filesystem::path const& search_path : search_paths) {
+      std::filesystem::path include_file = search_path / include_name;
+      if (!std::filesystem::is_regular_file(include_file, error_code)) continue;
+
+      include_file = std::filesystem::weakly_canonical(include_file, error_code);
+      if (!visited_files.insert(include_file.string()).second) break;
+
+      std::ifstream include_stream(include_file, std::ios::in);
+      std::string include_code(std::istreambuf_iterator<char>(include_stream), (std::istreambuf_iterator<char>()));
+      ExpandKernelIncludes(include_code, include_file.parent_path(), include_paths, visited_files, expanded_source);
+      break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSOpenCLManager::PreprocessKernelSource(std::string const& source_code, std::string const& compilation_options) const
+{
+  // Getting include paths from compilation options, '-Ipath' or '-I path'
+  std::vector<std::filesystem::path> include_paths;
+  std::istringstream options_stream(compilation_options);
+  std::string option;
+  while (options_stream >> option) {
+    if (option == "-I") {
+      if (options_stream >> option) include_paths.push_back(option);
+    }
+    else if (option.compare(0, 2, "-I") == 0) {
+      include_paths.push_back(option.substr(2));
+    }
+  }
+
+  std::unordered_set<std::string> visited_files;
+  std::ostringstream expanded_source(std::ostringstream::out);
+  ExpandKernelIncludes(source_code, std::filesystem::path(), include_paths, visited_files, expanded_source);
+
+  return expanded_source.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSOpenCLManager::GetKernelCacheKey(std::string const& preprocessed_source, std::string const& compilation_options, GGsize const& device_index) const
+{
+  // Program binary depends on code, options, device and driver
+  std::ostringstream oss(std::ostringstream::out);
+  oss << GGEMSCache::Hash(preprocessed_source) << '\n'
+      << compilation_options << '\n'
+      << device_name_[device_index] << '\n'
+      << device_vendor_[device_index] << '\n'
+      << device_version_[device_index] << '\n'
+      << device_driver_version_[device_index];
+
+  return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool GGEMSOpenCLManager::LoadKernelBinary(std::string const& cache_key, GGsize const& thread_index, char const* compilation_options, cl::Program& program) const
+{
+  std::filesystem::path cache_file = std::filesystem::path(kernel_cache_path_) / (GGEMSCache::Hash(cache_key) + ".clbin");
+
+  std::error_code error_code;
+  if (!std::filesystem::is_regular_file(cache_file, error_code)) return false;
+
+  // Reading program binary
+  std::vector<GGuchar> binary;
+  bool is_valid = GGEMSCache::ReadCacheFile(cache_file.string(), KERNEL_CACHE_MAGIC, cache_key, binary);
+
+  // Building program from binary, cached binary rejected by driver is removed
+  if (is_valid) {
+    std::vector<cl::Device> device;
+    CheckOpenCLError(computing_devices_[thread_index].context_->getInfo(CL_CONTEXT_DEVICES, &device), "GGEMSOpenCLManager", "LoadKernelBinary");
+
+    cl::Program::Binaries program_binary(1, std::make_pair(binary.data(), binary.size()));
+    std::vector<cl_int> binary_status;
+    cl_int error = CL_SUCCESS;
+    program = cl::Program(*computing_devices_[thread_index].context_, device, program_binary, &binary_status, &error);
+
+    is_valid = error == CL_SUCCESS && !binary_status.empty() && binary_status[0] == CL_SUCCESS && program.build(device, compilation_options) == CL_SUCCESS;
+  }
+
+  if (!is_valid) {
+    GGcout("GGEMSOpenCLManager", "LoadKernelBinary", 2) << "Invalid program binary in cache, removing: " << cache_file.string() << GGendl;
+    std::filesystem::remove(cache_file, error_code);
+    return false;
+  }
+
+  // Updating time of file, the least recently used binaries are evicted first
+  std::filesystem::last_write_time(cache_file, std::filesystem::file_time_type::clock::now(), error_code);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::SaveKernelBinary(std::string const& cache_key, cl::Program const& program)
+{
+  // Getting binary from program, in our case 1 program = 1 device
+  GGsize binary_size = 0;
+  if (clGetProgramInfo(program(), CL_PROGRAM_BINARY_SIZES, sizeof(GGsize), &binary_size, nullptr) != CL_SUCCESS || binary_size == 0) return;
+
+  std::vector<GGuchar> binary(binary_size);
+  GGuchar* binary_ptr = binary.data();
+  if (clGetProgramInfo(program(), CL_PROGRAM_BINARIES, sizeof(GGuchar*), &binary_ptr, nullptr) != CL_SUCCESS) return;
+
+  // Creating cache directory, cache disabled if not possible
+  std::error_code error_code;
+  std::filesystem::path cache_directory(kernel_cache_path_);
+  std::filesystem::create_directories(cache_directory, error_code);
+  if (error_code) {
+    GGwarn("GGEMSOpenCLManager", "SaveKernelBinary", 0) << "Impossible to create OpenCL program binary cache in '" << kernel_cache_path_ << "': " << error_code.message() << ", cache disabled!!!" << GGendl;
+    kernel_cache_path_.clear();
+    return;
+  }
+
+  // Writing in temporary file then renaming it, readers never see a partial file
+  std::filesystem::path cache_file = cache_directory / (GGEMSCache::Hash(cache_key) + ".clbin");
+  if (!GGEMSCache::WriteCacheFile(cache_file.string(), KERNEL_CACHE_MAGIC, cache_key, binary.data(), binary_size)) {
+    GGwarn("GGEMSOpenCLManager", "SaveKernelBinary", 0) << "Impossible to write OpenCL program binary in cache '" << kernel_cache_path_ << "'!!!" << GGendl;
+    return;
+  }
+
+  EvictKernelCache();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::EvictKernelCache(void) const
+{
+  // Listing program binaries in cache
+  std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> cache_files;
+  GGsize cache_size = 0;
+
+  std::error_code error_code;
+  for (std::filesystem::directory_iterator it(kernel_cache_path_, error_code), end; !error_code && it != end; it.increment(error_code)) {
+    if (it->path().extension() != ".clbin") continue;
+
+    std::error_code file_error_code;
+    GGsize file_size = static_cast<GGsize>(it->file_size(file_error_code));
+    std::filesystem::file_time_type file_time = it->last_write_time(file_error_code);
+    if (file_error_code) continue;
+
+    cache_size += file_size;
+    cache_files.push_back(std::make_pair(file_time, it->path()));
+  }
+
+  if (cache_size <= KERNEL_CACHE_MAXIMUM_SIZE) return;
+
+  // Removing the least recently used binaries
+  std::sort(cache_files.begin(), cache_files.end());
+  for (auto const& f : cache_files) {
+    if (cache_size <= KERNEL_CACHE_MAXIMUM_SIZE) break;
+
+    GGsize file_size = static_cast<GGsize>(std::filesystem::file_size(f.second, error_code));
+    if (error_code) continue;
+    if (std::filesystem::remove(f.second, error_code)) cache_size -= file_size;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 cl::Buffer* GGEMSOpenCLManager::Allocate(void* host_ptr, GGsize const& size, GGsize const& thread_index, cl_mem_flags flags, std::string const& class_name)
 {
   GGcout("GGEMSOpenCLManager","Allocate", 3) << "Allocating memory on OpenCL device memory..." << GGendl;
@@ -1552,3 +1928,21 @@ void set_device_balancing_opencl_manager(GGEMSOpenCLManager* opencl_manager, cha
 {
   opencl_manager->DeviceBalancing(device_balancing);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_kernel_cache_path_opencl_manager(GGEMSOpenCLManager* opencl_manager, char const* kernel_cache_path)
+{
+  opencl_manager->SetKernelCachePath(kernel_cache_path);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_particle_stack_size_opencl_manager(GGEMSOpenCLManager* opencl_manager, char const* particle_stack_size)
+{
+  opencl_manager->SetParticleStackSize(particle_stack_size);
+}
@@ -133,7 +133,7 @@ void GGEMSOpenGLParaGrid::WriteShaders(void)
 GGEMSRGBColor GGEMSOpenGLParaGrid::GetRGBColor(GGsize const& index) const
 {
   // Read label and get material color
-  GGuchar index_material = 0;
+  GGLabelType index_material = 0;
   if (material_rgb_.size() > 1) index_material = label_[index];
 
   // Getting material name and read rgb color
@@ -150,7 +150,7 @@ GGEMSRGBColor GGEMSOpenGLParaGrid::GetRGBColor(GGsize const& index) const
 bool GGEMSOpenGLParaGrid::IsMaterialVisible(GGsize const index) const
 {
   // Read label and get material color
-  GGuchar index_material = 0;
+  GGLabelType index_material = 0;
   if (material_rgb_.size() > 1) index_material = label_[index];
 
   // Getting material name and read visibility
@@ -177,18 +177,25 @@ void GGEMSOpenGLParticles::CopyParticlePosition(void)
 
   // Getting primary particles from OpenCL
   cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(0);
-  GGEMSPrimaryParticles* primary_particles_device = opencl_manager.GetDeviceBuffer<GGEMSPrimaryParticles>(primary_particles, CL_TRUE, CL_MAP_READ, sizeof(GGEMSPrimaryParticles), 0);
+  GGsize particle_stack_size = opencl_manager.GetParticleStackSize(0);
+
+  // Only trajectories are mapped, they are stored after particle stack
+  GGfloat* primary_particles_device = opencl_manager.GetDeviceBuffer<GGfloat>(primary_particles, CL_TRUE, CL_MAP_READ, GetPrimaryParticlesOpenGLSize(), 0, GetPrimaryParticlesSize(particle_stack_size));
+  GGfloat* px_gl = primary_particles_device;
+  GGfloat* py_gl = px_gl + MAXIMUM_DISPLAYED_PARTICLES*MAXIMUM_INTERACTIONS;
+  GGfloat* pz_gl = py_gl + MAXIMUM_DISPLAYED_PARTICLES*MAXIMUM_INTERACTIONS;
+  GGint* stored_particles_gl = reinterpret_cast<GGint*>(pz_gl + MAXIMUM_DISPLAYED_PARTICLES*MAXIMUM_INTERACTIONS);
 
   // Loop over particles
   for (GGsize i = 0; i < number_of_particles_; ++i) {
     // Getting number of interactions for each primary particles
-    GGsize stored_interactions = static_cast<GGsize>(primary_particles_device->stored_particles_gl_[i]);
+    GGsize stored_interactions = static_cast<GGsize>(stored_particles_gl[i]);
 
     // Loop over interactions
     for (GGsize j = 0; j < stored_interactions; ++j) {
-      vertex_[j*3+0+number_of_registered_particles_*MAXIMUM_INTERACTIONS*3] = primary_particles_device->px_gl_[j+i*MAXIMUM_INTERACTIONS];
-      vertex_[j*3+1+number_of_registered_particles_*MAXIMUM_INTERACTIONS*3] = primary_particles_device->py_gl_[j+i*MAXIMUM_INTERACTIONS];
-      vertex_[j*3+2+number_of_registered_particles_*MAXIMUM_INTERACTIONS*3] = primary_particles_device->pz_gl_[j+i*MAXIMUM_INTERACTIONS];
+      vertex_[j*3+0+number_of_registered_particles_*MAXIMUM_INTERACTIONS*3] = px_gl[j+i*MAXIMUM_INTERACTIONS];
+      vertex_[j*3+1+number_of_registered_particles_*MAXIMUM_INTERACTIONS*3] = py_gl[j+i*MAXIMUM_INTERACTIONS];
+      vertex_[j*3+2+number_of_registered_particles_*MAXIMUM_INTERACTIONS*3] = pz_gl[j+i*MAXIMUM_INTERACTIONS];
 
       index_[index_increment_++] = static_cast<GLuint>(j+number_of_registered_particles_*MAXIMUM_INTERACTIONS);
     }
@@ -270,11 +270,11 @@ void GGEMSOpenGLVolume::SetMaterial(GGEMSMaterials const* materials, cl::Buffer*
   }
 
   // Storing label from OpenCL
-  label_ = new GGuchar[number_of_voxels];
+  label_ = new GGLabelType[number_of_voxels];
 
   // Get pointer on OpenCL device
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
-  GGuchar* label_data_device = opencl_manager.GetDeviceBuffer<GGuchar>(label, CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, number_of_voxels * sizeof(GGuchar), 0);
+  GGLabelType* label_data_device = opencl_manager.GetDeviceBuffer<GGLabelType>(label, CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, number_of_voxels * sizeof(GGLabelType), 0);
 
   // Copy data
   for (GGsize i = 0; i < number_of_voxels; ++i) label_[i] = label_data_device[i];
@@ -253,6 +253,35 @@ void GGEMSMHDImage::Write(cl::Buffer* image, GGsize const& thread_index) const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSMHDImage::WriteDosimetry(GGDosiType* image, GGdouble const& fixed_point_scale, bool const& is_positive)
+{
+  #ifdef REPRODUCIBLE_RESULTS
+  // Fixed-point tallies are converted in double before writing
+  GGsize number_of_elements = dimensions_.x_ * dimensions_.y_ * dimensions_.z_;
+  GGdouble* real_image = new GGdouble[number_of_elements];
+  GGsize number_of_saturated_elements = 0;
+  for (GGsize i = 0; i < number_of_elements; ++i) {
+    real_image[i] = static_cast<GGdouble>(image[i]) / fixed_point_scale;
+
+    // Integer additions wrap silently, tallies close to 2^63 units or negative energies are overflows
+    if (image[i] >= FIXED_POINT_SATURATION || image[i] <= -FIXED_POINT_SATURATION || (is_positive && image[i] < 0)) ++number_of_saturated_elements;
+  }
+
+  if (number_of_saturated_elements > 0) {
+    GGwarn("GGEMSMHDImage", "WriteDosimetry", 0) << number_of_saturated_elements << " element(s) of '" << mhd_header_file_ << "' are saturated or close to saturation of fixed-point tally (range " << 2.0 * static_cast<GGdouble>(FIXED_POINT_SATURATION) / fixed_point_scale << "), values are wrong!!!" << GGendl;
+  }
+
+  Write<GGdouble>(real_image);
+  delete[] real_image;
+  #else
+  Write<GGDosiType>(image);
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSMHDImage::CheckParameters(void) const
 {
   if (mhd_header_file_.empty()) {
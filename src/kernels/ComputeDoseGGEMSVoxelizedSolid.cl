@@ -34,7 +34,7 @@
 #include "GGEMS/geometries/GGEMSVoxelizedSolidData.hh"
 
 /*!
-  \fn kernel void compute_dose_ggems_voxelized_solid(GGsize const dosel_id_limit, global GGEMSDoseParams const* dose_params, global GGDosiType const* edep, global GGint const* hit, global GGDosiType const* edep_squared, global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGuchar const* label_data, global GGEMSMaterialTables const* materials, global GGfloat* dose, global GGfloat* uncertainty, GGfloat const scale_factor, GGchar const is_water_reference, GGfloat const minimum_density)
+  \fn kernel void compute_dose_ggems_voxelized_solid(GGsize const dosel_id_limit, global GGEMSDoseParams const* dose_params, global GGDosiType const* edep, global GGint const* hit, global GGDosiType const* edep_squared, global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGLabelType const* label_data, global GGEMSMaterialTables const* materials, global GGfloat* dose, global GGfloat* uncertainty, GGfloat const scale_factor, GGchar const is_water_reference, GGfloat const minimum_density)
   \param dosel_id_limit - number total of dosels
   \param dose_params - params about dosemap
   \param edep - buffer storing energy deposit
@@ -57,7 +57,7 @@ kernel void compute_dose_ggems_voxelized_solid(
   global GGint const* hit,
   global GGDosiType const* edep_squared,
   global GGEMSVoxelizedSolidData const* voxelized_solid_data,
-  global GGuchar const* label_data,
+  global GGLabelType const* label_data,
   global GGEMSMaterialTables const* materials,
   global GGfloat* dose,
   global GGfloat* uncertainty,
@@ -84,7 +84,7 @@ kernel void compute_dose_ggems_voxelized_solid(
   GGint3 voxel_id = convert_int3((dosel_pos - voxelized_solid_data->obb_geometry_.border_min_xyz_) / voxelized_solid_data->voxel_sizes_xyz_);
 
   // Get the material that compose this volume
-  GGuchar material_id = label_data[
+  GGLabelType material_id = label_data[
     voxel_id.x +
     voxel_id.y * voxelized_solid_data->number_of_voxels_xyz_.x +
     voxel_id.z * voxelized_solid_data->number_of_voxels_xyz_.x * voxelized_solid_data->number_of_voxels_xyz_.y
@@ -94,10 +94,13 @@ kernel void compute_dose_ggems_voxelized_solid(
   GGfloat dosel_vol = dose_params->size_of_dosels_.x * dose_params->size_of_dosels_.y * dose_params->size_of_dosels_.z;
 
   // Get density
-  GGfloat density = is_water_reference ? 1.0f * (g/cm3) : materials->density_of_material_[material_id];
+  GGfloat density = is_water_reference ? 1.0f * (g/cm3) : GGEMS_TABLE(GGfloat, materials, density_of_material_)[material_id];
+
+  // Energy deposit in dosel, converted from fixed-point in reproducible mode
+  GGDosiRealType edep_dosel = DosiToReal(edep[global_id], (GGDosiRealType)DOSIMETRY_EDEP_FIXED_POINT_SCALE);
 
   // Apply threshold on density and computing dose
-  dose[global_id] = density < minimum_density ? 0.0f : scale_factor * edep[global_id] / density / dosel_vol / Gy;
+  dose[global_id] = density < minimum_density ? 0.0f : scale_factor * edep_dosel / density / dosel_vol / Gy;
 
   // Relative statistical uncertainty (from Ma et al. PMB 47 2002 p1671)
   //              /                                    \ ^1/2
@@ -110,9 +113,9 @@ kernel void compute_dose_ggems_voxelized_solid(
 
   // Computing uncertainty
   if (uncertainty) {
-    if (hit[global_id] > 1 && edep[global_id] != 0.0) {
-      GGDosiType sum_edep_2 = edep[global_id] * edep[global_id];
-      uncertainty[global_id] = sqrt((hit[global_id]*edep_squared[global_id] - sum_edep_2) / ((hit[global_id]-1) * sum_edep_2));
+    if (hit[global_id] > 1 && edep_dosel != 0.0) {
+      GGDosiRealType sum_edep_2 = edep_dosel * edep_dosel;
+      uncertainty[global_id] = sqrt((hit[global_id]*DosiToReal(edep_squared[global_id], (GGDosiRealType)DOSIMETRY_EDEP_SQUARED_FIXED_POINT_SCALE) - sum_edep_2) / ((hit[global_id]-1) * sum_edep_2));
     }
     else {
       uncertainty[global_id] = 1.0f;
@@ -36,7 +36,7 @@
 #include "GGEMS/physics/GGEMSProcessConstants.hh"
 
 /*!
-  \fn kernel void get_primaries_ggems_xray_source(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, GGchar const particle_name, global GGfloat const* energy_spectrum, global GGfloat const* cdf, GGint const number_of_energy_bins, GGfloat const aperture, GGfloat3 const focal_spot_size, global GGfloat44 const* matrix_transformation)
+  \fn kernel void get_primaries_ggems_xray_source(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, GGchar const particle_name, global GGfloat const* energy_spectrum, global GGfloat const* cdf, GGint const number_of_energy_bins, GGfloat const aperture, GGfloat3 const focal_spot_size, global GGfloat44 const* matrix_transformation, GGsize const first_history)
   \param particle_id_limit - particle id limit
   \param primary_particle - buffer of primary particles
   \param random - buffer for random number
@@ -47,6 +47,7 @@
   \param aperture - source aperture
   \param focal_spot_size - focal spot size of xray-source
   \param matrix_transformation - matrix storing information about axis
+  \param first_history - index of the first particle in simulation
   \brief Generate primaries for xray source
 */
 kernel void get_primaries_ggems_xray_source(
@@ -59,7 +60,8 @@ kernel void get_primaries_ggems_xray_source(
   GGint const number_of_energy_bins,
   GGfloat const aperture,
   GGfloat3 const focal_spot_size,
-  global GGfloat44 const* matrix_transformation
+  global GGfloat44 const* matrix_transformation,
+  GGsize const first_history
 )
 {
   // Get the index of thread
@@ -68,9 +70,17 @@ kernel void get_primaries_ggems_xray_source(
   // Return if index > to particle limit
   if (global_id >= particle_id_limit) return;
 
+  // Random state of the particle in private memory
+  GGEMSRandomState random_state = LoadRandomState(random, global_id);
+
+  // Random stream of the new history
+  #ifdef PHILOX_RANDOM
+  PhiloxNewHistory(&random_state, first_history + global_id);
+  #endif
+
   // Get random angles
-  GGdouble phi = KissUniform(random, global_id);
-  GGdouble theta = KissUniform(random, global_id);
+  GGdouble phi = KissUniform(&random_state);
+  GGdouble theta = KissUniform(&random_state);
 
   phi *= (GGdouble)TWO_PI;
   GGdouble new_aperture = 1.0 - cos((GGdouble)aperture);
@@ -95,43 +105,43 @@ kernel void get_primaries_ggems_xray_source(
   direction = normalize(direction);
 
   // Position with focal (local)
-  global_position.x = focal_spot_size.x * (KissUniform(random, global_id) - 0.5f);
-  global_position.y = focal_spot_size.y * (KissUniform(random, global_id) - 0.5f);
-  global_position.z = focal_spot_size.z * (KissUniform(random, global_id) - 0.5f);
+  global_position.x = focal_spot_size.x * (KissUniform(&random_state) - 0.5f);
+  global_position.y = focal_spot_size.y * (KissUniform(&random_state) - 0.5f);
+  global_position.z = focal_spot_size.z * (KissUniform(&random_state) - 0.5f);
 
   // Apply transformation (local to global frame)
   global_position = LocalToGlobalPosition(matrix_transformation, &global_position);
 
   // Getting a random energy
-  GGfloat rndm_for_energy = KissUniform(random, global_id);
+  GGfloat rndm_for_energy = KissUniform(&random_state);
 
   // Get index in cdf
   GGint index_for_energy = BinarySearchLeft(rndm_for_energy, cdf, number_of_energy_bins, 0, 0);
 
   // Setting the energy for particles
-  primary_particle->E_[global_id] = (index_for_energy == number_of_energy_bins - 1) ?
+  GGfloat energy = (index_for_energy == number_of_energy_bins - 1) ?
     energy_spectrum[index_for_energy] :
     LinearInterpolation(cdf[index_for_energy], energy_spectrum[index_for_energy], cdf[index_for_energy + 1], energy_spectrum[index_for_energy + 1], rndm_for_energy);
+  SetParticleEnergy(primary_particle, global_id, energy);
 
   // Then set the mandatory field to create a new particle
-  primary_particle->px_[global_id] = global_position.x;
-  primary_particle->py_[global_id] = global_position.y;
-  primary_particle->pz_[global_id] = global_position.z;
+  SetParticlePosition(primary_particle, global_id, global_position);
+  SetParticleDirection(primary_particle, global_id, direction);
 
-  primary_particle->dx_[global_id] = direction.x;
-  primary_particle->dy_[global_id] = direction.y;
-  primary_particle->dz_[global_id] = direction.z;
+  SetParticleScatter(primary_particle, global_id, FALSE);
 
-  primary_particle->scatter_[global_id] = FALSE;
+  SetParticleStatus(primary_particle, global_id, ALIVE);
 
-  primary_particle->status_[global_id] = ALIVE;
-
-  primary_particle->level_[global_id] = PRIMARY;
-  primary_particle->pname_[global_id] = particle_name;
+  SetParticleLevel(primary_particle, global_id, PRIMARY);
+  SetParticleName(primary_particle, global_id, particle_name);
 
   primary_particle->particle_solid_distance_[global_id] = OUT_OF_WORLD;
-  primary_particle->next_discrete_process_[global_id] = NO_PROCESS;
+  SetParticleNextDiscreteProcess(primary_particle, global_id, NO_PROCESS);
   primary_particle->next_interaction_distance_[global_id] = 0.0f;
+  primary_particle->number_of_mean_free_paths_[global_id] = -1.0f;
+
+  // Storing random state for transport
+  StoreRandomState(random, global_id, &random_state);
 
   #ifdef OPENGL
   // Storing vertex position for OpenGL
@@ -150,9 +160,9 @@ kernel void get_primaries_ggems_xray_source(
     // Checking if buffer is full
    // if (stored_particles_gl != MAXIMUM_INTERACTIONS) {
 
-      primary_particle->px_gl_[global_id*MAXIMUM_INTERACTIONS] = primary_particle->px_[global_id];
-      primary_particle->py_gl_[global_id*MAXIMUM_INTERACTIONS] = primary_particle->py_[global_id];
-      primary_particle->pz_gl_[global_id*MAXIMUM_INTERACTIONS] = primary_particle->pz_[global_id];
+      primary_particle->px_gl_[global_id*MAXIMUM_INTERACTIONS] = global_position.x;
+      primary_particle->py_gl_[global_id*MAXIMUM_INTERACTIONS] = global_position.y;
+      primary_particle->pz_gl_[global_id*MAXIMUM_INTERACTIONS] = global_position.z;
       //stored_particles_gl += 1;
 
       // primary_particle->px_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] += primary_particle->dx_[global_id]*2.0f*m;
@@ -171,12 +181,12 @@ kernel void get_primaries_ggems_xray_source(
     printf("[GGEMS OpenCL kernel get_primaries_ggems_xray_source] ################################################################################\n");
     printf("[GGEMS OpenCL kernel get_primaries_ggems_xray_source] Particle id: %d\n", global_id);
     printf("[GGEMS OpenCL kernel get_primaries_ggems_xray_source] Particle type: ");
-    if (primary_particle->pname_[global_id] == PHOTON) printf("gamma\n");
-    else if (primary_particle->pname_[global_id] == ELECTRON) printf("e-\n");
-    else if (primary_particle->pname_[global_id] == POSITRON) printf("e+\n");
+    if (GetParticleName(primary_particle, global_id) == PHOTON) printf("gamma\n");
+    else if (GetParticleName(primary_particle, global_id) == ELECTRON) printf("e-\n");
+    else if (GetParticleName(primary_particle, global_id) == POSITRON) printf("e+\n");
     printf("[GGEMS OpenCL kernel get_primaries_ggems_xray_source] Position (x, y, z): %e %e %e mm\n", global_position.x/mm, global_position.y/mm, global_position.z/mm);
     printf("[GGEMS OpenCL kernel get_primaries_ggems_xray_source] Direction (x, y, z): %e %e %e\n", direction.x, direction.y, direction.z);
-    printf("[GGEMS OpenCL kernel get_primaries_ggems_xray_source] Energy: %e keV\n", primary_particle->E_[global_id]/keV);
+    printf("[GGEMS OpenCL kernel get_primaries_ggems_xray_source] Energy: %e keV\n", GetParticleEnergy(primary_particle, global_id)/keV);
   }
   #endif
 }
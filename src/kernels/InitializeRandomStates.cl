@@ -0,0 +1,92 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file InitializeRandomStates.cl
+
+  \brief OpenCL kernel initializing states of JKISS engine on device
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.2
+  \date Saturday October 17, 2026
+*/
+
+#include "GGEMS/randoms/GGEMSRandom.hh"
+
+#define GOLDEN_GAMMA 0x9E3779B97F4A7C15UL /*!< Increment of SplitMix64 sequence, odd and close to 2^64/golden ratio */
+
+/*!
+  \fn inline GGulong SplitMix64(GGulong x)
+  \param x - value to hash
+  \return hashed value
+  \brief finalizer of SplitMix64 (Steele et al., OOPSLA 2014), bijection on 64 bits with strong avalanche
+*/
+inline GGulong SplitMix64(GGulong x)
+{
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9UL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBUL;
+  return x ^ (x >> 31);
+}
+
+/*!
+  \fn kernel void initialize_random_states(GGsize const particle_id_limit, global GGEMSRandom* random, GGuint const seed, GGuint const device_index, GGuint const stack_index)
+  \param particle_id_limit - particle id limit
+  \param random - pointer on random buffer
+  \param seed - seed of simulation
+  \param device_index - index of activated device
+  \param stack_index - index of particle stack of device, 1 only for the second stack of pipelined run
+  \brief state of each particle is hashed from seed, index of device, index of stack and index of particle, JKISS forbidden states are avoided
+*/
+kernel void initialize_random_states(
+  GGsize const particle_id_limit,
+  global GGEMSRandom* random,
+  GGuint const seed,
+  GGuint const device_index,
+  GGuint const stack_index)
+{
+  // Get the index of thread
+  GGsize global_id = get_global_id(0);
+
+  // Return if index > to particle limit
+  if (global_id >= particle_id_limit) return;
+
+  // Origin of the sequence of the stack, SplitMix64(0) is 0 so the first stack of a device does not depend on pipelined run
+  GGulong key = SplitMix64(((GGulong)seed << 32) | (GGulong)device_index) ^ SplitMix64((GGulong)stack_index);
+
+  // Two elements of the SplitMix64 sequence by particle, all particles of a stack have different states
+  GGulong counter = key + 2UL*(GGulong)global_id*GOLDEN_GAMMA;
+  GGulong h0 = SplitMix64(counter + GOLDEN_GAMMA);
+  GGulong h1 = SplitMix64(counter + 2UL*GOLDEN_GAMMA);
+
+  GGuint x = (GGuint)h0;
+  GGuint y = (GGuint)(h0 >> 32);
+  GGuint z = (GGuint)h1;
+  GGuint w = (GGuint)(h1 >> 32);
+
+  // JKISS: xorshift state y must not be zero, z and w must not be both zero, carry is 0
+  if (y == 0) y = 123456789;
+  if (z == 0 && w == 0) w = 521288629;
+
+  random->prng_state_1_[global_id] = x;
+  random->prng_state_2_[global_id] = y;
+  random->prng_state_3_[global_id] = z;
+  random->prng_state_4_[global_id] = w;
+  random->prng_state_5_[global_id] = 0;
+}
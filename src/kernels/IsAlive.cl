@@ -32,23 +32,82 @@
 #include "GGEMS/physics/GGEMSParticleConstants.hh"
 
 /*!
-  \fn kernel void is_alive(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGint* status)
+  \fn kernel void is_alive(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGint* status, local GGint* alive_particles)
   \param particle_id_limit - particle id limit
   \param primary_particle - pointer on primary particles
-  \param status - status of particle
-  \brief checking if particle is alive
+  \param status - number of alive particles
+  \param alive_particles - number of alive particles by work-item in the work-group
+  \brief counting alive particles, reduction is done in local memory and only one atomic operation is done by work-group
 */
 kernel void is_alive(
   GGsize const particle_id_limit,
   global GGEMSPrimaryParticles* primary_particle,
-  global GGint* status
+  global GGint* status,
+  local GGint* alive_particles
 )
 {
   // Get the index of thread
   GGsize global_id = get_global_id(0);
+  GGuint local_id = get_local_id(0);
 
-  // Return if index > to particle limit
-  if (global_id >= particle_id_limit) return;
+  // No return before the barriers, work-items outside the particle limit are dead
+  alive_particles[local_id] = (global_id < particle_id_limit && GetParticleStatus(primary_particle, global_id) == ALIVE) ? 1 : 0;
+  barrier(CLK_LOCAL_MEM_FENCE);
 
-  atomic_add(&status[0], primary_particle->status_[global_id]);
+  // Reduction in local memory, stride is the same for all work-items
+  for (GGuint stride = get_local_size(0); stride > 1;) {
+    GGuint half_stride = (stride + 1) >> 1;
+    if (local_id + half_stride < stride) alive_particles[local_id] += alive_particles[local_id + half_stride];
+    stride = half_stride;
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  // Only one global atomic by work-group
+  if (local_id == 0 && alive_particles[0] > 0) atomic_add(&status[0], alive_particles[0]);
+}
+
+/*!
+  \fn kernel void compact_alive(GGsize const particle_id_limit, global GGint const* alive_particles, global GGint* compacted_alive_particles, global GGEMSPrimaryParticles* primary_particle, local GGint* alive_prefix)
+  \param particle_id_limit - particle id limit
+  \param alive_particles - number of alive particles followed by their indices, null if particles are not compacted
+  \param compacted_alive_particles - number of particles still alive followed by their indices, number must be 0 before launch
+  \param primary_particle - pointer on primary particles
+  \param alive_prefix - prefix sum of alive flags in the work-group
+  \brief building the list of alive particles, a prefix sum is done in local memory and only one atomic operation is done by work-group
+*/
+kernel void compact_alive(
+  GGsize const particle_id_limit,
+  global GGint const* alive_particles,
+  global GGint* compacted_alive_particles,
+  global GGEMSPrimaryParticles* primary_particle,
+  local GGint* alive_prefix
+)
+{
+  // Offset of work-group in compacted list
+  local GGint group_offset;
+
+  // Get the index of thread
+  GGuint local_id = get_local_id(0);
+  GGuint local_size = get_local_size(0);
+
+  // No return before the barriers, work-items without particle are dead
+  GGint particle_id = GetParticleID(get_global_id(0), particle_id_limit, alive_particles);
+  GGint is_alive = (particle_id >= 0 && GetParticleStatus(primary_particle, particle_id) == ALIVE) ? 1 : 0;
+  alive_prefix[local_id] = is_alive;
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  // Inclusive prefix sum in local memory (Hillis-Steele)
+  for (GGuint offset = 1; offset < local_size; offset <<= 1) {
+    GGint value = local_id >= offset ? alive_prefix[local_id - offset] : 0;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    alive_prefix[local_id] += value;
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  // Only one global atomic by work-group, reserving space in compacted list
+  if (local_id == local_size - 1) group_offset = alive_prefix[local_id] > 0 ? atomic_add(&compacted_alive_particles[0], alive_prefix[local_id]) : 0;
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  // Order of particles is kept inside the work-group
+  if (is_alive) compacted_alive_particles[1 + group_offset + alive_prefix[local_id] - 1] = particle_id;
 }
@@ -0,0 +1,58 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file ParticleSolidDistanceGGEMSCTSystem.cl
+
+  \brief OpenCL kernel computing distance between all modules of CT system and particles
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.2
+  \date Saturday October 17, 2026
+*/
+
+#include "GGEMS/navigators/GGEMSSolidNavigation.hh"
+
+/*!
+  \fn kernel void particle_solid_distance_ggems_ct_system(GGsize const particle_id_limit, global GGint const* alive_particles, global GGEMSPrimaryParticles* primary_particle, global GGEMSCTSystemData const* ct_system_data, global GGEMSSolidBoxData const* modules_data)
+  \param particle_id_limit - particle id limit
+  \param alive_particles - number of alive particles followed by their indices, null if particles are not compacted
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param ct_system_data - pointer to CT system data
+  \param modules_data - pointer to data of all modules of CT system
+  \brief OpenCL kernel computing distance between all modules of CT system and particles
+*/
+kernel void particle_solid_distance_ggems_ct_system(
+  GGsize const particle_id_limit,
+  global GGint const* alive_particles,
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSCTSystemData const* ct_system_data,
+  global GGEMSSolidBoxData const* modules_data
+)
+{
+  // Getting index of particle, read in list of alive particles if compacted
+  GGint particle_id = GetParticleID(get_global_id(0), particle_id_limit, alive_particles);
+
+  // Return if no particle for this work-item
+  if (particle_id < 0) return;
+
+  // Computing distance between modules crossed by particle and particle
+  ParticleCTSystemDistance(primary_particle, ct_system_data, modules_data, particle_id);
+}
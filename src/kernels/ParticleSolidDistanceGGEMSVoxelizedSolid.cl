@@ -28,81 +28,29 @@
   \date Tuesday May 19, 2020
 */
 
-#include "GGEMS/physics/GGEMSPrimaryParticles.hh"
-
-#include "GGEMS/geometries/GGEMSVoxelizedSolidData.hh"
-#include "GGEMS/geometries/GGEMSRayTracing.hh"
+#include "GGEMS/navigators/GGEMSSolidNavigation.hh"
 
 /*!
-  \fn kernel void particle_solid_distance_ggems_voxelized_solid(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSVoxelizedSolidData const* voxelized_solid_data)
+  \fn kernel void particle_solid_distance_ggems_voxelized_solid(GGsize const particle_id_limit, global GGint const* alive_particles, global GGEMSPrimaryParticles* primary_particle, global GGEMSVoxelizedSolidData const* voxelized_solid_data)
   \param particle_id_limit - particle id limit
+  \param alive_particles - number of alive particles followed by their indices, null if particles are not compacted
   \param primary_particle - pointer to primary particles on OpenCL memory
   \param voxelized_solid_data - pointer to voxelized solid data
   \brief OpenCL kernel computing distance between voxelized solid and particles
 */
 kernel void particle_solid_distance_ggems_voxelized_solid(
   GGsize const particle_id_limit,
+  global GGint const* alive_particles,
   global GGEMSPrimaryParticles* primary_particle,
   global GGEMSVoxelizedSolidData const* voxelized_solid_data
 )
 {
-  // Getting index of thread
-  GGsize global_id = get_global_id(0);
-
-  // Return if index > to particle limit
-  if (global_id >= particle_id_limit) return;
-
-  // Checking particle status. If DEAD, the particle is not track
-  if (primary_particle->status_[global_id] == DEAD) return;
-
-  // Checking if the particle - solid is 0. If yes the particle is already in another navigator
-  if (primary_particle->particle_solid_distance_[global_id] == 0.0f) return;
-
-  // Position of particle
-  GGfloat3 position = {
-    primary_particle->px_[global_id],
-    primary_particle->py_[global_id],
-    primary_particle->pz_[global_id]
-  };
-
-  // Direction of particle
-  GGfloat3 direction = {
-    primary_particle->dx_[global_id],
-    primary_particle->dy_[global_id],
-    primary_particle->dz_[global_id]
-  };
-
-  // Check if particle inside voxelized navigator, if yes distance is 0.0 and not need to compute particle - solid distance
-  if (IsParticleInOBB(&position, &voxelized_solid_data->obb_geometry_)) {
-    #ifdef GGEMS_TRACKING
-    if (global_id == primary_particle->particle_tracking_id) {
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_voxelized_solid] --------------------------------------------------------------------------------\n");
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_voxelized_solid] Find a closest solid\n");
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_voxelized_solid] Particle id: %d\n", global_id);
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_voxelized_solid] Particle in voxelized solid, id: %d\n", voxelized_solid_data->solid_id_);
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_voxelized_solid] Particle solid distance: 0.0\n");
-    }
-    #endif
-    primary_particle->particle_solid_distance_[global_id] = 0.0f;
-    primary_particle->solid_id_[global_id] = voxelized_solid_data->solid_id_;
-    return;
-  }
+  // Getting index of particle, read in list of alive particles if compacted
+  GGint particle_id = GetParticleID(get_global_id(0), particle_id_limit, alive_particles);
 
-  // Compute distance between particles and voxelized navigator
-  GGfloat distance = ComputeDistanceToOBB(&position, &direction, &voxelized_solid_data->obb_geometry_);
+  // Return if no particle for this work-item
+  if (particle_id < 0) return;
 
-  // Check distance value with previous value. Store the minimum value
-  if (distance < primary_particle->particle_solid_distance_[global_id]) {
-    #ifdef GGEMS_TRACKING
-    if (global_id == primary_particle->particle_tracking_id) {
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_voxelized_solid] --------------------------------------------------------------------------------\n");
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_voxelized_solid] Find a closest solid\n");
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_voxelized_solid] Particle id: %d\n", global_id);
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_voxelized_solid] Particle in voxelized solid, id: %d\n", voxelized_solid_data->solid_id_);
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_voxelized_solid] Particle solid distance: %e mm\n", distance/mm);
-    }
-    #endif
-    primary_particle->particle_solid_distance_[global_id] = distance;
-    primary_particle->solid_id_[global_id] = voxelized_solid_data->solid_id_;
-  }
+  // Computing distance between voxelized solid and particle
+  ParticleSolidDistance(primary_particle, &voxelized_solid_data->obb_geometry_, voxelized_solid_data->solid_id_, particle_id);
 }
@@ -28,102 +28,29 @@
   \date Friday May 29, 2020
 */
 
-#include "GGEMS/physics/GGEMSPrimaryParticles.hh"
-#include "GGEMS/geometries/GGEMSVoxelizedSolidData.hh"
-#include "GGEMS/geometries/GGEMSRayTracing.hh"
-#include "GGEMS/global/GGEMSConstants.hh"
-#include "GGEMS/maths/GGEMSMatrixOperations.hh"
+#include "GGEMS/navigators/GGEMSSolidNavigation.hh"
 
 /*!
-  \fn kernel void project_to_ggems_voxelized_solid(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSVoxelizedSolidData const* voxelized_solid_data)
+  \fn kernel void project_to_ggems_voxelized_solid(GGsize const particle_id_limit, global GGint const* alive_particles, global GGEMSPrimaryParticles* primary_particle, global GGEMSVoxelizedSolidData const* voxelized_solid_data)
   \param particle_id_limit - particle id limit
+  \param alive_particles - number of alive particles followed by their indices, null if particles are not compacted
   \param primary_particle - pointer to primary particles on OpenCL memory
   \param voxelized_solid_data - pointer to voxelized solid data
   \brief OpenCL kernel moving particles to voxelized solid
 */
 kernel void project_to_ggems_voxelized_solid(
   GGsize const particle_id_limit,
+  global GGint const* alive_particles,
   global GGEMSPrimaryParticles* primary_particle,
   global GGEMSVoxelizedSolidData const* voxelized_solid_data
 )
 {
-  // Getting index of thread
-  GGsize global_id = get_global_id(0);
+  // Getting index of particle, read in list of alive particles if compacted
+  GGint particle_id = GetParticleID(get_global_id(0), particle_id_limit, alive_particles);
 
-  // Return if index > to particle limit
-  if (global_id >= particle_id_limit) return;
+  // Return if no particle for this work-item
+  if (particle_id < 0) return;
 
-  // No solid detected, consider particle as dead
-  if(primary_particle->solid_id_[global_id] == -1) primary_particle->status_[global_id] = DEAD;
-
-  // Checking if distance to navigator is OUT_OF_WORLD after computation distance
-  // If yes, the particle is OUT_OF_WORLD and DEAD, so no tracking
-  if (primary_particle->particle_solid_distance_[global_id] == OUT_OF_WORLD) {
-    primary_particle->solid_id_[global_id] = -1; // -1 is out_of_world, using for debugging
-    primary_particle->status_[global_id] = DEAD;
-
-    #ifdef OPENGL
-    if (global_id < MAXIMUM_DISPLAYED_PARTICLES) {
-      // Storing OpenGL index on OpenCL private memory
-      GGint stored_particles_gl = primary_particle->stored_particles_gl_[global_id];
-
-      // Checking if buffer is full
-      if (stored_particles_gl != MAXIMUM_INTERACTIONS) {
-        primary_particle->px_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = primary_particle->px_[global_id] + primary_particle->dx_[global_id]*100.0*m;
-        primary_particle->py_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = primary_particle->py_[global_id] + primary_particle->dy_[global_id]*100.0*m;
-        primary_particle->pz_gl_[global_id*MAXIMUM_INTERACTIONS+stored_particles_gl] = primary_particle->pz_[global_id] + primary_particle->dz_[global_id]*100.0*m;
-
-        // Storing final index
-        primary_particle->stored_particles_gl_[global_id] += 1;
-      }
-    }
-    #endif
-
-    return;
-  }
-
-  // Checking if the current navigator is the selected navigator
-  if (primary_particle->solid_id_[global_id] != voxelized_solid_data->solid_id_) return;
-
-  // Checking status of particle
-  if (primary_particle->status_[global_id] == DEAD) return;
-
-  // Position of particle
-  GGfloat3 position = {
-    primary_particle->px_[global_id],
-    primary_particle->py_[global_id],
-    primary_particle->pz_[global_id]
-  };
-
-  // Direction of particle
-  GGfloat3 direction = {
-    primary_particle->dx_[global_id],
-    primary_particle->dy_[global_id],
-    primary_particle->dz_[global_id]
-  };
-
-  // Distance to current navigator and geometry tolerance
-  GGfloat distance = primary_particle->particle_solid_distance_[global_id];
-
-  // Moving the particle slightly inside the volume
-  position += direction*(distance+GEOMETRY_TOLERANCE);
-
-  // Correcting the particle position if not totally inside due to float tolerance
-  TransportGetSafetyInsideOBB(&position, &voxelized_solid_data->obb_geometry_);
-
-  // Set new value for particles
-  primary_particle->px_[global_id] = position.x;
-  primary_particle->py_[global_id] = position.y;
-  primary_particle->pz_[global_id] = position.z;
-
-  primary_particle->particle_solid_distance_[global_id] = 0.0f;
-
-  #ifdef GGEMS_TRACKING
-  if (global_id == primary_particle->particle_tracking_id) {
-    printf("[GGEMS OpenCL kernel project_to_ggems_voxelized_solid] ********************************************************************************\n");
-    printf("[GGEMS OpenCL kernel project_to_ggems_voxelized_solid] Project to closest solid\n");
-    printf("[GGEMS OpenCL kernel project_to_ggems_voxelized_solid] Particle id: %d\n", global_id);
-    printf("[GGEMS OpenCL kernel project_to_ggems_voxelized_solid] Position (x, y, z): %e %e %e mm\n", position.x/mm, position.y/mm, position.z/mm);
-  }
-  #endif
+  // Moving particle to voxelized solid
+  ProjectToSolid(primary_particle, &voxelized_solid_data->obb_geometry_, voxelized_solid_data->solid_id_, particle_id);
 }
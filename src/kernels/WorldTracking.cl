@@ -29,20 +29,19 @@
   \date Wednesday March 3, 2021
 */
 
-#include "GGEMS/physics/GGEMSPrimaryParticles.hh"
-#include "GGEMS/physics/GGEMSParticleConstants.hh"
-#include "GGEMS/geometries/GGEMSGeometryConstants.hh"
+#include "GGEMS/navigators/GGEMSSolidNavigation.hh"
 
 /*!
-  \fn kernel void world_tracking(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGint* photon_tracking, global GGDosiType* edep_tracking, global GGDosiType* edep_squared_tracking, global GGDosiType* momentum_x, global GGDosiType* momentum_y, global GGDosiType* momentum_z, GGsize width, GGsize height, GGsize depth, GGfloat size_x, GGfloat size_y, GGfloat size_z)
+  \fn kernel void world_tracking(GGsize const particle_id_limit, global GGint const* alive_particles, global GGEMSPrimaryParticles* primary_particle, global GGint* photon_tracking, global GGDosiType* edep_tracking, global GGDosiType* edep_squared_tracking, global GGDosiType* momentum_x, global GGDosiType* momentum_y, global GGDosiType* momentum_z, GGsize width, GGsize height, GGsize depth, GGfloat size_x, GGfloat size_y, GGfloat size_z)
   \param particle_id_limit - particle id limit
+  \param alive_particles - number of alive particles followed by their indices, null if particles are not compacted
   \param primary_particle - pointer to primary particles on OpenCL memory
   \param photon_tracking - photon tracking counter in world
-  \param edep_tracking - energy tracking in world
-  \param edep_squared_tracking - energy tracking in world
-  \param momentum_x - sum of momentum along X
-  \param momentum_y - sum of momentum along Y
-  \param momentum_z - sum of momentum along Z
+  \param edep_tracking - sum of energy times track length in world (MeV.mm)
+  \param edep_squared_tracking - sum of squared energy times track length in world (MeV2.mm), divided by edep_tracking it gives the mean energy weighted by energy fluence, not a variance of the estimate
+  \param momentum_x - sum of energy times track length times direction along X (MeV.mm)
+  \param momentum_y - sum of energy times track length times direction along Y (MeV.mm)
+  \param momentum_z - sum of energy times track length times direction along Z (MeV.mm)
   \param width - number of elements in world along X
   \param height - number of elements in world along Y
   \param depth - number of elements in world along Z
@@ -53,6 +52,7 @@
 */
 kernel void world_tracking(
   GGsize const particle_id_limit,
+  global GGint const* alive_particles,
   global GGEMSPrimaryParticles* primary_particle,
   global GGint* photon_tracking,
   global GGDosiType* edep_tracking,
@@ -68,95 +68,12 @@ kernel void world_tracking(
   GGfloat size_z
 )
 {
-  // Getting index of thread
-  GGsize global_id = get_global_id(0);
+  // Getting index of particle, read in list of alive particles if compacted
+  GGint particle_id = GetParticleID(get_global_id(0), particle_id_limit, alive_particles);
 
-  // Return if index > to particle limit
-  if (global_id >= particle_id_limit) return;
+  // Return if no particle for this work-item
+  if (particle_id < 0) return;
 
-  if (primary_particle->status_[global_id] == DEAD) return;
-
-  // In world, the particles is tracked using a DDA algorithm
-  // Get direction of particle
-  GGfloat3 direction = {primary_particle->dx_[global_id], primary_particle->dy_[global_id], primary_particle->dz_[global_id]};
-  // Get point x1, y1 and z1
-  GGfloat3 p1 = {primary_particle->px_[global_id], primary_particle->py_[global_id], primary_particle->pz_[global_id]};
-  // Get voxel size
-  GGfloat3 size = {size_x, size_y, size_z};
-
-  // Computing point x2, y2, z2
-  GGfloat distance = primary_particle->particle_solid_distance_[global_id] == OUT_OF_WORLD ? 10000.0f : primary_particle->particle_solid_distance_[global_id];
-
-  if (distance <= GEOMETRY_TOLERANCE) return;
-
-  GGfloat3 p2 = p1 + distance*direction;
-
-  // Start index
-  GGint3 dim = {width, height, depth};
-  GGint3 index = convert_int3((p1 - (size*convert_float3(dim)*-0.5f))/size);
-
-  // Computing difference between p1 and p2 and length for each axis
-  GGfloat3 diff_p1_p2 = p2 - p1;
-  GGfloat3 len_p1_p2 = fabs(diff_p1_p2);
-
-  // Getting main direction and size
-  GGfloat length = len_p1_p2.x;
-  GGfloat main_size = size.x;
-  if (len_p1_p2.y > length) {
-    length = len_p1_p2.y;
-    main_size = size.y;
-  }
-  else if (len_p1_p2.z > length) {
-    length = len_p1_p2.z;
-    main_size = size.z;
-  }
-
-  GGfloat inv_length = 1.0f / length;
-
-  // Computing incrementation
-  GGfloat3 increment = inv_length*diff_p1_p2;
-
-  // Computing number of step
-  GGint step = (GGint)(1.0f + (length/main_size));
-  GGint global_index_world = 0;
-
-  for (GGint i = 0; i < step; ++i) {
-    // Checking index
-    if (index.x < 0 || index.x >= dim.x || index.y < 0 || index.y >= dim.y || index.z < 0 || index.z >= dim.z) {
-      break;
-    }
-
-    global_index_world = index.x + index.y * dim.x + index.z * dim.x * dim.y;
-
-    if (photon_tracking) atomic_add(&photon_tracking[global_index_world], 1);
-
-    #ifdef DOSIMETRY_DOUBLE_PRECISION
-    if (edep_tracking) AtomicAddDouble(&edep_tracking[global_index_world], (GGDosiType)primary_particle->E_[global_id]);
-    if (edep_squared_tracking) AtomicAddDouble(&edep_squared_tracking[global_index_world], (GGDosiType)primary_particle->E_[global_id]*(GGDosiType)primary_particle->E_[global_id]);
-    if (momentum_x) AtomicAddDouble(&momentum_x[global_index_world], (GGDosiType)primary_particle->dx_[global_id]);
-    if (momentum_y) AtomicAddDouble(&momentum_y[global_index_world], (GGDosiType)primary_particle->dy_[global_id]);
-    if (momentum_z) AtomicAddDouble(&momentum_z[global_index_world], (GGDosiType)primary_particle->dz_[global_id]);
-    #else
-    if (edep_tracking) AtomicAddFloat(&edep_tracking[global_index_world], (GGDosiType)primary_particle->E_[global_id]);
-    if (edep_squared_tracking) AtomicAddFloat(&edep_squared_tracking[global_index_world], (GGDosiType)primary_particle->E_[global_id]*(GGDosiType)primary_particle->E_[global_id]);
-    if (momentum_x) AtomicAddFloat(&momentum_x[global_index_world], (GGDosiType)primary_particle->dx_[global_id]);
-    if (momentum_y) AtomicAddFloat(&momentum_y[global_index_world], (GGDosiType)primary_particle->dy_[global_id]);
-    if (momentum_z) AtomicAddFloat(&momentum_z[global_index_world], (GGDosiType)primary_particle->dz_[global_id]);
-    #endif
-
-    p1 += increment*main_size;
-    index = convert_int3((p1 - (size*convert_float3(dim)*-0.5f))/size);
-  }
-
-  #ifdef GGEMS_TRACKING
-  if (global_id == primary_particle->particle_tracking_id) {
-    printf("[GGEMS OpenCL kernel world_tracking] ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
-    printf("[GGEMS OpenCL kernel world_tracking] World tracking particle\n");
-    printf("[GGEMS OpenCL kernel world_tracking] Particle status: %d, DEAD: %d, ALIVE: %d\n", primary_particle->status_[global_id], DEAD, ALIVE);
-    printf("[GGEMS OpenCL kernel world_tracking] Particle position: %e %e %e mm\n", primary_particle->px_[global_id]/mm, primary_particle->py_[global_id]/mm, primary_particle->pz_[global_id]/mm);
-    printf("[GGEMS OpenCL kernel world_tracking] Particle direction: %e %e %e\n", primary_particle->dx_[global_id], primary_particle->dy_[global_id], primary_particle->dz_[global_id]);
-    printf("[GGEMS OpenCL kernel world_tracking] Particle energy: %e keV\n", primary_particle->E_[global_id]/keV);
-    printf("[GGEMS OpenCL kernel world_tracking] Distance to next solid: %e mm\n", distance/mm);
-  }
-  #endif
+  // Tracking particle in world until next solid
+  WorldTracking(primary_particle, photon_tracking, edep_tracking, edep_squared_tracking, momentum_x, momentum_y, momentum_z, width, height, depth, size_x, size_y, size_z, particle_id);
 }
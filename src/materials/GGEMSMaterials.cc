@@ -29,10 +29,12 @@
 */
 
 #include <limits>
+#include <cstring>
 
 #include "GGEMS/navigators/GGEMSNavigatorManager.hh"
 #include "GGEMS/materials/GGEMSIonizationParamsMaterial.hh"
 #include "GGEMS/physics/GGEMSRangeCuts.hh"
+#include "GGEMS/physics/GGEMSProcessesManager.hh"
 #include "GGEMS/tools/GGEMSRAMManager.hh"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -53,7 +55,7 @@ GGEMSMaterials::GGEMSMaterials(void)
   number_activated_devices_ = opencl_manager.GetNumberOfActivatedDevice();
 
   material_tables_ = new cl::Buffer*[number_activated_devices_];
-
+  material_tables_size_ = 0;
 
   GGcout("GGEMSMaterials", "GGEMSMaterials", 3) << "GGEMSMaterials created!!!" << GGendl;
 }
@@ -86,7 +88,7 @@ void GGEMSMaterials::Clean(void)
 
   if (material_tables_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(material_tables_[i], sizeof(GGEMSMaterialTables), i);
+      opencl_manager.Deallocate(material_tables_[i], material_tables_size_, i);
     }
     delete[] material_tables_;
     material_tables_ = nullptr;
@@ -102,8 +104,11 @@ void GGEMSMaterials::Clean(void)
 void GGEMSMaterials::AddMaterial(std::string const& material_name)
 {
   // Checking the number of material
-  if (materials_.size() == 255) {
-    GGEMSMisc::ThrowException("GGEMSMaterials", "AddMaterial", "Limit of material reached. The limit is 255 materials!!!");
+  // The maximum of label type is kept for voxels out of any material range
+  if (materials_.size() == static_cast<GGsize>(std::numeric_limits<GGLabelType>::max())) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Limit of material reached. The limit is " << static_cast<GGsize>(std::numeric_limits<GGLabelType>::max()) << " materials!!! Compile GGEMS with LABEL_16BITS to use more materials.";
+    GGEMSMisc::ThrowException("GGEMSMaterials", "AddMaterial", oss.str());
   }
 
   // Add material and check if the material already exists
@@ -148,7 +153,7 @@ void GGEMSMaterials::PrintInfos(void) const
   // Loop over the device
   for (GGsize d = 0; d < number_activated_devices_; ++d) {
     // Getting the OpenCL pointer on material tables
-    GGEMSMaterialTables* material_table_device = opencl_manager.GetDeviceBuffer<GGEMSMaterialTables>(material_tables_[d], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSMaterialTables), d);
+    GGEMSMaterialTables* material_table_device = opencl_manager.GetDeviceBuffer<GGEMSMaterialTables>(material_tables_[d], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, material_tables_size_, d);
 
     // Get the index of device
     GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(d);
@@ -162,39 +167,39 @@ void GGEMSMaterials::PrintInfos(void) const
     GGcout("GGEMSMaterials", "PrintInfos", 0) << "-----------------------------------" << GGendl;
     for (GGsize i = 0; i < material_table_device->number_of_materials_; ++i) {
       GGcout("GGEMSMaterials", "PrintInfos", 0) << "* " << materials_.at(i) << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Number of chemical elements: " << static_cast<GGushort>(material_table_device->number_of_chemical_elements_[i]) << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Density: " << material_table_device->density_of_material_[i]/(g/cm3) << " g/cm3" << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Photon cut: " << BestEnergyUnit(material_table_device->photon_energy_cut_[i]) << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Electron cut: " << BestEnergyUnit(material_table_device->electron_energy_cut_[i]) << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Positron cut: " << BestEnergyUnit(material_table_device->positron_energy_cut_[i]) << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Radiation length: " << BestDistanceUnit(material_table_device->radiation_length_[i]) << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Total atomic density: " << material_table_device->number_of_atoms_by_volume_[i]/(mol/cm3) << " atom/cm3" << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Total electron density: " << material_table_device->number_of_electrons_by_volume_[i]/(mol/cm3) << " e-/cm3" << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Number of chemical elements: " << static_cast<GGushort>(GGEMS_TABLE(GGsize, material_table_device, number_of_chemical_elements_)[i]) << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Density: " << GGEMS_TABLE(GGfloat, material_table_device, density_of_material_)[i]/(g/cm3) << " g/cm3" << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Photon cut: " << BestEnergyUnit(GGEMS_TABLE(GGfloat, material_table_device, photon_energy_cut_)[i]) << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Electron cut: " << BestEnergyUnit(GGEMS_TABLE(GGfloat, material_table_device, electron_energy_cut_)[i]) << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Positron cut: " << BestEnergyUnit(GGEMS_TABLE(GGfloat, material_table_device, positron_energy_cut_)[i]) << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Radiation length: " << BestDistanceUnit(GGEMS_TABLE(GGfloat, material_table_device, radiation_length_)[i]) << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Total atomic density: " << GGEMS_TABLE(GGfloat, material_table_device, number_of_atoms_by_volume_)[i]/(mol/cm3) << " atom/cm3" << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Total electron density: " << GGEMS_TABLE(GGfloat, material_table_device, number_of_electrons_by_volume_)[i]/(mol/cm3) << " e-/cm3" << GGendl;
       GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Chemical Elements:" << GGendl;
-      for (GGsize j = 0; j < material_table_device->number_of_chemical_elements_[i]; ++j) {
-        GGsize chemical_element_id = material_table_device->index_of_chemical_elements_[i];
-        GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + Z = " << static_cast<GGushort>(material_table_device->atomic_number_Z_[j+chemical_element_id]) << GGendl;
-        GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + fraction of chemical element = " << material_table_device->mass_fraction_[j+chemical_element_id]/percent << " %" << GGendl;
-        GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + Atomic number density = " << material_table_device->atomic_number_density_[j+chemical_element_id]/(mol/cm3) << " atom/cm3" << GGendl;
-        GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + Element abundance = " << 100.0f*material_table_device->atomic_number_density_[j+chemical_element_id]/material_table_device->number_of_atoms_by_volume_[i] << " %" << GGendl;
+      for (GGsize j = 0; j < GGEMS_TABLE(GGsize, material_table_device, number_of_chemical_elements_)[i]; ++j) {
+        GGsize chemical_element_id = GGEMS_TABLE(GGsize, material_table_device, index_of_chemical_elements_)[i];
+        GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + Z = " << static_cast<GGushort>(GGEMS_TABLE(GGuchar, material_table_device, atomic_number_Z_)[j+chemical_element_id]) << GGendl;
+        GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + fraction of chemical element = " << GGEMS_TABLE(GGfloat, material_table_device, mass_fraction_)[j+chemical_element_id]/percent << " %" << GGendl;
+        GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + Atomic number density = " << GGEMS_TABLE(GGfloat, material_table_device, atomic_number_density_)[j+chemical_element_id]/(mol/cm3) << " atom/cm3" << GGendl;
+        GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + Element abundance = " << 100.0f*GGEMS_TABLE(GGfloat, material_table_device, atomic_number_density_)[j+chemical_element_id]/GGEMS_TABLE(GGfloat, material_table_device, number_of_atoms_by_volume_)[i] << " %" << GGendl;
       }
       GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Energy loss fluctuation data:" << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + Mean electron excitation energy: " << BestEnergyUnit(material_table_device->mean_excitation_energy_[i]) << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + Log mean electron excitation energy: " << material_table_device->log_mean_excitation_energy_[i] << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + f1: " << material_table_device->f1_fluct_[i] << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + f2: " << material_table_device->f2_fluct_[i] << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + energy0: " << BestEnergyUnit(material_table_device->energy0_fluct_[i]) << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + energy1: " << BestEnergyUnit(material_table_device->energy1_fluct_[i]) << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + energy2: " << BestEnergyUnit(material_table_device->energy2_fluct_[i]) << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + log energy 1: " << material_table_device->log_energy1_fluct_[i] << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + log energy 2: " << material_table_device->log_energy2_fluct_[i] << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + Mean electron excitation energy: " << BestEnergyUnit(GGEMS_TABLE(GGfloat, material_table_device, mean_excitation_energy_)[i]) << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + Log mean electron excitation energy: " << GGEMS_TABLE(GGfloat, material_table_device, log_mean_excitation_energy_)[i] << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + f1: " << GGEMS_TABLE(GGfloat, material_table_device, f1_fluct_)[i] << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + f2: " << GGEMS_TABLE(GGfloat, material_table_device, f2_fluct_)[i] << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + energy0: " << BestEnergyUnit(GGEMS_TABLE(GGfloat, material_table_device, energy0_fluct_)[i]) << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + energy1: " << BestEnergyUnit(GGEMS_TABLE(GGfloat, material_table_device, energy1_fluct_)[i]) << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + energy2: " << BestEnergyUnit(GGEMS_TABLE(GGfloat, material_table_device, energy2_fluct_)[i]) << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + log energy 1: " << GGEMS_TABLE(GGfloat, material_table_device, log_energy1_fluct_)[i] << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + log energy 2: " << GGEMS_TABLE(GGfloat, material_table_device, log_energy2_fluct_)[i] << GGendl;
       GGcout("GGEMSMaterials", "PrintInfos", 0) << "    - Density correction data:" << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + x0 = " << material_table_device->x0_density_[i] << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + x1 = " << material_table_device->x1_density_[i] << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + d0 = " << material_table_device->d0_density_[i] << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + -C = " << material_table_device->c_density_[i] << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + a = " << material_table_device->a_density_[i] << GGendl;
-      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + m = " << material_table_device->m_density_[i] << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + x0 = " << GGEMS_TABLE(GGfloat, material_table_device, x0_density_)[i] << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + x1 = " << GGEMS_TABLE(GGfloat, material_table_device, x1_density_)[i] << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + d0 = " << GGEMS_TABLE(GGfloat, material_table_device, d0_density_)[i] << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + -C = " << GGEMS_TABLE(GGfloat, material_table_device, c_density_)[i] << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + a = " << GGEMS_TABLE(GGfloat, material_table_device, a_density_)[i] << GGendl;
+      GGcout("GGEMSMaterials", "PrintInfos", 0) << "        + m = " << GGEMS_TABLE(GGfloat, material_table_device, m_density_)[i] << GGendl;
     }
     GGcout("GGEMSMaterials", "PrintInfos", 0) << GGendl;
 
@@ -207,6 +212,48 @@ void GGEMSMaterials::PrintInfos(void) const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+GGsize GGEMSMaterials::GetTotalNumberOfChemicalElements(void) const
+{
+  GGEMSMaterialsDatabaseManager& material_database_manager = GGEMSMaterialsDatabaseManager::GetInstance();
+
+  GGsize total_number_of_chemical_elements = 0;
+  for (GGsize i = 0; i < materials_.size(); ++i) {
+    total_number_of_chemical_elements += material_database_manager.GetMaterial(materials_.at(i)).nb_elements_;
+  }
+
+  return total_number_of_chemical_elements;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSMaterials::GetPhysicTablesCacheKey(void) const
+{
+  GGEMSMaterialsDatabaseManager& material_database_manager = GGEMSMaterialsDatabaseManager::GetInstance();
+
+  // Values are written in hexadecimal, tables are reused only for exactly the same materials
+  std::ostringstream oss(std::ostringstream::out);
+  oss << std::hexfloat;
+  for (GGsize i = 0; i < materials_.size(); ++i) {
+    GGEMSSingleMaterial const& single_material = material_database_manager.GetMaterial(materials_.at(i));
+    oss << "material " << materials_.at(i) << ' ' << single_material.density_ << ' ' << single_material.nb_elements_ << '\n';
+    for (GGsize j = 0; j < single_material.nb_elements_; ++j) {
+      GGEMSChemicalElement const& chemical_element = material_database_manager.GetChemicalElement(single_material.chemical_element_name_[j]);
+      oss << "  element " << single_material.chemical_element_name_[j] << ' ' << single_material.mixture_f_[j] << ' '
+          << static_cast<GGint>(chemical_element.atomic_number_Z_) << ' ' << chemical_element.molar_mass_M_ << ' '
+          << chemical_element.mean_excitation_energy_I_ << ' ' << static_cast<GGint>(chemical_element.state_) << ' '
+          << chemical_element.index_density_correction_ << '\n';
+    }
+  }
+
+  return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSMaterials::BuildMaterialTables(void)
 {
   GGcout("GGEMSMaterials", "BuildMaterialTables", 3) << "Building the material tables..." << GGendl;
@@ -217,16 +264,61 @@ void GGEMSMaterials::BuildMaterialTables(void)
   // Get the material database manager
   GGEMSMaterialsDatabaseManager& material_database_manager = GGEMSMaterialsDatabaseManager::GetInstance();
 
-  // Loop over activated device and allocate particle buffer on each device
-  for (GGsize d = 0; d < number_activated_devices_; ++d) {
-    // Allocating memory for material tables in OpenCL device
-    material_tables_[d] = opencl_manager.Allocate(nullptr, sizeof(GGEMSMaterialTables), d, CL_MEM_READ_WRITE, "GGEMSMaterials");
-
-    // Getting the OpenCL pointer on material tables
-    GGEMSMaterialTables* material_table_device = opencl_manager.GetDeviceBuffer<GGEMSMaterialTables>(material_tables_[d], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSMaterialTables), d);
-
-    // Get the number of activated materials
-    material_table_device->number_of_materials_ = static_cast<GGuchar>(materials_.size());
+  // Counting chemical elements, tables are sized to the activated materials only
+  GGsize number_of_materials = materials_.size();
+  GGsize total_number_of_chemical_elements = GetTotalNumberOfChemicalElements();
+
+  // Computing the offset of each table after the header
+  GGEMSMaterialTables material_tables_header;
+  material_tables_header.number_of_materials_ = number_of_materials;
+  material_tables_header.total_number_of_chemical_elements_ = total_number_of_chemical_elements;
+
+  material_tables_size_ = sizeof(GGEMSMaterialTables);
+  GGsize material_float_size = number_of_materials * sizeof(GGfloat);
+  material_tables_header.number_of_chemical_elements_ = AppendTable(material_tables_size_, number_of_materials * sizeof(GGsize));
+  material_tables_header.density_of_material_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.number_of_atoms_by_volume_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.number_of_electrons_by_volume_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.mean_excitation_energy_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.log_mean_excitation_energy_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.radiation_length_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.x0_density_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.x1_density_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.d0_density_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.c_density_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.a_density_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.m_density_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.f1_fluct_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.f2_fluct_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.energy0_fluct_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.energy1_fluct_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.energy2_fluct_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.log_energy1_fluct_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.log_energy2_fluct_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.photon_energy_cut_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.electron_energy_cut_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.positron_energy_cut_ = AppendTable(material_tables_size_, material_float_size);
+  material_tables_header.index_of_chemical_elements_ = AppendTable(material_tables_size_, number_of_materials * sizeof(GGsize));
+  material_tables_header.atomic_number_Z_ = AppendTable(material_tables_size_, total_number_of_chemical_elements * sizeof(GGuchar));
+  material_tables_header.atomic_number_density_ = AppendTable(material_tables_size_, total_number_of_chemical_elements * sizeof(GGfloat));
+  material_tables_header.mass_fraction_ = AppendTable(material_tables_size_, total_number_of_chemical_elements * sizeof(GGfloat));
+
+  // Material tables and energy cuts are loaded from cache if computed before with the same materials and cuts
+  GGEMSProcessesManager& process_manager = GGEMSProcessesManager::GetInstance();
+  std::ostringstream cache_key(std::ostringstream::out);
+  cache_key << "materials " << sizeof(GGEMSMaterialTables) << '\n' << std::hexfloat
+    << process_manager.GetCrossSectionTableMinEnergy() << ' ' << range_cuts_->GetPhotonDistanceCut() << ' '
+    << range_cuts_->GetElectronDistanceCut() << ' ' << range_cuts_->GetPositronDistanceCut() << '\n'
+    << GetPhysicTablesCacheKey();
+
+  if (process_manager.LoadPhysicTables(cache_key.str(), material_tables_size_, material_tables_host_)) {
+    range_cuts_->StoreEnergyCuts(this);
+  }
+  else {
+    // Tables are built once on host, header is stored first
+    material_tables_host_.assign(material_tables_size_, 0);
+    GGEMSMaterialTables* material_tables_host = GetMaterialTablesHost();
+    *material_tables_host = material_tables_header;
 
     // Loop over the materials
     GGsize index_to_chemical_element = 0;
@@ -235,12 +327,12 @@ void GGEMSMaterials::BuildMaterialTables(void)
       GGEMSSingleMaterial const& single_material = material_database_manager.GetMaterial(materials_.at(i));
 
       // Storing infos about material
-      material_table_device->number_of_chemical_elements_[i] = single_material.nb_elements_;
-      material_table_device->density_of_material_[i] = single_material.density_;
+      GGEMS_TABLE(GGsize, material_tables_host, number_of_chemical_elements_)[i] = single_material.nb_elements_;
+      GGEMS_TABLE(GGfloat, material_tables_host, density_of_material_)[i] = single_material.density_;
 
       // Initialize some counters
-      material_table_device->number_of_atoms_by_volume_[i] = 0.0f;
-      material_table_device->number_of_electrons_by_volume_[i] = 0.0f;
+      GGEMS_TABLE(GGfloat, material_tables_host, number_of_atoms_by_volume_)[i] = 0.0f;
+      GGEMS_TABLE(GGfloat, material_tables_host, number_of_electrons_by_volume_)[i] = 0.0f;
 
       // Loop over the chemical elements by material
       for (GGsize j = 0; j < single_material.nb_elements_; ++j) {
@@ -248,56 +340,73 @@ void GGEMSMaterials::BuildMaterialTables(void)
         GGEMSChemicalElement const& chemical_element = material_database_manager.GetChemicalElement(single_material.chemical_element_name_[j]);
 
         // Atomic number Z
-        material_table_device->atomic_number_Z_[j+index_to_chemical_element] = chemical_element.atomic_number_Z_;
+        GGEMS_TABLE(GGuchar, material_tables_host, atomic_number_Z_)[j+index_to_chemical_element] = chemical_element.atomic_number_Z_;
 
         // Mass fraction of element by material
-        material_table_device->mass_fraction_[j+index_to_chemical_element] = single_material.mixture_f_[j];
+        GGEMS_TABLE(GGfloat, material_tables_host, mass_fraction_)[j+index_to_chemical_element] = single_material.mixture_f_[j];
 
         // Atomic number density
-        material_table_device->atomic_number_density_[j+index_to_chemical_element] = material_database_manager.GetAtomicNumberDensity(materials_.at(i), j);
+        GGEMS_TABLE(GGfloat, material_tables_host, atomic_number_density_)[j+index_to_chemical_element] = material_database_manager.GetAtomicNumberDensity(materials_.at(i), j);
 
         // Increment density of atoms and electrons
-        material_table_device->number_of_atoms_by_volume_[i] += material_table_device->atomic_number_density_[j+index_to_chemical_element];
-        material_table_device->number_of_electrons_by_volume_[i] += material_table_device->atomic_number_density_[j+index_to_chemical_element] * chemical_element.atomic_number_Z_;
+        GGEMS_TABLE(GGfloat, material_tables_host, number_of_atoms_by_volume_)[i] += GGEMS_TABLE(GGfloat, material_tables_host, atomic_number_density_)[j+index_to_chemical_element];
+        GGEMS_TABLE(GGfloat, material_tables_host, number_of_electrons_by_volume_)[i] += GGEMS_TABLE(GGfloat, material_tables_host, atomic_number_density_)[j+index_to_chemical_element] * chemical_element.atomic_number_Z_;
       }
 
       // Computing ionization params for a material
       GGEMSIonizationParamsMaterial ionization_params(&single_material);
-      material_table_device->mean_excitation_energy_[i] = ionization_params.GetMeanExcitationEnergy();
-      material_table_device->log_mean_excitation_energy_[i] = ionization_params.GetLogMeanExcitationEnergy();
-      material_table_device->x0_density_[i] = ionization_params.GetX0Density();
-      material_table_device->x1_density_[i] = ionization_params.GetX1Density();
-      material_table_device->d0_density_[i] = ionization_params.GetD0Density();
-      material_table_device->c_density_[i] = ionization_params.GetCDensity();
-      material_table_device->a_density_[i] = ionization_params.GetADensity();
-      material_table_device->m_density_[i] = ionization_params.GetMDensity();
+      GGEMS_TABLE(GGfloat, material_tables_host, mean_excitation_energy_)[i] = ionization_params.GetMeanExcitationEnergy();
+      GGEMS_TABLE(GGfloat, material_tables_host, log_mean_excitation_energy_)[i] = ionization_params.GetLogMeanExcitationEnergy();
+      GGEMS_TABLE(GGfloat, material_tables_host, x0_density_)[i] = ionization_params.GetX0Density();
+      GGEMS_TABLE(GGfloat, material_tables_host, x1_density_)[i] = ionization_params.GetX1Density();
+      GGEMS_TABLE(GGfloat, material_tables_host, d0_density_)[i] = ionization_params.GetD0Density();
+      GGEMS_TABLE(GGfloat, material_tables_host, c_density_)[i] = ionization_params.GetCDensity();
+      GGEMS_TABLE(GGfloat, material_tables_host, a_density_)[i] = ionization_params.GetADensity();
+      GGEMS_TABLE(GGfloat, material_tables_host, m_density_)[i] = ionization_params.GetMDensity();
 
       // Energy fluctuation parameters
-      material_table_device->f1_fluct_[i] = ionization_params.GetF1Fluct();
-      material_table_device->f2_fluct_[i] = ionization_params.GetF2Fluct();
-      material_table_device->energy0_fluct_[i] = ionization_params.GetEnergy0Fluct();
-      material_table_device->energy1_fluct_[i] = ionization_params.GetEnergy1Fluct();
-      material_table_device->energy2_fluct_[i] = ionization_params.GetEnergy2Fluct();
-      material_table_device->log_energy1_fluct_[i] = ionization_params.GetLogEnergy1Fluct();
-      material_table_device->log_energy2_fluct_[i] = ionization_params.GetLogEnergy2Fluct();
+      GGEMS_TABLE(GGfloat, material_tables_host, f1_fluct_)[i] = ionization_params.GetF1Fluct();
+      GGEMS_TABLE(GGfloat, material_tables_host, f2_fluct_)[i] = ionization_params.GetF2Fluct();
+      GGEMS_TABLE(GGfloat, material_tables_host, energy0_fluct_)[i] = ionization_params.GetEnergy0Fluct();
+      GGEMS_TABLE(GGfloat, material_tables_host, energy1_fluct_)[i] = ionization_params.GetEnergy1Fluct();
+      GGEMS_TABLE(GGfloat, material_tables_host, energy2_fluct_)[i] = ionization_params.GetEnergy2Fluct();
+      GGEMS_TABLE(GGfloat, material_tables_host, log_energy1_fluct_)[i] = ionization_params.GetLogEnergy1Fluct();
+      GGEMS_TABLE(GGfloat, material_tables_host, log_energy2_fluct_)[i] = ionization_params.GetLogEnergy2Fluct();
 
       // Radiation length
-      material_table_device->radiation_length_[i] = material_database_manager.GetRadiationLength(materials_.at(i));
+      GGEMS_TABLE(GGfloat, material_tables_host, radiation_length_)[i] = material_database_manager.GetRadiationLength(materials_.at(i));
 
       // Computing the access to chemical element by material
-      material_table_device->index_of_chemical_elements_[i] = index_to_chemical_element;
-      index_to_chemical_element += material_table_device->number_of_chemical_elements_[i];
+      GGEMS_TABLE(GGsize, material_tables_host, index_of_chemical_elements_)[i] = index_to_chemical_element;
+      index_to_chemical_element += GGEMS_TABLE(GGsize, material_tables_host, number_of_chemical_elements_)[i];
     }
 
-    // Storing number total of chemical elements
-    material_table_device->total_number_of_chemical_elements_ = index_to_chemical_element;
+    // Converting length cut to energy cut
+    range_cuts_->ConvertCutsFromDistanceToEnergy(this);
 
-    // Release the pointer, mandatory step!!!
-    opencl_manager.ReleaseDeviceBuffer(material_tables_[d], material_table_device, d);
+    process_manager.SavePhysicTables(cache_key.str(), material_tables_host_);
   }
 
-  // Converting length cut to energy cut
-  range_cuts_->ConvertCutsFromDistanceToEnergy(this);
+  // Copying material tables to all devices
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    material_tables_[d] = opencl_manager.Allocate(material_tables_host_.data(), material_tables_size_, d, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, "GGEMSMaterials");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSMaterials::CopyMaterialTablesToDevices(void)
+{
+  // Get the OpenCL manager
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    GGuchar* material_table_device = opencl_manager.GetDeviceBuffer<GGuchar>(material_tables_[d], CL_TRUE, CL_MAP_WRITE, material_tables_size_, d);
+    std::memcpy(material_table_device, material_tables_host_.data(), material_tables_size_);
+    opencl_manager.ReleaseDeviceBuffer(material_tables_[d], material_table_device, d);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -310,7 +419,7 @@ GGfloat GGEMSMaterials::GetDensity(std::string const& material_name, GGsize cons
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
   // Getting the OpenCL pointer on material tables
-  GGEMSMaterialTables* material_table_device = opencl_manager.GetDeviceBuffer<GGEMSMaterialTables>(material_tables_[thread_index], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSMaterialTables), thread_index);
+  GGEMSMaterialTables* material_table_device = opencl_manager.GetDeviceBuffer<GGEMSMaterialTables>(material_tables_[thread_index], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, material_tables_size_, thread_index);
 
   // Get index of material
   std::vector<std::string>::const_iterator iter_mat = std::find(materials_.begin(), materials_.end(), material_name);
@@ -321,7 +430,7 @@ GGfloat GGEMSMaterials::GetDensity(std::string const& material_name, GGsize cons
   }
   ptrdiff_t index = std::distance(materials_.begin(), iter_mat);
 
-  GGfloat density = material_table_device->density_of_material_[index];
+  GGfloat density = GGEMS_TABLE(GGfloat, material_table_device, density_of_material_)[index];
 
   opencl_manager.ReleaseDeviceBuffer(material_tables_[thread_index], material_table_device, thread_index);
 
@@ -338,12 +447,12 @@ GGfloat GGEMSMaterials::GetAtomicNumberDensity(std::string const& material_name,
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
   // Getting the OpenCL pointer on material tables
-  GGEMSMaterialTables* material_table_device = opencl_manager.GetDeviceBuffer<GGEMSMaterialTables>(material_tables_[thread_index], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSMaterialTables), thread_index);
+  GGEMSMaterialTables* material_table_device = opencl_manager.GetDeviceBuffer<GGEMSMaterialTables>(material_tables_[thread_index], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, material_tables_size_, thread_index);
 
   // Get index of material
   ptrdiff_t index = GetMaterialIndex(material_name);
 
-  GGfloat atomic_number_density = material_table_device->atomic_number_density_[index];
+  GGfloat atomic_number_density = GGEMS_TABLE(GGfloat, material_table_device, atomic_number_density_)[index];
 
   opencl_manager.ReleaseDeviceBuffer(material_tables_[thread_index], material_table_device, thread_index);
 
@@ -362,24 +471,25 @@ GGfloat GGEMSMaterials::GetEnergyCut(std::string const& material_name, std::stri
   // Set distance cut
   SetDistanceCut(particle_type, distance, unit);
 
-  // Convert cut
+  // Convert cut, and update tables on devices
   range_cuts_->ConvertCutsFromDistanceToEnergy(this);
+  CopyMaterialTablesToDevices();
 
   // Getting the OpenCL pointer on material tables
-  GGEMSMaterialTables* material_table_device = opencl_manager.GetDeviceBuffer<GGEMSMaterialTables>(material_tables_[thread_index], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSMaterialTables), thread_index);
+  GGEMSMaterialTables* material_table_device = opencl_manager.GetDeviceBuffer<GGEMSMaterialTables>(material_tables_[thread_index], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, material_tables_size_, thread_index);
 
   // Get index of material
   ptrdiff_t index = GetMaterialIndex(material_name);
 
   GGfloat energy_cut = 0.0f;
   if (particle_type == "gamma") {
-    energy_cut = material_table_device->photon_energy_cut_[index];
+    energy_cut = GGEMS_TABLE(GGfloat, material_table_device, photon_energy_cut_)[index];
   }
   else if (particle_type == "e+") {
-    energy_cut = material_table_device->positron_energy_cut_[index];
+    energy_cut = GGEMS_TABLE(GGfloat, material_table_device, positron_energy_cut_)[index];
   }
   else if (particle_type == "e-") {
-    energy_cut = material_table_device->electron_energy_cut_[index];
+    energy_cut = GGEMS_TABLE(GGfloat, material_table_device, electron_energy_cut_)[index];
   }
 
   opencl_manager.ReleaseDeviceBuffer(material_tables_[thread_index], material_table_device, thread_index);
@@ -30,6 +30,12 @@
 #include "GGEMS/navigators/GGEMSCTSystem.hh"
 #include "GGEMS/geometries/GGEMSSolidBox.hh"
 #include "GGEMS/geometries/GGEMSSolidBoxData.hh"
+#include "GGEMS/navigators/GGEMSCTSystemData.hh"
+#include "GGEMS/maths/GGEMSGeometryTransformation.hh"
+#include "GGEMS/physics/GGEMSCrossSections.hh"
+#include "GGEMS/sources/GGEMSSourceManager.hh"
+#include "GGEMS/randoms/GGEMSPseudoRandomGenerator.hh"
+#include "GGEMS/tools/GGEMSProfilerManager.hh"
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,10 +45,17 @@ GGEMSCTSystem::GGEMSCTSystem(std::string const& ct_system_name)
 : GGEMSSystem(ct_system_name),
   ct_system_type_(""),
   source_isocenter_distance_(0.0f),
-  source_detector_distance_(0.0f)
+  source_detector_distance_(0.0f),
+  ct_system_data_(nullptr),
+  modules_data_(nullptr)
 {
   GGcout("GGEMSCTSystem", "GGEMSCTSystem", 3) << "GGEMSCTSystem creating..." << GGendl;
 
+  // Storing a kernel for each device, a single kernel handles all the modules
+  kernel_particle_solid_distance_ = new cl::Kernel*[number_activated_devices_];
+  kernel_project_to_solid_ = new cl::Kernel*[number_activated_devices_];
+  kernel_track_through_solid_ = new cl::Kernel*[number_activated_devices_];
+
   GGcout("GGEMSCTSystem", "GGEMSCTSystem", 3) << "GGEMSCTSystem created!!!" << GGendl;
 }
 
@@ -54,6 +67,39 @@ GGEMSCTSystem::~GGEMSCTSystem(void)
 {
   GGcout("GGEMSCTSystem", "~GGEMSCTSystem", 3) << "GGEMSCTSystem erasing..." << GGendl;
 
+  if (kernel_particle_solid_distance_) {
+    delete[] kernel_particle_solid_distance_;
+    kernel_particle_solid_distance_ = nullptr;
+  }
+
+  if (kernel_project_to_solid_) {
+    delete[] kernel_project_to_solid_;
+    kernel_project_to_solid_ = nullptr;
+  }
+
+  if (kernel_track_through_solid_) {
+    delete[] kernel_track_through_solid_;
+    kernel_track_through_solid_ = nullptr;
+  }
+
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  if (ct_system_data_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(ct_system_data_[i], sizeof(GGEMSCTSystemData), i);
+    }
+    delete[] ct_system_data_;
+    ct_system_data_ = nullptr;
+  }
+
+  if (modules_data_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(modules_data_[i], number_of_solids_*sizeof(GGEMSSolidBoxData), i);
+    }
+    delete[] modules_data_;
+    modules_data_ = nullptr;
+  }
+
   GGcout("GGEMSCTSystem", "~GGEMSCTSystem", 3) << "GGEMSCTSystem erased!!!" << GGendl;
 }
 
@@ -220,6 +266,114 @@ void GGEMSCTSystem::InitializeFlatGeometry(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSCTSystem::InitializeCTSystemData(void)
+{
+  GGcout("GGEMSCTSystem", "InitializeCTSystemData", 3) << "Initializing CT system data..." << GGendl;
+
+  // Getting the OpenCL manager
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  // Getting the index of first module
+  GGEMSNavigatorManager& navigator_manager = GGEMSNavigatorManager::GetInstance();
+  GGsize number_of_registered_solids = navigator_manager.GetNumberOfRegisteredSolids();
+
+  // Size of module, module X is along Z axis of CT system, module Z (depth) is along X axis of CT system
+  GGfloat module_size_x = static_cast<GGfloat>(number_of_detection_elements_inside_module_xyz_.x_)*size_of_detection_elements_xyz_.s[0];
+  GGfloat module_size_y = static_cast<GGfloat>(number_of_detection_elements_inside_module_xyz_.y_)*size_of_detection_elements_xyz_.s[1];
+  GGfloat module_size_z = static_cast<GGfloat>(number_of_detection_elements_inside_module_xyz_.z_)*size_of_detection_elements_xyz_.s[2];
+
+  // Angle between two modules, same computation than in InitializeCurvedGeometry
+  GGfloat c = module_size_y*0.5f;
+  GGfloat rho = std::sqrt(source_detector_distance_*source_detector_distance_ + c*c);
+  GGfloat alpha = 2.0f*std::asin(c/rho);
+
+  // Transformation from CT system frame to global frame, same transformation than modules without their own placement
+  GGEMSGeometryTransformation ct_system_transformation;
+  ct_system_transformation.SetTranslation(global_system_position_xyz_);
+  if (is_update_rot_) ct_system_transformation.SetRotation(rotation_xyz_);
+
+  // Total number of detection elements in X, modules are stored in a single histogram
+  GGsize total_dim_x = number_of_modules_xy_.x_*number_of_detection_elements_inside_module_xyz_.x_;
+
+  // Allocating data on each device
+  ct_system_data_ = new cl::Buffer*[number_activated_devices_];
+  modules_data_ = new cl::Buffer*[number_activated_devices_];
+
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    ct_system_data_[d] = opencl_manager.Allocate(nullptr, sizeof(GGEMSCTSystemData), d, CL_MEM_READ_WRITE, "GGEMSCTSystem");
+    modules_data_[d] = opencl_manager.Allocate(nullptr, number_of_solids_*sizeof(GGEMSSolidBoxData), d, CL_MEM_READ_WRITE, "GGEMSCTSystem");
+
+    // Filling CT system data
+    GGEMSCTSystemData* ct_system_data_device = opencl_manager.GetDeviceBuffer<GGEMSCTSystemData>(ct_system_data_[d], CL_TRUE, CL_MAP_WRITE, sizeof(GGEMSCTSystemData), d);
+    GGfloat44* matrix_transformation_device = opencl_manager.GetDeviceBuffer<GGfloat44>(ct_system_transformation.GetTransformationMatrix(d), CL_TRUE, CL_MAP_READ, sizeof(GGfloat44), d);
+
+    ct_system_data_device->matrix_transformation_ = *matrix_transformation_device;
+    ct_system_data_device->number_of_modules_xy_[0] = static_cast<GGint>(number_of_modules_xy_.x_);
+    ct_system_data_device->number_of_modules_xy_[1] = static_cast<GGint>(number_of_modules_xy_.y_);
+    ct_system_data_device->module_size_xyz_[0] = module_size_x;
+    ct_system_data_device->module_size_xyz_[1] = module_size_y;
+    ct_system_data_device->module_size_xyz_[2] = module_size_z;
+    ct_system_data_device->source_isocenter_distance_ = source_isocenter_distance_;
+    ct_system_data_device->source_detector_distance_ = source_detector_distance_;
+    ct_system_data_device->module_angle_ = alpha;
+    ct_system_data_device->is_curved_ = ct_system_type_ == "curved" ? 1 : 0;
+    ct_system_data_device->first_solid_id_ = static_cast<GGint>(number_of_registered_solids);
+
+    opencl_manager.ReleaseDeviceBuffer(ct_system_transformation.GetTransformationMatrix(d), matrix_transformation_device, d);
+    opencl_manager.ReleaseDeviceBuffer(ct_system_data_[d], ct_system_data_device, d);
+
+    // Copying data of each module, with its place in histogram of CT system
+    GGEMSSolidBoxData* modules_data_device = opencl_manager.GetDeviceBuffer<GGEMSSolidBoxData>(modules_data_[d], CL_TRUE, CL_MAP_WRITE, number_of_solids_*sizeof(GGEMSSolidBoxData), d);
+
+    for (GGsize j = 0; j < number_of_modules_xy_.y_; ++j) {
+      for (GGsize i = 0; i < number_of_modules_xy_.x_; ++i) {
+        GGsize global_index = i+j*number_of_modules_xy_.x_;
+        cl::Buffer* solid_data = solids_[global_index]->GetSolidData(d);
+
+        GGEMSSolidBoxData* solid_data_device = opencl_manager.GetDeviceBuffer<GGEMSSolidBoxData>(solid_data, CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSSolidBoxData), d);
+
+        solid_data_device->histogram_offset_ = i*number_of_detection_elements_inside_module_xyz_.x_ + j*number_of_detection_elements_inside_module_xyz_.y_*total_dim_x;
+        solid_data_device->histogram_stride_ = total_dim_x;
+        modules_data_device[global_index] = *solid_data_device;
+
+        opencl_manager.ReleaseDeviceBuffer(solid_data, solid_data_device, d);
+      }
+    }
+
+    opencl_manager.ReleaseDeviceBuffer(modules_data_[d], modules_data_device, d);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSCTSystem::InitializeKernel(void)
+{
+  GGcout("GGEMSCTSystem", "InitializeKernel", 3) << "Initializing kernel for CT system..." << GGendl;
+
+  // Getting the OpenCLManager singleton
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  // Getting the path to kernel
+  std::string openCL_kernel_path = OPENCL_KERNEL_PATH;
+  std::string particle_solid_distance_filename = openCL_kernel_path + "/ParticleSolidDistanceGGEMSCTSystem.cl";
+  std::string project_to_filename = openCL_kernel_path + "/ProjectToGGEMSCTSystem.cl";
+  std::string track_through_filename = openCL_kernel_path + "/TrackThroughGGEMSCTSystem.cl";
+
+  // All the modules share the same options
+  std::string kernel_option = solids_[0]->GetKernelOption();
+
+  // Compiling the kernels
+  opencl_manager.CompileKernel(particle_solid_distance_filename, "particle_solid_distance_ggems_ct_system", kernel_particle_solid_distance_, nullptr, const_cast<char*>(kernel_option.c_str()));
+  opencl_manager.CompileKernel(project_to_filename, "project_to_ggems_ct_system", kernel_project_to_solid_, nullptr, const_cast<char*>(kernel_option.c_str()));
+  opencl_manager.CompileKernel(track_through_filename, "track_through_ggems_ct_system", kernel_track_through_solid_, nullptr, const_cast<char*>(kernel_option.c_str()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSCTSystem::Initialize(void)
 {
   GGcout("GGEMSCTSystem", "Initialize", 3) << "Initializing a GGEMS CT system..." << GGendl;
@@ -238,7 +392,8 @@ void GGEMSCTSystem::Initialize(void)
   // Allocation of memory for solid
   solids_ = new GGEMSSolid*[number_of_solids_];
 
-  for (GGsize i = 0; i < number_of_solids_; ++i) { // In CT system only "HISTOGRAM"
+  // In CT system only "MODULE", histogram is owned by the system and shared by all the modules
+  for (GGsize i = 0; i < number_of_solids_; ++i) {
     solids_[i] = new GGEMSSolidBox(
       number_of_detection_elements_inside_module_xyz_.x_,
       number_of_detection_elements_inside_module_xyz_.y_,
@@ -246,7 +401,7 @@ void GGEMSCTSystem::Initialize(void)
       static_cast<GGfloat>(number_of_detection_elements_inside_module_xyz_.x_) * size_of_detection_elements_xyz_.s[0],
       static_cast<GGfloat>(number_of_detection_elements_inside_module_xyz_.y_) * size_of_detection_elements_xyz_.s[1],
       static_cast<GGfloat>(number_of_detection_elements_inside_module_xyz_.z_) * size_of_detection_elements_xyz_.s[2],
-      "HISTOGRAM"
+      "MODULE"
     );
     solids_[i]->SetVisible(is_visible_);
     solids_[i]->SetMaterialName(materials_->GetMaterialName(0));
@@ -258,9 +413,6 @@ void GGEMSCTSystem::Initialize(void)
 
     // Enabling tracking if necessary
     if (is_tracking_) solids_[i]->EnableTracking();
-
-    // Initialize kernels
-    solids_[i]->Initialize(nullptr);
   }
 
   // Initialize of the geometry depending on type of CT system
@@ -292,6 +444,11 @@ void GGEMSCTSystem::Initialize(void)
     }
   }
 
+  // Histogram of all the modules, data of CT system and kernels handling all the modules
+  InitializeHistogram();
+  InitializeCTSystemData();
+  InitializeKernel();
+
   #ifdef OPENGL_VISUALIZATION
   for (GGsize i = 0; i < number_of_solids_; ++i) solids_[i]->BuildOpenGL();
   #endif
@@ -304,6 +461,248 @@ void GGEMSCTSystem::Initialize(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSCTSystem::ParticleSolidDistance(GGsize const& thread_index)
+{
+  // Getting the OpenCL manager and infos for work-item launching
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSCTSystem::ParticleSolidDistance on " << device_name << ", index " << device_index;
+
+  // Pointer to primary particles, and number to particles in buffer
+  GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
+  cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
+
+  // Kernels are launched only over alive particles if particles are compacted
+  cl::Buffer* alive_particles = source_manager.GetParticles()->GetAliveParticles(thread_index);
+  GGsize number_of_alive_particles = source_manager.GetParticles()->GetNumberOfAliveParticles(thread_index);
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_alive_particles);
+
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Getting kernel, and setting parameters, a single launch for all the modules
+  cl::Kernel* kernel = kernel_particle_solid_distance_[thread_index];
+  kernel->setArg(0, number_of_particles);
+  if (!alive_particles) kernel->setArg(1, sizeof(cl_mem), nullptr);
+  else kernel->setArg(1, *alive_particles);
+  kernel->setArg(2, *primary_particles);
+  kernel->setArg(3, *ct_system_data_[thread_index]);
+  kernel->setArg(4, *modules_data_[thread_index]);
+
+  // Launching kernel
+  cl::Event event;
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, &event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSCTSystem", "ParticleSolidDistance");
+
+  // GGEMS Profiling
+  GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSCTSystem::ProjectToSolid(GGsize const& thread_index)
+{
+  // Getting the OpenCL manager and infos for work-item launching
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSCTSystem::ProjectToSolid on " << device_name << ", index " << device_index;
+
+  // Pointer to primary particles, and number to particles in buffer
+  GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
+  cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
+
+  // Kernels are launched only over alive particles if particles are compacted
+  cl::Buffer* alive_particles = source_manager.GetParticles()->GetAliveParticles(thread_index);
+  GGsize number_of_alive_particles = source_manager.GetParticles()->GetNumberOfAliveParticles(thread_index);
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_alive_particles);
+
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Getting kernel, and setting parameters, a single launch for all the modules
+  cl::Kernel* kernel = kernel_project_to_solid_[thread_index];
+  kernel->setArg(0, number_of_particles);
+  if (!alive_particles) kernel->setArg(1, sizeof(cl_mem), nullptr);
+  else kernel->setArg(1, *alive_particles);
+  kernel->setArg(2, *primary_particles);
+  kernel->setArg(3, *ct_system_data_[thread_index]);
+  kernel->setArg(4, *modules_data_[thread_index]);
+
+  // Launching kernel
+  cl::Event event;
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, &event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSCTSystem", "ProjectToSolid");
+
+  // GGEMS Profiling
+  GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSCTSystem::TrackThroughSolid(GGsize const& thread_index)
+{
+  // Getting the OpenCL manager and infos for work-item launching
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSCTSystem::TrackThroughSolid on " << device_name << ", index " << device_index;
+
+  // Pointer to primary particles, and number to particles in buffer
+  GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
+  cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
+
+  // Kernels are launched only over alive particles if particles are compacted
+  cl::Buffer* alive_particles = source_manager.GetParticles()->GetAliveParticles(thread_index);
+  GGsize number_of_alive_particles = source_manager.GetParticles()->GetNumberOfAliveParticles(thread_index);
+
+  // Getting OpenCL pointer to random number of the active stack
+  cl::Buffer* randoms = source_manager.GetPseudoRandomGenerator()->GetPseudoRandomNumbers(thread_index, source_manager.GetParticles()->GetActiveStack(thread_index));
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_alive_particles);
+
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Getting kernel, and setting parameters, a single launch for all the modules
+  cl::Kernel* kernel = kernel_track_through_solid_[thread_index];
+  kernel->setArg(0, number_of_particles);
+  if (!alive_particles) kernel->setArg(1, sizeof(cl_mem), nullptr);
+  else kernel->setArg(1, *alive_particles);
+  kernel->setArg(2, *primary_particles);
+  kernel->setArg(3, *randoms);
+  kernel->setArg(4, *ct_system_data_[thread_index]);
+  kernel->setArg(5, *modules_data_[thread_index]);
+  kernel->setArg(6, *cross_sections_->GetCrossSections(thread_index));
+  kernel->setArg(7, *materials_->GetMaterialTables(thread_index));
+  kernel->setArg(8, *attenuations_->GetAttenuations(thread_index));
+  kernel->setArg(9, threshold_);
+  kernel->setArg(10, *histogram_[thread_index]);
+  if (!scatter_histogram_) kernel->setArg(11, sizeof(cl_mem), nullptr);
+  else kernel->setArg(11, *scatter_histogram_[thread_index]);
+
+  // Launching kernel
+  cl::Event event;
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, &event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSCTSystem", "TrackThroughSolid");
+
+  // GGEMS Profiling
+  GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSCTSystem::GetTransportKernelParameters(GGsize& parameter_size) const
+{
+  std::ostringstream oss(std::ostringstream::out);
+
+  oss << ",\n  global GGEMSParticleCrossSections const* particle_cross_sections_" << navigator_id_;
+  oss << ",\n  global GGEMSMaterialTables const* materials_" << navigator_id_;
+  oss << ",\n  global GGEMSMuMuEnData const* attenuations_" << navigator_id_;
+  oss << ",\n  GGfloat const threshold_" << navigator_id_;
+  oss << ",\n  global GGEMSCTSystemData const* ct_system_data_" << navigator_id_;
+  oss << ",\n  global GGEMSSolidBoxData const* modules_data_" << navigator_id_;
+  oss << ",\n  global GGint* histogram_" << navigator_id_;
+  oss << ",\n  global GGint* scatter_histogram_" << navigator_id_;
+  parameter_size += 7*sizeof(cl_mem) + sizeof(GGfloat);
+
+  return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSCTSystem::GetTransportKernelParticleSolidDistance(void) const
+{
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "    ParticleCTSystemDistance(primary_particle, ct_system_data_" << navigator_id_ << ", modules_data_" << navigator_id_ << ", global_id);\n";
+  return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSCTSystem::GetTransportKernelProjectToSolid(void) const
+{
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "    ProjectToCTSystem(primary_particle, ct_system_data_" << navigator_id_ << ", modules_data_" << navigator_id_ << ", global_id);\n";
+  return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSCTSystem::GetTransportKernelTrackThroughSolid(void) const
+{
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "    TrackThroughCTSystem(primary_particle, &random_state, ct_system_data_" << navigator_id_ << ", modules_data_" << navigator_id_;
+  oss << ", particle_cross_sections_" << navigator_id_ << ", materials_" << navigator_id_ << ", attenuations_" << navigator_id_ << ", threshold_" << navigator_id_;
+  oss << ", histogram_" << navigator_id_ << ", scatter_histogram_" << navigator_id_ << ", global_id);\n";
+  return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGuint GGEMSCTSystem::SetTransportKernelArguments(cl::Kernel* kernel, GGuint const& argument_index, GGsize const& thread_index) const
+{
+  GGuint index = argument_index;
+
+  // Same arguments as in TrackThroughSolid
+  kernel->setArg(index++, *cross_sections_->GetCrossSections(thread_index));
+  kernel->setArg(index++, *materials_->GetMaterialTables(thread_index));
+  kernel->setArg(index++, *attenuations_->GetAttenuations(thread_index));
+  kernel->setArg(index++, threshold_);
+  kernel->setArg(index++, *ct_system_data_[thread_index]);
+  kernel->setArg(index++, *modules_data_[thread_index]);
+  kernel->setArg(index++, *histogram_[thread_index]);
+  if (!scatter_histogram_) kernel->setArg(index++, sizeof(cl_mem), nullptr);
+  else kernel->setArg(index++, *scatter_histogram_[thread_index]);
+
+  return index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 GGEMSCTSystem* create_ggems_ct_system(char const* ct_system_name)
 {
   return new(std::nothrow) GGEMSCTSystem(ct_system_name);
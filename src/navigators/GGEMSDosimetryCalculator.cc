@@ -60,15 +60,15 @@ GGEMSDosimetryCalculator::GGEMSDosimetryCalculator(void)
   // Get the number of activated device
   number_activated_devices_ = opencl_manager.GetNumberOfActivatedDevice();
 
-  // Checking double precision computation
-  #ifdef DOSIMETRY_DOUBLE_PRECISION
+  // Checking double precision computation, fixed-point tallies in reproducible mode need the same int64 atomics
+  #if defined(DOSIMETRY_DOUBLE_PRECISION) || defined(REPRODUCIBLE_RESULTS)
   // Get device index
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
     GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(i);
     if (!opencl_manager.IsDoublePrecisionAtomicAddition(device_index)) {
       std::ostringstream oss(std::ostringstream::out);
       oss << "Your OpenCL device: " << opencl_manager.GetDeviceName(device_index) << ", does not support double precision for atomic operation!!!" << std::endl;
-      oss << "Please, recompile with DOSIMETRY_DOUBLE_PRECISION to OFF. Precision will be lost only for dosimetry application" << std::endl;
+      oss << "Please, recompile with DOSIMETRY_DOUBLE_PRECISION and REPRODUCIBLE_RESULTS to OFF. Precision will be lost only for dosimetry application" << std::endl;
       GGEMSMisc::ThrowException("GGEMSDosimetryCalculator", "GGEMSDosimetryCalculator", oss.str());
     }
   }
@@ -264,6 +264,15 @@ void GGEMSDosimetryCalculator::SetTLE(bool const& is_activated)
   navigator_->EnableTLE(is_activated);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSDosimetryCalculator::SetLocalTally(bool const& is_activated)
+{
+  navigator_->EnableDoseLocalTally(is_activated);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -381,6 +390,54 @@ void GGEMSDosimetryCalculator::ComputeDose(GGsize const& thread_index)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSDosimetryCalculator::ReduceDose(void)
+{
+  GGcout("GGEMSDosimetryCalculator", "ReduceDose", 3) << "Reducing dosimetry tallies of all devices..." << GGendl;
+
+  // Get the OpenCL manager
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  // Tallies of other devices are added to first device, integer additions give the same result whatever the number of devices
+  if (number_activated_devices_ > 1) {
+    GGDosiType* edep = opencl_manager.GetDeviceBuffer<GGDosiType>(dose_recording_.edep_[0], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels_*sizeof(GGDosiType), 0);
+    GGDosiType* edep_squared = dose_recording_.edep_squared_[0] ? opencl_manager.GetDeviceBuffer<GGDosiType>(dose_recording_.edep_squared_[0], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels_*sizeof(GGDosiType), 0) : nullptr;
+    GGint* hit = dose_recording_.hit_[0] ? opencl_manager.GetDeviceBuffer<GGint>(dose_recording_.hit_[0], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels_*sizeof(GGint), 0) : nullptr;
+
+    for (GGsize j = 1; j < number_activated_devices_; ++j) {
+      GGDosiType* edep_device = opencl_manager.GetDeviceBuffer<GGDosiType>(dose_recording_.edep_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels_*sizeof(GGDosiType), j);
+      for (GGsize i = 0; i < total_number_of_dosels_; ++i) edep[i] += edep_device[i];
+      opencl_manager.ReleaseDeviceBuffer(dose_recording_.edep_[j], edep_device, j);
+      opencl_manager.CleanBuffer(dose_recording_.edep_[j], total_number_of_dosels_*sizeof(GGDosiType), j);
+
+      if (edep_squared) {
+        GGDosiType* edep_squared_device = opencl_manager.GetDeviceBuffer<GGDosiType>(dose_recording_.edep_squared_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels_*sizeof(GGDosiType), j);
+        for (GGsize i = 0; i < total_number_of_dosels_; ++i) edep_squared[i] += edep_squared_device[i];
+        opencl_manager.ReleaseDeviceBuffer(dose_recording_.edep_squared_[j], edep_squared_device, j);
+        opencl_manager.CleanBuffer(dose_recording_.edep_squared_[j], total_number_of_dosels_*sizeof(GGDosiType), j);
+      }
+
+      if (hit) {
+        GGint* hit_device = opencl_manager.GetDeviceBuffer<GGint>(dose_recording_.hit_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels_*sizeof(GGint), j);
+        for (GGsize i = 0; i < total_number_of_dosels_; ++i) hit[i] += hit_device[i];
+        opencl_manager.ReleaseDeviceBuffer(dose_recording_.hit_[j], hit_device, j);
+        opencl_manager.CleanBuffer(dose_recording_.hit_[j], total_number_of_dosels_*sizeof(GGint), j);
+      }
+    }
+
+    // Release the pointers
+    opencl_manager.ReleaseDeviceBuffer(dose_recording_.edep_[0], edep, 0);
+    if (edep_squared) opencl_manager.ReleaseDeviceBuffer(dose_recording_.edep_squared_[0], edep_squared, 0);
+    if (hit) opencl_manager.ReleaseDeviceBuffer(dose_recording_.hit_[0], hit, 0);
+  }
+
+  // Dose and uncertainty are computed once, from reduced tallies
+  ComputeDose(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSDosimetryCalculator::Initialize(void)
 {
   GGcout("GGEMSDosimetryCalculator", "Initialize", 3) << "Initializing dosimetry calculator..." << GGendl;
@@ -566,7 +623,7 @@ void GGEMSDosimetryCalculator::SaveHit(void) const
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGint* hit_device = opencl_manager.GetDeviceBuffer<GGint>(dose_recording_.hit_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels*sizeof(GGint), j);
 
-    for (GGsize i = 0; i < total_number_of_dosels; ++i) hit_tracking[i] = hit_device[i];
+    for (GGsize i = 0; i < total_number_of_dosels; ++i) hit_tracking[i] += hit_device[i];
 
     opencl_manager.ReleaseDeviceBuffer(dose_recording_.hit_[j], hit_device, j);
   }
@@ -611,13 +668,13 @@ void GGEMSDosimetryCalculator::SaveEdep(void) const
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGDosiType* edep_device = opencl_manager.GetDeviceBuffer<GGDosiType>(dose_recording_.edep_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels*sizeof(GGDosiType), j);
 
-    for (GGsize i = 0; i < total_number_of_dosels; ++i) edep_tracking[i] = edep_device[i];
+    for (GGsize i = 0; i < total_number_of_dosels; ++i) edep_tracking[i] += edep_device[i];
 
     opencl_manager.ReleaseDeviceBuffer(dose_recording_.edep_[j], edep_device, j);
   }
 
   // Writing data
-  mhdImage.Write<GGDosiType>(edep_tracking);
+  mhdImage.WriteDosimetry(edep_tracking, DOSIMETRY_EDEP_FIXED_POINT_SCALE, true);
   delete[] edep_tracking;
 }
 
@@ -656,13 +713,13 @@ void GGEMSDosimetryCalculator::SaveEdepSquared(void) const
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGDosiType* edep_squared_device = opencl_manager.GetDeviceBuffer<GGDosiType>(dose_recording_.edep_squared_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels*sizeof(GGDosiType), j);
 
-    for (GGsize i = 0; i < total_number_of_dosels; ++i) edep_squared_tracking[i] = edep_squared_device[i];
+    for (GGsize i = 0; i < total_number_of_dosels; ++i) edep_squared_tracking[i] += edep_squared_device[i];
 
     opencl_manager.ReleaseDeviceBuffer(dose_recording_.edep_squared_[j], edep_squared_device, j);
   }
 
   // Writing data
-  mhdImage.Write<GGDosiType>(edep_squared_tracking);
+  mhdImage.WriteDosimetry(edep_squared_tracking, DOSIMETRY_EDEP_SQUARED_FIXED_POINT_SCALE, true);
   delete[] edep_squared_tracking;
 }
 
@@ -705,6 +762,18 @@ void GGEMSDosimetryCalculator::SaveDose(void) const
     opencl_manager.ReleaseDeviceBuffer(dose_recording_.dose_[j], dose_device, j);
   }
 
+  #ifdef REPRODUCIBLE_RESULTS
+  // Negative dose comes from an energy deposit tally wrapped above 2^63 fixed-point units
+  GGsize number_of_saturated_dosels = 0;
+  for (GGsize i = 0; i < total_number_of_dosels; ++i) {
+    if (dose[i] < 0.0f) ++number_of_saturated_dosels;
+  }
+
+  if (number_of_saturated_dosels > 0) {
+    GGwarn("GGEMSDosimetryCalculator", "SaveDose", 0) << number_of_saturated_dosels << " dosel(s) with saturated energy deposit tally (range " << 2.0 * static_cast<GGdouble>(FIXED_POINT_SATURATION) / DOSIMETRY_EDEP_FIXED_POINT_SCALE << " MeV), dose is wrong!!!" << GGendl;
+  }
+  #endif
+
   // Writing data
   mhdImage.Write<GGfloat>(dose);
   delete[] dose;
@@ -740,8 +809,15 @@ void GGEMSDosimetryCalculator::SaveUncertainty(void) const
   // Release the pointer
   opencl_manager.ReleaseDeviceBuffer(dose_params_[0], dose_params_device, 0);
 
+  // Uncertainty is not additive, in reproducible mode it is computed in first device only from reduced tallies
+  #ifdef REPRODUCIBLE_RESULTS
+  GGsize number_of_devices = 1;
+  #else
+  GGsize number_of_devices = number_activated_devices_;
+  #endif
+
   // Loop over all activated device
-  for (GGsize j = 0; j < number_activated_devices_; ++j) {
+  for (GGsize j = 0; j < number_of_devices; ++j) {
     GGfloat* uncertainty_device = opencl_manager.GetDeviceBuffer<GGfloat>(dose_recording_.uncertainty_dose_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_dosels*sizeof(GGfloat), j);
 
     for (GGsize i = 0; i < total_number_of_dosels; ++i) uncertainty[i] = uncertainty_device[i];
@@ -860,6 +936,15 @@ void dose_tle_navigator(GGEMSDosimetryCalculator* dose_calculator, bool const is
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void dose_local_tally_navigator(GGEMSDosimetryCalculator* dose_calculator, bool const is_activated)
+{
+  dose_calculator->SetLocalTally(is_activated);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void water_reference_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, bool const is_activated)
 {
   dose_calculator->SetWaterReference(is_activated);
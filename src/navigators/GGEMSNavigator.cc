@@ -54,7 +54,9 @@ GGEMSNavigator::GGEMSNavigator(std::string const& navigator_name)
   number_of_solids_(0),
   dose_calculator_(nullptr),
   is_dosimetry_mode_(false),
-  is_tle_(0)
+  is_tle_(0),
+  is_woodcock_tracking_(false),
+  is_dose_local_tally_(false)
 {
   GGcout("GGEMSNavigator", "GGEMSNavigator", 3) << "GGEMSNavigator creating..." << GGendl;
 
@@ -200,6 +202,24 @@ void GGEMSNavigator::EnableTLE(bool const& is_activated)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSNavigator::EnableWoodcockTracking(bool const& is_activated)
+{
+  is_woodcock_tracking_ = is_activated;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSNavigator::EnableDoseLocalTally(bool const& is_activated)
+{
+  is_dose_local_tally_ = is_activated;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSNavigator::SetVisible(bool const& is_visible)
 {
   is_visible_ = is_visible;
@@ -325,9 +345,13 @@ void GGEMSNavigator::ParticleSolidDistance(GGsize const& thread_index)
   cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
   GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
 
+  // Kernels are launched only over alive particles if particles are compacted
+  cl::Buffer* alive_particles = source_manager.GetParticles()->GetAliveParticles(thread_index);
+  GGsize number_of_alive_particles = source_manager.GetParticles()->GetNumberOfAliveParticles(thread_index);
+
   // Getting work group size, and work-item number
   GGsize work_group_size = opencl_manager.GetWorkGroupSize();
-  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_particles);
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_alive_particles);
 
   // Parameters for work-item in kernel
   cl::NDRange global_wi(number_of_work_items);
@@ -341,14 +365,15 @@ void GGEMSNavigator::ParticleSolidDistance(GGsize const& thread_index)
     // Getting kernel, and setting parameters
     cl::Kernel* kernel = solids_[i]->GetKernelParticleSolidDistance(thread_index);
     kernel->setArg(0, number_of_particles);
-    kernel->setArg(1, *primary_particles);
-    kernel->setArg(2, *solid_data);
+    if (!alive_particles) kernel->setArg(1, sizeof(cl_mem), nullptr);
+    else kernel->setArg(1, *alive_particles);
+    kernel->setArg(2, *primary_particles);
+    kernel->setArg(3, *solid_data);
 
     // Launching kernel
     cl::Event event;
     GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, &event);
     opencl_manager.CheckOpenCLError(kernel_status, "GGEMSNavigator", "ParticleSolidDistance");
-    queue->finish();
 
     // GGEMS Profiling
     GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
@@ -376,9 +401,13 @@ void GGEMSNavigator::ProjectToSolid(GGsize const& thread_index)
   cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
   GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
 
+  // Kernels are launched only over alive particles if particles are compacted
+  cl::Buffer* alive_particles = source_manager.GetParticles()->GetAliveParticles(thread_index);
+  GGsize number_of_alive_particles = source_manager.GetParticles()->GetNumberOfAliveParticles(thread_index);
+
   // Getting work group size, and work-item number
   GGsize work_group_size = opencl_manager.GetWorkGroupSize();
-  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_particles);
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_alive_particles);
 
   // Parameters for work-item in kernel
   cl::NDRange global_wi(number_of_work_items);
@@ -392,14 +421,15 @@ void GGEMSNavigator::ProjectToSolid(GGsize const& thread_index)
     // Getting kernel, and setting parameters
     cl::Kernel* kernel = solids_[i]->GetKernelProjectToSolid(thread_index);
     kernel->setArg(0, number_of_particles);
-    kernel->setArg(1, *primary_particles);
-    kernel->setArg(2, *solid_data);
+    if (!alive_particles) kernel->setArg(1, sizeof(cl_mem), nullptr);
+    else kernel->setArg(1, *alive_particles);
+    kernel->setArg(2, *primary_particles);
+    kernel->setArg(3, *solid_data);
 
     // Launching kernel
     cl::Event event;
     GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, &event);
     opencl_manager.CheckOpenCLError(kernel_status, "GGEMSNavigator", "ProjectToSolid");
-    queue->finish();
 
     // GGEMS Profiling
     GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
@@ -427,8 +457,12 @@ void GGEMSNavigator::TrackThroughSolid(GGsize const& thread_index)
   cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
   GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
 
-  // Getting OpenCL pointer to random number
-  cl::Buffer* randoms = source_manager.GetPseudoRandomGenerator()->GetPseudoRandomNumbers(thread_index);
+  // Kernels are launched only over alive particles if particles are compacted
+  cl::Buffer* alive_particles = source_manager.GetParticles()->GetAliveParticles(thread_index);
+  GGsize number_of_alive_particles = source_manager.GetParticles()->GetNumberOfAliveParticles(thread_index);
+
+  // Getting OpenCL pointer to random number of the active stack
+  cl::Buffer* randoms = source_manager.GetPseudoRandomGenerator()->GetPseudoRandomNumbers(thread_index, source_manager.GetParticles()->GetActiveStack(thread_index));
 
   // Getting OpenCL buffer for cross section
   cl::Buffer* cross_sections = cross_sections_->GetCrossSections(thread_index);
@@ -441,7 +475,7 @@ void GGEMSNavigator::TrackThroughSolid(GGsize const& thread_index)
 
   // Getting work group size, and work-item number
   GGsize work_group_size = opencl_manager.GetWorkGroupSize();
-  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_particles);
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_alive_particles);
 
   // Parameters for work-item in kernel
   cl::NDRange global_wi(number_of_work_items);
@@ -482,31 +516,33 @@ void GGEMSNavigator::TrackThroughSolid(GGsize const& thread_index)
     // Getting kernel, and setting parameters
     cl::Kernel* kernel = solids_[i]->GetKernelTrackThroughSolid(thread_index);
     kernel->setArg(0, number_of_particles);
-    kernel->setArg(1, *primary_particles);
-    kernel->setArg(2, *randoms);
-    kernel->setArg(3, *solid_data);
-    if (!label_data) kernel->setArg(4, sizeof(cl_mem), nullptr);
-    else kernel->setArg(4, *label_data); // Useful only for GGEMSVoxelizedSolid
-    kernel->setArg(5, *cross_sections);
-    kernel->setArg(6, *materials);
-    kernel->setArg(7, *attenuations);
-    kernel->setArg(8, threshold_);
+    if (!alive_particles) kernel->setArg(1, sizeof(cl_mem), nullptr);
+    else kernel->setArg(1, *alive_particles);
+    kernel->setArg(2, *primary_particles);
+    kernel->setArg(3, *randoms);
+    kernel->setArg(4, *solid_data);
+    if (!label_data) kernel->setArg(5, sizeof(cl_mem), nullptr);
+    else kernel->setArg(5, *label_data); // Useful only for GGEMSVoxelizedSolid
+    kernel->setArg(6, *cross_sections);
+    kernel->setArg(7, *materials);
+    kernel->setArg(8, *attenuations);
+    kernel->setArg(9, threshold_);
     if (data_reg_type == "HISTOGRAM") {
-      kernel->setArg(9, *histogram);
-      if (!scatter_histogram) kernel->setArg(10, sizeof(cl_mem), nullptr);
-      else kernel->setArg(10, *scatter_histogram);
+      kernel->setArg(10, *histogram);
+      if (!scatter_histogram) kernel->setArg(11, sizeof(cl_mem), nullptr);
+      else kernel->setArg(11, *scatter_histogram);
     }
     else if (data_reg_type == "DOSIMETRY") {
-      kernel->setArg(9, *dosimetry_params);
-      kernel->setArg(10, *edep_tracking_dosimetry);
+      kernel->setArg(10, *dosimetry_params);
+      kernel->setArg(11, *edep_tracking_dosimetry);
 
-      if (!edep_squared_tracking_dosimetry) kernel->setArg(11, sizeof(cl_mem), nullptr);
-      else kernel->setArg(11, *edep_squared_tracking_dosimetry);
+      if (!edep_squared_tracking_dosimetry) kernel->setArg(12, sizeof(cl_mem), nullptr);
+      else kernel->setArg(12, *edep_squared_tracking_dosimetry);
 
-      if (!hit_tracking_dosimetry) kernel->setArg(12, sizeof(cl_mem), nullptr);
-      else kernel->setArg(12, *hit_tracking_dosimetry);
-      if (!photon_tracking_dosimetry) kernel->setArg(13, sizeof(cl_mem), nullptr);
-      else kernel->setArg(13, *photon_tracking_dosimetry);
+      if (!hit_tracking_dosimetry) kernel->setArg(13, sizeof(cl_mem), nullptr);
+      else kernel->setArg(13, *hit_tracking_dosimetry);
+      if (!photon_tracking_dosimetry) kernel->setArg(14, sizeof(cl_mem), nullptr);
+      else kernel->setArg(14, *photon_tracking_dosimetry);
     }
 
     // Launching kernel
@@ -516,7 +552,6 @@ void GGEMSNavigator::TrackThroughSolid(GGsize const& thread_index)
 
     // GGEMS Profiling
     GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
-    queue->finish();
   }
 }
 
@@ -524,6 +559,161 @@ void GGEMSNavigator::TrackThroughSolid(GGsize const& thread_index)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+std::string GGEMSNavigator::GetTransportKernelParameters(GGsize& parameter_size) const
+{
+  std::ostringstream oss(std::ostringstream::out);
+
+  // Parameters shared by all the solids of navigator
+  oss << ",\n  global GGEMSParticleCrossSections const* particle_cross_sections_" << navigator_id_;
+  oss << ",\n  global GGEMSMaterialTables const* materials_" << navigator_id_;
+  oss << ",\n  global GGEMSMuMuEnData const* attenuations_" << navigator_id_;
+  oss << ",\n  GGfloat const threshold_" << navigator_id_;
+  parameter_size += 3*sizeof(cl_mem) + sizeof(GGfloat);
+
+  // Loop over all the solids
+  for (GGsize i = 0; i < number_of_solids_; ++i) {
+    std::string data_reg_type = solids_[i]->GetRegisteredDataType();
+    std::string suffix = std::to_string(navigator_id_) + "_" + std::to_string(i);
+
+    if (data_reg_type == "HISTOGRAM") {
+      oss << ",\n  global GGEMSSolidBoxData const* solid_data_" << suffix;
+      oss << ",\n  global GGLabelType const* label_data_" << suffix;
+      oss << ",\n  global GGint* histogram_" << suffix;
+      oss << ",\n  global GGint* scatter_histogram_" << suffix;
+      parameter_size += 4*sizeof(cl_mem);
+    }
+    else {
+      oss << ",\n  global GGEMSVoxelizedSolidData const* solid_data_" << suffix;
+      oss << ",\n  global GGLabelType const* label_data_" << suffix;
+      parameter_size += 2*sizeof(cl_mem);
+      if (data_reg_type == "DOSIMETRY") {
+        oss << ",\n  global GGEMSDoseParams* dose_params_" << suffix;
+        oss << ",\n  global GGDosiType* edep_tracking_" << suffix;
+        oss << ",\n  global GGDosiType* edep_squared_tracking_" << suffix;
+        oss << ",\n  global GGint* hit_tracking_" << suffix;
+        oss << ",\n  global GGint* photon_tracking_" << suffix;
+        parameter_size += 5*sizeof(cl_mem);
+      }
+    }
+  }
+
+  return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSNavigator::GetTransportKernelParticleSolidDistance(void) const
+{
+  std::ostringstream oss(std::ostringstream::out);
+
+  for (GGsize i = 0; i < number_of_solids_; ++i) {
+    std::string suffix = std::to_string(navigator_id_) + "_" + std::to_string(i);
+    oss << "    ParticleSolidDistance(primary_particle, &solid_data_" << suffix << "->obb_geometry_, solid_data_" << suffix << "->solid_id_, global_id);\n";
+  }
+
+  return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSNavigator::GetTransportKernelProjectToSolid(void) const
+{
+  std::ostringstream oss(std::ostringstream::out);
+
+  for (GGsize i = 0; i < number_of_solids_; ++i) {
+    std::string suffix = std::to_string(navigator_id_) + "_" + std::to_string(i);
+    oss << "    ProjectToSolid(primary_particle, &solid_data_" << suffix << "->obb_geometry_, solid_data_" << suffix << "->solid_id_, global_id);\n";
+  }
+
+  return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSNavigator::GetTransportKernelTrackThroughSolid(void) const
+{
+  std::ostringstream oss(std::ostringstream::out);
+
+  for (GGsize i = 0; i < number_of_solids_; ++i) {
+    std::string data_reg_type = solids_[i]->GetRegisteredDataType();
+    std::string suffix = std::to_string(navigator_id_) + "_" + std::to_string(i);
+
+    oss << "    TrackThrough" << (data_reg_type == "HISTOGRAM" ? "SolidBox" : "VoxelizedSolid") << "(primary_particle, &random_state, solid_data_" << suffix << ", label_data_" << suffix;
+    oss << ", particle_cross_sections_" << navigator_id_ << ", materials_" << navigator_id_ << ", attenuations_" << navigator_id_ << ", threshold_" << navigator_id_;
+    if (data_reg_type == "HISTOGRAM") {
+      oss << ", histogram_" << suffix << ", scatter_histogram_" << suffix;
+    }
+    else if (data_reg_type == "DOSIMETRY") {
+      oss << ", dose_params_" << suffix << ", edep_tracking_" << suffix << ", edep_squared_tracking_" << suffix << ", hit_tracking_" << suffix << ", photon_tracking_" << suffix;
+    }
+    oss << ", global_id);\n";
+  }
+
+  return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGuint GGEMSNavigator::SetTransportKernelArguments(cl::Kernel* kernel, GGuint const& argument_index, GGsize const& thread_index) const
+{
+  GGuint index = argument_index;
+
+  // Parameters shared by all the solids of navigator
+  kernel->setArg(index++, *cross_sections_->GetCrossSections(thread_index));
+  kernel->setArg(index++, *materials_->GetMaterialTables(thread_index));
+  kernel->setArg(index++, *attenuations_->GetAttenuations(thread_index));
+  kernel->setArg(index++, threshold_);
+
+  // Loop over all the solids, same arguments as in TrackThroughSolid
+  for (GGsize i = 0; i < number_of_solids_; ++i) {
+    cl::Buffer* label_data = solids_[i]->GetLabelData(thread_index);
+    std::string data_reg_type = solids_[i]->GetRegisteredDataType();
+
+    kernel->setArg(index++, *solids_[i]->GetSolidData(thread_index));
+    if (!label_data) kernel->setArg(index++, sizeof(cl_mem), nullptr);
+    else kernel->setArg(index++, *label_data);
+
+    if (data_reg_type == "HISTOGRAM") {
+      cl::Buffer* scatter_histogram = solids_[i]->GetScatterHistogram(thread_index);
+
+      kernel->setArg(index++, *solids_[i]->GetHistogram(thread_index));
+      if (!scatter_histogram) kernel->setArg(index++, sizeof(cl_mem), nullptr);
+      else kernel->setArg(index++, *scatter_histogram);
+    }
+    else if (data_reg_type == "DOSIMETRY") {
+      cl::Buffer* edep_squared_tracking_dosimetry = dose_calculator_->GetEdepSquaredBuffer(thread_index);
+      cl::Buffer* hit_tracking_dosimetry = dose_calculator_->GetHitTrackingBuffer(thread_index);
+      cl::Buffer* photon_tracking_dosimetry = dose_calculator_->GetPhotonTrackingBuffer(thread_index);
+
+      kernel->setArg(index++, *dose_calculator_->GetDoseParams(thread_index));
+      kernel->setArg(index++, *dose_calculator_->GetEdepBuffer(thread_index));
+
+      if (!edep_squared_tracking_dosimetry) kernel->setArg(index++, sizeof(cl_mem), nullptr);
+      else kernel->setArg(index++, *edep_squared_tracking_dosimetry);
+
+      if (!hit_tracking_dosimetry) kernel->setArg(index++, sizeof(cl_mem), nullptr);
+      else kernel->setArg(index++, *hit_tracking_dosimetry);
+
+      if (!photon_tracking_dosimetry) kernel->setArg(index++, sizeof(cl_mem), nullptr);
+      else kernel->setArg(index++, *photon_tracking_dosimetry);
+    }
+  }
+
+  return index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSNavigator::ComputeDose(GGsize const& thread_index)
 {
   if (is_dosimetry_mode_) dose_calculator_->ComputeDose(thread_index);
@@ -533,6 +723,15 @@ void GGEMSNavigator::ComputeDose(GGsize const& thread_index)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSNavigator::ReduceDose(void)
+{
+  if (is_dosimetry_mode_) dose_calculator_->ReduceDose();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSNavigator::PrintInfos(void) const
 {
   GGcout("GGEMSNavigator", "PrintInfos", 0) << GGendl;
@@ -28,9 +28,14 @@
   \date Tuesday February 11, 2020
 */
 
+#include <algorithm>
+#include <functional>
+
 #include "GGEMS/physics/GGEMSRangeCutsManager.hh"
 #include "GGEMS/geometries/GGEMSSolid.hh"
 #include "GGEMS/sources/GGEMSSourceManager.hh"
+#include "GGEMS/randoms/GGEMSPseudoRandomGenerator.hh"
+#include "GGEMS/tools/GGEMSProfilerManager.hh"
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,7 +44,8 @@
 GGEMSNavigatorManager::GGEMSNavigatorManager(void)
 : navigators_(nullptr),
   number_of_navigators_(0),
-  world_(nullptr)
+  world_(nullptr),
+  kernel_transport_(nullptr)
 {
   GGcout("GGEMSNavigatorManager", "GGEMSNavigatorManager", 3) << "GGEMSNavigatorManager creating..." << GGendl;
 
@@ -59,6 +65,11 @@ GGEMSNavigatorManager::~GGEMSNavigatorManager(void)
     navigators_ = nullptr;
   }
 
+  if (kernel_transport_) {
+    delete[] kernel_transport_;
+    kernel_transport_ = nullptr;
+  }
+
   GGcout("GGEMSNavigatorManager", "~GGEMSNavigatorManager", 3) << "GGEMSNavigatorManager erased!!!" << GGendl;
 }
 
@@ -221,3 +232,172 @@ void GGEMSNavigatorManager::ComputeDose(GGsize const& thread_index)
     navigators_[i]->ComputeDose(thread_index);
   }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSNavigatorManager::ReduceDose(void)
+{
+  for (GGsize i = 0; i < number_of_navigators_; ++i) {
+    navigators_[i]->ReduceDose();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSNavigatorManager::InitializeTransportKernel(void)
+{
+  GGcout("GGEMSNavigatorManager", "InitializeTransportKernel", 3) << "Initializing persistent transport kernel..." << GGendl;
+
+  if (number_of_navigators_ == 0) return;
+
+  // All the solids of same type are compiled in a single program, so they must share the same options
+  std::string voxelized_solid_option("");
+  std::string solid_box_option("");
+  bool is_voxelized_solid = false;
+  bool is_solid_box = false;
+  for (GGsize i = 0; i < number_of_navigators_; ++i) {
+    for (GGsize j = 0; j < navigators_[i]->GetNumberOfSolids(); ++j) {
+      GGEMSSolid* solid = navigators_[i]->GetSolids(j);
+      bool is_box = solid->GetRegisteredDataType() == "HISTOGRAM" || solid->GetRegisteredDataType() == "MODULE";
+      std::string& option = is_box ? solid_box_option : voxelized_solid_option;
+      bool& is_type_found = is_box ? is_solid_box : is_voxelized_solid;
+
+      if (!is_type_found) {
+        option = solid->GetKernelOption();
+        is_type_found = true;
+      }
+      else if (option != solid->GetKernelOption()) {
+        GGwarn("GGEMSNavigatorManager", "InitializeTransportKernel", 0) << "Solids have different kernel options, persistent transport disabled!!!" << GGendl;
+        return;
+      }
+    }
+  }
+
+  // Union of the preprocessor options
+  std::vector<std::string> option_tokens;
+  std::istringstream iss(voxelized_solid_option + " " + solid_box_option + " " + (world_ ? world_->GetKernelOption() : std::string("")));
+  std::string token;
+  while (iss >> token) {
+    if (std::find(option_tokens.begin(), option_tokens.end(), token) == option_tokens.end()) option_tokens.push_back(token);
+  }
+
+  // Local dose tallies are flushed at the end of work-group, all the work-items must reach the barrier
+  if (std::find(option_tokens.begin(), option_tokens.end(), "-DDOSE_LOCAL_TALLY") != option_tokens.end()) {
+    GGwarn("GGEMSNavigatorManager", "InitializeTransportKernel", 0) << "Local dose tallies need multi-kernel transport, persistent transport disabled!!!" << GGendl;
+    return;
+  }
+
+  // Generating the kernel source, the parameters are the union of the parameters of each step
+  GGsize parameter_size = sizeof(GGsize) + 2*sizeof(cl_mem);
+  std::ostringstream parameters(std::ostringstream::out);
+  std::ostringstream particle_solid_distance(std::ostringstream::out);
+  std::ostringstream project_to_solid(std::ostringstream::out);
+  std::ostringstream track_through_solid(std::ostringstream::out);
+  for (GGsize i = 0; i < number_of_navigators_; ++i) {
+    parameters << navigators_[i]->GetTransportKernelParameters(parameter_size);
+    particle_solid_distance << navigators_[i]->GetTransportKernelParticleSolidDistance();
+    project_to_solid << navigators_[i]->GetTransportKernelProjectToSolid();
+    track_through_solid << navigators_[i]->GetTransportKernelTrackThroughSolid();
+  }
+  if (world_) parameters << world_->GetTransportKernelParameters(parameter_size);
+
+  std::ostringstream source(std::ostringstream::out);
+  source << "#include \"GGEMS/navigators/GGEMSSolidNavigation.hh\"\n\n";
+  source << "kernel void transport_ggems(\n";
+  source << "  GGsize const particle_id_limit,\n";
+  source << "  global GGEMSPrimaryParticles* primary_particle,\n";
+  source << "  global GGEMSRandom* random";
+  source << parameters.str() << "\n";
+  source << ")\n";
+  source << "{\n";
+  source << "  GGsize global_id = get_global_id(0);\n";
+  source << "  if (global_id >= particle_id_limit) return;\n\n";
+  source << "  GGEMSRandomState random_state = LoadRandomState(random, global_id);\n\n";
+  source << "  for (GGint step = 0; step < MAXIMUM_NAVIGATION_STEPS; ++step) {\n";
+  source << "    if (GetParticleStatus(primary_particle, global_id) == DEAD) break;\n\n";
+  source << particle_solid_distance.str();
+  if (world_) source << world_->GetTransportKernelTracking();
+  source << project_to_solid.str();
+  source << track_through_solid.str();
+  source << "  }\n\n";
+  source << "  StoreRandomState(random, global_id, &random_state);\n";
+  source << "}\n";
+
+  // Checking size of parameters on each device
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  GGsize number_activated_devices = opencl_manager.GetNumberOfActivatedDevice();
+  for (GGsize i = 0; i < number_activated_devices; ++i) {
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(i);
+    if (parameter_size > opencl_manager.GetMaxParameterSize(device_index)) {
+      GGwarn("GGEMSNavigatorManager", "InitializeTransportKernel", 0) << "Size of persistent transport kernel parameters (" << parameter_size << " bytes) too big for device "
+        << opencl_manager.GetDeviceName(device_index) << ", persistent transport disabled!!!" << GGendl;
+      return;
+    }
+  }
+
+  // Kernels are cached by name and options, the source hash distinguishes two scenes
+  std::ostringstream options(std::ostringstream::out);
+  for (auto&& t : option_tokens) options << t << " ";
+  options << "-DGGEMS_TRANSPORT_KERNEL=" << std::hash<std::string>()(source.str());
+  std::string kernel_option = options.str();
+
+  // Compiling the kernel
+  kernel_transport_ = new cl::Kernel*[number_activated_devices];
+  opencl_manager.CompileKernelFromSource(source.str(), "transport_ggems", kernel_transport_, nullptr, const_cast<char*>(kernel_option.c_str()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSNavigatorManager::Transport(GGsize const& thread_index) const
+{
+  // Getting the OpenCL manager and infos for work-item launching
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSNavigatorManager::Transport on " << device_name << ", index " << device_index;
+
+  // Pointer to primary particles, and number to particles in buffer
+  GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
+  cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
+
+  // Getting OpenCL pointer to random number of the active stack
+  cl::Buffer* randoms = source_manager.GetPseudoRandomGenerator()->GetPseudoRandomNumbers(thread_index, source_manager.GetParticles()->GetActiveStack(thread_index));
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_particles);
+
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Getting kernel, and setting parameters
+  cl::Kernel* kernel = kernel_transport_[thread_index];
+  kernel->setArg(0, number_of_particles);
+  kernel->setArg(1, *primary_particles);
+  kernel->setArg(2, *randoms);
+  GGuint argument_index = 3;
+  for (GGsize i = 0; i < number_of_navigators_; ++i) {
+    argument_index = navigators_[i]->SetTransportKernelArguments(kernel, argument_index, thread_index);
+  }
+  if (world_) world_->SetTransportKernelArguments(kernel, argument_index, thread_index);
+
+  // Launching kernel
+  cl::Event event;
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, &event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSNavigatorManager", "Transport");
+
+  // GGEMS Profiling
+  GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
+}
@@ -57,6 +57,9 @@ GGEMSSystem::GGEMSSystem(std::string const& system_name)
   global_system_position_xyz_.s[1] = 0.0f;
   global_system_position_xyz_.s[2] = 0.0f;
 
+  histogram_ = nullptr;
+  scatter_histogram_ = nullptr;
+
   GGcout("GGEMSSystem", "GGEMSSystem", 3) << "GGEMSSystem created!!!" << GGendl;
 }
 
@@ -68,6 +71,24 @@ GGEMSSystem::~GGEMSSystem(void)
 {
   GGcout("GGEMSSystem", "~GGEMSSystem", 3) << "GGEMSSystem erasing..." << GGendl;
 
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  if (histogram_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(histogram_[i], GetNumberOfHistogramElements()*sizeof(GGint), i);
+    }
+    delete[] histogram_;
+    histogram_ = nullptr;
+  }
+
+  if (scatter_histogram_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(scatter_histogram_[i], GetNumberOfHistogramElements()*sizeof(GGint), i);
+    }
+    delete[] scatter_histogram_;
+    scatter_histogram_ = nullptr;
+  }
+
   GGcout("GGEMSSystem", "~GGEMSSystem", 3) << "GGEMSSystem erased!!!" << GGendl;
 }
 
@@ -171,6 +192,42 @@ void GGEMSSystem::CheckParameters(void) const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+GGsize GGEMSSystem::GetNumberOfHistogramElements(void) const
+{
+  return number_of_modules_xy_.x_*number_of_detection_elements_inside_module_xyz_.x_
+    * number_of_modules_xy_.y_*number_of_detection_elements_inside_module_xyz_.y_
+    * number_of_detection_elements_inside_module_xyz_.z_;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSystem::InitializeHistogram(void)
+{
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  GGsize number_of_elements = GetNumberOfHistogramElements();
+
+  histogram_ = new cl::Buffer*[number_activated_devices_];
+  if (is_scatter_) scatter_histogram_ = new cl::Buffer*[number_activated_devices_];
+
+  // Loop over number of device
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    histogram_[d] = opencl_manager.Allocate(nullptr, number_of_elements*sizeof(GGint), d, CL_MEM_READ_WRITE, "GGEMSSystem");
+    opencl_manager.CleanBuffer(histogram_[d], number_of_elements*sizeof(GGint), d);
+
+    if (is_scatter_) {
+      scatter_histogram_[d] = opencl_manager.Allocate(nullptr, number_of_elements*sizeof(GGint), d, CL_MEM_READ_WRITE, "GGEMSSystem");
+      opencl_manager.CleanBuffer(scatter_histogram_[d], number_of_elements*sizeof(GGint), d);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSSystem::SaveResults(void)
 {
   GGcout("GGEMSSystem", "SaveResults", 2) << "Saving results in MHD format..." << GGendl;
@@ -190,25 +247,14 @@ void GGEMSSystem::SaveResults(void)
   mhdImage.SetDimensions(total_dim);
   mhdImage.SetElementSizes(size_of_detection_elements_xyz_);
 
-  // Getting all the counts from solid from all OpenCL devices
+  // Getting all the counts from all OpenCL devices, modules are already placed in histogram
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    for (GGsize jj = 0; jj < number_of_modules_xy_.y_; ++jj) {
-      for (GGsize ii = 0; ii < number_of_modules_xy_.x_; ++ii) {
-        cl::Buffer* histogram = solids_[ii + jj* number_of_modules_xy_.x_]->GetHistogram(i);
-
-        GGint* histogram_device = opencl_manager.GetDeviceBuffer<GGint>(histogram, CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, number_of_detection_elements_inside_module_xyz_.x_*number_of_detection_elements_inside_module_xyz_.y_*sizeof(GGint), i);
-
-        // Storing data on host
-        for (GGsize jjj = 0; jjj < number_of_detection_elements_inside_module_xyz_.y_; ++jjj) {
-          for (GGsize iii = 0; iii < number_of_detection_elements_inside_module_xyz_.x_; ++iii) {
-            output[(iii+ii*number_of_detection_elements_inside_module_xyz_.x_) + (jjj+jj*number_of_detection_elements_inside_module_xyz_.y_)*total_dim.x_] +=
-              histogram_device[iii + jjj*number_of_detection_elements_inside_module_xyz_.x_];
-          }
-        }
-
-        opencl_manager.ReleaseDeviceBuffer(histogram, histogram_device, i);
-      }
-    }
+    GGint* histogram_device = opencl_manager.GetDeviceBuffer<GGint>(histogram_[i], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_dim.x_*total_dim.y_*sizeof(GGint), i);
+
+    // Storing data on host
+    for (GGsize j = 0; j < total_dim.x_*total_dim.y_; ++j) output[j] += histogram_device[j];
+
+    opencl_manager.ReleaseDeviceBuffer(histogram_[i], histogram_device, i);
   }
 
   mhdImage.Write<GGint>(output);
@@ -237,25 +283,14 @@ void GGEMSSystem::SaveResults(void)
     mhdImageScatter.SetDimensions(total_dim);
     mhdImageScatter.SetElementSizes(size_of_detection_elements_xyz_);
 
-    // Getting all the counts from solid from all OpenCL devices
+    // Getting all the counts from all OpenCL devices
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      for (GGsize jj = 0; jj < number_of_modules_xy_.y_; ++jj) {
-        for (GGsize ii = 0; ii < number_of_modules_xy_.x_; ++ii) {
-          cl::Buffer* scatter_histogram = solids_[ii + jj* number_of_modules_xy_.x_]->GetScatterHistogram(i);
-
-          GGint* scatter_histogram_device = opencl_manager.GetDeviceBuffer<GGint>(scatter_histogram, CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, number_of_detection_elements_inside_module_xyz_.x_*number_of_detection_elements_inside_module_xyz_.y_*sizeof(GGint), i);
-
-          // Storing data on host
-          for (GGsize jjj = 0; jjj < number_of_detection_elements_inside_module_xyz_.y_; ++jjj) {
-            for (GGsize iii = 0; iii < number_of_detection_elements_inside_module_xyz_.x_; ++iii) {
-              output[(iii+ii*number_of_detection_elements_inside_module_xyz_.x_) + (jjj+jj*number_of_detection_elements_inside_module_xyz_.y_)*total_dim.x_] +=
-                scatter_histogram_device[iii + jjj*number_of_detection_elements_inside_module_xyz_.x_];
-            }
-          }
-
-          opencl_manager.ReleaseDeviceBuffer(scatter_histogram, scatter_histogram_device, i);
-        }
-      }
+      GGint* scatter_histogram_device = opencl_manager.GetDeviceBuffer<GGint>(scatter_histogram_[i], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_dim.x_*total_dim.y_*sizeof(GGint), i);
+
+      // Storing data on host
+      for (GGsize j = 0; j < total_dim.x_*total_dim.y_; ++j) output[j] += scatter_histogram_device[j];
+
+      opencl_manager.ReleaseDeviceBuffer(scatter_histogram_[i], scatter_histogram_device, i);
     }
 
     mhdImageScatter.Write<GGint>(output);
@@ -115,6 +115,25 @@ void GGEMSVoxelizedPhantom::Initialize(void)
   // Enabling TLE
   if (is_tle_) solids_[0]->AddKernelOption(" -DTLE");
 
+  // Enabling dose scoring in local memory
+  if (is_dosimetry_mode_ && is_dose_local_tally_) solids_[0]->AddKernelOption(" -DDOSE_LOCAL_TALLY");
+
+  // Enabling Woodcock tracking, TLE needs the track length in each voxel
+  if (is_woodcock_tracking_) {
+    if (is_tle_) {
+      GGwarn("GGEMSVoxelizedPhantom", "Initialize", 0) << "Woodcock tracking is not compatible with TLE, Woodcock tracking disabled for phantom: " << navigator_name_ << GGendl;
+    }
+    else {
+      // Photons are not scored voxel by voxel in Woodcock tracking
+      if (is_dosimetry_mode_ && dose_calculator_->IsPhotonTracking()) {
+        std::ostringstream oss(std::ostringstream::out);
+        oss << "Woodcock tracking is not compatible with photon tracking in dosimetry, disable one of them for phantom: " << navigator_name_;
+        GGEMSMisc::ThrowException("GGEMSVoxelizedPhantom", "Initialize", oss.str());
+      }
+      solids_[0]->AddKernelOption(" -DWOODCOCK");
+    }
+  }
+
   // Load voxelized phantom from MHD file and storing materials
   solids_[0]->Initialize(materials_);
   solids_[0]->SetCustomMaterialColor(custom_material_rgb_);
@@ -244,3 +263,12 @@ void set_material_color_name_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxe
 {
   voxelized_phantom->SetMaterialColor(material_name, color_name);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_woodcock_tracking_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, bool const flag)
+{
+  voxelized_phantom->EnableWoodcockTracking(flag);
+}
@@ -331,9 +331,13 @@ void GGEMSWorld::Tracking(GGsize const& thread_index)
   cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
   GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
 
+  // Kernels are launched only over alive particles if particles are compacted
+  cl::Buffer* alive_particles = source_manager.GetParticles()->GetAliveParticles(thread_index);
+  GGsize number_of_alive_particles = source_manager.GetParticles()->GetNumberOfAliveParticles(thread_index);
+
   // Getting work group size, and work-item number
   GGsize work_group_size = opencl_manager.GetWorkGroupSize();
-  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_particles);
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_alive_particles);
 
   // Parameters for work-item in kernel
   cl::NDRange global_wi(number_of_work_items);
@@ -341,35 +345,36 @@ void GGEMSWorld::Tracking(GGsize const& thread_index)
 
   // Getting kernel, and setting parameters
   kernel_world_tracking_[thread_index]->setArg(0, number_of_particles);
-  kernel_world_tracking_[thread_index]->setArg(0, number_of_particles);
-  kernel_world_tracking_[thread_index]->setArg(1, *primary_particles);
+  if (!alive_particles) kernel_world_tracking_[thread_index]->setArg(1, sizeof(cl_mem), nullptr);
+  else kernel_world_tracking_[thread_index]->setArg(1, *alive_particles);
+  kernel_world_tracking_[thread_index]->setArg(2, *primary_particles);
 
-  if (!is_photon_tracking_) kernel_world_tracking_[thread_index]->setArg(2, sizeof(cl_mem), nullptr);
-  else kernel_world_tracking_[thread_index]->setArg(2, *world_recording_.photon_tracking_[thread_index]);
+  if (!is_photon_tracking_) kernel_world_tracking_[thread_index]->setArg(3, sizeof(cl_mem), nullptr);
+  else kernel_world_tracking_[thread_index]->setArg(3, *world_recording_.photon_tracking_[thread_index]);
 
-  if (!is_energy_tracking_) kernel_world_tracking_[thread_index]->setArg(3, sizeof(cl_mem), nullptr);
-  else kernel_world_tracking_[thread_index]->setArg(3, *world_recording_.energy_tracking_[thread_index]);
+  if (!is_energy_tracking_) kernel_world_tracking_[thread_index]->setArg(4, sizeof(cl_mem), nullptr);
+  else kernel_world_tracking_[thread_index]->setArg(4, *world_recording_.energy_tracking_[thread_index]);
 
-  if (!is_energy_squared_tracking_) kernel_world_tracking_[thread_index]->setArg(4, sizeof(cl_mem), nullptr);
-  else kernel_world_tracking_[thread_index]->setArg(4, *world_recording_.energy_squared_tracking_[thread_index]);
+  if (!is_energy_squared_tracking_) kernel_world_tracking_[thread_index]->setArg(5, sizeof(cl_mem), nullptr);
+  else kernel_world_tracking_[thread_index]->setArg(5, *world_recording_.energy_squared_tracking_[thread_index]);
 
   if (!is_momentum_) {
-    kernel_world_tracking_[thread_index]->setArg(5, sizeof(cl_mem), nullptr);
     kernel_world_tracking_[thread_index]->setArg(6, sizeof(cl_mem), nullptr);
     kernel_world_tracking_[thread_index]->setArg(7, sizeof(cl_mem), nullptr);
+    kernel_world_tracking_[thread_index]->setArg(8, sizeof(cl_mem), nullptr);
   }
   else {
-    kernel_world_tracking_[thread_index]->setArg(5, *world_recording_.momentum_x_[thread_index]);
-    kernel_world_tracking_[thread_index]->setArg(6, *world_recording_.momentum_y_[thread_index]);
-    kernel_world_tracking_[thread_index]->setArg(7, *world_recording_.momentum_z_[thread_index]);
+    kernel_world_tracking_[thread_index]->setArg(6, *world_recording_.momentum_x_[thread_index]);
+    kernel_world_tracking_[thread_index]->setArg(7, *world_recording_.momentum_y_[thread_index]);
+    kernel_world_tracking_[thread_index]->setArg(8, *world_recording_.momentum_z_[thread_index]);
   }
 
-  kernel_world_tracking_[thread_index]->setArg(8, dimensions_.x_);
-  kernel_world_tracking_[thread_index]->setArg(9, dimensions_.y_);
-  kernel_world_tracking_[thread_index]->setArg(10, dimensions_.z_);
-  kernel_world_tracking_[thread_index]->setArg(11, sizes_.s[0]);
-  kernel_world_tracking_[thread_index]->setArg(12, sizes_.s[1]);
-  kernel_world_tracking_[thread_index]->setArg(13, sizes_.s[2]);
+  kernel_world_tracking_[thread_index]->setArg(9, dimensions_.x_);
+  kernel_world_tracking_[thread_index]->setArg(10, dimensions_.y_);
+  kernel_world_tracking_[thread_index]->setArg(11, dimensions_.z_);
+  kernel_world_tracking_[thread_index]->setArg(12, sizes_.s[0]);
+  kernel_world_tracking_[thread_index]->setArg(13, sizes_.s[1]);
+  kernel_world_tracking_[thread_index]->setArg(14, sizes_.s[2]);
 
   // Launching kernel
   cl::Event event;
@@ -378,7 +383,82 @@ void GGEMSWorld::Tracking(GGsize const& thread_index)
 
   // GGEMS Profiling
   GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
-  queue->finish();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSWorld::GetTransportKernelParameters(GGsize& parameter_size) const
+{
+  parameter_size += 6*sizeof(cl_mem) + 3*sizeof(GGsize) + 3*sizeof(GGfloat);
+
+  return std::string(
+    ",\n  global GGint* world_photon_tracking"
+    ",\n  global GGDosiType* world_edep_tracking"
+    ",\n  global GGDosiType* world_edep_squared_tracking"
+    ",\n  global GGDosiType* world_momentum_x"
+    ",\n  global GGDosiType* world_momentum_y"
+    ",\n  global GGDosiType* world_momentum_z"
+    ",\n  GGsize world_width"
+    ",\n  GGsize world_height"
+    ",\n  GGsize world_depth"
+    ",\n  GGfloat world_size_x"
+    ",\n  GGfloat world_size_y"
+    ",\n  GGfloat world_size_z"
+  );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSWorld::GetTransportKernelTracking(void) const
+{
+  return std::string(
+    "    WorldTracking(primary_particle, world_photon_tracking, world_edep_tracking, world_edep_squared_tracking, "
+    "world_momentum_x, world_momentum_y, world_momentum_z, world_width, world_height, world_depth, "
+    "world_size_x, world_size_y, world_size_z, global_id);\n"
+  );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGuint GGEMSWorld::SetTransportKernelArguments(cl::Kernel* kernel, GGuint const& argument_index, GGsize const& thread_index) const
+{
+  GGuint index = argument_index;
+
+  // Same arguments as in Tracking
+  if (!is_photon_tracking_) kernel->setArg(index++, sizeof(cl_mem), nullptr);
+  else kernel->setArg(index++, *world_recording_.photon_tracking_[thread_index]);
+
+  if (!is_energy_tracking_) kernel->setArg(index++, sizeof(cl_mem), nullptr);
+  else kernel->setArg(index++, *world_recording_.energy_tracking_[thread_index]);
+
+  if (!is_energy_squared_tracking_) kernel->setArg(index++, sizeof(cl_mem), nullptr);
+  else kernel->setArg(index++, *world_recording_.energy_squared_tracking_[thread_index]);
+
+  if (!is_momentum_) {
+    kernel->setArg(index++, sizeof(cl_mem), nullptr);
+    kernel->setArg(index++, sizeof(cl_mem), nullptr);
+    kernel->setArg(index++, sizeof(cl_mem), nullptr);
+  }
+  else {
+    kernel->setArg(index++, *world_recording_.momentum_x_[thread_index]);
+    kernel->setArg(index++, *world_recording_.momentum_y_[thread_index]);
+    kernel->setArg(index++, *world_recording_.momentum_z_[thread_index]);
+  }
+
+  kernel->setArg(index++, dimensions_.x_);
+  kernel->setArg(index++, dimensions_.y_);
+  kernel->setArg(index++, dimensions_.z_);
+  kernel->setArg(index++, sizes_.s[0]);
+  kernel->setArg(index++, sizes_.s[1]);
+  kernel->setArg(index++, sizes_.s[2]);
+
+  return index;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -416,7 +496,7 @@ void GGEMSWorld::SavePhotonTracking(void) const
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGint* photon_tracking_device = opencl_manager.GetDeviceBuffer<GGint>(world_recording_.photon_tracking_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_voxels*sizeof(GGint), j);
 
-    for (GGsize i = 0; i < total_number_of_voxels; ++i) photon_tracking[i] = photon_tracking_device[i];
+    for (GGsize i = 0; i < total_number_of_voxels; ++i) photon_tracking[i] += photon_tracking_device[i];
 
     opencl_manager.ReleaseDeviceBuffer(world_recording_.photon_tracking_[j], photon_tracking_device, j);
   }
@@ -440,7 +520,7 @@ void GGEMSWorld::SaveEnergyTracking(void) const
   std::memset(edep_tracking, 0, total_number_of_voxels*sizeof(GGDosiType));
 
   GGEMSMHDImage mhdImage;
-  mhdImage.SetOutputFileName(world_output_basename_ + "_world_edep.mhd");
+  mhdImage.SetOutputFileName(world_output_basename_ + "_world_energy_track_length.mhd");
   if (sizeof(GGDosiType) == 4) mhdImage.SetDataType("MET_FLOAT");
   else if (sizeof(GGDosiType) == 8) mhdImage.SetDataType("MET_DOUBLE");
   mhdImage.SetDimensions(dimensions_);
@@ -450,13 +530,13 @@ void GGEMSWorld::SaveEnergyTracking(void) const
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGDosiType* edep_device = opencl_manager.GetDeviceBuffer<GGDosiType>(world_recording_.energy_tracking_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_voxels*sizeof(GGDosiType), j);
 
-    for (GGsize i = 0; i < total_number_of_voxels; ++i) edep_tracking[i] = edep_device[i];
+    for (GGsize i = 0; i < total_number_of_voxels; ++i) edep_tracking[i] += edep_device[i];
 
     opencl_manager.ReleaseDeviceBuffer(world_recording_.energy_tracking_[j], edep_device, j);
   }
 
   // Writing data
-  mhdImage.Write<GGDosiType>(edep_tracking);
+  mhdImage.WriteDosimetry(edep_tracking, WORLD_ENERGY_FIXED_POINT_SCALE, true);
   delete[] edep_tracking;
 }
 
@@ -474,7 +554,7 @@ void GGEMSWorld::SaveEnergySquaredTracking(void) const
   std::memset(edep_squared_tracking, 0, total_number_of_voxels*sizeof(GGDosiType));
 
   GGEMSMHDImage mhdImage;
-  mhdImage.SetOutputFileName(world_output_basename_ + "_world_edep_squared.mhd");
+  mhdImage.SetOutputFileName(world_output_basename_ + "_world_energy_squared_track_length.mhd");
   if (sizeof(GGDosiType) == 4) mhdImage.SetDataType("MET_FLOAT");
   else if (sizeof(GGDosiType) == 8) mhdImage.SetDataType("MET_DOUBLE");
   mhdImage.SetDimensions(dimensions_);
@@ -484,13 +564,13 @@ void GGEMSWorld::SaveEnergySquaredTracking(void) const
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGDosiType* edep_squared_device = opencl_manager.GetDeviceBuffer<GGDosiType>(world_recording_.energy_squared_tracking_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_voxels*sizeof(GGDosiType), j);
 
-    for (GGsize i = 0; i < total_number_of_voxels; ++i) edep_squared_tracking[i] = edep_squared_device[i];
+    for (GGsize i = 0; i < total_number_of_voxels; ++i) edep_squared_tracking[i] += edep_squared_device[i];
 
     opencl_manager.ReleaseDeviceBuffer(world_recording_.energy_squared_tracking_[j], edep_squared_device, j);
   }
 
   // Writing data
-  mhdImage.Write<GGDosiType>(edep_squared_tracking);
+  mhdImage.WriteDosimetry(edep_squared_tracking, WORLD_ENERGY_SQUARED_FIXED_POINT_SCALE, true);
   delete[] edep_squared_tracking;
 }
 
@@ -515,21 +595,21 @@ void GGEMSWorld::SaveMomentum(void) const
   std::memset(momentum_z, 0, total_number_of_voxels*sizeof(GGDosiType));
 
   GGEMSMHDImage mhdImage_momentum_x;
-  mhdImage_momentum_x.SetOutputFileName(world_output_basename_ + "_world_momentum_x.mhd");
+  mhdImage_momentum_x.SetOutputFileName(world_output_basename_ + "_world_momentum_track_length_x.mhd");
   if (sizeof(GGDosiType) == 4) mhdImage_momentum_x.SetDataType("MET_FLOAT");
   else if (sizeof(GGDosiType) == 8) mhdImage_momentum_x.SetDataType("MET_DOUBLE");
   mhdImage_momentum_x.SetDimensions(dimensions_);
   mhdImage_momentum_x.SetElementSizes(sizes_);
 
   GGEMSMHDImage mhdImage_momentum_y;
-  mhdImage_momentum_y.SetOutputFileName(world_output_basename_ + "_world_momentum_y.mhd");
+  mhdImage_momentum_y.SetOutputFileName(world_output_basename_ + "_world_momentum_track_length_y.mhd");
   if (sizeof(GGDosiType) == 4) mhdImage_momentum_y.SetDataType("MET_FLOAT");
   else if (sizeof(GGDosiType) == 8) mhdImage_momentum_y.SetDataType("MET_DOUBLE");
   mhdImage_momentum_y.SetDimensions(dimensions_);
   mhdImage_momentum_y.SetElementSizes(sizes_);
 
   GGEMSMHDImage mhdImage_momentum_z;
-  mhdImage_momentum_z.SetOutputFileName(world_output_basename_ + "_world_momentum_z.mhd");
+  mhdImage_momentum_z.SetOutputFileName(world_output_basename_ + "_world_momentum_track_length_z.mhd");
   if (sizeof(GGDosiType) == 4) mhdImage_momentum_z.SetDataType("MET_FLOAT");
   else if (sizeof(GGDosiType) == 8) mhdImage_momentum_z.SetDataType("MET_DOUBLE");
   mhdImage_momentum_z.SetDimensions(dimensions_);
@@ -539,39 +619,39 @@ void GGEMSWorld::SaveMomentum(void) const
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGDosiType* momentum_x_device = opencl_manager.GetDeviceBuffer<GGDosiType>(world_recording_.momentum_x_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_voxels*sizeof(GGDosiType), j);
 
-    for (GGsize i = 0; i < total_number_of_voxels; ++i) momentum_x[i] = momentum_x_device[i];
+    for (GGsize i = 0; i < total_number_of_voxels; ++i) momentum_x[i] += momentum_x_device[i];
 
     opencl_manager.ReleaseDeviceBuffer(world_recording_.momentum_x_[j], momentum_x_device, j);
   }
 
   // Writing data
-  mhdImage_momentum_x.Write<GGDosiType>(momentum_x);
+  mhdImage_momentum_x.WriteDosimetry(momentum_x, WORLD_ENERGY_FIXED_POINT_SCALE, false);
   delete[] momentum_x;
 
   // Loop over all activated device
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGDosiType* momentum_y_device = opencl_manager.GetDeviceBuffer<GGDosiType>(world_recording_.momentum_y_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_voxels*sizeof(GGDosiType), j);
 
-    for (GGsize i = 0; i < total_number_of_voxels; ++i) momentum_y[i] = momentum_y_device[i];
+    for (GGsize i = 0; i < total_number_of_voxels; ++i) momentum_y[i] += momentum_y_device[i];
 
     opencl_manager.ReleaseDeviceBuffer(world_recording_.momentum_y_[j], momentum_y_device, j);
   }
 
   // Writing data
-  mhdImage_momentum_y.Write<GGDosiType>(momentum_y);
+  mhdImage_momentum_y.WriteDosimetry(momentum_y, WORLD_ENERGY_FIXED_POINT_SCALE, false);
   delete[] momentum_y;
 
   // Loop over all activated device
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGDosiType* momentum_z_device = opencl_manager.GetDeviceBuffer<GGDosiType>(world_recording_.momentum_z_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, total_number_of_voxels*sizeof(GGDosiType), j);
 
-    for (GGsize i = 0; i < total_number_of_voxels; ++i) momentum_z[i] = momentum_z_device[i];
+    for (GGsize i = 0; i < total_number_of_voxels; ++i) momentum_z[i] += momentum_z_device[i];
 
     opencl_manager.ReleaseDeviceBuffer(world_recording_.momentum_z_[j], momentum_z_device, j);
   }
 
   // Writing data
-  mhdImage_momentum_z.Write<GGDosiType>(momentum_z);
+  mhdImage_momentum_z.WriteDosimetry(momentum_z, WORLD_ENERGY_FIXED_POINT_SCALE, false);
   delete[] momentum_z;
 }
 
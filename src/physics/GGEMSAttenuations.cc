@@ -28,10 +28,13 @@
   \date Tuesday January 18, 2022
 */
 
+#include <thread>
+
 #include "GGEMS/physics/GGEMSAttenuations.hh"
 #include "GGEMS/physics/GGEMSMuDataConstants.hh"
 #include "GGEMS/materials/GGEMSMaterials.hh"
 #include "GGEMS/physics/GGEMSCrossSections.hh"
+#include "GGEMS/physics/GGEMSProcessesManager.hh"
 #include "GGEMS/maths/GGEMSMathAlgorithms.hh"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -55,8 +58,8 @@ GGEMSAttenuations::GGEMSAttenuations(GGEMSMaterials* materials, GGEMSCrossSectio
   materials_ = materials;
   cross_sections_ = cross_sections;
 
-  attenuations_host_ = new GGEMSMuMuEnData();
   mu_tables_ = nullptr;
+  mu_tables_size_ = 0;
 
   GGint index_table = 0;
   GGint index_data = 0;
@@ -106,11 +109,6 @@ GGEMSAttenuations::~GGEMSAttenuations(void)
     mu_index_ = nullptr;
   }
 
-  if (attenuations_host_) {
-    delete attenuations_host_;
-    attenuations_host_ = nullptr;
-  }
-
   GGcout("GGEMSAttenuations", "~GGEMSAttenuations", 3) << "GGEMSAttenuations erased!!!" << GGendl;
 }
 
@@ -126,7 +124,7 @@ void GGEMSAttenuations::Clean(void)
 
   if (mu_tables_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(mu_tables_[i], sizeof(GGEMSMuMuEnData), i);
+      opencl_manager.Deallocate(mu_tables_[i], mu_tables_size_, i);
     }
     delete[] mu_tables_;
     mu_tables_ = nullptr;
@@ -145,121 +143,113 @@ void GGEMSAttenuations::Initialize(void)
 
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
-  // Loop over the device and storing value for each materials
-  mu_tables_ = new cl::Buffer*[number_activated_devices_];
-  for (GGsize d = 0; d < number_activated_devices_; ++d) {
-    // Allocating memory on OpenCL device
-    mu_tables_[d] = opencl_manager.Allocate(nullptr, sizeof(GGEMSMuMuEnData), d, CL_MEM_READ_WRITE, "GGEMSAttenuations");
-
-    // Getting the OpenCL pointer on Mu tables
-    GGEMSMuMuEnData* mu_table_device = opencl_manager.GetDeviceBuffer<GGEMSMuMuEnData>(mu_tables_[d], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSMuMuEnData), d);
-
-    cl::Buffer* particle_cs = cross_sections_->GetCrossSections(d);
-    GGEMSParticleCrossSections* particle_cs_device =  opencl_manager.GetDeviceBuffer<GGEMSParticleCrossSections>(particle_cs, CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSParticleCrossSections), d);
-
-    mu_table_device->number_of_materials_ = static_cast<GGint>(particle_cs_device->number_of_materials_);
-    mu_table_device->energy_max_ = ATTENUATION_ENERGY_MAX;
-    mu_table_device->energy_min_ = ATTENUATION_ENERGY_MIN;
-    mu_table_device->number_of_bins_ = ATTENUATION_TABLE_NUMBER_BINS;
-
-    opencl_manager.ReleaseDeviceBuffer(particle_cs, particle_cs_device, d);
+  // Computing the offset of each table after the header, tables are sized to the number of materials
+  GGsize number_of_materials = materials_->GetNumberOfMaterials();
+  GGsize table_size = number_of_materials * ATTENUATION_TABLE_NUMBER_BINS * sizeof(GGfloat);
+  mu_tables_size_ = sizeof(GGEMSMuMuEnData);
+  GGsize mu_offset = AppendTable(mu_tables_size_, table_size);
+  GGsize mu_en_offset = AppendTable(mu_tables_size_, table_size);
+
+  // Tables are loaded from cache if computed before with the same materials
+  GGEMSProcessesManager& process_manager = GGEMSProcessesManager::GetInstance();
+  std::ostringstream cache_key(std::ostringstream::out);
+  cache_key << "attenuations " << sizeof(GGEMSMuMuEnData) << '\n' << std::hexfloat
+    << ATTENUATION_ENERGY_MIN << ' ' << ATTENUATION_ENERGY_MAX << ' ' << ATTENUATION_TABLE_NUMBER_BINS << '\n'
+    << materials_->GetPhysicTablesCacheKey();
+
+  if (!process_manager.LoadPhysicTables(cache_key.str(), mu_tables_size_, attenuations_host_)) {
+    // Tables are built once on host, header is stored first
+    attenuations_host_.assign(mu_tables_size_, 0);
+    GGEMSMuMuEnData* attenuations_host = reinterpret_cast<GGEMSMuMuEnData*>(attenuations_host_.data());
+
+    attenuations_host->number_of_materials_ = static_cast<GGint>(number_of_materials);
+    attenuations_host->energy_max_ = ATTENUATION_ENERGY_MAX;
+    attenuations_host->energy_min_ = ATTENUATION_ENERGY_MIN;
+    attenuations_host->number_of_bins_ = ATTENUATION_TABLE_NUMBER_BINS;
+    attenuations_host->mu_ = mu_offset;
+    attenuations_host->mu_en_ = mu_en_offset;
 
     // Fill energy table with log scale
-    GGfloat slope = logf(mu_table_device->energy_max_ / mu_table_device->energy_min_);
+    GGfloat slope = logf(attenuations_host->energy_max_ / attenuations_host->energy_min_);
     GGint i = 0;
-    while (i < mu_table_device->number_of_bins_) {
-      mu_table_device->energy_bins_[i] = mu_table_device->energy_min_ * expf(slope * (static_cast<GGfloat>(i) / (static_cast<GGfloat>(mu_table_device->number_of_bins_)-1.0f)))*MeV;
+    while (i < attenuations_host->number_of_bins_) {
+      attenuations_host->energy_bins_[i] = attenuations_host->energy_min_ * expf(slope * (static_cast<GGfloat>(i) / (static_cast<GGfloat>(attenuations_host->number_of_bins_)-1.0f)))*MeV;
       ++i;
     }
 
-    GGEMSMaterialTables* materials_device =  opencl_manager.GetDeviceBuffer<GGEMSMaterialTables>(materials_->GetMaterialTables(d), CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSMaterialTables), d);
-
-    // For each material and energy bin compute mu and muen
-    GGint imat = 0;
-    GGint abs_index, E_index, mu_index_E;
-    GGsize iZ, Z;
-    GGfloat energy, mu_over_rho, mu_en_over_rho, frac;
-    while (imat < mu_table_device->number_of_materials_) {
-      // for each energy bin
-      i=0;
-      while (i < mu_table_device->number_of_bins_) {
-        // absolute index to store data within the table
-        abs_index = imat*mu_table_device->number_of_bins_ + i;
-
-        // Energy value
-        energy = mu_table_device->energy_bins_[i];
-
-        // For each element of the material
-        mu_over_rho = 0.0f; mu_en_over_rho = 0.0f;
-        iZ=0;
-        while (iZ < materials_device->number_of_chemical_elements_[imat]) {
-          // Get Z and mass fraction
-          Z = materials_device->atomic_number_Z_[materials_device->index_of_chemical_elements_[imat] + iZ];
-          frac = materials_device->mass_fraction_[materials_device->index_of_chemical_elements_[imat] + iZ];
-
-          // Get energy index
-          mu_index_E = GGEMSMuDataConstants::kMuIndexEnergy[Z];
-          E_index = BinarySearchLeft(energy, energies_, mu_index_E+GGEMSMuDataConstants::kMuNbEnergyBins[Z], 0, mu_index_E);
-
-          // Get mu an mu_en from interpolation
-          if ( E_index == mu_index_E ) {
-            mu_over_rho += mu_[E_index];
-            mu_en_over_rho += mu_en_[E_index];
-          }
-          else
-          {
-            mu_over_rho += frac * LinearInterpolation(energies_[E_index-1], mu_[E_index-1], energies_[E_index], mu_[E_index], energy);
-            mu_en_over_rho += frac * LinearInterpolation(energies_[E_index-1], mu_en_[E_index-1], energies_[E_index], mu_en_[E_index], energy);
-          }
-          ++iZ;
-        }
-
-        // Store values
-        mu_table_device->mu_[abs_index] = mu_over_rho * materials_device->density_of_material_[imat] / (g/cm3);
-        mu_table_device->mu_en_[abs_index] = mu_en_over_rho * materials_device->density_of_material_[imat] / (g/cm3);
-
-        ++i;
-      } // E bin
-      ++imat;
+    // For each material and energy bin compute mu and muen, each host thread computes a contiguous part of bins of all materials
+    GGEMSMaterialTables const* material_tables = materials_->GetMaterialTablesHost();
+    GGsize total_number_of_bins = number_of_materials * ATTENUATION_TABLE_NUMBER_BINS;
+    GGsize number_of_threads = std::max(static_cast<GGsize>(std::thread::hardware_concurrency()), static_cast<GGsize>(1));
+    number_of_threads = std::min(number_of_threads, total_number_of_bins);
+    GGsize bins_by_thread = number_of_threads > 0 ? (total_number_of_bins + number_of_threads - 1) / number_of_threads : 0;
+
+    std::vector<std::thread> thread_attenuations;
+    for (GGsize t = 0; t < number_of_threads; ++t) {
+      GGsize first_bin = t * bins_by_thread;
+      GGsize last_bin = std::min(first_bin + bins_by_thread, total_number_of_bins);
+      if (first_bin >= last_bin) break;
+      thread_attenuations.push_back(std::thread(&GGEMSAttenuations::ComputeAttenuationsOfBins, this, attenuations_host, material_tables, first_bin, last_bin));
     }
-    opencl_manager.ReleaseDeviceBuffer(mu_tables_[d], mu_table_device, d);
-    opencl_manager.ReleaseDeviceBuffer(materials_->GetMaterialTables(d), materials_device, d);
+    for (GGsize t = 0; t < thread_attenuations.size(); ++t) thread_attenuations[t].join();
+
+    process_manager.SavePhysicTables(cache_key.str(), attenuations_host_);
   }
 
-  // Copy data from device to RAM memory (optimization for python users)
-  LoadAttenuationsOnHost();
+  // Copying attenuation tables to all devices
+  mu_tables_ = new cl::Buffer*[number_activated_devices_];
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    mu_tables_[d] = opencl_manager.Allocate(attenuations_host_.data(), mu_tables_size_, d, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, "GGEMSAttenuations");
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSAttenuations::LoadAttenuationsOnHost(void)
+void GGEMSAttenuations::ComputeAttenuationsOfBins(GGEMSMuMuEnData* attenuations, GGEMSMaterialTables const* material_tables, GGsize const first_bin, GGsize const last_bin) const
 {
-  GGcout("GGEMSAttenuations", "LoadAttenuationsOnHost", 1) << "Loading attenuations coefficient from OpenCL device to host (RAM)..." << GGendl;
-
-  // Get the OpenCL manager
-  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
-
-  // Get pointer to data on OpenCL device
-  GGEMSMuMuEnData* attenuations_device = opencl_manager.GetDeviceBuffer<GGEMSMuMuEnData>(mu_tables_[0], CL_TRUE, CL_MAP_READ, sizeof(GGEMSMuMuEnData), 0);
-
-  attenuations_host_->number_of_bins_ = attenuations_device->number_of_bins_;
-  attenuations_host_->energy_min_ = attenuations_device->energy_min_;
-  attenuations_host_->energy_max_ = attenuations_device->energy_max_;
-  attenuations_host_->number_of_materials_ = attenuations_device->number_of_materials_;
-
-  for(GGint i = 0; i < ATTENUATION_TABLE_NUMBER_BINS; ++i) {
-    attenuations_host_->energy_bins_[i] = attenuations_device->energy_bins_[i];
-  }
+  GGsize number_of_bins = static_cast<GGsize>(attenuations->number_of_bins_);
+
+  GGint E_index, mu_index_E;
+  GGsize iZ, Z;
+  GGfloat energy, mu_over_rho, mu_en_over_rho, frac;
+  for (GGsize abs_index = first_bin; abs_index < last_bin; ++abs_index) {
+    GGsize imat = abs_index / number_of_bins;
+    GGsize i = abs_index % number_of_bins;
+
+    // Energy value
+    energy = attenuations->energy_bins_[i];
+
+    // For each element of the material
+    mu_over_rho = 0.0f; mu_en_over_rho = 0.0f;
+    iZ=0;
+    while (iZ < GGEMS_TABLE(GGsize, material_tables, number_of_chemical_elements_)[imat]) {
+      // Get Z and mass fraction
+      Z = GGEMS_TABLE(GGuchar, material_tables, atomic_number_Z_)[GGEMS_TABLE(GGsize, material_tables, index_of_chemical_elements_)[imat] + iZ];
+      frac = GGEMS_TABLE(GGfloat, material_tables, mass_fraction_)[GGEMS_TABLE(GGsize, material_tables, index_of_chemical_elements_)[imat] + iZ];
+
+      // Get energy index
+      mu_index_E = GGEMSMuDataConstants::kMuIndexEnergy[Z];
+      E_index = BinarySearchLeft(energy, energies_, mu_index_E+GGEMSMuDataConstants::kMuNbEnergyBins[Z], 0, mu_index_E);
+
+      // Get mu an mu_en from interpolation
+      if ( E_index == mu_index_E ) {
+        mu_over_rho += mu_[E_index];
+        mu_en_over_rho += mu_en_[E_index];
+      }
+      else
+      {
+        mu_over_rho += frac * LinearInterpolation(energies_[E_index-1], mu_[E_index-1], energies_[E_index], mu_[E_index], energy);
+        mu_en_over_rho += frac * LinearInterpolation(energies_[E_index-1], mu_en_[E_index-1], energies_[E_index], mu_en_[E_index], energy);
+      }
+      ++iZ;
+    }
 
-  for(GGint i = 0; i < 256*ATTENUATION_TABLE_NUMBER_BINS; ++i) {
-    attenuations_host_->mu_[i] = attenuations_device->mu_[i];
-    attenuations_host_->mu_en_[i] = attenuations_device->mu_en_[i];
+    // Store values
+    GGEMS_TABLE(GGfloat, attenuations, mu_)[abs_index] = mu_over_rho * GGEMS_TABLE(GGfloat, material_tables, density_of_material_)[imat] / (g/cm3);
+    GGEMS_TABLE(GGfloat, attenuations, mu_en_)[abs_index] = mu_en_over_rho * GGEMS_TABLE(GGfloat, material_tables, density_of_material_)[imat] / (g/cm3);
   }
-
-  // Release pointer
-  opencl_manager.ReleaseDeviceBuffer(mu_tables_[0], attenuations_device, 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -268,10 +258,12 @@ void GGEMSAttenuations::LoadAttenuationsOnHost(void)
 
 GGfloat GGEMSAttenuations::GetAttenuation(std::string const& material_name, GGfloat const& energy, std::string const& unit) const
 {
+  GGEMSMuMuEnData const* attenuations_host = reinterpret_cast<GGEMSMuMuEnData const*>(attenuations_host_.data());
+
   // Get min and max energy in the table, and number of bins
-  GGfloat min_energy = attenuations_host_->energy_min_;
-  GGfloat max_energy = attenuations_host_->energy_max_;
-  GGint number_of_bins = attenuations_host_->number_of_bins_;
+  GGfloat min_energy = attenuations_host->energy_min_;
+  GGfloat max_energy = attenuations_host->energy_max_;
+  GGint number_of_bins = attenuations_host->number_of_bins_;
 
   // Converting energy
   GGfloat e_MeV = EnergyUnit(energy, unit);
@@ -286,13 +278,13 @@ GGfloat GGEMSAttenuations::GetAttenuation(std::string const& material_name, GGfl
   ptrdiff_t material_id = materials_->GetMaterialIndex(material_name);
 
   // Computing the energy bin
-  GGsize energy_bin = static_cast<GGsize>(BinarySearchLeft(e_MeV, attenuations_host_->energy_bins_, static_cast<GGint>(number_of_bins), 0, 0));
+  GGsize energy_bin = static_cast<GGsize>(BinarySearchLeft(e_MeV, attenuations_host->energy_bins_, static_cast<GGint>(number_of_bins), 0, 0));
 
   // Computing attenuation
-  GGfloat energy_a = attenuations_host_->energy_bins_[energy_bin];
-  GGfloat energy_b = attenuations_host_->energy_bins_[energy_bin+1];
-  GGfloat attenuation_a = attenuations_host_->mu_[energy_bin + static_cast<GGsize>(number_of_bins*material_id)];
-  GGfloat attenuation_b = attenuations_host_->mu_[energy_bin+1 + static_cast<GGsize>(number_of_bins*material_id)];
+  GGfloat energy_a = attenuations_host->energy_bins_[energy_bin];
+  GGfloat energy_b = attenuations_host->energy_bins_[energy_bin+1];
+  GGfloat attenuation_a = GGEMS_TABLE(GGfloat, attenuations_host, mu_)[energy_bin + static_cast<GGsize>(number_of_bins*material_id)];
+  GGfloat attenuation_b = GGEMS_TABLE(GGfloat, attenuations_host, mu_)[energy_bin+1 + static_cast<GGsize>(number_of_bins*material_id)];
 
   GGfloat attenuation = LinearInterpolation(energy_a, attenuation_a, energy_b, attenuation_b, e_MeV);
 
@@ -305,10 +297,12 @@ GGfloat GGEMSAttenuations::GetAttenuation(std::string const& material_name, GGfl
 
 GGfloat GGEMSAttenuations::GetEnergyAttenuation(std::string const& material_name, GGfloat const& energy, std::string const& unit) const
 {
+  GGEMSMuMuEnData const* attenuations_host = reinterpret_cast<GGEMSMuMuEnData const*>(attenuations_host_.data());
+
   // Get min and max energy in the table, and number of bins
-  GGfloat min_energy = attenuations_host_->energy_min_;
-  GGfloat max_energy = attenuations_host_->energy_max_;
-  GGint number_of_bins = attenuations_host_->number_of_bins_;
+  GGfloat min_energy = attenuations_host->energy_min_;
+  GGfloat max_energy = attenuations_host->energy_max_;
+  GGint number_of_bins = attenuations_host->number_of_bins_;
 
   // Converting energy
   GGfloat e_MeV = EnergyUnit(energy, unit);
@@ -323,13 +317,13 @@ GGfloat GGEMSAttenuations::GetEnergyAttenuation(std::string const& material_name
   ptrdiff_t material_id = materials_->GetMaterialIndex(material_name);
 
   // Computing the energy bin
-  GGsize energy_bin = static_cast<GGsize>(BinarySearchLeft(e_MeV, attenuations_host_->energy_bins_, static_cast<GGint>(number_of_bins), 0, 0));
+  GGsize energy_bin = static_cast<GGsize>(BinarySearchLeft(e_MeV, attenuations_host->energy_bins_, static_cast<GGint>(number_of_bins), 0, 0));
 
   // Computing attenuation
-  GGfloat energy_a = attenuations_host_->energy_bins_[energy_bin];
-  GGfloat energy_b = attenuations_host_->energy_bins_[energy_bin+1];
-  GGfloat energy_attenuation_a = attenuations_host_->mu_en_[energy_bin + static_cast<GGsize>(number_of_bins*material_id)];
-  GGfloat energy_attenuation_b = attenuations_host_->mu_en_[energy_bin+1 + static_cast<GGsize>(number_of_bins*material_id)];
+  GGfloat energy_a = attenuations_host->energy_bins_[energy_bin];
+  GGfloat energy_b = attenuations_host->energy_bins_[energy_bin+1];
+  GGfloat energy_attenuation_a = GGEMS_TABLE(GGfloat, attenuations_host, mu_en_)[energy_bin + static_cast<GGsize>(number_of_bins*material_id)];
+  GGfloat energy_attenuation_b = GGEMS_TABLE(GGfloat, attenuations_host, mu_en_)[energy_bin+1 + static_cast<GGsize>(number_of_bins*material_id)];
 
   GGfloat energy_attenuation = LinearInterpolation(energy_a, energy_attenuation_a, energy_b, energy_attenuation_b, e_MeV);
 
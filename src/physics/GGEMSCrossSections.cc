@@ -28,6 +28,8 @@
   \date Tuesday March 31, 2020
 */
 
+#include <algorithm>
+
 #include "GGEMS/physics/GGEMSCrossSections.hh"
 #include "GGEMS/physics/GGEMSComptonScattering.hh"
 #include "GGEMS/physics/GGEMSPhotoElectricEffect.hh"
@@ -55,14 +57,12 @@ GGEMSCrossSections::GGEMSCrossSections(GGEMSMaterials* materials)
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
   number_activated_devices_ = opencl_manager.GetNumberOfActivatedDevice();
 
-  // Allocating memory for cross section tables on host and device
+  // Cross section tables are allocated during initialization, when the number of materials is known
   particle_cross_sections_ = new cl::Buffer*[number_activated_devices_];
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    particle_cross_sections_[i] = opencl_manager.Allocate(nullptr, sizeof(GGEMSParticleCrossSections), i, CL_MEM_READ_WRITE, "GGEMSCrossSections");
+    particle_cross_sections_[i] = nullptr;
   }
-
-  // Useful to avoid memory transfer between host and OpenCL
-  particle_cross_sections_host_ = new GGEMSParticleCrossSections();
+  particle_cross_sections_size_ = 0;
 
   materials_ = materials;
 
@@ -86,11 +86,6 @@ GGEMSCrossSections::~GGEMSCrossSections(void)
     em_processes_list_ = nullptr;
   }
 
-  if (particle_cross_sections_host_) {
-    delete particle_cross_sections_host_;
-    particle_cross_sections_host_ = nullptr;
-  }
-
   GGcout("GGEMSCrossSections", "~GGEMSCrossSections", 3) << "GGEMSCrossSections erased!!!" << GGendl;
 }
 
@@ -106,7 +101,7 @@ void GGEMSCrossSections::Clean(void)
 
   if (particle_cross_sections_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(particle_cross_sections_[i], sizeof(GGEMSParticleCrossSections), i);
+      opencl_manager.Deallocate(particle_cross_sections_[i], particle_cross_sections_size_, i);
     }
     delete[] particle_cross_sections_;
     particle_cross_sections_ = nullptr;
@@ -183,90 +178,110 @@ void GGEMSCrossSections::Initialize(void)
   GGfloat min_energy = process_manager.GetCrossSectionTableMinEnergy();
   GGfloat max_energy = process_manager.GetCrossSectionTableMaxEnergy();
 
-  // Initialize physics on each device
-  for (GGsize j = 0; j < number_activated_devices_; ++j) {
-    GGEMSParticleCrossSections* particle_cross_sections_device = opencl_manager.GetDeviceBuffer<GGEMSParticleCrossSections>(particle_cross_sections_[j], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSParticleCrossSections), j);
-
-    particle_cross_sections_device->number_of_bins_ = number_of_bins;
-    particle_cross_sections_device->min_energy_ = min_energy;
-    particle_cross_sections_device->max_energy_ = max_energy;
-    for (GGsize i = 0; i < materials_->GetNumberOfMaterials(); ++i) {
-      #ifdef _WIN32
-      strcpy_s(reinterpret_cast<char*>(particle_cross_sections_device->material_names_[i]), 32, (materials_->GetMaterialName(i)).c_str());
-      #else
-      strcpy(reinterpret_cast<char*>(particle_cross_sections_device->material_names_[i]), (materials_->GetMaterialName(i)).c_str());
-      #endif
+  // Computing the offset of each table after the header, tables are sized to the number of materials, chemical elements and bins. Only the activated processes have tables
+  GGsize number_of_materials = materials_->GetNumberOfMaterials();
+  GGsize total_number_of_chemical_elements = materials_->GetTotalNumberOfChemicalElements();
+  GGsize table_size = number_of_materials * number_of_bins * sizeof(GGfloat);
+  GGsize table_per_atom_size = total_number_of_chemical_elements * number_of_bins * sizeof(GGfloat);
+  particle_cross_sections_size_ = sizeof(GGEMSParticleCrossSections);
+  GGsize energy_bins_offset = AppendTable(particle_cross_sections_size_, number_of_bins * sizeof(GGfloat));
+  GGsize photon_cross_sections_offset[NUMBER_PHOTON_PROCESSES];
+  GGsize photon_cross_sections_per_atom_offset[NUMBER_PHOTON_PROCESSES];
+  for (GGsize i = 0; i < NUMBER_PHOTON_PROCESSES; ++i) {
+    photon_cross_sections_offset[i] = 0;
+    photon_cross_sections_per_atom_offset[i] = 0;
+    if (is_process_activated_.at(i)) {
+      photon_cross_sections_offset[i] = AppendTable(particle_cross_sections_size_, table_size);
+      photon_cross_sections_per_atom_offset[i] = AppendTable(particle_cross_sections_size_, table_per_atom_size);
     }
+  }
+  GGsize photon_total_cross_sections_offset = AppendTable(particle_cross_sections_size_, table_size);
+  GGsize photon_majorant_cross_sections_offset = AppendTable(particle_cross_sections_size_, number_of_bins * sizeof(GGfloat));
+
+  GGcout("GGEMSCrossSections", "Initialize", 2) << "Size of cross section tables: " << particle_cross_sections_size_ << " bytes" << GGendl;
+
+  // Tables are loaded from cache if computed before with the same materials, processes and bins, printing tables needs to compute them
+  std::ostringstream cache_key(std::ostringstream::out);
+  cache_key << "cross_sections " << sizeof(GGEMSParticleCrossSections) << '\n' << std::hexfloat
+    << min_energy << ' ' << max_energy << ' ' << number_of_bins << '\n';
+  for (GGsize i = 0; i < number_of_activated_processes_; ++i) cache_key << "process " << em_processes_list_[i]->GetProcessName() << '\n';
+  cache_key << materials_->GetPhysicTablesCacheKey();
+
+  if (process_manager.IsPrintPhysicTables() || !process_manager.LoadPhysicTables(cache_key.str(), particle_cross_sections_size_, particle_cross_sections_host_)) {
+    // Tables are built once on host, header is stored first
+    particle_cross_sections_host_.assign(particle_cross_sections_size_, 0);
+    GGEMSParticleCrossSections* particle_cross_sections_host = reinterpret_cast<GGEMSParticleCrossSections*>(particle_cross_sections_host_.data());
+
+    particle_cross_sections_host->number_of_bins_ = number_of_bins;
+    particle_cross_sections_host->min_energy_ = min_energy;
+    particle_cross_sections_host->max_energy_ = max_energy;
 
     // Storing information from materials
-    particle_cross_sections_device->number_of_materials_ = static_cast<GGuchar>(materials_->GetNumberOfMaterials());
+    particle_cross_sections_host->number_of_materials_ = number_of_materials;
+    particle_cross_sections_host->total_number_of_chemical_elements_ = total_number_of_chemical_elements;
+
+    // Offsets of tables
+    particle_cross_sections_host->energy_bins_ = energy_bins_offset;
+    for (GGsize i = 0; i < NUMBER_PHOTON_PROCESSES; ++i) {
+      particle_cross_sections_host->photon_cross_sections_[i] = photon_cross_sections_offset[i];
+      particle_cross_sections_host->photon_cross_sections_per_atom_[i] = photon_cross_sections_per_atom_offset[i];
+    }
+    particle_cross_sections_host->photon_total_cross_sections_ = photon_total_cross_sections_offset;
+    particle_cross_sections_host->photon_majorant_cross_sections_ = photon_majorant_cross_sections_offset;
 
     // Filling energy table with log scale
     GGfloat slope = logf(max_energy/min_energy);
     for (GGsize i = 0; i < number_of_bins; ++i) {
-      particle_cross_sections_device->energy_bins_[i] = min_energy * expf(slope * (static_cast<float>(i) / (static_cast<GGfloat>(number_of_bins)-1.0f))) * MeV;
+      GGEMS_TABLE(GGfloat, particle_cross_sections_host, energy_bins_)[i] = min_energy * expf(slope * (static_cast<float>(i) / (static_cast<GGfloat>(number_of_bins)-1.0f))) * MeV;
     }
 
-    // Release pointer
-    opencl_manager.ReleaseDeviceBuffer(particle_cross_sections_[j], particle_cross_sections_device, j);
+    // Index of energy is computed directly from log of energy
+    particle_cross_sections_host->log_min_energy_ = logf(GGEMS_TABLE(GGfloat, particle_cross_sections_host, energy_bins_)[0]);
+    particle_cross_sections_host->inverse_log_energy_step_ = (static_cast<GGfloat>(number_of_bins)-1.0f) / slope;
 
     // Loop over the activated physic processes and building tables
     for (GGsize i = 0; i < number_of_activated_processes_; ++i)
-      em_processes_list_[i]->BuildCrossSectionTables(particle_cross_sections_[j], materials_->GetMaterialTables(j), j);
+      em_processes_list_[i]->BuildCrossSectionTables(particle_cross_sections_host, materials_);
+
+    // Total cross section of each material, and majorant over materials of navigator
+    BuildTotalCrossSections();
+
+    process_manager.SavePhysicTables(cache_key.str(), particle_cross_sections_host_);
   }
 
-  // Copy data from device to RAM memory (optimization for python users)
-  LoadPhysicTablesOnHost();
+  // Copying cross section tables to all devices
+  for (GGsize j = 0; j < number_activated_devices_; ++j) {
+    particle_cross_sections_[j] = opencl_manager.Allocate(particle_cross_sections_host_.data(), particle_cross_sections_size_, j, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, "GGEMSCrossSections");
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSCrossSections::LoadPhysicTablesOnHost(void)
+void GGEMSCrossSections::BuildTotalCrossSections(void)
 {
-  GGcout("GGEMSCrossSections", "LoadPhysicTablesOnHost", 1) << "Loading physic tables from OpenCL device to host (RAM)..." << GGendl;
-
-  // Get the OpenCL manager
-  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
-
-  GGEMSParticleCrossSections* particle_cross_sections_device = opencl_manager.GetDeviceBuffer<GGEMSParticleCrossSections>(particle_cross_sections_[0], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSParticleCrossSections), 0);
-
-  particle_cross_sections_host_->number_of_bins_ = particle_cross_sections_device->number_of_bins_;
-  particle_cross_sections_host_->number_of_materials_ = particle_cross_sections_device->number_of_materials_;
-  particle_cross_sections_host_->min_energy_ = particle_cross_sections_device->min_energy_;
-  particle_cross_sections_host_->max_energy_ = particle_cross_sections_device->max_energy_;
-
-  for(GGuchar i = 0; i < particle_cross_sections_host_->number_of_materials_; ++i) {
-    for(GGuchar j = 0; j < 32; ++j) {
-      particle_cross_sections_host_->material_names_[i][j] = particle_cross_sections_device->material_names_[i][j];
-    }
-  }
-
-  for(GGushort i = 0; i < particle_cross_sections_host_->number_of_bins_; ++i) {
-    particle_cross_sections_host_->energy_bins_[i] = particle_cross_sections_device->energy_bins_[i];
-  }
-
-  particle_cross_sections_host_->number_of_activated_photon_processes_ = particle_cross_sections_device->number_of_activated_photon_processes_;
-
-  for(GGuchar i = 0; i < NUMBER_PHOTON_PROCESSES; ++i) {
-    particle_cross_sections_host_->photon_cs_id_[i] = particle_cross_sections_device->photon_cs_id_[i];
-  }
-
-  for(GGuchar j = 0; j < NUMBER_PHOTON_PROCESSES; ++j) {
-    for(GGuint i = 0; i < 256*MAX_CROSS_SECTION_TABLE_NUMBER_BINS; ++i) {
-      particle_cross_sections_host_->photon_cross_sections_[j][i] = particle_cross_sections_device->photon_cross_sections_[j][i];
-    }
-  }
-
-  for(GGuchar j = 0; j < NUMBER_PHOTON_PROCESSES; ++j) {
-    for(GGuint i = 0; i < 101*MAX_CROSS_SECTION_TABLE_NUMBER_BINS; ++i) {
-      particle_cross_sections_host_->photon_cross_sections_per_atom_[j][i] = particle_cross_sections_device->photon_cross_sections_per_atom_[j][i];
+  GGcout("GGEMSCrossSections", "BuildTotalCrossSections", 3) << "Building total and majorant cross section tables..." << GGendl;
+
+  GGEMSParticleCrossSections* particle_cross_sections_host = reinterpret_cast<GGEMSParticleCrossSections*>(particle_cross_sections_host_.data());
+
+  GGsize number_of_bins = particle_cross_sections_host->number_of_bins_;
+  GGsize number_of_materials = particle_cross_sections_host->number_of_materials_;
+
+  // Total cross section is the sum of activated processes, the majorant is the maximum over materials
+  for (GGsize i = 0; i < number_of_bins; ++i) {
+    GGfloat majorant_cross_section = 0.0f;
+    for (GGsize j = 0; j < number_of_materials; ++j) {
+      GGfloat total_cross_section = 0.0f;
+      for (GGsize k = 0; k < particle_cross_sections_host->number_of_activated_photon_processes_; ++k) {
+        GGchar process_id = particle_cross_sections_host->photon_cs_id_[k];
+        total_cross_section += GGEMS_TABLE(GGfloat, particle_cross_sections_host, photon_cross_sections_[process_id])[i + number_of_bins*j];
+      }
+      GGEMS_TABLE(GGfloat, particle_cross_sections_host, photon_total_cross_sections_)[i + number_of_bins*j] = total_cross_section;
+      majorant_cross_section = std::max(majorant_cross_section, total_cross_section);
     }
+    GGEMS_TABLE(GGfloat, particle_cross_sections_host, photon_majorant_cross_sections_)[i] = majorant_cross_section;
   }
-
-  // Release pointer
-  opencl_manager.ReleaseDeviceBuffer(particle_cross_sections_[0], particle_cross_sections_device, 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -275,11 +290,12 @@ void GGEMSCrossSections::LoadPhysicTablesOnHost(void)
 
 GGfloat GGEMSCrossSections::GetPhotonCrossSection(std::string const& process_name, std::string const& material_name, GGfloat const& energy, std::string const& unit) const
 {
+  GGEMSParticleCrossSections const* particle_cross_sections_host = reinterpret_cast<GGEMSParticleCrossSections const*>(particle_cross_sections_host_.data());
+
   // Get min and max energy in the table, and number of bins
-  GGfloat min_energy = particle_cross_sections_host_->min_energy_;
-  GGfloat max_energy = particle_cross_sections_host_->max_energy_;
-  GGsize number_of_bins = particle_cross_sections_host_->number_of_bins_;
-  GGsize number_of_materials = particle_cross_sections_host_->number_of_materials_;
+  GGfloat min_energy = particle_cross_sections_host->min_energy_;
+  GGfloat max_energy = particle_cross_sections_host->max_energy_;
+  GGsize number_of_bins = particle_cross_sections_host->number_of_bins_;
 
   // Converting energy
   GGfloat e_MeV = EnergyUnit(energy, unit);
@@ -310,27 +326,28 @@ GGfloat GGEMSCrossSections::GetPhotonCrossSection(std::string const& process_nam
     GGEMSMisc::ThrowException("GGEMSCrossSections", "GetPhotonCrossSection", oss.str());
   }
 
-  // Get id of material
-  GGsize mat_id = 0;
-  for (GGsize i = 0; i < number_of_materials; ++i) {
-    if (strcmp(material_name.c_str(), reinterpret_cast<char*>(particle_cross_sections_host_->material_names_[i])) == 0) {
-      mat_id = i;
-      break;
-    }
+  // Tables are stored only for activated processes
+  if (!is_process_activated_.at(process_id)) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Process '" << process_name << "' is not activated!!!" << std::endl;
+    GGEMSMisc::ThrowException("GGEMSCrossSections", "GetPhotonCrossSection", oss.str());
   }
 
+  // Get id of material
+  GGsize mat_id = static_cast<GGsize>(materials_->GetMaterialIndex(material_name));
+
   // Get density of material
   GGEMSMaterialsDatabaseManager& material_database_manager = GGEMSMaterialsDatabaseManager::GetInstance();
   GGfloat density = material_database_manager.GetMaterial(material_name).density_;
 
   // Computing the energy bin
-  GGsize energy_bin = static_cast<GGsize>(BinarySearchLeft(e_MeV, particle_cross_sections_host_->energy_bins_, static_cast<GGint>(number_of_bins), 0, 0));
+  GGsize energy_bin = static_cast<GGsize>(BinarySearchLeft(e_MeV, GGEMS_TABLE(GGfloat, particle_cross_sections_host, energy_bins_), static_cast<GGint>(number_of_bins), 0, 0));
 
   // Compute cross section using linear interpolation
-  GGfloat energy_a = particle_cross_sections_host_->energy_bins_[energy_bin];
-  GGfloat energy_b = particle_cross_sections_host_->energy_bins_[energy_bin+1];
-  GGfloat cross_section_a = particle_cross_sections_host_->photon_cross_sections_[process_id][energy_bin + number_of_bins*mat_id];
-  GGfloat cross_section_b = particle_cross_sections_host_->photon_cross_sections_[process_id][energy_bin+1 + number_of_bins*mat_id];
+  GGfloat energy_a = GGEMS_TABLE(GGfloat, particle_cross_sections_host, energy_bins_)[energy_bin];
+  GGfloat energy_b = GGEMS_TABLE(GGfloat, particle_cross_sections_host, energy_bins_)[energy_bin+1];
+  GGfloat cross_section_a = GGEMS_TABLE(GGfloat, particle_cross_sections_host, photon_cross_sections_[process_id])[energy_bin + number_of_bins*mat_id];
+  GGfloat cross_section_b = GGEMS_TABLE(GGfloat, particle_cross_sections_host, photon_cross_sections_[process_id])[energy_bin+1 + number_of_bins*mat_id];
 
   GGfloat cross_section = LinearInterpolation(energy_a, cross_section_a, energy_b, cross_section_b, e_MeV);
 
@@ -30,6 +30,7 @@
 
 #include "GGEMS/physics/GGEMSProcessesManager.hh"
 #include "GGEMS/physics/GGEMSEMProcess.hh"
+#include "GGEMS/materials/GGEMSMaterials.hh"
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -62,64 +63,71 @@ GGEMSEMProcess::~GGEMSEMProcess(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSEMProcess::BuildCrossSectionTables(cl::Buffer* particle_cross_sections, cl::Buffer* material_tables, GGsize const& thread_index)
+void GGEMSEMProcess::BuildCrossSectionTables(GGEMSParticleCrossSections* particle_cross_sections, GGEMSMaterials const* materials)
 {
-  // Getting OpenCL manager
-  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
-  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
-
-  GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 3) << "Building cross section table for process " << process_name_ << " on device: " << opencl_manager.GetDeviceName(device_index) << GGendl;
-
-  // Set missing information in cross section table
-  GGEMSParticleCrossSections* cross_section_device = opencl_manager.GetDeviceBuffer<GGEMSParticleCrossSections>(particle_cross_sections, CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSParticleCrossSections), thread_index);
+  GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 3) << "Building cross section table for process " << process_name_ << "..." << GGendl;
 
   // Store index of activated process
-  cross_section_device->photon_cs_id_[cross_section_device->number_of_activated_photon_processes_] = process_id_;
+  particle_cross_sections->photon_cs_id_[particle_cross_sections->number_of_activated_photon_processes_] = process_id_;
 
   // Increment number of activated photon process
-  cross_section_device->number_of_activated_photon_processes_ += 1;
+  particle_cross_sections->number_of_activated_photon_processes_ += 1;
 
   // Get the material tables
-  GGEMSMaterialTables* materials_device = opencl_manager.GetDeviceBuffer<GGEMSMaterialTables>(material_tables, CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSMaterialTables), thread_index);
-
-  // Compute Compton cross section par material
-  GGsize number_of_bins = cross_section_device->number_of_bins_;
-  // Loop over the materials
-  for (GGsize j = 0; j < materials_device->number_of_materials_; ++j) {
-    // Loop over the number of bins
-    for (GGsize i = 0; i < number_of_bins; ++i) {
-      cross_section_device->photon_cross_sections_[process_id_][i + j*number_of_bins] = ComputeCrossSectionPerMaterial(cross_section_device, materials_device, j, i);
-    }
+  GGEMSMaterialTables const* material_tables = materials->GetMaterialTablesHost();
+
+  // Compute cross section per material, each host thread computes a contiguous part of bins of all materials
+  GGsize number_of_bins = particle_cross_sections->number_of_bins_;
+  GGsize total_number_of_bins = material_tables->number_of_materials_ * number_of_bins;
+  GGsize number_of_threads = std::max(static_cast<GGsize>(std::thread::hardware_concurrency()), static_cast<GGsize>(1));
+  number_of_threads = std::min(number_of_threads, total_number_of_bins);
+  GGsize bins_by_thread = number_of_threads > 0 ? (total_number_of_bins + number_of_threads - 1) / number_of_threads : 0;
+
+  std::vector<std::thread> thread_cross_sections;
+  for (GGsize t = 0; t < number_of_threads; ++t) {
+    GGsize first_bin = t * bins_by_thread;
+    GGsize last_bin = std::min(first_bin + bins_by_thread, total_number_of_bins);
+    if (first_bin >= last_bin) break;
+    thread_cross_sections.push_back(std::thread(&GGEMSEMProcess::ComputeCrossSectionsOfBins, this, particle_cross_sections, material_tables, first_bin, last_bin));
   }
+  for (GGsize t = 0; t < thread_cross_sections.size(); ++t) thread_cross_sections[t].join();
 
   // If flag activate print tables
   GGEMSProcessesManager& process_manager = GGEMSProcessesManager::GetInstance();
   if (process_manager.IsPrintPhysicTables()) {
-    GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 0) << "* PROCESS " << process_name_ << " on device: " << opencl_manager.GetDeviceName(device_index) << GGendl;
+    GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 0) << "* PROCESS " << process_name_ << GGendl;
 
     // Loop over material
-    for (GGsize j = 0; j < materials_device->number_of_materials_; ++j) {
-      GGsize id_elt = materials_device->index_of_chemical_elements_[j];
-      GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 0) << "    - Material: " << cross_section_device->material_names_[j]
-        << ", density: " << materials_device->density_of_material_[j]/(g/cm3) << " g.cm-3" << GGendl;
+    for (GGsize j = 0; j < material_tables->number_of_materials_; ++j) {
+      GGsize id_elt = GGEMS_TABLE(GGsize, material_tables, index_of_chemical_elements_)[j];
+      GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 0) << "    - Material: " << materials->GetMaterialName(j)
+        << ", density: " << GGEMS_TABLE(GGfloat, material_tables, density_of_material_)[j]/(g/cm3) << " g.cm-3" << GGendl;
       // Loop over number of bins (energy)
       for (GGsize i = 0; i < number_of_bins; ++i) {
-        GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 0) << "        + Energy: " << cross_section_device->energy_bins_[i]/keV << " keV, cross section: "
-          << (cross_section_device->photon_cross_sections_[process_id_][i + j*number_of_bins]/materials_device->density_of_material_[j])/(cm2/g) << " cm2.g-1" << GGendl;
+        GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 0) << "        + Energy: " << GGEMS_TABLE(GGfloat, particle_cross_sections, energy_bins_)[i]/keV << " keV, cross section: "
+          << (GGEMS_TABLE(GGfloat, particle_cross_sections, photon_cross_sections_[process_id_])[i + j*number_of_bins]/GGEMS_TABLE(GGfloat, material_tables, density_of_material_)[j])/(cm2/g) << " cm2.g-1" << GGendl;
         // Loop over elements
-        for (GGsize k = 0; k < materials_device->number_of_chemical_elements_[j]; ++k) {
-          GGuchar atomic_number = materials_device->atomic_number_Z_[k+id_elt];
+        for (GGsize k = 0; k < GGEMS_TABLE(GGsize, material_tables, number_of_chemical_elements_)[j]; ++k) {
+          GGuchar atomic_number = GGEMS_TABLE(GGuchar, material_tables, atomic_number_Z_)[k+id_elt];
           GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 0) << "            # Element (Z): " << atomic_number
-            << ", atomic number density: " << materials_device->atomic_number_density_[k+id_elt]/(1/cm3) << " atom/cm3, cross section per atom: "
-            << cross_section_device->photon_cross_sections_per_atom_[process_id_][i + atomic_number*number_of_bins]/(cm2)<< " cm2" << GGendl;
+            << ", atomic number density: " << GGEMS_TABLE(GGfloat, material_tables, atomic_number_density_)[k+id_elt]/(1/cm3) << " atom/cm3, cross section per atom: "
+            << GGEMS_TABLE(GGfloat, particle_cross_sections, photon_cross_sections_per_atom_[process_id_])[i + (k+id_elt)*number_of_bins]/(cm2)<< " cm2" << GGendl;
         }
       }
     }
   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-  // Release pointer
-  opencl_manager.ReleaseDeviceBuffer(material_tables, materials_device, thread_index);
-  opencl_manager.ReleaseDeviceBuffer(particle_cross_sections, cross_section_device, thread_index);
+void GGEMSEMProcess::ComputeCrossSectionsOfBins(GGEMSParticleCrossSections* particle_cross_sections, GGEMSMaterialTables const* material_tables, GGsize const first_bin, GGsize const last_bin)
+{
+  GGsize number_of_bins = particle_cross_sections->number_of_bins_;
+  for (GGsize bin = first_bin; bin < last_bin; ++bin) {
+    GGEMS_TABLE(GGfloat, particle_cross_sections, photon_cross_sections_[process_id_])[bin] = ComputeCrossSectionPerMaterial(particle_cross_sections, material_tables, bin / number_of_bins, bin % number_of_bins);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -128,16 +136,16 @@ void GGEMSEMProcess::BuildCrossSectionTables(cl::Buffer* particle_cross_sections
 
 GGfloat GGEMSEMProcess::ComputeCrossSectionPerMaterial(GGEMSParticleCrossSections* cross_section_device, GGEMSMaterialTables const* material_tables, GGsize const& material_index, GGsize const& energy_index)
 {
-  GGfloat energy = cross_section_device->energy_bins_[energy_index];
+  GGfloat energy = GGEMS_TABLE(GGfloat, cross_section_device, energy_bins_)[energy_index];
   GGfloat cross_section_material = 0.0f;
-  GGsize index_of_offset = material_tables->index_of_chemical_elements_[material_index];
+  GGsize index_of_offset = GGEMS_TABLE(GGsize, material_tables, index_of_chemical_elements_)[material_index];
 
   // Loop over all the chemical elements
-  for (GGsize i = 0; i < material_tables->number_of_chemical_elements_[material_index]; ++i) {
-    GGuchar atomic_number = material_tables->atomic_number_Z_[i+index_of_offset];
+  for (GGsize i = 0; i < GGEMS_TABLE(GGsize, material_tables, number_of_chemical_elements_)[material_index]; ++i) {
+    GGuchar atomic_number = GGEMS_TABLE(GGuchar, material_tables, atomic_number_Z_)[i+index_of_offset];
     GGfloat cross_section_per_atom = ComputeCrossSectionPerAtom(energy, atomic_number);
-    cross_section_device->photon_cross_sections_per_atom_[process_id_][energy_index + atomic_number*cross_section_device->number_of_bins_] = cross_section_per_atom;
-    cross_section_material += material_tables->atomic_number_density_[i+index_of_offset] * cross_section_per_atom;
+    GGEMS_TABLE(GGfloat, cross_section_device, photon_cross_sections_per_atom_[process_id_])[energy_index + (i+index_of_offset)*cross_section_device->number_of_bins_] = cross_section_per_atom;
+    cross_section_material += GGEMS_TABLE(GGfloat, material_tables, atomic_number_density_)[i+index_of_offset] * cross_section_per_atom;
   }
   return cross_section_material;
 }
@@ -40,7 +40,19 @@
 GGEMSParticles::GGEMSParticles(void)
 : number_of_particles_(nullptr),
   primary_particles_(nullptr),
-  kernel_alive_(nullptr)
+  number_of_stacks_(1),
+  active_stack_(nullptr),
+  status_(nullptr),
+  status_pinned_(nullptr),
+  status_pinned_ptr_(nullptr),
+  status_event_(nullptr),
+  kernel_alive_(nullptr),
+  is_alive_compaction_(false),
+  alive_particles_(nullptr),
+  active_alive_particles_(nullptr),
+  number_of_alive_particles_(nullptr),
+  kernel_compact_alive_(nullptr),
+  is_opengl_trajectories_(false)
 {
   GGcout("GGEMSParticles", "GGEMSParticles", 3) << "GGEMSParticles creating..." << GGendl;
 
@@ -62,15 +74,33 @@ GGEMSParticles::~GGEMSParticles(void)
     number_of_particles_ = nullptr;
   }
 
+  if (active_stack_) {
+    delete[] active_stack_;
+    active_stack_ = nullptr;
+  }
+
   if (primary_particles_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(primary_particles_[i], sizeof(GGEMSPrimaryParticles), i);
+      for (GGsize j = 0; j < number_of_stacks_; ++j) {
+        opencl_manager.Deallocate(primary_particles_[i*number_of_stacks_ + j], GetPrimaryParticlesBufferSize(i), i);
+      }
       opencl_manager.Deallocate(status_[i], sizeof(GGint), i);
+      opencl_manager.ReleaseDeviceBuffer(status_pinned_[i], status_pinned_ptr_[i], i);
+      opencl_manager.Deallocate(status_pinned_[i], sizeof(GGint), i);
     }
     delete[] primary_particles_;
     primary_particles_ = nullptr;
     delete[] status_;
     status_ = nullptr;
+    delete[] status_pinned_;
+    status_pinned_ = nullptr;
+    delete[] status_pinned_ptr_;
+    status_pinned_ptr_ = nullptr;
+  }
+
+  if (status_event_) {
+    delete[] status_event_;
+    status_event_ = nullptr;
   }
 
   if (kernel_alive_) {
@@ -78,6 +108,29 @@ GGEMSParticles::~GGEMSParticles(void)
     kernel_alive_ = nullptr;
   }
 
+  if (alive_particles_) {
+    for (GGsize i = 0; i < number_activated_devices_*2; ++i) {
+      opencl_manager.Deallocate(alive_particles_[i], (opencl_manager.GetParticleStackSize(i/2)+1)*sizeof(GGint), i/2);
+    }
+    delete[] alive_particles_;
+    alive_particles_ = nullptr;
+  }
+
+  if (active_alive_particles_) {
+    delete[] active_alive_particles_;
+    active_alive_particles_ = nullptr;
+  }
+
+  if (number_of_alive_particles_) {
+    delete[] number_of_alive_particles_;
+    number_of_alive_particles_ = nullptr;
+  }
+
+  if (kernel_compact_alive_) {
+    delete[] kernel_compact_alive_;
+    kernel_compact_alive_ = nullptr;
+  }
+
   GGcout("GGEMSParticles", "~GGEMSParticles", 3) << "GGEMSParticles erased!!!" << GGendl;
 }
 
@@ -85,9 +138,93 @@ GGEMSParticles::~GGEMSParticles(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSParticles::SetNumberOfParticles(GGsize const& thread_index, GGsize const& number_of_particles)
+void GGEMSParticles::SetNumberOfStacks(GGsize const& number_of_stacks)
 {
-  number_of_particles_[thread_index] = number_of_particles;
+  if (primary_particles_) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Number of particle stacks must be set before initialization of particles!!!";
+    GGEMSMisc::ThrowException("GGEMSParticles", "SetNumberOfStacks", oss.str());
+  }
+
+  if (number_of_stacks == 0 || number_of_stacks > 2) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Number of particle stacks must be 1 or 2!!!";
+    GGEMSMisc::ThrowException("GGEMSParticles", "SetNumberOfStacks", oss.str());
+  }
+
+  number_of_stacks_ = number_of_stacks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSParticles::SwapStacks(GGsize const& thread_index)
+{
+  active_stack_[thread_index] = GetNextStack(thread_index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSParticles::SetAliveCompaction(bool const& is_alive_compaction)
+{
+  if (primary_particles_) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Compaction of alive particles must be set before initialization of particles!!!";
+    GGEMSMisc::ThrowException("GGEMSParticles", "SetAliveCompaction", oss.str());
+  }
+
+  is_alive_compaction_ = is_alive_compaction;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSParticles::SetOpenGLTrajectories(bool const& is_opengl_trajectories)
+{
+  if (primary_particles_) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Storage of OpenGL trajectories must be set before initialization of particles!!!";
+    GGEMSMisc::ThrowException("GGEMSParticles", "SetOpenGLTrajectories", oss.str());
+  }
+
+  is_opengl_trajectories_ = is_opengl_trajectories;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGsize GGEMSParticles::GetPrimaryParticlesBufferSize(GGsize const& thread_index) const
+{
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  // Trajectories are stored after particle stack only if OpenGL is activated
+  GGsize size = GetPrimaryParticlesSize(opencl_manager.GetParticleStackSize(thread_index));
+  if (is_opengl_trajectories_) size += GetPrimaryParticlesOpenGLSize();
+
+  return size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSParticles::ResetAliveParticles(GGsize const& thread_index)
+{
+  active_alive_particles_[thread_index] = -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSParticles::SetNumberOfParticles(GGsize const& thread_index, GGsize const& number_of_particles, GGsize const& stack_index)
+{
+  number_of_particles_[thread_index*number_of_stacks_ + stack_index] = number_of_particles;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -111,6 +248,11 @@ void GGEMSParticles::InitializeKernel(void)
 
   // Compiling kernel on each device
   opencl_manager.CompileKernel(filename, "is_alive", kernel_alive_, nullptr, nullptr);
+
+  if (is_alive_compaction_) {
+    kernel_compact_alive_ = new cl::Kernel*[number_activated_devices_];
+    opencl_manager.CompileKernel(filename, "compact_alive", kernel_compact_alive_, nullptr, nullptr);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -126,7 +268,15 @@ void GGEMSParticles::Initialize(void)
   // Get number of activated device
   number_activated_devices_ = opencl_manager.GetNumberOfActivatedDevice();
 
-  number_of_particles_ = new GGsize[number_activated_devices_];
+  number_of_particles_ = new GGsize[number_activated_devices_*number_of_stacks_];
+  active_stack_ = new GGsize[number_activated_devices_];
+  active_alive_particles_ = new GGint[number_activated_devices_];
+  number_of_alive_particles_ = new GGsize[number_activated_devices_];
+  for (GGsize i = 0; i < number_activated_devices_; ++i) {
+    active_stack_[i] = 0;
+    active_alive_particles_[i] = -1;
+    number_of_alive_particles_[i] = 0;
+  }
 
   // Allocation of the PrimaryParticle structure
   AllocatePrimaryParticles();
@@ -139,8 +289,14 @@ void GGEMSParticles::Initialize(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-bool GGEMSParticles::IsAlive(GGsize const& thread_index) const
+void GGEMSParticles::CheckAlive(GGsize const& thread_index)
 {
+  // In compaction mode, alive particles are counted when building their list
+  if (is_alive_compaction_) {
+    CompactAlive(thread_index);
+    return;
+  }
+
   // Get command queue and event
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
   cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
@@ -149,53 +305,127 @@ bool GGEMSParticles::IsAlive(GGsize const& thread_index) const
   GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
   std::string device_name = opencl_manager.GetDeviceName(device_index);
   std::ostringstream oss(std::ostringstream::out);
-  oss << "GGEMSParticles::IsAlive on " << device_name << ", index " << device_index;
+  oss << "GGEMSParticles::CheckAlive on " << device_name << ", index " << device_index;
 
   // Get the OpenCL buffers
-  cl::Buffer* particles = primary_particles_[thread_index];
+  cl::Buffer* particles = GetPrimaryParticles(thread_index);
   cl::Buffer* status = status_[thread_index];
+  GGsize number_of_particles = GetNumberOfParticles(thread_index);
 
   // Getting work group size, and work-item number
   GGsize work_group_size = opencl_manager.GetWorkGroupSize();
-  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_particles_[thread_index]);
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_particles);
 
   // Parameters for work-item in kernel
   cl::NDRange global_wi(number_of_work_items);
   cl::NDRange local_wi(work_group_size);
 
-  // Set parameters for kernel
-  kernel_alive_[thread_index]->setArg(0, number_of_particles_[thread_index]);
+  // Set parameters for kernel, last argument is local memory used for reduction
+  kernel_alive_[thread_index]->setArg(0, number_of_particles);
   kernel_alive_[thread_index]->setArg(1, *particles);
   kernel_alive_[thread_index]->setArg(2, *status);
+  kernel_alive_[thread_index]->setArg(3, work_group_size*sizeof(GGint), nullptr);
 
   // Launching kernel
   cl::Event event;
   GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_alive_[thread_index], 0, global_wi, local_wi, nullptr, &event);
-  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSParticles", "IsAlive");
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSParticles", "CheckAlive");
 
   // GGEMS Profiling
   GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
-  queue->finish();
 
-  // Get status from OpenCL device
-  GGint* status_device = opencl_manager.GetDeviceBuffer<GGint>(status_[thread_index], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGint), thread_index);
+  // Non-blocking read back in pinned host memory
+  GGint read_status = queue->enqueueReadBuffer(*status, CL_FALSE, 0, sizeof(GGint), status_pinned_ptr_[thread_index], nullptr, &status_event_[thread_index]);
+  opencl_manager.CheckOpenCLError(read_status, "GGEMSParticles", "CheckAlive");
+
+  // Cleaning buffer for the next check, in-order queue so done after read back
+  opencl_manager.CleanBuffer(status, sizeof(GGint), thread_index);
+
+  // Submitting commands to device without waiting
+  queue->flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSParticles::CompactAlive(GGsize const& thread_index)
+{
+  // Get command queue and event
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSParticles::CompactAlive on " << device_name << ", index " << device_index;
+
+  // The new list is built from the current list, lists are used alternately
+  cl::Buffer* particles = GetPrimaryParticles(thread_index);
+  cl::Buffer* alive_particles = GetAliveParticles(thread_index);
+  GGint compacted_index = active_alive_particles_[thread_index] == 0 ? 1 : 0;
+  cl::Buffer* compacted_alive_particles = alive_particles_[thread_index*2 + compacted_index];
+  GGsize number_of_particles = GetNumberOfParticles(thread_index);
+
+  // Number of alive particles in new list is incremented by kernel
+  opencl_manager.CleanBuffer(compacted_alive_particles, sizeof(GGint), thread_index);
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(GetNumberOfAliveParticles(thread_index));
 
-  GGint status_from_device = status_device[0];
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Set parameters for kernel, last argument is local memory used for prefix sum
+  kernel_compact_alive_[thread_index]->setArg(0, number_of_particles);
+  if (!alive_particles) kernel_compact_alive_[thread_index]->setArg(1, sizeof(cl_mem), nullptr);
+  else kernel_compact_alive_[thread_index]->setArg(1, *alive_particles);
+  kernel_compact_alive_[thread_index]->setArg(2, *compacted_alive_particles);
+  kernel_compact_alive_[thread_index]->setArg(3, *particles);
+  kernel_compact_alive_[thread_index]->setArg(4, work_group_size*sizeof(GGint), nullptr);
+
+  // Launching kernel
+  cl::Event event;
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_compact_alive_[thread_index], 0, global_wi, local_wi, nullptr, &event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSParticles", "CompactAlive");
+
+  // GGEMS Profiling
+  GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
 
-  // Release the pointer
-  opencl_manager.ReleaseDeviceBuffer(status_[thread_index], status_device, thread_index);
+  // Non-blocking read back of number of alive particles in pinned host memory
+  GGint read_status = queue->enqueueReadBuffer(*compacted_alive_particles, CL_FALSE, 0, sizeof(GGint), status_pinned_ptr_[thread_index], nullptr, &status_event_[thread_index]);
+  opencl_manager.CheckOpenCLError(read_status, "GGEMSParticles", "CompactAlive");
 
-  // Cleaning buffer
-  opencl_manager.CleanBuffer(status_[thread_index], sizeof(GGint), thread_index);
+  // Next kernels read their particles in new list, host number of alive particles is an upper bound until read back
+  number_of_alive_particles_[thread_index] = GetNumberOfAliveParticles(thread_index);
+  active_alive_particles_[thread_index] = compacted_index;
 
-  if (status_from_device == static_cast<GGint>(number_of_particles_[thread_index])) return false;
-  else return true;
+  // Submitting commands to device without waiting
+  queue->flush();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+bool GGEMSParticles::IsAlive(GGsize const& thread_index)
+{
+  // Waiting only for the read back of the last check
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  opencl_manager.CheckOpenCLError(status_event_[thread_index].wait(), "GGEMSParticles", "IsAlive");
+
+  // Kernels are launched only over alive particles
+  if (active_alive_particles_[thread_index] >= 0) number_of_alive_particles_[thread_index] = static_cast<GGsize>(status_pinned_ptr_[thread_index][0]);
+
+  return status_pinned_ptr_[thread_index][0] > 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSParticles::AllocatePrimaryParticles(void)
 {
   GGcout("GGEMSParticles", "AllocatePrimaryParticles", 1) << "Allocation of primary particles..." << GGendl;
@@ -203,13 +433,31 @@ void GGEMSParticles::AllocatePrimaryParticles(void)
   // Get the OpenCL manager
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
-  primary_particles_ = new cl::Buffer*[number_activated_devices_];
+  primary_particles_ = new cl::Buffer*[number_activated_devices_*number_of_stacks_];
   status_ = new cl::Buffer*[number_activated_devices_];
+  status_pinned_ = new cl::Buffer*[number_activated_devices_];
+  status_pinned_ptr_ = new GGint*[number_activated_devices_];
+  status_event_ = new cl::Event[number_activated_devices_];
 
-  // Loop over activated device and allocate particle buffer on each device
+  // Loop over activated device and allocate particle buffer(s) on each device
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    primary_particles_[i] = opencl_manager.Allocate(nullptr, sizeof(GGEMSPrimaryParticles), i, CL_MEM_READ_WRITE, "GGEMSParticles");
+    for (GGsize j = 0; j < number_of_stacks_; ++j) {
+      primary_particles_[i*number_of_stacks_ + j] = opencl_manager.Allocate(nullptr, GetPrimaryParticlesBufferSize(i), i, CL_MEM_READ_WRITE, "GGEMSParticles");
+    }
     status_[i] = opencl_manager.Allocate(nullptr, sizeof(GGint), i, CL_MEM_READ_WRITE, "GGEMSParticles");
     opencl_manager.CleanBuffer(status_[i], sizeof(GGint), i);
+
+    // Pinned host memory mapped once, and used as destination of non-blocking read back
+    status_pinned_[i] = opencl_manager.Allocate(nullptr, sizeof(GGint), i, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, "GGEMSParticles");
+    status_pinned_ptr_[i] = opencl_manager.GetDeviceBuffer<GGint>(status_pinned_[i], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGint), i);
+    status_pinned_ptr_[i][0] = 0;
+  }
+
+  // Two lists of alive particles by device, storing number of alive particles followed by their indices
+  if (is_alive_compaction_) {
+    alive_particles_ = new cl::Buffer*[number_activated_devices_*2];
+    for (GGsize i = 0; i < number_activated_devices_*2; ++i) {
+      alive_particles_[i] = opencl_manager.Allocate(nullptr, (opencl_manager.GetParticleStackSize(i/2)+1)*sizeof(GGint), i/2, CL_MEM_READ_WRITE, "GGEMSParticles");
+    }
   }
 }
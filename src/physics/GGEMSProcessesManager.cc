@@ -28,6 +28,11 @@
   \date Monday March 9, 2020
 */
 
+#include <filesystem>
+#include <sstream>
+
+#include "GGEMS/global/GGEMSConfiguration.hh"
+#include "GGEMS/tools/GGEMSTools.hh"
 #include "GGEMS/physics/GGEMSProcessesManager.hh"
 #include "GGEMS/navigators/GGEMSNavigatorManager.hh"
 #include "GGEMS/physics/GGEMSCrossSections.hh"
@@ -41,7 +46,8 @@ GGEMSProcessesManager::GGEMSProcessesManager(void)
 : cross_section_table_number_of_bins_(CROSS_SECTION_TABLE_NUMBER_BINS),
   cross_section_table_min_energy_(CROSS_SECTION_TABLE_ENERGY_MIN),
   cross_section_table_max_energy_(CROSS_SECTION_TABLE_ENERGY_MAX),
-  is_processes_print_tables_(false)
+  is_processes_print_tables_(false),
+  physic_tables_cache_path_("")
 {
   GGcout("GGEMSProcessesManager", "GGEMSProcessesManager", 3) << "GGEMSProcessesManager creating..." << GGendl;
 
@@ -197,6 +203,86 @@ void GGEMSProcessesManager::PrintPhysicTables(bool const& is_processes_print_tab
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSProcessesManager::SetPhysicTablesCachePath(std::string const& physic_tables_cache_path)
+{
+  physic_tables_cache_path_ = physic_tables_cache_path;
+
+  if (physic_tables_cache_path_.empty())
+    GGcout("GGEMSProcessesManager", "SetPhysicTablesCachePath", 1) << "Physic tables cache disabled" << GGendl;
+  else
+    GGcout("GGEMSProcessesManager", "SetPhysicTablesCachePath", 1) << "Physic tables cache in: " << physic_tables_cache_path_ << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSProcessesManager::GetPhysicTablesCacheKey(std::string const& cache_key) const
+{
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMS " << GGEMS_VERSION << '\n'
+    << "Physic tables " << PHYSIC_TABLES_VERSION << '\n'
+    << cache_key;
+
+  return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool GGEMSProcessesManager::LoadPhysicTables(std::string const& cache_key, GGsize const& tables_size, std::vector<GGuchar>& tables) const
+{
+  if (physic_tables_cache_path_.empty()) return false;
+
+  std::string full_cache_key = GetPhysicTablesCacheKey(cache_key);
+  std::filesystem::path cache_file = std::filesystem::path(physic_tables_cache_path_) / (GGEMSCache::Hash(full_cache_key) + ".ggpt");
+
+  std::error_code error_code;
+  if (!std::filesystem::is_regular_file(cache_file, error_code)) return false;
+
+  // Reading physic tables, size of tables must be the expected one
+  if (!GGEMSCache::ReadCacheFile(cache_file.string(), PHYSIC_TABLES_CACHE_MAGIC, full_cache_key, tables) || tables.size() != tables_size) {
+    GGcout("GGEMSProcessesManager", "LoadPhysicTables", 2) << "Invalid physic tables in cache, removing: " << cache_file.string() << GGendl;
+    std::filesystem::remove(cache_file, error_code);
+    return false;
+  }
+
+  GGcout("GGEMSProcessesManager", "LoadPhysicTables", 2) << "Physic tables loaded from cache: " << cache_file.string() << GGendl;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSProcessesManager::SavePhysicTables(std::string const& cache_key, std::vector<GGuchar> const& tables)
+{
+  if (physic_tables_cache_path_.empty()) return;
+
+  // Creating cache directory, cache disabled if not possible
+  std::error_code error_code;
+  std::filesystem::path cache_directory(physic_tables_cache_path_);
+  std::filesystem::create_directories(cache_directory, error_code);
+  if (error_code) {
+    GGwarn("GGEMSProcessesManager", "SavePhysicTables", 0) << "Impossible to create physic tables cache in '" << physic_tables_cache_path_ << "': " << error_code.message() << ", cache disabled!!!" << GGendl;
+    physic_tables_cache_path_.clear();
+    return;
+  }
+
+  // Writing in temporary file then renaming it, concurrent jobs never see a partial file
+  std::string full_cache_key = GetPhysicTablesCacheKey(cache_key);
+  std::filesystem::path cache_file = cache_directory / (GGEMSCache::Hash(full_cache_key) + ".ggpt");
+  if (!GGEMSCache::WriteCacheFile(cache_file.string(), PHYSIC_TABLES_CACHE_MAGIC, full_cache_key, tables.data(), tables.size())) {
+    GGwarn("GGEMSProcessesManager", "SavePhysicTables", 0) << "Impossible to write physic tables in cache '" << physic_tables_cache_path_ << "'!!!" << GGendl;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 GGEMSProcessesManager* get_instance_processes_manager(void)
 {
   return &GGEMSProcessesManager::GetInstance();
@@ -264,3 +350,12 @@ void print_tables_processes_manager(GGEMSProcessesManager* processes_manager, bo
 {
   processes_manager->PrintPhysicTables(is_processes_print_tables);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_physic_tables_cache_path_processes_manager(GGEMSProcessesManager* processes_manager, char const* physic_tables_cache_path)
+{
+  processes_manager->SetPhysicTablesCachePath(physic_tables_cache_path);
+}
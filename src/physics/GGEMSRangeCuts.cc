@@ -182,7 +182,7 @@ GGfloat GGEMSRangeCuts::ConvertToEnergy(GGEMSMaterialTables* material_table, GGu
     GGfloat constexpr kTune = 0.025f * mm * g / cm3;
     GGfloat constexpr kLowEnergy = 30.f * keV;
     if (kinetic_energy_cut < kLowEnergy) {
-      kinetic_energy_cut /= ( 1.0f + (1.0f - kinetic_energy_cut/kLowEnergy) * kTune / (cut*material_table->density_of_material_[index_mat]));
+      kinetic_energy_cut /= ( 1.0f + (1.0f - kinetic_energy_cut/kLowEnergy) * kTune / (cut*GGEMS_TABLE(GGfloat, material_table, density_of_material_)[index_mat]));
     }
   }
 
@@ -195,13 +195,13 @@ GGfloat GGEMSRangeCuts::ConvertToEnergy(GGEMSMaterialTables* material_table, GGu
 
   // Storing cut
   if (particle_name == "gamma") {
-    material_table->photon_energy_cut_[index_mat] = kinetic_energy_cut;
+    GGEMS_TABLE(GGfloat, material_table, photon_energy_cut_)[index_mat] = kinetic_energy_cut;
   }
   else if (particle_name == "e-") {
-    material_table->electron_energy_cut_[index_mat] = kinetic_energy_cut;
+    GGEMS_TABLE(GGfloat, material_table, electron_energy_cut_)[index_mat] = kinetic_energy_cut;
   }
   else if (particle_name == "e+") {
-    material_table->positron_energy_cut_[index_mat] = kinetic_energy_cut;
+    GGEMS_TABLE(GGfloat, material_table, positron_energy_cut_)[index_mat] = kinetic_energy_cut;
   }
 
   return kinetic_energy_cut;
@@ -218,10 +218,10 @@ void GGEMSRangeCuts::BuildAbsorptionLengthTable(GGEMSMaterialTables* material_ta
   range_table_material_ = new GGEMSLogEnergyTable(min_energy_, max_energy_, number_of_bins_);
 
   // Get the number of elements in material
-  GGsize number_of_elements = material_table->number_of_chemical_elements_[index_mat];
+  GGsize number_of_elements = GGEMS_TABLE(GGsize, material_table, number_of_chemical_elements_)[index_mat];
 
   // Get index offset to element
-  GGsize index_of_offset = material_table->index_of_chemical_elements_[index_mat];
+  GGsize index_of_offset = GGEMS_TABLE(GGsize, material_table, index_of_chemical_elements_)[index_mat];
 
   // Loop over the bins in the table
   for (GGsize i = 0; i < number_of_bins_; ++i) {
@@ -229,7 +229,7 @@ void GGEMSRangeCuts::BuildAbsorptionLengthTable(GGEMSMaterialTables* material_ta
 
     // Loop over the number of elements in material
     for (GGsize j = 0; j < number_of_elements; ++j) {
-      sigma += material_table->atomic_number_density_[j+index_of_offset] * loss_table_dedx_table_elements_[j]->GetLossTableData(i);
+      sigma += GGEMS_TABLE(GGfloat, material_table, atomic_number_density_)[j+index_of_offset] * loss_table_dedx_table_elements_[j]->GetLossTableData(i);
     }
 
     // Storing value
@@ -251,16 +251,16 @@ void GGEMSRangeCuts::BuildMaterialLossTable(GGEMSMaterialTables* material_table,
   range_table_material_ = new GGEMSLogEnergyTable(min_energy_, max_energy_, number_of_bins_);
 
   // Get the number of elements in material
-  GGsize number_of_elements = static_cast<GGsize>(material_table->number_of_chemical_elements_[index_mat]);
+  GGsize number_of_elements = static_cast<GGsize>(GGEMS_TABLE(GGsize, material_table, number_of_chemical_elements_)[index_mat]);
 
   // Get index offset to element
-  GGsize index_of_offset = material_table->index_of_chemical_elements_[index_mat];
+  GGsize index_of_offset = GGEMS_TABLE(GGsize, material_table, index_of_chemical_elements_)[index_mat];
 
   for (GGsize i = 0; i <= number_of_bins_; ++i) {
     GGfloat value = 0.0f;
 
     for (GGsize j = 0; j < number_of_elements; ++j) {
-      value += material_table->atomic_number_density_[j+index_of_offset] * loss_table_dedx_table_elements_[j]->GetLossTableData(i);
+      value += GGEMS_TABLE(GGfloat, material_table, atomic_number_density_)[j+index_of_offset] * loss_table_dedx_table_elements_[j]->GetLossTableData(i);
     }
     loss.push_back(value);
   }
@@ -302,13 +302,13 @@ void GGEMSRangeCuts::BuildMaterialLossTable(GGEMSMaterialTables* material_table,
 void GGEMSRangeCuts::BuildElementsLossTable(GGEMSMaterialTables* material_table, GGushort const& index_mat, std::string const& particle_name)
 {
   // Getting number of elements in material
-  number_of_tables_ = static_cast<GGsize>(material_table->number_of_chemical_elements_[index_mat]);
+  number_of_tables_ = static_cast<GGsize>(GGEMS_TABLE(GGsize, material_table, number_of_chemical_elements_)[index_mat]);
 
   // Building cross section tables for each elements in material
   loss_table_dedx_table_elements_ = new GGEMSLogEnergyTable*[number_of_tables_];
 
   // Get index offset to element
-  GGsize index_of_offset = material_table->index_of_chemical_elements_[index_mat];
+  GGsize index_of_offset = GGEMS_TABLE(GGsize, material_table, index_of_chemical_elements_)[index_mat];
 
   // Filling cross section table
   for (GGsize i = 0; i < number_of_tables_; ++i) {
@@ -316,7 +316,7 @@ void GGEMSRangeCuts::BuildElementsLossTable(GGEMSMaterialTables* material_table,
     GGEMSLogEnergyTable* log_energy_table_element = new GGEMSLogEnergyTable(min_energy_, max_energy_, number_of_bins_);
 
     // Getting atomic number
-    GGuchar const kZ = material_table->atomic_number_Z_[i+index_of_offset];
+    GGuchar const kZ = GGEMS_TABLE(GGuchar, material_table, atomic_number_Z_)[i+index_of_offset];
 
     for (GGsize j = 0; j < number_of_bins_; ++j) {
       if (particle_name == "gamma") {
@@ -587,42 +587,66 @@ GGfloat GGEMSRangeCuts::ConvertLengthToEnergyCut(GGfloat const& length_cut) cons
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSRangeCuts::ConvertCutsOfMaterials(GGEMSMaterialTables* material_table, GGsize const first_material, GGsize const last_material)
+{
+  for (GGsize i = first_material; i < last_material; ++i) {
+    GGushort index_mat = static_cast<GGushort>(i);
+    ConvertToEnergy(material_table, index_mat, "gamma");
+    ConvertToEnergy(material_table, index_mat, "e-");
+    ConvertToEnergy(material_table, index_mat, "e+");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSRangeCuts::ConvertCutsFromDistanceToEnergy(GGEMSMaterials* materials)
 {
   // Getting the minimum for the loss/cross section table in process manager
   GGEMSProcessesManager& process_manager = GGEMSProcessesManager::GetInstance();
   min_energy_ = process_manager.GetCrossSectionTableMinEnergy();
 
-  // Get data from OpenCL device
-  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
-
-  // Get number of activated device
-  GGsize number_activated_devices = opencl_manager.GetNumberOfActivatedDevice();
-
-  for (GGsize j = 0; j < number_activated_devices; ++j) {
-    cl::Buffer* material_table = materials->GetMaterialTables(j);
-    GGEMSMaterialTables* material_table_device = opencl_manager.GetDeviceBuffer<GGEMSMaterialTables>(material_table, CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSMaterialTables), j);
-
-    // Loop over materials
-    for (GGushort i = 0; i < material_table_device->number_of_materials_; ++i) {
-      // Get the name of material
-
-      // Convert photon cuts
-      GGfloat energy_cut_photon = ConvertToEnergy(material_table_device, i, "gamma");
-
-      // Convert electron cuts
-      GGfloat energy_cut_electron = ConvertToEnergy(material_table_device, i, "e-");
+  // Cuts are converted once in material tables on host, then material tables are copied to each device
+  GGEMSMaterialTables* material_table = materials->GetMaterialTablesHost();
+  GGsize number_of_materials = material_table->number_of_materials_;
+
+  // Loss tables are members, so each host thread converts a contiguous part of materials with its own range cuts
+  GGsize number_of_threads = std::max(static_cast<GGsize>(std::thread::hardware_concurrency()), static_cast<GGsize>(1));
+  number_of_threads = std::min(number_of_threads, number_of_materials);
+  GGsize materials_by_thread = number_of_threads > 0 ? (number_of_materials + number_of_threads - 1) / number_of_threads : 0;
+
+  GGEMSRangeCuts* range_cuts_thread = new GGEMSRangeCuts[number_of_threads];
+  std::vector<std::thread> thread_conversion;
+  for (GGsize t = 0; t < number_of_threads; ++t) {
+    range_cuts_thread[t].min_energy_ = min_energy_;
+    range_cuts_thread[t].distance_cut_photon_ = distance_cut_photon_;
+    range_cuts_thread[t].distance_cut_electron_ = distance_cut_electron_;
+    range_cuts_thread[t].distance_cut_positron_ = distance_cut_positron_;
+
+    GGsize first_material = t * materials_by_thread;
+    GGsize last_material = std::min(first_material + materials_by_thread, number_of_materials);
+    if (first_material >= last_material) break;
+    thread_conversion.push_back(std::thread(&GGEMSRangeCuts::ConvertCutsOfMaterials, &range_cuts_thread[t], material_table, first_material, last_material));
+  }
+  for (GGsize t = 0; t < thread_conversion.size(); ++t) thread_conversion[t].join();
+  delete[] range_cuts_thread;
+
+  // Storing the cuts in map
+  StoreEnergyCuts(materials);
+}
 
-      // Convert electron cuts
-      GGfloat energy_cut_positron = ConvertToEnergy(material_table_device, i, "e+");
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-      // Storing the cuts in map
-      energy_cuts_photon_.insert(std::make_pair(materials->GetMaterialName(i), energy_cut_photon));
-      energy_cuts_electron_.insert(std::make_pair(materials->GetMaterialName(i), energy_cut_electron));
-      energy_cuts_positron_.insert(std::make_pair(materials->GetMaterialName(i), energy_cut_positron));
-    }
+void GGEMSRangeCuts::StoreEnergyCuts(GGEMSMaterials const* materials)
+{
+  GGEMSMaterialTables const* material_table = materials->GetMaterialTablesHost();
 
-    // Release pointer
-    opencl_manager.ReleaseDeviceBuffer(material_table, material_table_device, j);
+  for (GGsize i = 0; i < material_table->number_of_materials_; ++i) {
+    energy_cuts_photon_.insert(std::make_pair(materials->GetMaterialName(i), GGEMS_TABLE(GGfloat, material_table, photon_energy_cut_)[i]));
+    energy_cuts_electron_.insert(std::make_pair(materials->GetMaterialName(i), GGEMS_TABLE(GGfloat, material_table, electron_energy_cut_)[i]));
+    energy_cuts_positron_.insert(std::make_pair(materials->GetMaterialName(i), GGEMS_TABLE(GGfloat, material_table, positron_energy_cut_)[i]));
   }
 }
@@ -28,12 +28,11 @@
   \date Monday December 16, 2019
 */
 
-#include <random>
-
 #include "GGEMS/randoms/GGEMSPseudoRandomGenerator.hh"
 #include "GGEMS/randoms/GGEMSRandom.hh"
 
 #include "GGEMS/tools/GGEMSRAMManager.hh"
+#include "GGEMS/tools/GGEMSProfilerManager.hh"
 
 #include "GGEMS/sources/GGEMSSourceManager.hh"
 
@@ -50,6 +49,8 @@
 
 GGEMSPseudoRandomGenerator::GGEMSPseudoRandomGenerator(void)
 : pseudo_random_numbers_(nullptr),
+  kernel_initialize_random_states_(nullptr),
+  number_of_stacks_(1),
   seed_(0)
 {
   GGcout("GGEMSPseudoRandomGenerator", "GGEMSPseudoRandomGenerator", 3) << "GGEMSPseudoRandomGenerator creating..." << GGendl;
@@ -69,12 +70,19 @@ GGEMSPseudoRandomGenerator::~GGEMSPseudoRandomGenerator(void)
 
   if (pseudo_random_numbers_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(pseudo_random_numbers_[i], sizeof(GGEMSRandom), i);
+      for (GGsize j = 0; j < number_of_stacks_; ++j) {
+        opencl_manager.Deallocate(pseudo_random_numbers_[i*number_of_stacks_ + j], GetRandomSize(opencl_manager.GetParticleStackSize(i)), i);
+      }
     }
     delete[] pseudo_random_numbers_;
     pseudo_random_numbers_ = nullptr;
   }
 
+  if (kernel_initialize_random_states_) {
+    delete[] kernel_initialize_random_states_;
+    kernel_initialize_random_states_ = nullptr;
+  }
+
   GGcout("GGEMSPseudoRandomGenerator", "~GGEMSPseudoRandomGenerator", 3) << "GGEMSPseudoRandomGenerator erased!!!" << GGendl;
 }
 
@@ -120,6 +128,21 @@ GGuint GGEMSPseudoRandomGenerator::GenerateSeed(void) const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSPseudoRandomGenerator::SetNumberOfStacks(GGsize const& number_of_stacks)
+{
+  if (pseudo_random_numbers_) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Number of random stacks must be set before initialization of random!!!";
+    GGEMSMisc::ThrowException("GGEMSPseudoRandomGenerator", "SetNumberOfStacks", oss.str());
+  }
+
+  number_of_stacks_ = number_of_stacks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSPseudoRandomGenerator::Initialize(GGuint const& seed)
 {
   GGcout("GGEMSPseudoRandomGenerator", "Initialize", 1) << "Initialization of GGEMSPseudoRandomGenerator..." << GGendl;
@@ -139,31 +162,76 @@ void GGEMSPseudoRandomGenerator::Initialize(GGuint const& seed)
 
 void GGEMSPseudoRandomGenerator::InitializeSeeds(void)
 {
-  GGcout("GGEMSPseudoRandomGenerator", "InitializeSeeds", 1) << "Initialization of seeds for each particles..." << GGendl;
+  #ifdef PHILOX_RANDOM
+  GGcout("GGEMSPseudoRandomGenerator", "InitializeSeeds", 1) << "Initialization of seed for Philox engine..." << GGendl;
+
+  // Get the OpenCL manager
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
-  // Initialize the Mersenne Twister engine
-  std::mt19937 mt_gen(seed_);
+  // Counter-based engine, only the seed is stored, streams of histories are set by source kernels
+  for (GGsize i = 0; i < number_activated_devices_; ++i) {
+    for (GGsize k = 0; k < number_of_stacks_; ++k) {
+      cl::Buffer* random_buffer = pseudo_random_numbers_[i*number_of_stacks_ + k];
+
+      // Seed is the first member of random structure, only this member is mapped
+      GGuint* seed_device = opencl_manager.GetDeviceBuffer<GGuint>(random_buffer, CL_TRUE, CL_MAP_WRITE, sizeof(GGuint), i);
+      seed_device[0] = seed_;
+      opencl_manager.ReleaseDeviceBuffer(random_buffer, seed_device, i);
+    }
+  }
+  #else
+  GGcout("GGEMSPseudoRandomGenerator", "InitializeSeeds", 1) << "Initialization of seeds for each particles..." << GGendl;
 
   // Get the OpenCL manager
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
-  // Loop over activated device
+  // Compiling kernel hashing states on device
+  std::string openCL_kernel_path = OPENCL_KERNEL_PATH;
+  std::string filename = openCL_kernel_path + "/InitializeRandomStates.cl";
+  kernel_initialize_random_states_ = new cl::Kernel*[number_activated_devices_];
+  opencl_manager.CompileKernel(filename, "initialize_random_states", kernel_initialize_random_states_, nullptr, nullptr);
+
+  // Loop over activated device and stacks
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    // Get the pointer on device
-    GGEMSRandom* random_device = opencl_manager.GetDeviceBuffer<GGEMSRandom>(pseudo_random_numbers_[i], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSRandom), i);
-
-    // For each particle a seed is generated
-    for (GGsize j = 0; j < MAXIMUM_PARTICLES; ++j) {
-      random_device->prng_state_1_[j] = static_cast<GGuint>(mt_gen());
-      random_device->prng_state_2_[j] = static_cast<GGuint>(mt_gen());
-      random_device->prng_state_3_[j] = static_cast<GGuint>(mt_gen());
-      random_device->prng_state_4_[j] = static_cast<GGuint>(mt_gen());
-      random_device->prng_state_5_[j] = 0;
+    cl::CommandQueue* queue = opencl_manager.GetCommandQueue(i);
+
+    // Get Device name and storing methode name + device
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(i);
+    std::string device_name = opencl_manager.GetDeviceName(device_index);
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "GGEMSPseudoRandomGenerator::InitializeSeeds on " << device_name << ", index " << device_index;
+
+    // Getting work group size, and work-item number
+    GGsize particle_stack_size = opencl_manager.GetParticleStackSize(i);
+    GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+    GGsize number_of_work_items = opencl_manager.GetBestWorkItem(particle_stack_size);
+
+    // Parameters for work-item in kernel
+    cl::NDRange global_wi(number_of_work_items);
+    cl::NDRange local_wi(work_group_size);
+
+    // Second stack of pipelined run is seeded on device, host seeding cost does not depend on the number of stacks
+    for (GGsize k = 0; k < number_of_stacks_; ++k) {
+      // States depend on seed, device and stack, not on the number of particles in stack nor on the number of stacks
+      kernel_initialize_random_states_[i]->setArg(0, particle_stack_size);
+      kernel_initialize_random_states_[i]->setArg(1, *pseudo_random_numbers_[i*number_of_stacks_ + k]);
+      kernel_initialize_random_states_[i]->setArg(2, seed_);
+      kernel_initialize_random_states_[i]->setArg(3, static_cast<GGuint>(i));
+      kernel_initialize_random_states_[i]->setArg(4, static_cast<GGuint>(k));
+
+      // Launching kernel
+      cl::Event event;
+      GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_initialize_random_states_[i], 0, global_wi, local_wi, nullptr, &event);
+      opencl_manager.CheckOpenCLError(kernel_status, "GGEMSPseudoRandomGenerator", "InitializeSeeds");
+
+      // GGEMS Profiling
+      GGEMSProfilerManager::GetInstance().HandleEvent(event, oss.str());
     }
 
-    // Release the pointer, mandatory step!!!
-    opencl_manager.ReleaseDeviceBuffer(pseudo_random_numbers_[i], random_device, i);
+    // States must be ready for the queue of the next particle stack
+    queue->finish();
   }
+  #endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -181,9 +249,11 @@ void GGEMSPseudoRandomGenerator::AllocateRandom(void)
   number_activated_devices_ = opencl_manager.GetNumberOfActivatedDevice();
 
   // Allocation of memory on OpenCL device
-  pseudo_random_numbers_ = new cl::Buffer*[number_activated_devices_];
+  pseudo_random_numbers_ = new cl::Buffer*[number_activated_devices_*number_of_stacks_];
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    pseudo_random_numbers_[i] = opencl_manager.Allocate(nullptr, sizeof(GGEMSRandom), i, CL_MEM_READ_WRITE, "GGEMSPseudoRandomGenerator");
+    for (GGsize j = 0; j < number_of_stacks_; ++j) {
+      pseudo_random_numbers_[i*number_of_stacks_ + j] = opencl_manager.Allocate(nullptr, GetRandomSize(opencl_manager.GetParticleStackSize(i)), i, CL_MEM_READ_WRITE, "GGEMSPseudoRandomGenerator");
+    }
   }
 }
 
@@ -196,6 +266,9 @@ void GGEMSPseudoRandomGenerator::PrintInfos(void) const
   GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "Printing infos about random" << GGendl;
   GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "Seed: " << seed_ << GGendl;
 
+  #ifdef PHILOX_RANDOM
+  GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "Engine: Philox4x32-10, random numbers depend only on seed, history and draw counter" << GGendl;
+  #else
   // Getting OpenCL manager
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
@@ -203,27 +276,28 @@ void GGEMSPseudoRandomGenerator::PrintInfos(void) const
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
     GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(i);
 
-    GGEMSRandom* random_device = opencl_manager.GetDeviceBuffer<GGEMSRandom>(pseudo_random_numbers_[i], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSRandom), i);
+    GGsize particle_stack_size = opencl_manager.GetParticleStackSize(i);
+    GGuint* random_device = opencl_manager.GetDeviceBuffer<GGuint>(pseudo_random_numbers_[i*number_of_stacks_], CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, GetRandomSize(particle_stack_size), i);
 
     GGuint state[2][5] = {
       {
-        random_device->prng_state_1_[0],
-        random_device->prng_state_2_[0],
-        random_device->prng_state_3_[0],
-        random_device->prng_state_4_[0],
-        random_device->prng_state_5_[0]
+        random_device[0],
+        random_device[particle_stack_size],
+        random_device[2*particle_stack_size],
+        random_device[3*particle_stack_size],
+        random_device[4*particle_stack_size]
       },
       {
-        random_device->prng_state_1_[1],
-        random_device->prng_state_2_[1],
-        random_device->prng_state_3_[1],
-        random_device->prng_state_4_[1],
-        random_device->prng_state_5_[1]
+        random_device[1],
+        random_device[1 + particle_stack_size],
+        random_device[1 + 2*particle_stack_size],
+        random_device[1 + 3*particle_stack_size],
+        random_device[1 + 4*particle_stack_size]
       }
     };
 
     // Release the pointer, mandatory step!!!
-    opencl_manager.ReleaseDeviceBuffer(pseudo_random_numbers_[i], random_device, i);
+    opencl_manager.ReleaseDeviceBuffer(pseudo_random_numbers_[i*number_of_stacks_], random_device, i);
 
     GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "Device: " << opencl_manager.GetDeviceName(device_index) << GGendl;
     GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "-------" << GGendl;
@@ -234,4 +308,5 @@ void GGEMSPseudoRandomGenerator::PrintInfos(void) const
     GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "    * state 3: " << state[0][3] << " " << state[1][3] << GGendl;
     GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "    * state 4: " << state[0][4] << " " << state[1][4] << GGendl;
   }
+  #endif
 }
@@ -259,7 +259,8 @@ void GGEMSSource::OrganizeParticlesInBatch(void)
   number_of_particles_in_batch_ = new GGsize*[number_activated_devices_];
   number_of_batchs_ = new GGsize[number_activated_devices_];
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    number_of_batchs_[i] = static_cast<GGsize>(std::ceil(static_cast<GGfloat>(number_of_particles_by_device_[i]) / MAXIMUM_PARTICLES));
+    GGsize particle_stack_size = opencl_manager.GetParticleStackSize(i);
+    number_of_batchs_[i] = (number_of_particles_by_device_[i] + particle_stack_size - 1) / particle_stack_size;
 
     number_of_particles_in_batch_[i] = new GGsize[number_of_batchs_[i]];
 
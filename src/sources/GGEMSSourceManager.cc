@@ -28,9 +28,21 @@
   \date Thursday January 16, 2020
 */
 
+#include <mutex>
+#include <algorithm>
+
+/*!
+  \brief empty namespace storing mutex
+*/
+namespace {
+  std::mutex mutex; /*!< Mutex variable */
+}
+
 #include "GGEMS/sources/GGEMSSourceManager.hh"
 #include "GGEMS/physics/GGEMSPrimaryParticles.hh"
 #include "GGEMS/randoms/GGEMSPseudoRandomGenerator.hh"
+#include "GGEMS/randoms/GGEMSRandom.hh"
+#include "GGEMS/tools/GGEMSRAMManager.hh"
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -38,7 +50,9 @@
 
 GGEMSSourceManager::GGEMSSourceManager(void)
 : sources_(nullptr),
-  number_of_sources_(0)
+  number_of_sources_(0),
+  is_dynamic_batch_scheduling_(false),
+  next_batch_in_pool_(0)
 {
   GGcout("GGEMSSourceManager", "GGEMSSourceManager", 3) << "GGEMSSourceManager creating..." << GGendl;
 
@@ -129,6 +143,9 @@ void GGEMSSourceManager::PrintInfos(void) const
 
 GGsize GGEMSSourceManager::GetTotalNumberOfBatchs(void) const
 {
+  // In dynamic scheduling, all the batchs are in the shared pool
+  if (is_dynamic_batch_scheduling_) return batch_pool_.size();
+
   // Getting the number of activated device
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
   GGsize number_of_activated_devices = opencl_manager.GetNumberOfActivatedDevice();
@@ -149,7 +166,168 @@ GGsize GGEMSSourceManager::GetTotalNumberOfBatchs(void) const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSSourceManager::Initialize(GGuint const& seed, bool const& is_tracking, GGint const& particle_tracking_id) const
+void GGEMSSourceManager::SetNumberOfStacks(GGsize const& number_of_stacks) const
+{
+  particles_->SetNumberOfStacks(number_of_stacks);
+  pseudo_random_generator_->SetNumberOfStacks(number_of_stacks);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSourceManager::SetDynamicBatchScheduling(bool const& is_dynamic_batch_scheduling)
+{
+  is_dynamic_batch_scheduling_ = is_dynamic_batch_scheduling;
+
+  // JKISS random states belong to particle stack of device, histories of a batch depend on the device pulling it
+  #ifndef PHILOX_RANDOM
+  if (is_dynamic_batch_scheduling_) {
+    GGwarn("GGEMSSourceManager", "SetDynamicBatchScheduling", 0) << "Dynamic scheduling of batchs without PHILOX_RANDOM: results depend on the device simulating each batch, compile with REPRODUCIBLE_RESULTS for results independent of scheduling!!!" << GGendl;
+  }
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSourceManager::InitializeParticleStackSize(void)
+{
+  GGcout("GGEMSSourceManager", "InitializeParticleStackSize", 3) << "Sizing particle stacks..." << GGendl;
+
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  GGEMSRAMManager& ram_manager = GGEMSRAMManager::GetInstance();
+
+  // Memory on device for one particle: primary particles and random in each stack, and lists of alive particles
+  GGsize primary_particle_size = GetPrimaryParticlesSize(1) - GetPrimaryParticlesSize(0);
+  GGsize random_particle_size = GetRandomSize(1) - GetRandomSize(0);
+  GGsize particle_size = particles_->GetNumberOfStacks()*(primary_particle_size + random_particle_size);
+  if (particles_->IsAliveCompaction()) particle_size += 2*sizeof(GGint);
+
+  // Size of primary particles independent of stack size, with trajectories for OpenGL if activated
+  GGsize primary_fixed_size = GetPrimaryParticlesSize(0);
+  if (particles_->IsOpenGLTrajectories()) primary_fixed_size += GetPrimaryParticlesOpenGLSize();
+
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+
+  for (GGsize i = 0; i < opencl_manager.GetNumberOfActivatedDevice(); ++i) {
+    // Size given by user
+    if (opencl_manager.GetParticleStackSize(i) != 0) continue;
+
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(i);
+
+    // A quarter of available memory is given to particle stacks, remaining memory is kept for navigators and dosimetry
+    GGsize particle_stack_size = std::min(ram_manager.GetAvailableRAMMemory(device_index) / 4 / particle_size, static_cast<GGsize>(MAXIMUM_PARTICLE_STACK_SIZE));
+
+    // Each stack is a single buffer, limited by maximum allocation size of device
+    GGsize max_buffer_size = opencl_manager.GetMaxBufferAllocationSize(device_index);
+    particle_stack_size = std::min(particle_stack_size, max_buffer_size > primary_fixed_size ? (max_buffer_size - primary_fixed_size) / primary_particle_size : 0);
+    particle_stack_size = std::min(particle_stack_size, max_buffer_size > GetRandomSize(0) ? (max_buffer_size - GetRandomSize(0)) / random_particle_size : 0);
+
+    // Stack is a multiple of work group size
+    particle_stack_size = (particle_stack_size / work_group_size) * work_group_size;
+
+    if (particle_stack_size == 0) {
+      std::ostringstream oss(std::ostringstream::out);
+      oss << "Not enough memory on device " << opencl_manager.GetDeviceName(device_index) << " for particle stack!!!";
+      GGEMSMisc::ThrowException("GGEMSSourceManager", "InitializeParticleStackSize", oss.str());
+    }
+
+    opencl_manager.SetParticleStackSize(i, particle_stack_size);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSourceManager::OrganizeBatchPool(void)
+{
+  GGcout("GGEMSSourceManager", "OrganizeBatchPool", 3) << "Organizing the pool of batchs..." << GGendl;
+
+  // Getting the number of activated device
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  GGsize number_of_activated_devices = opencl_manager.GetNumberOfActivatedDevice();
+
+  batch_pool_.clear();
+  next_batch_in_pool_ = 0;
+
+  // Batchs are shared, they fit in the smallest particle stack
+  GGsize particle_stack_size = opencl_manager.GetParticleStackSize(0);
+  for (GGsize i = 1; i < number_of_activated_devices; ++i) particle_stack_size = std::min(particle_stack_size, opencl_manager.GetParticleStackSize(i));
+
+  // Particles of each source are cut in batchs independently of devices, several batchs by device so a fast device pulls batchs of slow devices
+  GGsize first_history = 0;
+  for (GGsize i = 0; i < number_of_sources_; ++i) {
+    GGsize number_of_particles = sources_[i]->GetNumberOfParticles();
+    GGsize number_of_batchs = (number_of_particles + particle_stack_size - 1) / particle_stack_size;
+    number_of_batchs = std::min(std::max(number_of_batchs, MINIMUM_BATCHS_BY_DEVICE * number_of_activated_devices), number_of_particles);
+
+    for (GGsize j = 0; j < number_of_batchs; ++j) {
+      GGEMSBatch batch;
+      batch.source_index_ = i;
+      batch.number_of_particles_ = number_of_particles / number_of_batchs;
+
+      // Adding the remaining particles
+      if (j < number_of_particles % number_of_batchs) batch.number_of_particles_++;
+
+      batch.first_history_ = first_history;
+      first_history += batch.number_of_particles_;
+
+      batch_pool_.push_back(batch);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool GGEMSSourceManager::GetNextBatch(GGsize const& thread_index, GGsize& batch_counter, GGEMSBatch& batch)
+{
+  // Dynamic scheduling, pulling the next batch from the shared pool
+  if (is_dynamic_batch_scheduling_) {
+    mutex.lock();
+    bool is_batch = next_batch_in_pool_ < batch_pool_.size();
+    if (is_batch) batch = batch_pool_[next_batch_in_pool_++];
+    mutex.unlock();
+
+    if (is_batch) ++batch_counter;
+    return is_batch;
+  }
+
+  // Static scheduling, finding the source of the batch in batchs of device
+  GGsize batch_index = batch_counter;
+  GGsize first_history = 0;
+  for (GGsize i = 0; i < number_of_sources_; ++i) {
+    GGsize number_of_batchs = sources_[i]->GetNumberOfBatchs(thread_index);
+    if (batch_index < number_of_batchs) {
+      batch.source_index_ = i;
+      batch.number_of_particles_ = sources_[i]->GetNumberOfParticlesInBatch(thread_index, batch_index);
+
+      // Particles of source simulated by previous devices and by previous batchs of device
+      for (GGsize j = 0; j < thread_index; ++j) {
+        for (GGsize k = 0; k < sources_[i]->GetNumberOfBatchs(j); ++k) first_history += sources_[i]->GetNumberOfParticlesInBatch(j, k);
+      }
+      for (GGsize k = 0; k < batch_index; ++k) first_history += sources_[i]->GetNumberOfParticlesInBatch(thread_index, k);
+      batch.first_history_ = first_history;
+
+      ++batch_counter;
+      return true;
+    }
+    batch_index -= number_of_batchs;
+    first_history += sources_[i]->GetNumberOfParticles();
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSourceManager::Initialize(GGuint const& seed, bool const& is_tracking, GGint const& particle_tracking_id)
 {
   GGcout("GGEMSSourceManager", "Initialize", 3) << "Initializing the GGEMS source(s)..." << GGendl;
 
@@ -160,6 +338,9 @@ void GGEMSSourceManager::Initialize(GGuint const& seed, bool const& is_tracking,
     GGEMSMisc::ThrowException("GGEMSSourceManager", "Initialize", oss.str());
   }
 
+  // Size of particle stacks on each device, before any allocation and compilation of kernel using particles
+  InitializeParticleStackSize();
+
   // Initialization of particle stack and random stack
   particles_->Initialize();
   GGcout("GGEMSSourceManager", "Initialize", 0) << "Initialization of particles OK" << GGendl;
@@ -170,20 +351,25 @@ void GGEMSSourceManager::Initialize(GGuint const& seed, bool const& is_tracking,
   // Initialization of sources
   for (GGsize i = 0; i < number_of_sources_; ++i) sources_[i]->Initialize(is_tracking);
 
+  // Sharing batchs between devices
+  if (is_dynamic_batch_scheduling_) OrganizeBatchPool();
+
   // If tracking activated, set the particle id to track
   if (is_tracking) {
     // Get the OpenCL manager
     GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
-    // Loop over activated device
+    // Loop over activated device and particle stacks
     for (GGsize i = 0; i < opencl_manager.GetNumberOfActivatedDevice(); ++i) {
-      // Get pointer on OpenCL device for particles
-      GGEMSPrimaryParticles* primary_particles_device = opencl_manager.GetDeviceBuffer<GGEMSPrimaryParticles>(particles_->GetPrimaryParticles(i), CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGEMSPrimaryParticles), i);
+      for (GGsize j = 0; j < particles_->GetNumberOfStacks(); ++j) {
+        // Get pointer on OpenCL device for particles, particle_tracking_id is the first member of primary particles
+        GGint* particle_tracking_id_device = opencl_manager.GetDeviceBuffer<GGint>(particles_->GetPrimaryParticles(i, j), CL_TRUE, CL_MAP_WRITE | CL_MAP_READ, sizeof(GGint), i);
 
-      primary_particles_device->particle_tracking_id = particle_tracking_id;
+        particle_tracking_id_device[0] = particle_tracking_id;
 
-      // Release the pointer
-      opencl_manager.ReleaseDeviceBuffer(particles_->GetPrimaryParticles(i), primary_particles_device, i);
+        // Release the pointer
+        opencl_manager.ReleaseDeviceBuffer(particles_->GetPrimaryParticles(i, j), particle_tracking_id_device, i);
+      }
     }
   }
 }
@@ -192,6 +378,16 @@ void GGEMSSourceManager::Initialize(GGuint const& seed, bool const& is_tracking,
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSSourceManager::CheckAlive(GGsize const& thread_index) const
+{
+  // Counting alive particles without blocking the host
+  particles_->CheckAlive(thread_index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 bool GGEMSSourceManager::IsAlive(GGsize const& thread_index) const
 {
   // Check if all particles are DEAD in OpenCL particle buffer
@@ -136,11 +136,11 @@ void GGEMSXRaySource::InitializeKernel(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSXRaySource::GetPrimaries(GGsize const& thread_index, GGsize const& number_of_particles)
+void GGEMSXRaySource::GetPrimaries(GGsize const& thread_index, GGsize const& number_of_particles, GGsize const& first_history, GGsize const& stack_index, cl::Event* event)
 {
-  // Get command queue and event
+  // Get command queue and event, source queue is used if primaries are generated asynchronously
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
-  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+  cl::CommandQueue* queue = event ? opencl_manager.GetSourceCommandQueue(thread_index) : opencl_manager.GetCommandQueue(thread_index);
 
   // Get Device name and storing methode name + device
   GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
@@ -150,8 +150,8 @@ void GGEMSXRaySource::GetPrimaries(GGsize const& thread_index, GGsize const& num
 
   // Get the OpenCL buffers
   GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
-  cl::Buffer* particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
-  cl::Buffer* randoms = source_manager.GetPseudoRandomGenerator()->GetPseudoRandomNumbers(thread_index);
+  cl::Buffer* particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index, stack_index);
+  cl::Buffer* randoms = source_manager.GetPseudoRandomGenerator()->GetPseudoRandomNumbers(thread_index, stack_index);
   cl::Buffer* matrix_transformation = geometry_transformation_->GetTransformationMatrix(thread_index);
 
   // Getting work group size, and work-item number
@@ -173,16 +173,25 @@ void GGEMSXRaySource::GetPrimaries(GGsize const& thread_index, GGsize const& num
   kernel_get_primaries_[thread_index]->setArg(7, beam_aperture_);
   kernel_get_primaries_[thread_index]->setArg(8, focal_spot_size_);
   kernel_get_primaries_[thread_index]->setArg(9, *matrix_transformation);
+  kernel_get_primaries_[thread_index]->setArg(10, first_history);
 
   // Launching kernel
-  cl::Event event;
-  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_get_primaries_[thread_index], 0, global_wi, local_wi, nullptr, &event);
+  cl::Event kernel_event;
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_get_primaries_[thread_index], 0, global_wi, local_wi, nullptr, &kernel_event);
   opencl_manager.CheckOpenCLError(kernel_status, "GGEMSXRaySource", "GetPrimaries");
 
   // GGEMS Profiling
   GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
-  profiler_manager.HandleEvent(event, oss.str());
-  queue->finish();
+  profiler_manager.HandleEvent(kernel_event, oss.str());
+
+  // In asynchronous mode, the kernel is only submitted and the caller waits on the event
+  if (event) {
+    *event = kernel_event;
+    queue->flush();
+  }
+  else {
+    queue->finish();
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
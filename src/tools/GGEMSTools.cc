@@ -31,6 +31,9 @@
 #include <sstream>
 #include <cerrno>
 #include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <random>
 
 #include "GGEMS/tools/GGEMSTools.hh"
 #include "GGEMS/tools/GGEMSPrint.hh"
@@ -65,3 +68,82 @@ void GGEMSFileStream::CheckInputStream(std::ifstream const& input_stream, std::s
   GGcerr(class_name, method_name, 0) << oss.str() << GGendl;
   throw std::runtime_error("");
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSCache::Hash(std::string const& data)
+{
+  GGulong hash = 0xcbf29ce484222325ULL;
+  for (unsigned char c : data) {
+    hash ^= c;
+    hash *= 0x100000001b3ULL;
+  }
+
+  std::ostringstream oss(std::ostringstream::out);
+  oss << std::hex << std::setfill('0') << std::setw(16) << hash;
+  return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool GGEMSCache::ReadCacheFile(std::string const& cache_filename, std::string const& magic, std::string const& cache_key, std::vector<GGuchar>& data)
+{
+  std::error_code error_code;
+  GGsize file_size = static_cast<GGsize>(std::filesystem::file_size(cache_filename, error_code));
+  if (error_code) return false;
+
+  std::ifstream cache_stream(cache_filename, std::ios::in | std::ios::binary);
+  std::string stored_magic;
+  std::getline(cache_stream, stored_magic);
+
+  GGsize key_size = 0;
+  cache_stream.read(reinterpret_cast<char*>(&key_size), sizeof(GGsize));
+  if (!cache_stream || stored_magic != magic || key_size >= file_size) return false;
+
+  std::string stored_key(key_size, '\0');
+  cache_stream.read(&stored_key[0], static_cast<std::streamsize>(key_size));
+
+  GGsize data_size = 0;
+  cache_stream.read(reinterpret_cast<char*>(&data_size), sizeof(GGsize));
+  if (!cache_stream || stored_key != cache_key || data_size == 0 || data_size >= file_size) return false;
+
+  data.resize(data_size);
+  cache_stream.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data_size));
+
+  return static_cast<bool>(cache_stream);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool GGEMSCache::WriteCacheFile(std::string const& cache_filename, std::string const& magic, std::string const& cache_key, GGuchar const* data, GGsize const& data_size)
+{
+  std::string temporary_filename = cache_filename + "." + std::to_string(std::random_device()()) + ".tmp";
+
+  bool is_written = false;
+  {
+    std::ofstream cache_stream(temporary_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    GGsize key_size = cache_key.size();
+    cache_stream << magic << '\n';
+    cache_stream.write(reinterpret_cast<char const*>(&key_size), sizeof(GGsize));
+    cache_stream.write(cache_key.data(), static_cast<std::streamsize>(key_size));
+    cache_stream.write(reinterpret_cast<char const*>(&data_size), sizeof(GGsize));
+    cache_stream.write(reinterpret_cast<char const*>(data), static_cast<std::streamsize>(data_size));
+    cache_stream.close();
+    is_written = static_cast<bool>(cache_stream);
+  }
+
+  std::error_code error_code;
+  if (is_written) std::filesystem::rename(temporary_filename, cache_filename, error_code);
+  if (!is_written || error_code) {
+    std::filesystem::remove(temporary_filename, error_code);
+    return false;
+  }
+
+  return true;
+}